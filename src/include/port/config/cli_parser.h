@@ -9,4 +9,25 @@ void ParseCLI(int argc, char* argv[]);
 /** @brief When true, RmlUi handles all overlay menus (set via --ui rmlui CLI). */
 extern bool g_ui_mode_rmlui;
 
+/** @brief Chip count for the SDL2D Sprite2 benchmark (set via --bench-sprite2, 0 = off). */
+extern int g_bench_sprite2_chips;
+
+/** @brief WAV path for offline audio rendering (set via --render-audio, NULL = off). */
+extern const char* g_render_audio_path;
+
+/** @brief JSON path for the heap report written at exit (set via --heap-report, NULL = off). */
+extern const char* g_heap_report_path;
+
+/** @brief Verify AFS entries against the index digests in the background (set via --verify-assets). */
+extern bool g_verify_assets;
+
+/** @brief Time every character and stage load set, print the results and exit (set via --bench-loads). */
+extern bool g_bench_loads;
+
+/** @brief Chrome trace JSON path for asset load timings, written at exit (set via --load-trace, NULL = off). */
+extern const char* g_load_trace_path;
+
+/** @brief CSV path for simulation CPU time per task, effect and command, written at exit (set via --sim-profile). */
+extern const char* g_sim_profile_path;
+
 #endif
@@ -0,0 +1,21 @@
+/**
+ * @file heap_report.h
+ * @brief Occupancy and fragmentation report for the fixed game heaps.
+ *
+ * Collects the MemMan heaps (ramcnt, PPG, zlib), the ramcnt keys by kind
+ * and the AcrSDK system memory manager into one report, written as JSON
+ * (--heap-report) or condensed into a line for the debug HUD.
+ */
+#ifndef HEAP_REPORT_H
+#define HEAP_REPORT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/** @brief Write the full report to @p path as JSON. */
+bool HeapReport_WriteJSON(const char* path);
+
+/** @brief One-line summary (usage and fragmentation per heap) for the HUD. */
+void HeapReport_FormatOverlay(char* buf, size_t size);
+
+#endif // HEAP_REPORT_H
@@ -0,0 +1,18 @@
+/**
+ * @file load_bench.h
+ * @brief Load benchmark (--bench-loads): every character and stage load set, timed.
+ *
+ * Pushes each load set through the LDREQ queue in turn without running the
+ * game loop, pumping the queue and AFS until it drains, then releases what
+ * it loaded so the next set starts from the same state. Prints the time per
+ * set, the per-asset breakdown from the load trace and the total.
+ */
+#ifndef LOAD_BENCH_H
+#define LOAD_BENCH_H
+
+#include <stdbool.h>
+
+/** @brief Run the benchmark once the game is initialised; false if any set failed to load in time. */
+bool LoadBench_Run();
+
+#endif // LOAD_BENCH_H
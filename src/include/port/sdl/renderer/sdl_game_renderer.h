@@ -35,6 +35,12 @@ typedef struct Sprite2 {
     float modelY; // Per-character Y offset (vertex shader model transform, Opt #3)
 } Sprite2;
 
+/// Per-frame batching statistics from the last RenderFrame.
+typedef struct SDLGameRenderer_DrawStats {
+    int tasks;      // Quads submitted (one draw each before batching)
+    int draw_calls; // Draw calls issued after sort-key grouping and run merging
+} SDLGameRenderer_DrawStats;
+
 extern unsigned int cps3_canvas_texture;
 
 void SDLGameRenderer_Init();
@@ -63,10 +69,16 @@ void SDLGameRenderer_FlushSprite2Batch(Sprite2* chips, const unsigned char* acti
 // Used by ImGui to render game textures. Returns 0 if not found/invalid.
 unsigned int SDLGameRenderer_GetCachedGLTexture(unsigned int texture_handle, unsigned int palette_handle);
 
+// Fills `out` with the task and draw-call counts of the last rendered frame.
+void SDLGameRenderer_GetDrawStats(SDLGameRenderer_DrawStats* out);
+
 // Reset texture batch state between sub-frames (used by netplay rollback).
 void SDLGameRenderer_ResetBatchState(void);
 
 // Dumps all currently loaded textures to textures/*.tga
 void SDLGameRenderer_DumpTextures(void);
 
+// Times a synthetic scene of `chips` Sprite2 chips (SDL2D backend only, --bench-sprite2).
+void SDLGameRenderer_BenchmarkSprite2(int chips);
+
 #endif
@@ -0,0 +1,100 @@
+/**
+ * @file sim_profile.h
+ * @brief Counting CPU profiler for the game simulation: task slots, effect IDs, script commands.
+ *
+ * Times every call through the three dispatch points of the simulation:
+ * the task slots in cpLoopTask(), the effect move handlers in
+ * move_effect_work() and the character script commands in decode_chcmd.
+ * Always compiled in; while it is off each site costs one predictable
+ * branch. Turned on from the debug HUD (PgUp cycles the table, PgDn its
+ * sort order) or with --sim-profile, which writes a CSV on exit.
+ *
+ * Times are inclusive: a task includes the effects and commands it runs,
+ * and an effect includes any script commands it decodes. Rollback
+ * resimulation runs the same sites again, so resimulated frames count
+ * like any other.
+ *
+ * Game thread only.
+ */
+#ifndef SIM_PROFILE_H
+#define SIM_PROFILE_H
+
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SIM_PROFILE_TASKS 11
+#define SIM_PROFILE_EFFECTS 229
+#define SIM_PROFILE_COMMANDS 125
+#define SIM_PROFILE_LINE_LENGTH 96
+
+typedef enum SimProfileKind {
+    SIM_PROFILE_TASK,    // cpLoopTask() slot
+    SIM_PROFILE_EFFECT,  // effmovejptbl[] index
+    SIM_PROFILE_COMMAND, // decode_chcmd[] opcode
+    SIM_PROFILE_KIND_COUNT
+} SimProfileKind;
+
+typedef enum SimProfileSort {
+    SIM_PROFILE_BY_TIME,
+    SIM_PROFILE_BY_CALLS,
+    SIM_PROFILE_BY_AVERAGE,
+    SIM_PROFILE_SORT_COUNT
+} SimProfileSort;
+
+typedef struct SimProfileRow {
+    SimProfileKind kind;
+    int id;
+    uint64_t ns;
+    uint64_t calls;
+} SimProfileRow;
+
+/** @brief Read by the inline SimProfile_Begin(); use SimProfile_SetEnabled() to change it. */
+extern bool sim_profile_active;
+
+/** @brief Turn timing on or off; turning it on starts from zeroed counters. */
+void SimProfile_SetEnabled(bool enabled);
+bool SimProfile_IsEnabled();
+
+/** @brief Zero every counter and the frame count. */
+void SimProfile_Reset();
+
+/** @brief Count one simulated frame (called once per cpLoopTask()). */
+void SimProfile_NoteFrame();
+uint64_t SimProfile_GetFrames();
+
+/** @brief Timestamp to pass to SimProfile_End(), or 0 while the profiler is off. */
+static inline uint64_t SimProfile_Begin(void) {
+    return sim_profile_active ? SDL_GetPerformanceCounter() : 0;
+}
+
+void SimProfile_Record(SimProfileKind kind, int id, uint64_t begin);
+
+/** @brief Charge the time since @p begin and one call to @p id; a no-op if @p begin is 0. */
+static inline void SimProfile_End(SimProfileKind kind, int id, uint64_t begin) {
+    if (begin != 0) {
+        SimProfile_Record(kind, id, begin);
+    }
+}
+
+/** @brief Copy the IDs of @p kind that were called at least once into @p rows, sorted; returns the count. */
+int SimProfile_GetRows(SimProfileKind kind, SimProfileSort sort, SimProfileRow* rows, int max_rows);
+
+/** @brief Name of @p id as it appears in the source: "Task:Game", "effect_A6", "cmd_17". */
+void SimProfile_FormatName(SimProfileKind kind, int id, char* buf, size_t size);
+
+const char* SimProfile_KindName(SimProfileKind kind);
+const char* SimProfile_SortName(SimProfileSort sort);
+
+/** @brief Write every counter that was hit as CSV, per kind. */
+bool SimProfile_WriteCSV(const char* path);
+
+/** @brief HUD table: off, then tasks, effects, commands. Leaving "off" turns the profiler on. */
+void SimProfile_CycleView();
+void SimProfile_CycleSort();
+
+/** @brief Lines of the HUD table for the current view (none while off); returns how many were written. */
+int SimProfile_FormatOverlay(char (*lines)[SIM_PROFILE_LINE_LENGTH], int max_lines);
+
+#endif // SIM_PROFILE_H
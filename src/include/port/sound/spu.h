@@ -2,8 +2,7 @@
 #define SPU_H_
 
 #include "common.h"
-#include "port/tracy_zones.h"
-#include <SDL3/SDL_mutex.h>
+#include <stdbool.h>
 
 struct SPUVConf {
     u32 pitch;
@@ -12,14 +11,46 @@ struct SPUVConf {
     u16 pmon;
 };
 
-extern SDL_Mutex* soundLock;
-#ifdef TRACY_ENABLE
-extern TracyCLockCtx soundLockCtx;
-#endif
+/** @brief Largest payload carried by one queued SPU command. */
+#define SPU_CMD_PAYLOAD_MAX 64
+
+/** @brief Command applied on the audio thread; @p payload is the copy made at post time. */
+typedef void (*SPU_CommandFn)(const void* payload);
+
+/** @brief Sound-effect start latency, from the game-thread request to the first mixing batch. */
+typedef struct SPU_LatencyStats {
+    int starts;        // SE starts measured since SPU_Init()
+    int last_us;       // Request → mix, most recent start
+    int avg_us;        // Request → mix, moving average
+    int peak_us;       // Request → mix, worst start in the last window
+    int output_us;     // Moving average including audio queued ahead of the mix (≈ time to the speaker)
+    int device_frames; // Device period in 48 kHz frames (0 if unknown)
+    int batch_frames;  // Frames mixed per command-queue drain
+    bool low_latency;
+} SPU_LatencyStats;
 
 void SPU_Init(void (*cb)());
+
+/** @brief Skip the audio device in SPU_Init(); mixing is then driven by SPU_RenderOffline(). */
+void SPU_SetOffline(bool enable);
+
+/** @brief Offline mode: mix @p count stereo samples, running the eml timer as the callback would. */
+void SPU_RenderOffline(s16* output, int count);
+
+/** @brief Request a small device period in SPU_Init() and mix in batches of that period. */
+void SPU_SetLowLatency(bool enable);
+
+/** @brief Audio thread: record an SE start posted at @p posted_ns (SDL_GetTicksNS) as mixed now. */
+void SPU_NoteStartLatency(u64 posted_ns);
+
+/** @brief Snapshot of SE latency; safe to call from any thread. */
+void SPU_GetLatencyStats(SPU_LatencyStats* stats);
 void SPU_Upload(u32 dst, void* src, u32 size);
+bool SPU_PostCommand(SPU_CommandFn fn, const void* payload, u32 size);
+void SPU_RunCommands(void);
 void SPU_Tick(s16* output);
+void SPU_Render(s16* output, int count);
+void SPU_Reset(void);
 void SPU_VoiceStart(int vnum, u32 start_addr);
 void SPU_VoiceGetConf(int vnum, struct SPUVConf* conf);
 void SPU_VoiceSetConf(int vnum, struct SPUVConf* conf);
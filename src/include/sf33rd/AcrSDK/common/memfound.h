@@ -27,5 +27,8 @@ void* mflTemporaryUse(s32 len);
 void* mflRetrieve(u32 handle);
 s32 mflRelease(u32 handle);
 void* mflCompact();
+s32 mflCompactStep(size_t byte_budget, u64 ns_budget);
+void mflSetMoveHook(MEM_MOVE_HOOK hook);
+void mflGetStats(MEM_MGR_STATS* stats);
 
 #endif
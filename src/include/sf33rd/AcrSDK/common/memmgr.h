@@ -4,7 +4,8 @@
  *
  * Manages a pool of memory blocks identified by handles. Supports
  * forward/reverse allocation, aligned allocation, defragmentation
- * via compaction, and temporary (non-persistent) allocations.
+ * via compaction (all at once or in budgeted steps), and temporary
+ * (non-persistent) allocations.
  *
  * Part of the AcrSDK common module.
  * Originally from the PS2 SDK abstraction layer.
@@ -25,6 +26,14 @@ typedef struct {
     u16 next;
 } MEM_BLOCK;
 
+/**
+ * @brief Called after compaction moves a block.
+ *
+ * The handle stays valid; anything that cached the old address (renderer
+ * surfaces, buffer cursors) must follow the data to @p new_ptr.
+ */
+typedef void (*MEM_MOVE_HOOK)(u32 handle, u8* old_ptr, u8* new_ptr);
+
 typedef struct {
     s32 cnt;
     s32 memsize;
@@ -36,8 +45,39 @@ typedef struct {
     s32 used_size;
     s32 tmemsize;
     u32 blocklist;
+    MEM_MOVE_HOOK move_hook;
+
+    // Instrumentation (see plmemGetStats)
+    s32 peak_used;
+    u32 register_count;
+    u32 release_count;
+    u32 fail_count;
+    u32 compact_count;
+    u32 compact_step_count;
+    u32 compact_moves;
+    u64 compact_bytes;
+    u64 compact_ns;
+    u64 compact_max_ns;
 } MEM_MGR;
 
+/** @brief Occupancy, fragmentation and compaction cost of one manager. */
+typedef struct {
+    s32 size;
+    s32 used;
+    s32 peak_used;
+    size_t largest_free; // Frontier or biggest hole between blocks
+    s32 blocks;
+    u32 registers;
+    u32 releases;
+    u32 failures;
+    u32 compactions;
+    u32 compact_steps;  // plmemCompactStep calls that moved something
+    u32 compact_moves;  // Blocks memmoved by compaction
+    u64 compact_bytes;  // Bytes memmoved by compaction
+    u64 compact_ns;     // Total time spent compacting
+    u64 compact_max_ns; // Slowest single compaction
+} MEM_MGR_STATS;
+
 void plmemInit(MEM_MGR* memmgr, MEM_BLOCK* block, s32 count, void* mem_ptr, s32 memsize, s32 memalign, s32 direction);
 u32 plmemRegister(MEM_MGR* memmgr, s32 len);
 u32 plmemRegisterAlign(MEM_MGR* memmgr, s32 len, s32 align);
@@ -46,7 +86,10 @@ void* plmemTemporaryUse(MEM_MGR* memmgr, s32 len);
 void* plmemRetrieve(MEM_MGR* memmgr, u32 handle);
 s32 plmemRelease(MEM_MGR* memmgr, u32 handle);
 void* plmemCompact(MEM_MGR* memmgr);
+s32 plmemCompactStep(MEM_MGR* memmgr, size_t byte_budget, u64 ns_budget);
+void plmemSetMoveHook(MEM_MGR* memmgr, MEM_MOVE_HOOK hook);
 u32 plmemGetSpace(MEM_MGR* memmgr);
 size_t plmemGetFreeSpace(MEM_MGR* memmgr);
+void plmemGetStats(MEM_MGR* memmgr, MEM_MGR_STATS* stats);
 
 #endif
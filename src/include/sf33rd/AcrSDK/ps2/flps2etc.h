@@ -24,6 +24,7 @@ void* flAllocMemoryS(s32 size);
 u32 flPS2GetSystemMemoryHandle(s32 len, s32 type);
 void flPS2ReleaseSystemMemory(u32 handle);
 void* flPS2GetSystemBuffAdrs(u32 handle);
+void flPS2SystemMemoryMoved(u32 handle, u8* old_ptr, u8* new_ptr);
 void flPS2SystemTmpBuffInit();
 void flPS2SystemTmpBuffFlush();
 uintptr_t flPS2GetSystemTmpBuff(s32 len, s32 align);
@@ -27,7 +27,10 @@ s32 flPS2GetTextureInfoFromContext(plContext* bits, s32 bnum, u32 th, u32 flag);
 u32 flCreatePaletteHandle(plContext* lpcontext, u32 flag);
 s32 flReleasePaletteHandle(u32 palette_handle);
 u32 flCreateTextureHandle(s32 id, plContext* bits, u32 flag);
+u32 flCreateTextureHandleInPlace(plContext* bits, u32 flag, u8** pixels);
+s32 flPS2ConvertTextureRows(u32 th, plContext* bits, s32 y, s32 rows);
 s32 flReleaseTextureHandle(u32 texture_handle);
+void flPS2TextureMemoryMoved(u32 mem_handle);
 s32 flLockTexture(Rect* lprect, u32 th, plContext* lpcontext, u32 flag);
 s32 flUnlockTexture(u32 th);
 void flPS2VramInit();
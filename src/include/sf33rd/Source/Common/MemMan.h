@@ -15,6 +15,19 @@
 #include "structs.h"
 #include "types.h"
 
+/** @brief Occupancy and fragmentation snapshot of one heap. */
+typedef struct {
+    const s8* name;
+    ssize_t size;         // Usable bytes, sentinel cells excluded
+    ssize_t live;         // Bytes in allocated cells, headers included
+    ssize_t peak;         // Highest live since initialisation
+    ssize_t largest_free; // Biggest gap a single allocation could use, header included
+    s32 blocks;           // Allocated cells
+    s32 allocs;
+    s32 frees;
+    s32 failures;
+} MMHeapStats;
+
 void mmSystemInitialize();
 void mmHeapInitialize(_MEMMAN_OBJ* mmobj, u8* adrs, s32 size, s32 unit, s8* format);
 uintptr_t mmRoundUp(s32 unit, uintptr_t num);
@@ -25,5 +38,9 @@ ssize_t mmGetRemainderMin(_MEMMAN_OBJ* mmobj);
 u8* mmAlloc(_MEMMAN_OBJ* mmobj, ssize_t size, s32 flag);
 struct _MEMMAN_CELL* mmAllocSub(_MEMMAN_OBJ* mmobj, ssize_t size, s32 flag);
 void mmFree(_MEMMAN_OBJ* mmobj, u8* adrs);
+void mmSetGapIndexEnabled(s32 enable);
+void mmGetStats(_MEMMAN_OBJ* mmobj, MMHeapStats* stats);
+s32 mmGetHeapCount();
+_MEMMAN_OBJ* mmGetHeap(s32 index);
 
 #endif
@@ -0,0 +1,52 @@
+/**
+ * @file PPGChunkDir.h
+ * @brief Cached chunk directory for loaded PPG/PPL/PPX buffers.
+ *
+ * A packed-graphics file is a chain of chunks (pTEX, pPAL, pCMP, ...)
+ * closed by pEND, and finding the n-th chunk of a kind means walking the
+ * chain from the start. The first lookup in a buffer walks it once and
+ * records every chunk's offset, size and compression kind; later lookups
+ * in the same buffer are O(1).
+ *
+ * Directories are keyed by buffer address, so the owner must call
+ * ppgChunkDirForget() before the memory is reused (ramcnt does this when
+ * it frees a key).
+ *
+ * Part of the Common module.
+ */
+#ifndef PPGCHUNKDIR_H
+#define PPGCHUNKDIR_H
+
+#include "types.h"
+
+typedef enum {
+    PPG_CHUNK_CMP, // pCMP: compressed blob (e.g. ADX banks)
+    PPG_CHUNK_PAL, // pPAL: palette set
+    PPG_CHUNK_TEX, // pTEX: texture
+    PPG_CHUNK_KINDS
+} PPGChunkKind;
+
+/** @brief One chunk of a directory. */
+typedef struct {
+    u32 ofs;     // From the start of the buffer
+    u32 size;    // Including the 16-byte chunk header
+    u8 compress; // 0 = raw, 1 = LZ77, 2 = zlib
+} PPGChunkInfo;
+
+typedef struct {
+    s32 builds;  // Chain walks (directory misses)
+    s32 lookups; // ppgChunkDirFind()/ppgChunkDirCount() calls
+} PPGChunkDirStats;
+
+/** @brief The @p num-th chunk of @p kind in the buffer at @p adrs, or NULL if there are fewer. */
+const PPGChunkInfo* ppgChunkDirFind(const u8* adrs, PPGChunkKind kind, s32 num);
+
+/** @brief Number of chunks of @p kind in the buffer at @p adrs. */
+s32 ppgChunkDirCount(const u8* adrs, PPGChunkKind kind);
+
+/** @brief Drop the directory of the buffer at @p adrs (NULL drops all). */
+void ppgChunkDirForget(const u8* adrs);
+
+void ppgChunkDirGetStats(PPGChunkDirStats* stats);
+
+#endif
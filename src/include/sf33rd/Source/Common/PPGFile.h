@@ -17,6 +17,15 @@
 
 extern s16* dctex_linear;
 
+/** @brief One trans sub-rectangle of a PPG texture, in texture cells (flip 0). */
+typedef struct {
+    u32 texCode; // texhan | (palhan << 16)
+    u8 sx;
+    u8 sy;
+    u8 xs;
+    u8 ys;
+} PPGTransQuad;
+
 void ppg_Initialize(void* lcmAdrs, s32 lcmSize);
 void ppgSourceDataReleased(PPGDataList* dlist);
 void ppgSetupCurrentDataList(PPGDataList* dlist);
@@ -31,6 +40,9 @@ s32 ppgSetupTexChunk_1st_Accnum(Texture* tch, u16 accnum);
 s32 ppgSetupTexChunk_2nd(Texture* tch, s32 ixNum);
 s32 ppgSetupTexChunk_3rd(Texture* tch, s32 ixNum, u32 attribute);
 s32 ppgWriteQuadUseTrans(Vertex* pos, u32 col, PPGDataList* tb, s32 tix, s32 cix, s32 flip, s32 pal);
+s32 ppgBuildTransQuads(PPGDataList* tb, s32 tix, s32 cix, s32 pal, PPGTransQuad* out, s32 max, u8* cellsW,
+                       u8* cellsH);
+s32 ppgWriteTransQuads(Vertex* pos, u32 col, const PPGTransQuad* quads, s32 num, u8 cellsW, u8 cellsH);
 s32 ppgGetUsingTextureHandle(Texture* tch, s32 ixNums);
 s32 ppgGetUsingPaletteHandle(Palette* pch, s32 ixNums);
 s32 ppgCheckTextureNumber(Texture* tex, s32 num);
@@ -0,0 +1,40 @@
+/**
+ * @file PPGStream.h
+ * @brief Windowed decompression of PPG data straight into its final buffer.
+ *
+ * ppgDecompress() expands a whole chunk into a scratch buffer, which the
+ * caller then byte-swaps and converts in further passes over all of it.
+ * The stream decoder expands into the destination itself and hands each
+ * window of bytes that will no longer change to a sink, while the window
+ * is still in cache, so the sink can convert it in place.
+ *
+ * LZ77 copies may reach LZ77_MAX_DISTANCE bytes back into the output, so
+ * its windows trail the decoder by that much. inflate() keeps its own
+ * history, so zlib windows are handed over as soon as they are written.
+ *
+ * Part of the Common module.
+ */
+#ifndef PPGSTREAM_H
+#define PPGSTREAM_H
+
+#include "types.h"
+
+/** @brief Bytes per window handed to the sink (rounded down to a whole number of units). */
+#define PPG_STREAM_WINDOW 0x4000
+
+/** @brief Receives @p size bytes at @p adrs that have reached their final decompressed value. */
+typedef void (*PPGStreamSink)(u8* adrs, s32 size, void* user);
+
+/**
+ * @brief Decompress like ppgDecompress(), calling @p sink on each finished window.
+ *
+ * Windows arrive in order, cover the output exactly and are whole
+ * multiples of @p unit (a row pitch) except possibly the last. Returns
+ * what ppgDecompress() would: @p dstSize on success for LZ77 and zlib,
+ * @p srcSize for a raw copy. On failure the sink may have seen part of
+ * the output.
+ */
+ssize_t ppgStreamDecompress(s32 koCmpr, void* srcAdrs, s32 srcSize, void* dstAdrs, s32 dstSize, s32 unit,
+                            PPGStreamSink sink, void* user);
+
+#endif
@@ -14,6 +14,25 @@
 
 #include "types.h"
 
+/** @brief Farthest back a dictionary copy can reach; older output is never read again. */
+#define LZ77_MAX_DISTANCE 0x4000
+
+/** @brief Resumable decoder state for decLZ77Stream(). */
+typedef struct {
+    u8* src;  // Next compressed byte
+    u8* dst;  // Next output byte
+    s32 size; // Output still expected; negative if the last code overran
+} LZ77Stream;
+
 s32 decLZ77withSizeCheck(u8* src, u8* dst, s32 size);
 
+/**
+ * @brief Continue decoding @p st until its output reaches @p stop or all output is written.
+ *
+ * Codes are never split, so the output may run up to one code (at most
+ * 0x10000 bytes) past @p stop, and never past the expected size unless the
+ * data is corrupt.
+ */
+void decLZ77Stream(LZ77Stream* st, const u8* stop);
+
 #endif
@@ -16,5 +16,8 @@
 
 void zlib_Initialize(void* tempAdrs, s32 tempSize);
 ssize_t zlib_Decompress(void* srcBuff, s32 srcSize, void* dstBuff, s32 dstSize);
+s32 zlib_StreamBegin(void* srcBuff, s32 srcSize, void* dstBuff);
+ssize_t zlib_StreamRun(s32 size);
+ssize_t zlib_StreamEnd();
 
 #endif
@@ -947,6 +947,10 @@ typedef struct {
     u8* oriHead;
     s32 oriSize;
     s32 debIndex;
+    const s8* name; // Heap label passed to mmHeapInitialize()
+    s32 allocCount;
+    s32 freeCount;
+    s32 failCount; // mmAlloc() calls that found no gap
 } _MEMMAN_OBJ;
 
 typedef struct {
@@ -1279,6 +1283,7 @@ typedef struct {
         u32 number;
         u32 size;
     } info;
+    s32 handle; // AFS handle while the file is open (fs_sys)
 } REQ;
 
 struct _cursor_infor {
@@ -1337,6 +1342,7 @@ typedef struct {
     u8 group_num;
     u8 type;
     u8 use;
+    u8 borrowed; // adr is owned elsewhere (e.g. the AFS mapping) and is never freed
 } RCKeyWork;
 
 typedef struct {
@@ -20,7 +20,9 @@
 #include "port/sdl/app/sdl_app.h"
 #include "port/sdl/app/sdl_app_config.h"
 #include "port/sdl/netstats_renderer.h"
+#include "port/sdl/renderer/sdl_game_renderer.h"
 
+#include "sf33rd/AcrSDK/common/memfound.h"
 #include "sf33rd/AcrSDK/common/mlPAD.h"
 #include "sf33rd/AcrSDK/ps2/flps2debug.h"
 #include "sf33rd/AcrSDK/ps2/flps2etc.h"
@@ -42,6 +44,7 @@
 #include "sf33rd/Source/Game/rendering/color3rd.h"
 #include "sf33rd/Source/Game/rendering/mtrans.h"
 #include "sf33rd/Source/Game/rendering/texcash.h"
+#include "sf33rd/Source/Game/rendering/tile_decode.h"
 #include "sf33rd/Source/Game/sound/sound3rd.h"
 #include "sf33rd/Source/Game/stage/bg.h"
 #include "sf33rd/Source/Game/system/ramcnt.h"
@@ -61,8 +64,17 @@
 #endif
 
 #include "port/config/cli_parser.h"
+#include "port/config/config.h"
+#include "port/config/paths.h"
+#include "port/heap_report.h"
 #include "port/io/afs.h"
+#include "port/io/load_trace.h"
+#include "port/io/tile_cache.h"
+#include "port/load_bench.h"
 #include "port/rendering/resources.h"
+#include "port/sim_profile.h"
+#include "port/sound/audio_render.h"
+#include "port/sound/spu.h"
 
 #include <SDL3/SDL.h>
 
@@ -116,6 +128,10 @@ static int s_lag_test_initial_routine = 0;
 static int s_lag_test_initial_routine_1 = 0;
 static Uint64 s_lag_test_start_ticks = 0;
 
+// ⚡ Idle compaction of system memory: per loop iteration, at most this many bytes (config) or this long
+static size_t s_idle_compact_bytes = 0;
+#define IDLE_COMPACT_NS (500 * 1000)
+
 // forward decls
 static void game_init();
 static void game_step_0();
@@ -140,6 +156,10 @@ static void afs_init() {
     // Try the standard resources path first (e.g. AppData/Roaming/CrowdedStreet/3SX/resources/)
     char* file_path = Resources_GetPath("SF33RD.AFS");
 
+    AFS_SetMemoryMapped(Config_GetBool(CFG_KEY_AFS_MMAP));
+    AFS_SetPreloadThreads(Config_GetInt(CFG_KEY_AFS_PRELOAD_THREADS));
+    Set_LDREQ_Slots(Config_GetInt(CFG_KEY_LOAD_QUEUE_SLOTS));
+
     SDL_PathInfo info;
     if (SDL_GetPathInfo(file_path, &info) && info.type == SDL_PATHTYPE_FILE) {
         AFS_Init(file_path);
@@ -155,6 +175,31 @@ static void afs_init() {
     SDL_free(file_path);
 }
 
+/** @brief Open the persistent decoded-tile cache in the pref directory, if enabled. */
+static void tile_cache_init() {
+    char* path;
+
+    if (!Config_GetBool(CFG_KEY_TILE_CACHE)) {
+        return;
+    }
+
+    SDL_asprintf(&path, "%stilecache.bin", Paths_GetPrefPath());
+    TileCache_Init(path, AFS_GetArchiveHash());
+    SDL_free(path);
+}
+
+/**
+ * @brief Close holes in system memory a slice at a time, outside game logic and rendering.
+ *
+ * Texture churn leaves holes that plmemCompact() would otherwise close all at
+ * once when an allocation fails, in the middle of a frame.
+ */
+static void idle_compact() {
+    if (s_idle_compact_bytes > 0) {
+        mflCompactStep(s_idle_compact_bytes, IDLE_COMPACT_NS);
+    }
+}
+
 /**
  * @brief Pre-render frame step: process input, run game logic, flush rendering.
  *
@@ -214,15 +259,62 @@ int main(int argc, char* argv[]) {
 
     SDLApp_Init();
 
+    if (g_bench_sprite2_chips > 0) {
+        SDLGameRenderer_BenchmarkSprite2(g_bench_sprite2_chips);
+        SDLApp_Quit();
+        return 0;
+    }
+
 #ifndef _WIN32
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
 #endif
 
+    if (g_load_trace_path) {
+        LoadTrace_Start(0);
+    }
+
+    if (g_sim_profile_path) {
+        SimProfile_SetEnabled(true);
+    }
+
     afs_init();
+    tile_cache_init();
+
+    if (g_verify_assets) {
+        AFS_StartVerify();
+    }
+
+    // Must precede game_init(), which opens the sound devices
+    SPU_SetLowLatency(Config_GetBool(CFG_KEY_AUDIO_LOW_LATENCY));
+    if (g_render_audio_path && !AudioRender_Begin(g_render_audio_path)) {
+        SDL_Log("Can't render audio to %s, exiting", g_render_audio_path);
+        LoadTrace_Stop();
+        TileCache_Finish();
+        AFS_Finish();
+        SDLApp_Quit();
+        return 1;
+    }
+
     game_init();
 
+    if (g_bench_loads) {
+        const bool ok = LoadBench_Run();
+
+        if (g_load_trace_path) {
+            LoadTrace_WriteChrome(g_load_trace_path);
+        }
+
+        LoadTrace_Stop();
+        tileDecodeShutdown();
+        TileCache_Finish();
+        AFS_Finish();
+        SDLApp_Quit();
+        return ok ? 0 : 1;
+    }
+
     Menu_UpdateNetworkLabel();
+    s_idle_compact_bytes = (size_t)SDL_max(Config_GetInt(CFG_KEY_IDLE_COMPACT_KB), 0) * 1024;
 
     /* Timing state for decoupled rendering mode (F5 + VSync ON) */
     Uint64 last_tick_time = SDL_GetTicksNS();
@@ -272,6 +364,10 @@ int main(int argc, char* argv[]) {
                 is_running = false;
 #endif
             step_1();
+
+            // One game frame of audio per tick keeps the WAV sample-locked to game time
+            AudioRender_Frame();
+            idle_compact();
         } else {
             /* Re-present the existing canvas (no game logic, no FBO clear) */
             SDLApp_PresentOnly();
@@ -280,10 +376,28 @@ int main(int argc, char* argv[]) {
             if (g_signal_quit)
                 is_running = false;
 #endif
+            idle_compact();
         }
         TRACE_FRAME_MARK();
     }
 
+    if (g_heap_report_path) {
+        HeapReport_WriteJSON(g_heap_report_path);
+    }
+
+    if (g_load_trace_path) {
+        LoadTrace_WriteChrome(g_load_trace_path);
+    }
+
+    LoadTrace_Stop();
+
+    if (g_sim_profile_path) {
+        SimProfile_WriteCSV(g_sim_profile_path);
+    }
+
+    AudioRender_Finish();
+    tileDecodeShutdown();
+    TileCache_Finish();
     AFS_Finish();
     SDLApp_Quit();
     return 0;
@@ -680,6 +794,7 @@ static const struct {
 
 void cpLoopTask() {
     disp_ramcnt_free_area();
+    SimProfile_NoteFrame();
 
 #if DEBUG
     if (sysSLOW) {
@@ -696,11 +811,15 @@ void cpLoopTask() {
         struct _TASK* task_ptr = &task[i];
 
         switch (task_ptr->condition) {
-        case 1:
+        case 1: {
+            const uint64_t prof = SimProfile_Begin();
+
             TRACE_SUB_DYN_BEGIN(task_slot_names[i].name, task_slot_names[i].len);
             task_ptr->func_adrs(task_ptr);
             TRACE_SUB_END();
+            SimProfile_End(SIM_PROFILE_TASK, i, prof);
             break;
+        }
 
         case 2:
             task_ptr->condition = 1;
@@ -28,6 +28,27 @@ bool g_font_test_mode = false;
 // UI mode flag — session-only, not persisted to config
 bool g_ui_mode_rmlui = false;
 
+// Sprite2 benchmark — chip count for the SDL2D batching benchmark (0 = off)
+int g_bench_sprite2_chips = 0;
+
+// Offline audio render — WAV output path, driven by the game loop (NULL = off)
+const char* g_render_audio_path = NULL;
+
+// Heap report — JSON output path, written when the game exits (NULL = off)
+const char* g_heap_report_path = NULL;
+
+// Asset verification — hash every AFS entry in the background and check it against the index
+bool g_verify_assets = false;
+
+// Load benchmark — time every character and stage load set, then exit
+bool g_bench_loads = false;
+
+// Load trace — Chrome trace JSON output path, written when the game exits (NULL = off)
+const char* g_load_trace_path = NULL;
+
+// Simulation profile — per task, effect and script command CSV path, written when the game exits (NULL = off)
+const char* g_sim_profile_path = NULL;
+
 // These might need to be mocked in tests
 // void SDLApp_SetWindowPosition(int x, int y);
 // void SDLApp_SetWindowSize(int w, int h);
@@ -71,6 +92,13 @@ void ParseCLI(int argc, char* argv[]) {
             printf("  --shm-suffix <suffix>     Shared-memory name suffix for broadcast\n");
             printf("  --font-test               Boot into font debug visualization screen\n");
             printf("  --ui <rmlui>              UI toolkit for overlay menus (default: rmlui)\n");
+            printf("  --bench-sprite2 <chips>   Benchmark SDL2D Sprite2 batching and exit\n");
+            printf("  --render-audio <path>     Render audio offline to a WAV file (no audio device)\n");
+            printf("  --heap-report <path>      Write heap usage and fragmentation as JSON on exit\n");
+            printf("  --verify-assets           Check every AFS entry against its recorded digest\n");
+            printf("  --bench-loads             Time every character and stage load and exit\n");
+            printf("  --load-trace <path>       Write asset load timings as Chrome trace JSON on exit\n");
+            printf("  --sim-profile <path>      Write simulation CPU time per task, effect and command as CSV\n");
 #if DEBUG
             printf("  --test-enable             Enable test runner (DEBUG only)\n");
             printf("  --test-states <path>      Path to states directory (DEBUG only)\n");
@@ -125,6 +153,20 @@ void ParseCLI(int argc, char* argv[]) {
             const char* mode = argv[++i];
             g_ui_mode_rmlui = (strcmp(mode, "rmlui") == 0);
             printf("[CLI] UI mode: %s\n", mode);
+        } else if (strcmp(argv[i], "--bench-sprite2") == 0 && i + 1 < argc) {
+            g_bench_sprite2_chips = SDL_atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--render-audio") == 0 && i + 1 < argc) {
+            g_render_audio_path = argv[++i];
+        } else if (strcmp(argv[i], "--heap-report") == 0 && i + 1 < argc) {
+            g_heap_report_path = argv[++i];
+        } else if (strcmp(argv[i], "--verify-assets") == 0) {
+            g_verify_assets = true;
+        } else if (strcmp(argv[i], "--bench-loads") == 0) {
+            g_bench_loads = true;
+        } else if (strcmp(argv[i], "--load-trace") == 0 && i + 1 < argc) {
+            g_load_trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--sim-profile") == 0 && i + 1 < argc) {
+            g_sim_profile_path = argv[++i];
 #if DEBUG
         } else if (strcmp(argv[i], "--test-enable") == 0) {
             configuration.test.enabled = true;
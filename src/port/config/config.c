@@ -66,6 +66,13 @@ static const ConfigEntry default_entries[] = {
     { .key = CFG_KEY_NETPLAY_FT, .type = CFG_INT, .value.i = 2 },
     { .key = CFG_KEY_MODDED_BGM_ENABLED, .type = CFG_BOOL, .value.b = false },
     { .key = CFG_KEY_MODDED_VOICE_ENABLED, .type = CFG_BOOL, .value.b = false },
+    { .key = CFG_KEY_MODDED_BGM_CACHE_MB, .type = CFG_INT, .value.i = 256 },
+    { .key = CFG_KEY_TILE_CACHE, .type = CFG_BOOL, .value.b = false },
+    { .key = CFG_KEY_AFS_MMAP, .type = CFG_BOOL, .value.b = true },
+    { .key = CFG_KEY_AFS_PRELOAD_THREADS, .type = CFG_INT, .value.i = 0 },
+    { .key = CFG_KEY_AUDIO_LOW_LATENCY, .type = CFG_BOOL, .value.b = false },
+    { .key = CFG_KEY_IDLE_COMPACT_KB, .type = CFG_INT, .value.i = 256 },
+    { .key = CFG_KEY_LOAD_QUEUE_SLOTS, .type = CFG_INT, .value.i = 4 },
 };
 
 static ConfigEntry entries[CONFIG_ENTRIES_MAX] = { 0 };
@@ -68,6 +68,13 @@ extern "C" {
 #define CFG_KEY_HD_STAGES "hd-stages"
 #define CFG_KEY_MODDED_BGM_ENABLED "modded-bgm-enabled"
 #define CFG_KEY_MODDED_VOICE_ENABLED "modded-voice-enabled"
+#define CFG_KEY_MODDED_BGM_CACHE_MB "modded-bgm-cache-mb"
+#define CFG_KEY_TILE_CACHE "tile-cache"
+#define CFG_KEY_AFS_MMAP "afs-mmap"
+#define CFG_KEY_AFS_PRELOAD_THREADS "afs-preload-threads"
+#define CFG_KEY_AUDIO_LOW_LATENCY "audio-low-latency"
+#define CFG_KEY_IDLE_COMPACT_KB "idle-compact-kb"
+#define CFG_KEY_LOAD_QUEUE_SLOTS "load-queue-slots"
 
 /// Initialize config system
 void Config_Init(void);
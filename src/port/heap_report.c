@@ -0,0 +1,208 @@
+/**
+ * @file heap_report.c
+ * @brief Occupancy and fragmentation report for the fixed game heaps.
+ *
+ * Fragmentation is 1 - largest free block / total free: 0 when all free
+ * space is one block, approaching 1 when it is scattered in small holes.
+ */
+#include "port/heap_report.h"
+#include "sf33rd/AcrSDK/common/memfound.h"
+#include "sf33rd/Source/Common/MemMan.h"
+#include "sf33rd/Source/Game/system/ramcnt.h"
+
+#include <SDL3/SDL.h>
+
+static double fragmentation(size_t largest_free, size_t free) {
+    if (free == 0) {
+        return 0.0;
+    }
+
+    return 1.0 - (double)largest_free / (double)free;
+}
+
+/** @brief Heap label without the "- for ... -" decoration mmHeapInitialize() callers use. */
+static void short_name(const s8* name, char* buf, size_t size) {
+    const char* p = (name != NULL) ? (const char*)name : "heap";
+    size_t len;
+
+    if (SDL_strncmp(p, "- for ", 6) == 0) {
+        p += 6;
+    }
+
+    SDL_strlcpy(buf, p, size);
+    len = SDL_strlen(buf);
+
+    while ((len > 0) && ((buf[len - 1] == '-') || (buf[len - 1] == ' '))) {
+        buf[--len] = '\0';
+    }
+}
+
+static void write_memman(SDL_IOStream* io) {
+    SDL_IOprintf(io, "  \"memman\": [");
+
+    for (s32 i = 0; i < mmGetHeapCount(); i++) {
+        MMHeapStats stats;
+        char name[32];
+
+        mmGetStats(mmGetHeap(i), &stats);
+        short_name(stats.name, name, sizeof(name));
+        SDL_IOprintf(io,
+                     "%s\n    {\"name\": \"%s\", \"size\": %zd, \"live\": %zd, \"peak\": %zd, \"free\": %zd, "
+                     "\"largest_free\": %zd, \"fragmentation\": %.4f, \"blocks\": %d, \"allocs\": %d, "
+                     "\"frees\": %d, \"failures\": %d}",
+                     (i > 0) ? "," : "",
+                     name,
+                     stats.size,
+                     stats.live,
+                     stats.peak,
+                     stats.size - stats.live,
+                     stats.largest_free,
+                     fragmentation(stats.largest_free, stats.size - stats.live),
+                     stats.blocks,
+                     stats.allocs,
+                     stats.frees,
+                     stats.failures);
+    }
+
+    SDL_IOprintf(io, "\n  ],\n");
+}
+
+static void write_ramcnt(SDL_IOStream* io) {
+    bool first = true;
+
+    SDL_IOprintf(io,
+                 "  \"ramcnt\": {\n    \"keys_max\": %d, \"keys_free\": %d, \"keys_free_min\": %d,\n    \"kinds\": [",
+                 RCKEY_WORK_MAX - 1,
+                 rckeyctr,
+                 rckeymin);
+
+    for (s32 kokey = 0; kokey < 256; kokey++) {
+        RamcntKindStats stats;
+
+        Get_ramcnt_kind_stats((u8)kokey, &stats);
+
+        if ((stats.pulls == 0) && (stats.keys == 0)) {
+            continue;
+        }
+
+        SDL_IOprintf(io,
+                     "%s\n      {\"kokey\": %d, \"keys\": %d, \"bytes\": %zu, \"borrowed_bytes\": %zu, "
+                     "\"peak_bytes\": %zu, \"pulls\": %d, \"failures\": %d}",
+                     first ? "" : ",",
+                     kokey,
+                     stats.keys,
+                     stats.bytes,
+                     stats.borrowed_bytes,
+                     stats.peak_bytes,
+                     stats.pulls,
+                     stats.failures);
+        first = false;
+    }
+
+    SDL_IOprintf(io, "\n    ],\n    \"live\": [");
+    first = true;
+
+    for (s32 key = 1; key < RCKEY_WORK_MAX; key++) {
+        const RCKeyWork* rwk = &rckey_work[key];
+
+        if (!rwk->use) {
+            continue;
+        }
+
+        SDL_IOprintf(io,
+                     "%s\n      {\"key\": %d, \"kokey\": %d, \"group\": %d, \"size\": %zu, \"borrowed\": %s}",
+                     first ? "" : ",",
+                     key,
+                     rwk->type,
+                     rwk->group_num,
+                     rwk->size,
+                     rwk->borrowed ? "true" : "false");
+        first = false;
+    }
+
+    SDL_IOprintf(io, "\n    ]\n  },\n");
+}
+
+static void write_memmgr(SDL_IOStream* io) {
+    MEM_MGR_STATS stats;
+    const size_t free = (size_t)(mflGetSpace());
+
+    mflGetStats(&stats);
+    SDL_IOprintf(io,
+                 "  \"memmgr\": {\"size\": %d, \"used\": %d, \"peak\": %d, \"free\": %zu, \"largest_free\": %zu, "
+                 "\"fragmentation\": %.4f, \"blocks\": %d, \"registers\": %u, \"releases\": %u, \"failures\": %u, "
+                 "\"compactions\": %u, \"compact_steps\": %u, \"compact_moves\": %u, \"compact_bytes\": %llu, "
+                 "\"compact_ms\": %.3f, \"compact_max_ms\": %.3f}\n",
+                 stats.size,
+                 stats.used,
+                 stats.peak_used,
+                 free,
+                 stats.largest_free,
+                 fragmentation(stats.largest_free, free),
+                 stats.blocks,
+                 stats.registers,
+                 stats.releases,
+                 stats.failures,
+                 stats.compactions,
+                 stats.compact_steps,
+                 stats.compact_moves,
+                 (unsigned long long)stats.compact_bytes,
+                 stats.compact_ns / 1e6,
+                 stats.compact_max_ns / 1e6);
+}
+
+bool HeapReport_WriteJSON(const char* path) {
+    SDL_IOStream* io = SDL_IOFromFile(path, "w");
+
+    if (io == NULL) {
+        SDL_Log("Heap report: can't open %s: %s", path, SDL_GetError());
+        return false;
+    }
+
+    SDL_IOprintf(io, "{\n");
+    write_memman(io);
+    write_ramcnt(io);
+    write_memmgr(io);
+    SDL_IOprintf(io, "}\n");
+
+    if (!SDL_CloseIO(io)) {
+        SDL_Log("Heap report: failed writing %s: %s", path, SDL_GetError());
+        return false;
+    }
+
+    SDL_Log("Heap report written to %s", path);
+    return true;
+}
+
+void HeapReport_FormatOverlay(char* buf, size_t size) {
+    MEM_MGR_STATS sys;
+    size_t len = 0;
+
+    buf[0] = '\0';
+
+    for (s32 i = 0; i < mmGetHeapCount() && len < size; i++) {
+        MMHeapStats stats;
+        char name[32];
+
+        mmGetStats(mmGetHeap(i), &stats);
+        short_name(stats.name, name, sizeof(name));
+        len += SDL_snprintf(buf + len,
+                            size - len,
+                            "%s%s %.1f/%.1fM frag %d%%",
+                            (i > 0) ? " | " : "Heaps: ",
+                            name,
+                            stats.live / (1024.0 * 1024.0),
+                            stats.size / (1024.0 * 1024.0),
+                            (int)(fragmentation(stats.largest_free, stats.size - stats.live) * 100.0 + 0.5));
+    }
+
+    if (len < size) {
+        mflGetStats(&sys);
+        SDL_snprintf(buf + len,
+                     size - len,
+                     " | sys %.1fM free, %u compactions %.1f ms",
+                     mflGetSpace() / (1024.0 * 1024.0),
+                     sys.compactions,
+                     sys.compact_ns / 1e6);
+    }
+}
@@ -5,12 +5,41 @@
  * Parses AFS archive headers, preloads non-BGM entries into RAM for
  * zero-copy reads, and streams BGM files asynchronously via SDL3
  * async I/O with a persistent file handle.
+ *
+ * ⚡ In mapped mode (the default, see AFS_SetMemoryMapped) the whole
+ * archive is mapped read-only and non-BGM entries point straight into
+ * the mapping instead of being copied to the heap: the page cache is
+ * the only resident copy, and AFS_GetEntryPointer() lets loaders use an
+ * entry in place. If the archive can't be mapped, the preload thread
+ * fills the heap as before.
+ *
+ * ⚡ Whatever isn't mapped is preloaded by a small pool of reader threads
+ * pulling from a priority queue: entries the game is about to need
+ * (AFS_Hint) or has just missed on (AFS_Read) jump ahead of the
+ * background walk in index order.
+ *
+ * ⚡ The table of contents is cached in a sidecar index next to the
+ * archive (see afs_index.h) and loaded in one read while the archive's
+ * size and mtime are unchanged. AFS_StartVerify() hashes every entry on
+ * background threads and checks the digests the index recorded.
  */
 #include "port/io/afs.h"
 #include "common.h"
+#include "port/io/afs_index.h"
+#include "port/io/load_trace.h"
 #include <SDL3/SDL.h>
 #include <stdio.h>
 
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 // Inspired by https://github.com/MaikelChan/AFSLib
 
 #define AFS_MAGIC 0x41465300
@@ -23,6 +52,14 @@
 #define AFS_BGM_END_INDEX 1362
 
 #define AFS_MAX_READ_REQUESTS 100
+#define AFS_PRELOAD_MAX_THREADS 4
+
+// Preload queue priorities, highest first; equal priorities are served in push order
+#define AFS_PRELOAD_PRIORITY_BACKGROUND 0
+#define AFS_PRELOAD_PRIORITY_HINT 1
+#define AFS_PRELOAD_PRIORITY_DEMAND 2
+
+#define AFS_VERIFY_CHUNK (1 << 20)
 
 // Uncomment this to enable debug prints
 // #define AFS_DEBUG
@@ -31,13 +68,27 @@ typedef struct AFSEntry {
     unsigned int offset;
     unsigned int size;
     char name[AFS_MAX_NAME_LENGTH];
-    void* data; // Non-NULL if preloaded into RAM
+    void* data;          // Non-NULL if preloaded into RAM
+    bool mapped;         // data points into the archive mapping (not owned)
+    SDL_AtomicInt taken; // Claimed by a preload reader (or never to be preloaded)
+    int priority;        // Highest priority queued so far (guarded by preload.lock)
 } AFSEntry;
 
 typedef struct AFS {
     char* file_path;
     unsigned int entry_count;
     AFSEntry* entries;
+    Uint64 toc_hash;
+    const Uint8* map;      // Whole archive, read-only; NULL when not mapped
+    size_t map_size;
+    Uint64 archive_size;
+    SDL_Time archive_mtime;
+    bool has_info;         // archive_size/archive_mtime are known, so the index can be used
+    Uint64* digests;       // Per entry, from the index or the first verification pass
+    bool* has_digest;      // Per entry, digests[i] is a reference for the entry's bytes
+    bool has_digests;      // A pass recorded digests, for this archive or the one it replaced
+    Uint64 content_digest; // Digest over all entry digests
+    SDL_AtomicInt content_ready;
 } AFS;
 
 typedef struct ReadRequest {
@@ -46,9 +97,53 @@ typedef struct ReadRequest {
     int file_num;
     int sector;
     AFSReadState state;
+    Uint64 issued_ns; // When the read in flight was issued, for the load trace
 } ReadRequest;
 
+typedef struct PreloadJob {
+    int file_num;
+    int priority;
+    Uint32 seq;
+} PreloadJob;
+
+typedef struct Preload {
+    SDL_Mutex* lock;
+    PreloadJob* heap; // Binary max-heap on (priority, -seq); bumped entries may appear twice
+    int count;
+    int capacity;
+    Uint32 seq;
+    SDL_Thread* threads[AFS_PRELOAD_MAX_THREADS];
+    int thread_count;
+    SDL_AtomicInt shutdown;
+    SDL_AtomicInt running;
+    Uint64 start_ticks;
+    SDL_AtomicInt total;
+    SDL_AtomicInt loaded;
+    SDL_AtomicInt hits;
+    SDL_AtomicInt misses;
+    SDL_AtomicInt bumps;
+} Preload;
+
+typedef struct Verify {
+    SDL_Thread* threads[AFS_PRELOAD_MAX_THREADS];
+    int thread_count;
+    Uint64* digests; // Computed by this pass
+    bool* failed;    // Per entry, the entry couldn't be read
+    SDL_AtomicInt next;
+    SDL_AtomicInt checked;
+    SDL_AtomicInt running;
+    SDL_AtomicInt shutdown;
+    SDL_AtomicInt done;
+    Uint64 start_ticks;
+    int bad;
+    int first_bad;
+} Verify;
+
 static AFS afs = { 0 };
+static bool map_enabled = true;
+static int preload_threads_wanted = 0;
+static Preload preload = { 0 };
+static Verify verify = { 0 };
 static SDL_AsyncIOQueue* asyncio_queue = NULL;
 static ReadRequest requests[AFS_MAX_READ_REQUESTS] = { { 0 } };
 
@@ -92,8 +187,211 @@ static void read_string(SDL_IOStream* src, char* dst) {
     } while (c != '\0');
 }
 
+/** @brief FNV-1a over the entry table, so derived caches notice a replaced or modded archive. */
+static Uint64 hash_toc() {
+    Uint64 h = 0xCBF29CE484222325ull;
+
+    for (int i = 0; i < afs.entry_count; i++) {
+        const AFSEntry* entry = &afs.entries[i];
+        const Uint32 fields[2] = { entry->offset, entry->size };
+        const Uint8* p = (const Uint8*)fields;
+
+        for (int j = 0; j < sizeof(fields); j++) {
+            h = (h ^ p[j]) * 0x100000001B3ull;
+        }
+
+        for (const char* c = entry->name; *c != '\0'; c++) {
+            h = (h ^ (Uint8)*c) * 0x100000001B3ull;
+        }
+    }
+
+    return h;
+}
+
+// Sidecar index
+
+static char* index_path() {
+    char* path;
+
+    return (SDL_asprintf(&path, "%s.idx", afs.file_path) < 0) ? NULL : path;
+}
+
+/** @brief Digest over every entry digest, published for AFS_GetContentDigest() once every entry has one. */
+static void publish_content_digest() {
+    AFSDigestState state;
+
+    for (int i = 0; i < afs.entry_count; i++) {
+        if (!afs.has_digest[i]) {
+            return;
+        }
+    }
+
+    AFSDigest_Reset(&state, 0);
+
+    for (int i = 0; i < afs.entry_count; i++) {
+        const Uint64 digest = SDL_Swap64LE(afs.digests[i]);
+
+        AFSDigest_Update(&state, &digest, sizeof(digest));
+    }
+
+    afs.content_digest = AFSDigest_Final(&state);
+    SDL_MemoryBarrierRelease();
+    SDL_SetAtomicInt(&afs.content_ready, 1);
+}
+
+/** @brief Take the table of contents from the index; false if there is no current one. */
+static bool load_index() {
+    AFSIndex index;
+    char* path = index_path();
+    const bool loaded = (path != NULL) && AFSIndex_Load(path, afs.archive_size, afs.archive_mtime, &index);
+
+    SDL_free(path);
+
+    if (!loaded) {
+        return false;
+    }
+
+    afs.entry_count = index.entry_count;
+    afs.entries = SDL_calloc(SDL_max(index.entry_count, 1), sizeof(AFSEntry));
+    afs.digests = SDL_calloc(SDL_max(index.entry_count, 1), sizeof(Uint64));
+    afs.has_digest = SDL_calloc(SDL_max(index.entry_count, 1), sizeof(bool));
+
+    if ((afs.entries == NULL) || (afs.digests == NULL) || (afs.has_digest == NULL)) {
+        AFSIndex_Free(&index);
+        return false;
+    }
+
+    for (int i = 0; i < afs.entry_count; i++) {
+        const AFSIndexEntry* src = &index.entries[i];
+        AFSEntry* entry = &afs.entries[i];
+
+        entry->offset = src->offset;
+        entry->size = src->size;
+        SDL_memcpy(entry->name, src->name, sizeof(entry->name));
+        afs.digests[i] = src->digest;
+        afs.has_digest[i] = src->has_digest;
+    }
+
+    afs.has_digests = index.has_digests;
+    AFSIndex_Free(&index);
+    return true;
+}
+
+static void save_index() {
+    AFSIndex index;
+    char* path = index_path();
+
+    if (path == NULL) {
+        return;
+    }
+
+    SDL_zero(index);
+    index.archive_size = afs.archive_size;
+    index.archive_mtime = afs.archive_mtime;
+    index.entry_count = afs.entry_count;
+    index.has_digests = afs.has_digests;
+    index.entries = SDL_calloc(SDL_max(afs.entry_count, 1), sizeof(AFSIndexEntry));
+
+    if (index.entries != NULL) {
+        for (int i = 0; i < afs.entry_count; i++) {
+            AFSIndexEntry* dst = &index.entries[i];
+            const AFSEntry* entry = &afs.entries[i];
+
+            dst->offset = entry->offset;
+            dst->size = entry->size;
+            SDL_memcpy(dst->name, entry->name, sizeof(dst->name));
+            dst->digest = afs.digests[i];
+            dst->has_digest = afs.has_digest[i];
+        }
+
+        if (!AFSIndex_Save(path, &index)) {
+            SDL_Log("AFS: can't write index %s: %s", path, SDL_GetError());
+        }
+    }
+
+    SDL_free(index.entries);
+    SDL_free(path);
+}
+
+static int compare_index_entries(const void* a, const void* b) {
+    const AFSIndexEntry* x = (const AFSIndexEntry*)a;
+    const AFSIndexEntry* y = (const AFSIndexEntry*)b;
+
+    if (x->offset != y->offset) {
+        return (x->offset < y->offset) ? -1 : 1;
+    }
+
+    return (x->size < y->size) ? -1 : (x->size > y->size);
+}
+
+/**
+ * @brief Keep the digests an index for an earlier copy of the archive recorded.
+ *
+ * Replacing or damaging the archive changes its mtime, so that index no
+ * longer loads. Entries still at the same offset with the same size keep
+ * their digest, so the next pass checks the new bytes against it; the rest
+ * are left without a reference and reported rather than trusted.
+ */
+static void carry_over_digests() {
+    AFSIndex old;
+    char* path = index_path();
+    const bool loaded = (path != NULL) && AFSIndex_LoadAny(path, &old);
+    int kept = 0;
+
+    SDL_free(path);
+
+    if (!loaded) {
+        return;
+    }
+
+    if (old.has_digests) {
+        SDL_qsort(old.entries, old.entry_count, sizeof(AFSIndexEntry), compare_index_entries);
+
+        for (int i = 0; i < afs.entry_count; i++) {
+            AFSIndexEntry key;
+            const AFSIndexEntry* found;
+
+            key.offset = afs.entries[i].offset;
+            key.size = afs.entries[i].size;
+            found = SDL_bsearch(&key, old.entries, old.entry_count, sizeof(AFSIndexEntry), compare_index_entries);
+
+            if ((found != NULL) && found->has_digest) {
+                afs.digests[i] = found->digest;
+                afs.has_digest[i] = true;
+                kept += 1;
+            }
+        }
+
+        afs.has_digests = true;
+        SDL_Log("AFS: archive changed since its digests were recorded, %d of %u entries keep theirs",
+                kept,
+                afs.entry_count);
+    }
+
+    AFSIndex_Free(&old);
+}
+
 static bool init_afs(const char* file_path) {
+    SDL_PathInfo info;
+
     afs.file_path = SDL_strdup(file_path);
+
+    if (SDL_GetPathInfo(file_path, &info)) {
+        afs.archive_size = info.size;
+        afs.archive_mtime = info.modify_time;
+        afs.has_info = true;
+    }
+
+    if (afs.has_info && load_index()) {
+        afs.toc_hash = hash_toc();
+
+        if (afs.has_digests) {
+            publish_content_digest();
+        }
+
+        return true;
+    }
+
     SDL_IOStream* io = SDL_IOFromFile(file_path, "rb");
 
     if (io == NULL) {
@@ -167,57 +465,524 @@ static bool init_afs(const char* file_path) {
         }
     }
 
+    afs.toc_hash = hash_toc();
     SDL_CloseIO(io);
+
+    // No digests yet, unless an index for an earlier copy had some: the first verification pass records them
+    afs.digests = SDL_calloc(SDL_max(afs.entry_count, 1), sizeof(Uint64));
+    afs.has_digest = SDL_calloc(SDL_max(afs.entry_count, 1), sizeof(bool));
+
+    if ((afs.digests == NULL) || (afs.has_digest == NULL)) {
+        return false;
+    }
+
+    carry_over_digests();
+
+    if (afs.has_info) {
+        save_index();
+    }
+
+    if (afs.has_digests) {
+        publish_content_digest();
+    }
+
     return true;
 }
 
-static SDL_AtomicInt preload_shutdown_flag;
-static SDL_Thread* preload_thread = NULL;
+// Memory mapping
+
+static bool map_archive(const char* path) {
+#if defined(_WIN32)
+    int wlen = MultiByteToWideChar(CP_UTF8, 0, path, -1, NULL, 0);
+    WCHAR* wpath = SDL_malloc(wlen * sizeof(WCHAR));
+    HANDLE file;
+    HANDLE mapping;
+    LARGE_INTEGER size;
+    void* view;
+
+    if (wpath == NULL) {
+        return false;
+    }
+
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, wpath, wlen);
+    file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    SDL_free(wpath);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    if (!GetFileSizeEx(file, &size) || (size.QuadPart == 0) || ((Uint64)size.QuadPart > SIZE_MAX)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+
+    if (mapping == NULL) {
+        return false;
+    }
+
+    view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (view == NULL) {
+        return false;
+    }
+
+    afs.map = (const Uint8*)view;
+    afs.map_size = (size_t)size.QuadPart;
+    return true;
+#else
+    struct stat st;
+    void* view;
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    if ((fstat(fd, &st) != 0) || (st.st_size == 0)) {
+        close(fd);
+        return false;
+    }
+
+    view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (view == MAP_FAILED) {
+        return false;
+    }
+
+    afs.map = (const Uint8*)view;
+    afs.map_size = (size_t)st.st_size;
+    return true;
+#endif
+}
+
+static void unmap_archive() {
+    if (afs.map == NULL) {
+        return;
+    }
+
+#if defined(_WIN32)
+    UnmapViewOfFile((void*)afs.map);
+#else
+    munmap((void*)afs.map, afs.map_size);
+#endif
+
+    afs.map = NULL;
+    afs.map_size = 0;
+}
+
+/** @brief Point every preloadable entry into the mapping; the rest is left to the preload readers. */
+static void attach_mapped_entries() {
+    for (int i = 0; i < afs.entry_count; i++) {
+        AFSEntry* entry = &afs.entries[i];
+
+        if ((i >= AFS_BGM_START_INDEX && i <= AFS_BGM_END_INDEX) || (entry->offset == 0) || (entry->size == 0)) {
+            continue;
+        }
+
+        // Reads are whole sectors: the padding after the entry must be inside the file too
+        const Uint64 end = (Uint64)entry->offset + ((entry->size + 2048 - 1) & ~(2048 - 1));
+
+        if (end > afs.map_size) {
+            continue;
+        }
+
+        entry->data = (void*)(afs.map + entry->offset);
+        entry->mapped = true;
+    }
+}
+
+// Preloading
+
+static bool is_preloadable(int file_num) {
+    const AFSEntry* entry = &afs.entries[file_num];
+
+    return !(file_num >= AFS_BGM_START_INDEX && file_num <= AFS_BGM_END_INDEX) && (entry->offset != 0) &&
+           (entry->size > 0);
+}
+
+static bool job_before(const PreloadJob* a, const PreloadJob* b) {
+    return (a->priority != b->priority) ? (a->priority > b->priority) : ((Sint32)(a->seq - b->seq) < 0);
+}
+
+/** @brief Queue @p file_num at @p priority. Caller holds preload.lock. */
+static void heap_push(int file_num, int priority) {
+    if (preload.count == preload.capacity) {
+        const int capacity = preload.capacity ? preload.capacity * 2 : 256;
+        PreloadJob* heap = SDL_realloc(preload.heap, capacity * sizeof(PreloadJob));
+
+        if (heap == NULL) {
+            return;
+        }
+
+        preload.heap = heap;
+        preload.capacity = capacity;
+    }
+
+    int i = preload.count++;
+    const PreloadJob job = { file_num, priority, preload.seq++ };
+
+    while (i > 0) {
+        const int parent = (i - 1) / 2;
+
+        if (!job_before(&job, &preload.heap[parent])) {
+            break;
+        }
+
+        preload.heap[i] = preload.heap[parent];
+        i = parent;
+    }
+
+    preload.heap[i] = job;
+    afs.entries[file_num].priority = priority;
+}
+
+/** @brief Remove the most urgent job. Caller holds preload.lock and checked count > 0. */
+static PreloadJob heap_pop() {
+    const PreloadJob top = preload.heap[0];
+    const PreloadJob last = preload.heap[--preload.count];
+    int i = 0;
+
+    for (;;) {
+        int child = i * 2 + 1;
+
+        if (child >= preload.count) {
+            break;
+        }
+
+        if ((child + 1 < preload.count) && job_before(&preload.heap[child + 1], &preload.heap[child])) {
+            child += 1;
+        }
+
+        if (!job_before(&preload.heap[child], &last)) {
+            break;
+        }
+
+        preload.heap[i] = preload.heap[child];
+        i = child;
+    }
+
+    if (preload.count > 0) {
+        preload.heap[i] = last;
+    }
+
+    return top;
+}
+
+/** @brief Move an entry that isn't resident yet ahead of the background walk. */
+static void bump_entry(int file_num, int priority) {
+    if ((preload.lock == NULL) || (file_num < 0) || (file_num >= afs.entry_count)) {
+        return;
+    }
+
+    AFSEntry* entry = &afs.entries[file_num];
+
+    if (SDL_GetAtomicInt(&entry->taken)) {
+        return;
+    }
+
+    SDL_LockMutex(preload.lock);
+
+    // The stale lower-priority copy stays in the heap; whoever pops it second finds the entry taken
+    if (!SDL_GetAtomicInt(&entry->taken) && (priority > entry->priority)) {
+        heap_push(file_num, priority);
+        SDL_AddAtomicInt(&preload.bumps, 1);
+    }
+
+    SDL_UnlockMutex(preload.lock);
+}
 
 static int preload_thread_func(void* ptr) {
-    char* file_path = (char*)ptr;
-    SDL_IOStream* io = SDL_IOFromFile(file_path, "rb");
+    (void)ptr;
+    SDL_IOStream* io = SDL_IOFromFile(afs.file_path, "rb");
 
     if (io == NULL) {
-        SDL_free(file_path);
+        SDL_AddAtomicInt(&preload.running, -1);
         return 0;
     }
 
-    // Preload non-BGM files into RAM for zero-copy reads.
+    // Non-BGM files are preloaded into RAM for zero-copy reads.
     // BGM files (indices 91-1362) are large and streamed via async I/O.
-    for (int i = 0; i < afs.entry_count; i++) {
-        if (SDL_GetAtomicInt(&preload_shutdown_flag)) {
+    for (;;) {
+        PreloadJob job;
+
+        SDL_LockMutex(preload.lock);
+
+        // Every preloadable entry is queued at init, so an empty heap means everything was claimed
+        if ((preload.count == 0) || SDL_GetAtomicInt(&preload.shutdown)) {
+            SDL_UnlockMutex(preload.lock);
             break;
         }
 
-        if (i >= AFS_BGM_START_INDEX && i <= AFS_BGM_END_INDEX) {
+        job = heap_pop();
+        SDL_UnlockMutex(preload.lock);
+
+        AFSEntry* entry = &afs.entries[job.file_num];
+
+        if (SDL_SetAtomicInt(&entry->taken, 1) != 0) {
             continue;
         }
 
+        const unsigned int sector_aligned_size = (entry->size + 2048 - 1) & ~(2048 - 1);
+        void* preloaded_data = SDL_malloc(sector_aligned_size);
+
+        if (preloaded_data) {
+            SDL_SeekIO(io, entry->offset, SDL_IO_SEEK_SET);
+            SDL_ReadIO(io, preloaded_data, sector_aligned_size);
+
+            // Ensure all data writes are visible before publishing the pointer.
+            // Without this barrier, ARM cores could see the pointer but read
+            // partially-written data behind it.
+            SDL_MemoryBarrierRelease();
+            SDL_SetAtomicPointer(&entry->data, preloaded_data);
+            SDL_AddAtomicInt(&preload.loaded, 1);
+        }
+    }
+
+    SDL_CloseIO(io);
+
+    if ((SDL_AddAtomicInt(&preload.running, -1) == 1) && !SDL_GetAtomicInt(&preload.shutdown)) {
+        SDL_Log("AFS: preloaded %d/%d entries in %llu ms (%d threads, %d bumped, %d misses)",
+                SDL_GetAtomicInt(&preload.loaded),
+                SDL_GetAtomicInt(&preload.total),
+                (unsigned long long)(SDL_GetTicks() - preload.start_ticks),
+                preload.thread_count,
+                SDL_GetAtomicInt(&preload.bumps),
+                SDL_GetAtomicInt(&preload.misses));
+    }
+
+    return 0;
+}
+
+/** @brief Reader threads for background jobs: the configured count, or one picked from the CPU count. */
+static int reader_thread_count() {
+    if (preload_threads_wanted > 0) {
+        return SDL_min(preload_threads_wanted, AFS_PRELOAD_MAX_THREADS);
+    }
+
+    // Enough readers to keep an SSD or SD card busy without thrashing a spinning disk
+    return SDL_clamp(SDL_GetNumLogicalCPUCores() / 2, 1, AFS_PRELOAD_MAX_THREADS);
+}
+
+/** @brief Queue every entry that isn't resident yet and start the reader pool. */
+static void start_preload() {
+    int queued = 0;
+    int thread_count;
+
+    preload.lock = SDL_CreateMutex();
+    SDL_SetAtomicInt(&preload.shutdown, 0);
+    preload.start_ticks = SDL_GetTicks();
+
+    SDL_LockMutex(preload.lock);
+
+    for (int i = 0; i < afs.entry_count; i++) {
         AFSEntry* entry = &afs.entries[i];
 
-        if ((entry->offset != 0) && (entry->size > 0)) {
-            const unsigned int sector_aligned_size = (entry->size + 2048 - 1) & ~(2048 - 1);
-            void* preloaded_data = SDL_malloc(sector_aligned_size);
+        if (!is_preloadable(i)) {
+            SDL_SetAtomicInt(&entry->taken, 1);
+            continue;
+        }
+
+        SDL_AddAtomicInt(&preload.total, 1);
 
-            if (preloaded_data) {
-                SDL_SeekIO(io, entry->offset, SDL_IO_SEEK_SET);
-                SDL_ReadIO(io, preloaded_data, sector_aligned_size);
+        if (entry->mapped) {
+            SDL_SetAtomicInt(&entry->taken, 1);
+            SDL_AddAtomicInt(&preload.loaded, 1);
+            continue;
+        }
 
-                // Ensure all data writes are visible before publishing the pointer.
-                // Without this barrier, ARM cores could see the pointer but read
-                // partially-written data behind it.
-                SDL_MemoryBarrierRelease();
-                SDL_SetAtomicPointer(&entry->data, preloaded_data);
+        entry->priority = -1;
+        heap_push(i, AFS_PRELOAD_PRIORITY_BACKGROUND);
+        queued += 1;
+    }
+
+    SDL_UnlockMutex(preload.lock);
+
+    if (queued == 0) {
+        return;
+    }
+
+    thread_count = SDL_min(reader_thread_count(), queued);
+    SDL_SetAtomicInt(&preload.running, thread_count);
+
+    for (int i = 0; i < thread_count; i++) {
+        preload.threads[i] = SDL_CreateThread(preload_thread_func, "AFS_Preload", NULL);
+
+        if (preload.threads[i] == NULL) {
+            SDL_AddAtomicInt(&preload.running, -1);
+        }
+    }
+
+    preload.thread_count = thread_count;
+}
+
+static void stop_preload() {
+    SDL_SetAtomicInt(&preload.shutdown, 1);
+
+    for (int i = 0; i < preload.thread_count; i++) {
+        if (preload.threads[i] != NULL) {
+            SDL_WaitThread(preload.threads[i], NULL);
+        }
+    }
+
+    SDL_free(preload.heap);
+    SDL_DestroyMutex(preload.lock);
+    SDL_zero(preload);
+}
+
+// Verification
+
+/** @brief XXH64 of one entry's bytes into @p digest, from the mapping when possible; false if it can't be read. */
+static bool digest_entry(SDL_IOStream* io, const AFSEntry* entry, Uint8* buf, Uint64* digest) {
+    AFSDigestState state;
+    Uint32 left = entry->size;
+
+    if ((entry->offset == 0) || (entry->size == 0)) {
+        *digest = AFSDigest(NULL, 0, 0);
+        return true;
+    }
+
+    if ((afs.map != NULL) && ((Uint64)entry->offset + entry->size <= afs.map_size)) {
+        *digest = AFSDigest(afs.map + entry->offset, entry->size, 0);
+        return true;
+    }
+
+    if ((io == NULL) || (buf == NULL) || (SDL_SeekIO(io, entry->offset, SDL_IO_SEEK_SET) < 0)) {
+        return false;
+    }
+
+    AFSDigest_Reset(&state, 0);
+
+    while (left > 0) {
+        const Uint32 chunk = SDL_min(left, AFS_VERIFY_CHUNK);
+
+        if (SDL_ReadIO(io, buf, chunk) != chunk) {
+            return false;
+        }
+
+        AFSDigest_Update(&state, buf, chunk);
+        left -= chunk;
+    }
+
+    *digest = AFSDigest_Final(&state);
+    return true;
+}
+
+/** @brief Why entry @p i failed this pass, or NULL if it is fine. */
+static const char* bad_entry_reason(int i) {
+    if (verify.failed[i]) {
+        return "read failed";
+    }
+
+    if (!afs.has_digests) {
+        return NULL;
+    }
+
+    if (!afs.has_digest[i]) {
+        return "no reference digest, archive changed";
+    }
+
+    return (verify.digests[i] != afs.digests[i]) ? "digest mismatch" : NULL;
+}
+
+/** @brief Compare the pass against the index, or record it if the index has no digests yet. */
+static void finish_verify() {
+    const Uint64 ms = SDL_GetTicks() - verify.start_ticks;
+
+    verify.bad = 0;
+    verify.first_bad = -1;
+
+    for (int i = 0; i < afs.entry_count; i++) {
+        if (bad_entry_reason(i) != NULL) {
+            verify.bad += 1;
+
+            if (verify.first_bad < 0) {
+                verify.first_bad = i;
             }
         }
     }
 
-    SDL_CloseIO(io);
-    SDL_free(file_path);
+    if (verify.first_bad >= 0) {
+        const int i = verify.first_bad;
+
+        SDL_Log("AFS verify: %d of %u entries bad, first is %d (%s): %s",
+                verify.bad,
+                afs.entry_count,
+                i,
+                afs.entries[i].name,
+                bad_entry_reason(i));
+    } else if (afs.has_digests) {
+        SDL_Log("AFS verify: all %u entries match the index (%llu ms)", afs.entry_count, (unsigned long long)ms);
+    } else {
+        // First pass over this archive: nothing to check against yet, so record what is there
+        SDL_memcpy(afs.digests, verify.digests, afs.entry_count * sizeof(Uint64));
+
+        for (int i = 0; i < afs.entry_count; i++) {
+            afs.has_digest[i] = true;
+        }
+
+        afs.has_digests = true;
+
+        if (afs.has_info) {
+            save_index();
+        }
+
+        publish_content_digest();
+        SDL_Log("AFS verify: recorded digests for %u entries (%llu ms)", afs.entry_count, (unsigned long long)ms);
+    }
+
+    SDL_MemoryBarrierRelease();
+    SDL_SetAtomicInt(&verify.done, 1);
+}
+
+static int verify_thread_func(void* ptr) {
+    (void)ptr;
+    SDL_IOStream* io = SDL_IOFromFile(afs.file_path, "rb");
+    Uint8* buf = SDL_malloc(AFS_VERIFY_CHUNK);
+
+    for (;;) {
+        const int i = SDL_AddAtomicInt(&verify.next, 1);
+
+        if ((i >= afs.entry_count) || SDL_GetAtomicInt(&verify.shutdown)) {
+            break;
+        }
+
+        verify.failed[i] = !digest_entry(io, &afs.entries[i], buf, &verify.digests[i]);
+        SDL_AddAtomicInt(&verify.checked, 1);
+    }
+
+    SDL_free(buf);
+
+    if (io != NULL) {
+        SDL_CloseIO(io);
+    }
+
+    if ((SDL_AddAtomicInt(&verify.running, -1) == 1) && !SDL_GetAtomicInt(&verify.shutdown)) {
+        finish_verify();
+    }
+
     return 0;
 }
 
+static void stop_verify() {
+    SDL_SetAtomicInt(&verify.shutdown, 1);
+
+    for (int i = 0; i < verify.thread_count; i++) {
+        if (verify.threads[i] != NULL) {
+            SDL_WaitThread(verify.threads[i], NULL);
+        }
+    }
+
+    SDL_free(verify.digests);
+    SDL_free(verify.failed);
+    SDL_zero(verify);
+}
+
 static bool init_asyncio(const char* file_path) {
     asyncio_queue = SDL_CreateAsyncIOQueue();
     if (asyncio_queue == NULL) {
@@ -246,22 +1011,18 @@ bool AFS_Init(const char* file_path) {
         return false;
     }
 
-    SDL_SetAtomicInt(&preload_shutdown_flag, 0);
-    char* path_copy = SDL_strdup(file_path);
-    preload_thread = SDL_CreateThread(preload_thread_func, "AFS_Preload", path_copy);
-    if (preload_thread == NULL) {
-        SDL_free(path_copy);
+    if (map_enabled && map_archive(file_path)) {
+        attach_mapped_entries();
+        SDL_Log("AFS: mapped %zu MB archive", afs.map_size >> 20);
     }
 
+    start_preload();
     return true;
 }
 
 void AFS_Finish() {
-    SDL_SetAtomicInt(&preload_shutdown_flag, 1);
-    if (preload_thread) {
-        SDL_WaitThread(preload_thread, NULL);
-        preload_thread = NULL;
-    }
+    stop_verify();
+    stop_preload();
 
     // ⚡ Bolt: Close the persistent async I/O handle before destroying the queue.
     if (persistent_asyncio != NULL) {
@@ -277,24 +1038,137 @@ void AFS_Finish() {
     // Free preloaded file data
     if (afs.entries) {
         for (int i = 0; i < afs.entry_count; i++) {
-            if (afs.entries[i].data) {
+            if (afs.entries[i].data && !afs.entries[i].mapped) {
                 SDL_free(afs.entries[i].data);
             }
         }
     }
 
+    unmap_archive();
+
     SDL_free(afs.file_path);
     SDL_free(afs.entries);
+    SDL_free(afs.digests);
+    SDL_free(afs.has_digest);
     SDL_zero(afs);
     SDL_zeroa(requests);
     SDL_DestroyAsyncIOQueue(asyncio_queue);
     asyncio_queue = NULL;
 }
 
+void AFS_SetMemoryMapped(bool enabled) {
+    map_enabled = enabled;
+}
+
+void AFS_SetPreloadThreads(int count) {
+    preload_threads_wanted = count;
+}
+
+void AFS_Hint(int file_num) {
+    bump_entry(file_num, AFS_PRELOAD_PRIORITY_HINT);
+}
+
+void AFS_GetPreloadStats(AFSPreloadStats* stats) {
+    stats->total = SDL_GetAtomicInt(&preload.total);
+    stats->loaded = SDL_GetAtomicInt(&preload.loaded);
+    stats->hits = SDL_GetAtomicInt(&preload.hits);
+    stats->misses = SDL_GetAtomicInt(&preload.misses);
+    stats->bumps = SDL_GetAtomicInt(&preload.bumps);
+    stats->done = (SDL_GetAtomicInt(&preload.running) == 0);
+}
+
+bool AFS_IsMemoryMapped() {
+    return afs.map != NULL;
+}
+
+const void* AFS_GetEntryPointer(int file_num) {
+    if ((file_num < 0) || (file_num >= afs.entry_count)) {
+        return NULL;
+    }
+
+    void* data = SDL_GetAtomicPointer(&afs.entries[file_num].data);
+
+    if (data) {
+        // Pairs with the release barrier in the preload thread
+        SDL_MemoryBarrierAcquire();
+    }
+
+    return data;
+}
+
 unsigned int AFS_GetFileCount() {
     return afs.entry_count;
 }
 
+uint64_t AFS_GetArchiveHash() {
+    return afs.toc_hash;
+}
+
+uint64_t AFS_GetContentDigest() {
+    if (!SDL_GetAtomicInt(&afs.content_ready)) {
+        return 0;
+    }
+
+    SDL_MemoryBarrierAcquire();
+    return afs.content_digest;
+}
+
+void AFS_StartVerify() {
+    int thread_count;
+
+    if ((afs.entries == NULL) || (verify.digests != NULL)) {
+        return;
+    }
+
+    verify.digests = SDL_calloc(SDL_max(afs.entry_count, 1), sizeof(Uint64));
+    verify.failed = SDL_calloc(SDL_max(afs.entry_count, 1), sizeof(bool));
+
+    if ((verify.digests == NULL) || (verify.failed == NULL)) {
+        SDL_free(verify.digests);
+        SDL_free(verify.failed);
+        verify.digests = NULL;
+        verify.failed = NULL;
+        return;
+    }
+
+    verify.first_bad = -1;
+    verify.start_ticks = SDL_GetTicks();
+
+    if (afs.entry_count == 0) {
+        finish_verify();
+        return;
+    }
+
+    thread_count = SDL_min(reader_thread_count(), (int)afs.entry_count);
+    SDL_SetAtomicInt(&verify.running, thread_count);
+
+    for (int i = 0; i < thread_count; i++) {
+        verify.threads[i] = SDL_CreateThread(verify_thread_func, "AFS_Verify", NULL);
+
+        if (verify.threads[i] == NULL) {
+            // The last reader to leave finishes the pass, so a thread that never started must leave too
+            if (SDL_AddAtomicInt(&verify.running, -1) == 1) {
+                finish_verify();
+            }
+        }
+    }
+
+    verify.thread_count = thread_count;
+}
+
+void AFS_GetVerifyStats(AFSVerifyStats* stats) {
+    stats->total = afs.entry_count;
+    stats->checked = SDL_GetAtomicInt(&verify.checked);
+    stats->done = SDL_GetAtomicInt(&verify.done) != 0;
+
+    if (stats->done) {
+        SDL_MemoryBarrierAcquire();
+    }
+
+    stats->bad = stats->done ? verify.bad : 0;
+    stats->first_bad = stats->done ? verify.first_bad : -1;
+}
+
 unsigned int AFS_GetSize(int file_num) {
     if ((file_num < 0) || (file_num >= afs.entry_count)) {
         return 0;
@@ -303,8 +1177,31 @@ unsigned int AFS_GetSize(int file_num) {
     return afs.entries[file_num].size;
 }
 
+const char* AFS_GetName(int file_num) {
+    if ((file_num < 0) || (file_num >= afs.entry_count)) {
+        return NULL;
+    }
+
+    return afs.entries[file_num].name;
+}
+
 // AFS reading
 
+/** @brief Count a read of a preloadable entry; a miss moves it to the front of the preload queue. */
+static void note_read(int file_num, bool resident) {
+    if (!is_preloadable(file_num)) {
+        return;
+    }
+
+    if (resident) {
+        SDL_AddAtomicInt(&preload.hits, 1);
+        return;
+    }
+
+    SDL_AddAtomicInt(&preload.misses, 1);
+    bump_entry(file_num, AFS_PRELOAD_PRIORITY_DEMAND);
+}
+
 static void process_asyncio_outcome(const SDL_AsyncIOOutcome* outcome) {
     ReadRequest* request = (ReadRequest*)outcome->userdata;
 
@@ -321,6 +1218,8 @@ static void process_asyncio_outcome(const SDL_AsyncIOOutcome* outcome) {
 
     switch (outcome->type) {
     case SDL_ASYNCIO_TASK_READ:
+        LoadTrace_Span(LOAD_TRACE_IO_WAIT, afs.entries[request->file_num].name, request->issued_ns, LoadTrace_Now());
+
         switch (outcome->result) {
         case SDL_ASYNCIO_COMPLETE:
             request->state = AFS_READ_STATE_FINISHED;
@@ -395,6 +1294,8 @@ void AFS_Read(AFSHandle handle, int sectors, void* buf) {
 
     // Fast path: preloaded data — zero-copy memcpy, no I/O
     void* preloaded_data = SDL_GetAtomicPointer(&entry->data);
+    note_read(request->file_num, preloaded_data != NULL);
+    request->issued_ns = LoadTrace_Now();
     if (preloaded_data) {
         // Pair with the release barrier in the preload thread to ensure
         // all file data writes are visible before we memcpy.
@@ -402,6 +1303,7 @@ void AFS_Read(AFSHandle handle, int sectors, void* buf) {
         SDL_memcpy(buf, (Uint8*)preloaded_data + request->sector * 2048, sectors * 2048);
         request->sector += sectors;
         request->state = AFS_READ_STATE_FINISHED;
+        LoadTrace_Span(LOAD_TRACE_IO_WAIT, entry->name, request->issued_ns, LoadTrace_Now());
         return;
     }
 
@@ -422,6 +1324,34 @@ void AFS_Read(AFSHandle handle, int sectors, void* buf) {
     request->sector += sectors;
 }
 
+AFSReadState AFS_ReadAsync(int file_num, int sector, int sectors, void* buf, SDL_AsyncIOQueue* queue,
+                           void* userdata) {
+    if ((file_num < 0) || (file_num >= afs.entry_count) || (persistent_asyncio == NULL)) {
+        return AFS_READ_STATE_ERROR;
+    }
+
+    AFSEntry* entry = &afs.entries[file_num];
+
+    // Same preloaded fast path as AFS_Read
+    void* preloaded_data = SDL_GetAtomicPointer(&entry->data);
+    note_read(file_num, preloaded_data != NULL);
+    if (preloaded_data) {
+        SDL_MemoryBarrierAcquire();
+        SDL_memcpy(buf, (Uint8*)preloaded_data + sector * 2048, sectors * 2048);
+        return AFS_READ_STATE_FINISHED;
+    }
+
+    // SDL async I/O may be driven from any thread; only the handle table above is game-thread-only
+    const Uint64 offset = entry->offset + (Uint64)sector * 2048;
+
+    if (!SDL_ReadAsyncIO(persistent_asyncio, buf, offset, sectors * 2048, queue, userdata)) {
+        printf("SDL_ReadAsyncIO error: %s\n", SDL_GetError());
+        return AFS_READ_STATE_ERROR;
+    }
+
+    return AFS_READ_STATE_READING;
+}
+
 void AFS_ReadSync(AFSHandle handle, int sectors, void* buf) {
 #if defined(AFS_DEBUG)
     printf("📂 %d: read sync\n", handle);
@@ -1,11 +1,12 @@
 /**
  * @file afs.h
- * @brief AFS archive reader API (preloaded RAM cache, async I/O).
+ * @brief AFS archive reader API (mapped or preloaded RAM cache, async I/O).
  */
 #ifndef PORT_IO_AFS_H
 #define PORT_IO_AFS_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 typedef enum AFSReadState {
     AFS_READ_STATE_IDLE,
@@ -16,17 +17,106 @@ typedef enum AFSReadState {
 
 typedef int AFSHandle;
 
+struct SDL_AsyncIOQueue;
+
 #define AFS_NONE -1
 
+/**
+ * @brief Choose between mapping the archive and preloading entries into the heap.
+ *
+ * Takes effect at the next AFS_Init(). Mapping is the default; when it is
+ * off or the archive can't be mapped, entries are preloaded as before.
+ */
+void AFS_SetMemoryMapped(bool enabled);
+
+/** @brief Preload reader thread count for the next AFS_Init(); 0 picks one from the CPU count. */
+void AFS_SetPreloadThreads(int count);
+
+/** @brief Preloader progress and RAM cache effectiveness since AFS_Init(). */
+typedef struct AFSPreloadStats {
+    int total;  // Entries served from RAM once resident (mapped or preloaded)
+    int loaded; // Of those, resident now
+    int hits;   // Reads of such entries served from RAM
+    int misses; // Reads that had to go to disk because the entry wasn't resident yet
+    int bumps;  // Entries moved ahead of the background walk by a hint or a miss
+    bool done;  // All preload readers have finished
+} AFSPreloadStats;
+
 bool AFS_Init(const char* file_path);
 void AFS_Finish();
 unsigned int AFS_GetFileCount();
 unsigned int AFS_GetSize(int file_num);
 
+/** @brief Entry name from the archive's attribute table ("" if it has none), or NULL for a bad number. */
+const char* AFS_GetName(int file_num);
+uint64_t AFS_GetArchiveHash();
+
+/**
+ * @brief Digest of the archive's contents, or 0 until every entry has a digest recorded by a verification pass.
+ *
+ * Derived from the per-entry XXH64 digests in the sidecar index, so it is
+ * cheap to query and identical for any two copies with the same data, e.g.
+ * for netplay peers to confirm they run the same assets.
+ */
+uint64_t AFS_GetContentDigest();
+
+/** @brief Progress of the verification pass started by AFS_StartVerify(). */
+typedef struct AFSVerifyStats {
+    int total;     // Entries in the archive
+    int checked;   // Entries hashed so far
+    int bad;       // Entries that couldn't be read, don't match the index or have no digest in it (once done)
+    int first_bad; // Lowest bad entry, or -1 (once done)
+    bool done;
+} AFSVerifyStats;
+
+/**
+ * @brief Hash every entry on background threads and check it against the index.
+ *
+ * The first pass over an archive has nothing to check against; it records
+ * the digests in the index instead. After the archive changes, entries that
+ * moved or changed size have no recorded digest and are reported as bad;
+ * delete the index to accept a new dump. Results are logged and available
+ * from AFS_GetVerifyStats(). Does nothing if a pass was already started.
+ */
+void AFS_StartVerify();
+void AFS_GetVerifyStats(AFSVerifyStats* stats);
+
+/** @brief True if the open archive is served from a read-only mapping. */
+bool AFS_IsMemoryMapped();
+
+/**
+ * @brief Read-only view of an entry's bytes, valid until AFS_Finish().
+ *
+ * Returns the mapped (or already preloaded) data padded to whole sectors,
+ * or NULL for streamed BGM entries and entries that aren't resident yet;
+ * callers then fall back to AFS_Read(). Never write through the pointer:
+ * in mapped mode it faults.
+ */
+const void* AFS_GetEntryPointer(int file_num);
+
+/**
+ * @brief Ask the preloader to fetch @p file_num ahead of the background walk.
+ *
+ * For files a load request is about to read. No-op for streamed BGM and
+ * entries that are already resident or being read.
+ */
+void AFS_Hint(int file_num);
+void AFS_GetPreloadStats(AFSPreloadStats* stats);
+
 void AFS_RunServer();
 AFSHandle AFS_Open(int file_num);
 void AFS_Read(AFSHandle handle, int sectors, void* buf);
 void AFS_ReadSync(AFSHandle handle, int sectors, void* buf);
+
+/**
+ * @brief Thread-safe sector read that bypasses the handle table.
+ *
+ * Preloaded entries are copied immediately (AFS_READ_STATE_FINISHED);
+ * otherwise the read is queued (AFS_READ_STATE_READING) and its outcome,
+ * tagged with @p userdata, is delivered to the caller-owned @p queue.
+ */
+AFSReadState AFS_ReadAsync(int file_num, int sector, int sectors, void* buf, struct SDL_AsyncIOQueue* queue,
+                           void* userdata);
 void AFS_Stop(AFSHandle handle);
 void AFS_Close(AFSHandle handle);
 AFSReadState AFS_GetState(AFSHandle handle);
@@ -0,0 +1,284 @@
+/**
+ * @file afs_index.c
+ * @brief Sidecar index for the AFS archive: table of contents and entry digests.
+ *
+ * File layout: an AFSIndexHeader followed by entry_count AFSIndexEntry
+ * records, written in native layout like the tile cache. The header keeps
+ * an XXH64 of the entry table, so a torn or damaged index is rebuilt
+ * rather than trusted.
+ */
+#include "port/io/afs_index.h"
+
+#include <SDL3/SDL.h>
+
+#define AFS_INDEX_MAGIC 0x58534641 // "AFSX"
+#define AFS_INDEX_VERSION 2
+#define AFS_INDEX_HAS_DIGESTS 0x1
+
+#define XXH_PRIME1 0x9E3779B185EBCA87ull
+#define XXH_PRIME2 0xC2B2AE3D27D4EB4Full
+#define XXH_PRIME3 0x165667B19E3779F9ull
+#define XXH_PRIME4 0x85EBCA77C2B2AE63ull
+#define XXH_PRIME5 0x27D4EB2F165667C5ull
+
+typedef struct AFSIndexHeader {
+    Uint32 magic;
+    Uint32 version;
+    Uint64 archive_size;
+    Sint64 archive_mtime;
+    Uint32 entry_count;
+    Uint32 flags;
+    Uint64 check; // XXH64 of the entry table
+} AFSIndexHeader;
+
+_Static_assert(sizeof(AFSIndexEntry) == 56, "AFSIndexEntry is stored as-is");
+
+// XXH64
+
+static inline Uint64 rotl64(Uint64 x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline Uint64 read64(const Uint8* p) {
+    Uint64 v;
+
+    SDL_memcpy(&v, p, 8);
+    return SDL_Swap64LE(v);
+}
+
+static inline Uint32 read32(const Uint8* p) {
+    Uint32 v;
+
+    SDL_memcpy(&v, p, 4);
+    return SDL_Swap32LE(v);
+}
+
+static inline Uint64 xxh_round(Uint64 acc, Uint64 input) {
+    acc += input * XXH_PRIME2;
+    return rotl64(acc, 31) * XXH_PRIME1;
+}
+
+static inline Uint64 xxh_merge(Uint64 h, Uint64 acc) {
+    h ^= xxh_round(0, acc);
+    return h * XXH_PRIME1 + XXH_PRIME4;
+}
+
+/** @brief Consume whole 32-byte stripes; returns the bytes used. */
+static size_t xxh_stripes(Uint64* acc, const Uint8* p, size_t len) {
+    const Uint8* const start = p;
+
+    while (len >= 32) {
+        acc[0] = xxh_round(acc[0], read64(p));
+        acc[1] = xxh_round(acc[1], read64(p + 8));
+        acc[2] = xxh_round(acc[2], read64(p + 16));
+        acc[3] = xxh_round(acc[3], read64(p + 24));
+        p += 32;
+        len -= 32;
+    }
+
+    return (size_t)(p - start);
+}
+
+void AFSDigest_Reset(AFSDigestState* state, uint64_t seed) {
+    SDL_zerop(state);
+    state->seed = seed;
+    state->acc[0] = seed + XXH_PRIME1 + XXH_PRIME2;
+    state->acc[1] = seed + XXH_PRIME2;
+    state->acc[2] = seed;
+    state->acc[3] = seed - XXH_PRIME1;
+}
+
+void AFSDigest_Update(AFSDigestState* state, const void* data, size_t len) {
+    const Uint8* p = (const Uint8*)data;
+
+    state->total += len;
+
+    if (state->buffered > 0) {
+        const size_t fill = SDL_min(len, 32 - (size_t)state->buffered);
+
+        SDL_memcpy(state->buf + state->buffered, p, fill);
+        state->buffered += (Uint32)fill;
+        p += fill;
+        len -= fill;
+
+        if (state->buffered < 32) {
+            return;
+        }
+
+        xxh_stripes(state->acc, state->buf, 32);
+        state->buffered = 0;
+    }
+
+    const size_t used = xxh_stripes(state->acc, p, len);
+
+    SDL_memcpy(state->buf, p + used, len - used);
+    state->buffered = (Uint32)(len - used);
+}
+
+uint64_t AFSDigest_Final(const AFSDigestState* state) {
+    const Uint8* p = state->buf;
+    size_t len = state->buffered;
+    Uint64 h;
+
+    if (state->total >= 32) {
+        h = rotl64(state->acc[0], 1) + rotl64(state->acc[1], 7) + rotl64(state->acc[2], 12) +
+            rotl64(state->acc[3], 18);
+
+        for (int i = 0; i < 4; i++) {
+            h = xxh_merge(h, state->acc[i]);
+        }
+    } else {
+        h = state->seed + XXH_PRIME5;
+    }
+
+    h += state->total;
+
+    while (len >= 8) {
+        h ^= xxh_round(0, read64(p));
+        h = rotl64(h, 27) * XXH_PRIME1 + XXH_PRIME4;
+        p += 8;
+        len -= 8;
+    }
+
+    if (len >= 4) {
+        h ^= (Uint64)read32(p) * XXH_PRIME1;
+        h = rotl64(h, 23) * XXH_PRIME2 + XXH_PRIME3;
+        p += 4;
+        len -= 4;
+    }
+
+    while (len > 0) {
+        h ^= *p++ * XXH_PRIME5;
+        h = rotl64(h, 11) * XXH_PRIME1;
+        len -= 1;
+    }
+
+    h ^= h >> 33;
+    h *= XXH_PRIME2;
+    h ^= h >> 29;
+    h *= XXH_PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t AFSDigest(const void* data, size_t len, uint64_t seed) {
+    AFSDigestState state;
+
+    AFSDigest_Reset(&state, seed);
+    AFSDigest_Update(&state, data, len);
+    return AFSDigest_Final(&state);
+}
+
+// Index file
+
+bool AFSIndex_Load(const char* path, uint64_t archive_size, int64_t archive_mtime, AFSIndex* index) {
+    if (!AFSIndex_LoadAny(path, index)) {
+        return false;
+    }
+
+    if ((index->archive_size != archive_size) || (index->archive_mtime != archive_mtime)) {
+        AFSIndex_Free(index);
+        return false;
+    }
+
+    return true;
+}
+
+bool AFSIndex_LoadAny(const char* path, AFSIndex* index) {
+    AFSIndexHeader hdr;
+    size_t file_size = 0;
+    Uint8* file;
+    size_t table_size;
+
+    SDL_zerop(index);
+
+    // ⚡ The whole index in one read, instead of a read and a seek per entry
+    file = SDL_LoadFile(path, &file_size);
+
+    if (file == NULL) {
+        return false;
+    }
+
+    if (file_size < sizeof(hdr)) {
+        SDL_free(file);
+        return false;
+    }
+
+    SDL_memcpy(&hdr, file, sizeof(hdr));
+    table_size = (size_t)hdr.entry_count * sizeof(AFSIndexEntry);
+
+    if ((hdr.magic != AFS_INDEX_MAGIC) || (hdr.version != AFS_INDEX_VERSION) ||
+        (file_size != sizeof(hdr) + table_size) || (AFSDigest(file + sizeof(hdr), table_size, 0) != hdr.check)) {
+        SDL_free(file);
+        return false;
+    }
+
+    index->entries = SDL_malloc(SDL_max(table_size, 1));
+
+    if (index->entries == NULL) {
+        SDL_free(file);
+        return false;
+    }
+
+    SDL_memcpy(index->entries, file + sizeof(hdr), table_size);
+    SDL_free(file);
+
+    for (Uint32 i = 0; i < hdr.entry_count; i++) {
+        index->entries[i].name[AFS_INDEX_NAME_LENGTH - 1] = '\0';
+    }
+
+    index->archive_size = hdr.archive_size;
+    index->archive_mtime = hdr.archive_mtime;
+    index->entry_count = hdr.entry_count;
+    index->has_digests = (hdr.flags & AFS_INDEX_HAS_DIGESTS) != 0;
+    return true;
+}
+
+bool AFSIndex_Save(const char* path, const AFSIndex* index) {
+    const size_t table_size = (size_t)index->entry_count * sizeof(AFSIndexEntry);
+    AFSIndexHeader hdr;
+    SDL_IOStream* io;
+    char* tmp_path;
+    bool ok;
+
+    SDL_zero(hdr);
+    hdr.magic = AFS_INDEX_MAGIC;
+    hdr.version = AFS_INDEX_VERSION;
+    hdr.archive_size = index->archive_size;
+    hdr.archive_mtime = index->archive_mtime;
+    hdr.entry_count = index->entry_count;
+    hdr.flags = index->has_digests ? AFS_INDEX_HAS_DIGESTS : 0;
+    hdr.check = AFSDigest(index->entries, table_size, 0);
+
+    if (SDL_asprintf(&tmp_path, "%s.tmp", path) < 0) {
+        return false;
+    }
+
+    io = SDL_IOFromFile(tmp_path, "wb");
+
+    if (io == NULL) {
+        SDL_free(tmp_path);
+        return false;
+    }
+
+    ok = (SDL_WriteIO(io, &hdr, sizeof(hdr)) == sizeof(hdr)) &&
+         (SDL_WriteIO(io, index->entries, table_size) == table_size);
+    ok = SDL_CloseIO(io) && ok;
+
+    // Readers only ever see a complete index, or the previous one
+    if (ok) {
+        ok = SDL_RenamePath(tmp_path, path);
+    }
+
+    if (!ok) {
+        SDL_RemovePath(tmp_path);
+    }
+
+    SDL_free(tmp_path);
+    return ok;
+}
+
+void AFSIndex_Free(AFSIndex* index) {
+    SDL_free(index->entries);
+    SDL_zerop(index);
+}
@@ -0,0 +1,77 @@
+/**
+ * @file afs_index.h
+ * @brief Sidecar index for the AFS archive: table of contents and entry digests.
+ *
+ * The index is written next to the archive and keyed by the archive's size
+ * and modification time. While those match, the table of contents is
+ * loaded from it in a single read instead of being parsed entry by entry.
+ * Once a verification pass has hashed every entry, the index also carries
+ * a 64-bit XXH64 digest per entry, which later passes check against. When
+ * the archive is replaced or damaged its mtime changes; the rebuilt index
+ * keeps the digests of entries at the same offset and size, so the new
+ * bytes are checked against them rather than recorded as correct.
+ */
+#ifndef PORT_IO_AFS_INDEX_H
+#define PORT_IO_AFS_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define AFS_INDEX_NAME_LENGTH 32
+
+typedef struct AFSIndexEntry {
+    uint32_t offset;
+    uint32_t size;
+    char name[AFS_INDEX_NAME_LENGTH];
+    uint64_t digest; // XXH64 of the entry's bytes (seed 0); meaningful only when has_digest
+    bool has_digest;
+    uint8_t reserved[7];
+} AFSIndexEntry;
+
+typedef struct AFSIndex {
+    uint64_t archive_size;
+    int64_t archive_mtime; // SDL_Time of the archive when the index was written
+    uint32_t entry_count;
+    bool has_digests; // A pass recorded digests, for this archive or the one it replaced
+    AFSIndexEntry* entries;
+} AFSIndex;
+
+/**
+ * @brief Load the index at @p path if it describes an archive of this size and mtime.
+ *
+ * Returns false (leaving @p index empty) when the file is missing, damaged,
+ * from another format version or written for a different archive.
+ */
+bool AFSIndex_Load(const char* path, uint64_t archive_size, int64_t archive_mtime, AFSIndex* index);
+
+/**
+ * @brief Load the index at @p path whatever archive it was written for.
+ *
+ * archive_size and archive_mtime report that archive. Used to carry digests
+ * over to a changed archive; the table of contents may not match it.
+ */
+bool AFSIndex_LoadAny(const char* path, AFSIndex* index);
+
+/** @brief Write @p index to @p path, replacing any previous index only once it is complete. */
+bool AFSIndex_Save(const char* path, const AFSIndex* index);
+
+void AFSIndex_Free(AFSIndex* index);
+
+/** @brief Streaming XXH64 state. */
+typedef struct AFSDigestState {
+    uint64_t total;
+    uint64_t acc[4];
+    uint8_t buf[32];
+    uint32_t buffered;
+    uint64_t seed;
+} AFSDigestState;
+
+void AFSDigest_Reset(AFSDigestState* state, uint64_t seed);
+void AFSDigest_Update(AFSDigestState* state, const void* data, size_t len);
+uint64_t AFSDigest_Final(const AFSDigestState* state);
+
+/** @brief XXH64 of @p len bytes in one call. */
+uint64_t AFSDigest(const void* data, size_t len, uint64_t seed);
+
+#endif
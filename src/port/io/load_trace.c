@@ -0,0 +1,255 @@
+/**
+ * @file load_trace.c
+ * @brief Timeline of where asset load time goes: I/O wait, decompress, convert, allocate.
+ */
+#include "port/io/load_trace.h"
+
+#include <SDL3/SDL.h>
+
+typedef struct LoadTrace {
+    LoadTraceEvent* events; // Ring of capacity events; NULL while not recording
+    int capacity;
+    int head; // Oldest event
+    int count;
+    int dropped;
+    Uint64 origin_ns; // Timestamps in the Chrome export are relative to this
+    char asset[LOAD_TRACE_NAME_LENGTH];
+    int depth;
+    Uint64 child_ns[LOAD_TRACE_MAX_DEPTH]; // Time spent in scopes nested in each open scope
+} LoadTrace;
+
+static LoadTrace trace;
+
+static const char* const category_names[LOAD_TRACE_CATEGORY_COUNT] = {
+    "io-wait", "decompress", "convert", "alloc", "request",
+};
+
+const char* LoadTrace_CategoryName(LoadTraceCategory category) {
+    if ((category < 0) || (category >= LOAD_TRACE_CATEGORY_COUNT)) {
+        return "?";
+    }
+
+    return category_names[category];
+}
+
+bool LoadTrace_Start(int capacity) {
+    LoadTrace_Stop();
+
+    if (capacity <= 0) {
+        capacity = LOAD_TRACE_DEFAULT_CAPACITY;
+    }
+
+    trace.events = SDL_malloc(capacity * sizeof(LoadTraceEvent));
+
+    if (trace.events == NULL) {
+        return false;
+    }
+
+    trace.capacity = capacity;
+    trace.origin_ns = SDL_GetTicksNS();
+    return true;
+}
+
+void LoadTrace_Stop() {
+    SDL_free(trace.events);
+    SDL_zero(trace);
+}
+
+bool LoadTrace_IsActive() {
+    return trace.events != NULL;
+}
+
+void LoadTrace_Clear() {
+    trace.head = 0;
+    trace.count = 0;
+    trace.dropped = 0;
+}
+
+void LoadTrace_SetAsset(const char* name) {
+    SDL_strlcpy(trace.asset, (name != NULL) ? name : "", sizeof(trace.asset));
+}
+
+const char* LoadTrace_GetAsset() {
+    return trace.asset;
+}
+
+uint64_t LoadTrace_Now() {
+    return LoadTrace_IsActive() ? SDL_GetTicksNS() : 0;
+}
+
+/** @brief Append an event, overwriting the oldest when the ring is full. */
+static void record(LoadTraceCategory category, const char* asset, Uint64 begin_ns, Uint64 end_ns, Uint64 self_ns,
+                   bool span) {
+    LoadTraceEvent* event;
+
+    if (trace.count < trace.capacity) {
+        event = &trace.events[(trace.head + trace.count) % trace.capacity];
+        trace.count += 1;
+    } else {
+        event = &trace.events[trace.head];
+        trace.head = (trace.head + 1) % trace.capacity;
+        trace.dropped += 1;
+    }
+
+    event->begin_ns = begin_ns;
+    event->end_ns = (end_ns > begin_ns) ? end_ns : begin_ns;
+    event->self_ns = self_ns;
+    event->category = category;
+    event->span = span;
+    SDL_strlcpy(event->asset, (asset != NULL) ? asset : trace.asset, sizeof(event->asset));
+}
+
+uint64_t LoadTrace_Begin() {
+    if (!LoadTrace_IsActive()) {
+        return 0;
+    }
+
+    if (trace.depth < LOAD_TRACE_MAX_DEPTH) {
+        trace.child_ns[trace.depth] = 0;
+    }
+
+    trace.depth += 1;
+    return SDL_GetTicksNS();
+}
+
+void LoadTrace_End(LoadTraceCategory category, uint64_t begin_ns) {
+    Uint64 end_ns;
+    Uint64 dur;
+    Uint64 child;
+
+    // Scopes opened before the trace started (or in an earlier one) were never counted
+    if ((begin_ns == 0) || !LoadTrace_IsActive() || (trace.depth == 0)) {
+        return;
+    }
+
+    end_ns = SDL_GetTicksNS();
+    dur = end_ns - begin_ns;
+    trace.depth -= 1;
+    child = (trace.depth < LOAD_TRACE_MAX_DEPTH) ? trace.child_ns[trace.depth] : 0;
+
+    if ((trace.depth > 0) && (trace.depth <= LOAD_TRACE_MAX_DEPTH)) {
+        trace.child_ns[trace.depth - 1] += dur;
+    }
+
+    record(category, NULL, begin_ns, end_ns, (dur > child) ? dur - child : 0, false);
+}
+
+void LoadTrace_Span(LoadTraceCategory category, const char* asset, uint64_t begin_ns, uint64_t end_ns) {
+    if ((begin_ns == 0) || !LoadTrace_IsActive()) {
+        return;
+    }
+
+    record(category, asset, begin_ns, end_ns, (end_ns > begin_ns) ? end_ns - begin_ns : 0, true);
+}
+
+int LoadTrace_GetEventCount() {
+    return trace.count;
+}
+
+const LoadTraceEvent* LoadTrace_GetEvent(int index) {
+    if ((index < 0) || (index >= trace.count)) {
+        return NULL;
+    }
+
+    return &trace.events[(trace.head + index) % trace.capacity];
+}
+
+int LoadTrace_GetDropped() {
+    return trace.dropped;
+}
+
+int LoadTrace_Summarize(LoadTraceAsset* assets, int max_assets) {
+    int found = 0;
+
+    for (int i = 0; i < trace.count; i++) {
+        const LoadTraceEvent* event = LoadTrace_GetEvent(i);
+        LoadTraceAsset* asset = NULL;
+
+        for (int j = 0; j < found; j++) {
+            if (SDL_strcmp(assets[j].name, event->asset) == 0) {
+                asset = &assets[j];
+                break;
+            }
+        }
+
+        if (asset == NULL) {
+            if (found == max_assets) {
+                continue;
+            }
+
+            asset = &assets[found++];
+            SDL_zerop(asset);
+            SDL_strlcpy(asset->name, event->asset, sizeof(asset->name));
+        }
+
+        asset->ns[event->category] += event->self_ns;
+        asset->count[event->category] += 1;
+    }
+
+    return found;
+}
+
+/** @brief Write @p s as a JSON string body (AFS names are plain ASCII, but don't trust them). */
+static void write_json_string(SDL_IOStream* io, const char* s) {
+    for (; *s != '\0'; s++) {
+        const unsigned char c = (unsigned char)*s;
+
+        if ((c == '"') || (c == '\\')) {
+            SDL_IOprintf(io, "\\%c", c);
+        } else if ((c < 0x20) || (c >= 0x7F)) {
+            SDL_IOprintf(io, "\\u%04x", c);
+        } else {
+            SDL_IOprintf(io, "%c", c);
+        }
+    }
+}
+
+static void write_event_head(SDL_IOStream* io, bool first, const LoadTraceEvent* event, const char* phase,
+                             Uint64 ts_ns) {
+    SDL_IOprintf(io, "%s\n{\"name\":\"", first ? "" : ",");
+    write_json_string(io, (event->asset[0] != '\0') ? event->asset : LoadTrace_CategoryName(event->category));
+    SDL_IOprintf(io,
+                 "\",\"cat\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":1",
+                 LoadTrace_CategoryName(event->category),
+                 phase,
+                 (ts_ns - trace.origin_ns) / 1e3);
+}
+
+bool LoadTrace_WriteChrome(const char* path) {
+    SDL_IOStream* io = SDL_IOFromFile(path, "w");
+
+    if (io == NULL) {
+        SDL_Log("Load trace: can't open %s: %s", path, SDL_GetError());
+        return false;
+    }
+
+    SDL_IOprintf(io, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    for (int i = 0; i < trace.count; i++) {
+        const LoadTraceEvent* event = LoadTrace_GetEvent(i);
+
+        if (event->span) {
+            // Spans overlap, so they go on async tracks instead of the game thread's stack
+            write_event_head(io, i == 0, event, "b", event->begin_ns);
+            SDL_IOprintf(io, ",\"id\":%d}", i);
+            write_event_head(io, false, event, "e", event->end_ns);
+            SDL_IOprintf(io, ",\"id\":%d}", i);
+        } else {
+            write_event_head(io, i == 0, event, "X", event->begin_ns);
+            SDL_IOprintf(io,
+                         ",\"dur\":%.3f,\"args\":{\"self_us\":%.3f}}",
+                         (event->end_ns - event->begin_ns) / 1e3,
+                         event->self_ns / 1e3);
+        }
+    }
+
+    SDL_IOprintf(io, "\n],\"otherData\":{\"dropped\":%d}}\n", trace.dropped);
+
+    if (!SDL_CloseIO(io)) {
+        SDL_Log("Load trace: failed writing %s: %s", path, SDL_GetError());
+        return false;
+    }
+
+    SDL_Log("Load trace written to %s (%d events)", path, trace.count);
+    return true;
+}
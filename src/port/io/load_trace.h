@@ -0,0 +1,114 @@
+/**
+ * @file load_trace.h
+ * @brief Timeline of where asset load time goes: I/O wait, decompress, convert, allocate.
+ *
+ * Loaders mark their work with LOAD_TRACE_BEGIN()/LOAD_TRACE_END() scopes,
+ * which become Tracy zones when Tracy is built in and, while a trace is
+ * recording (LoadTrace_Start), events in a ring buffer. Each event is
+ * tagged with the AFS entry being loaded at the time (LoadTrace_SetAsset).
+ * Reads and load requests span frames and overlap one another, so they are
+ * recorded as whole spans once they finish (LoadTrace_Span).
+ *
+ * The buffer can be written as Chrome trace JSON (chrome://tracing,
+ * Perfetto) or summed per asset, which is what --bench-loads prints.
+ *
+ * Game thread only.
+ */
+#ifndef PORT_IO_LOAD_TRACE_H
+#define PORT_IO_LOAD_TRACE_H
+
+#include "port/tracy_zones.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define LOAD_TRACE_NAME_LENGTH 32
+#define LOAD_TRACE_DEFAULT_CAPACITY 65536
+#define LOAD_TRACE_MAX_DEPTH 16
+
+typedef enum LoadTraceCategory {
+    LOAD_TRACE_IO_WAIT,    // Read issued until its data is in place (a copy, for resident entries)
+    LOAD_TRACE_DECOMPRESS, // Expanding LZ77/zlib data
+    LOAD_TRACE_CONVERT,    // Byte swaps, pixel and palette conversion, texture setup
+    LOAD_TRACE_ALLOC,      // Heap allocation for the loaded data
+    LOAD_TRACE_REQUEST,    // One LDREQ queue entry, pushed until retired
+    LOAD_TRACE_CATEGORY_COUNT
+} LoadTraceCategory;
+
+typedef struct LoadTraceEvent {
+    uint64_t begin_ns;
+    uint64_t end_ns;
+    uint64_t self_ns; // Duration minus the scopes nested inside it
+    LoadTraceCategory category;
+    bool span; // Recorded with LoadTrace_Span(); may overlap other events
+    char asset[LOAD_TRACE_NAME_LENGTH];
+} LoadTraceEvent;
+
+/** @brief Per-asset totals from LoadTrace_Summarize(). */
+typedef struct LoadTraceAsset {
+    char name[LOAD_TRACE_NAME_LENGTH];
+    uint64_t ns[LOAD_TRACE_CATEGORY_COUNT]; // Self time of scopes, full duration of spans
+    int count[LOAD_TRACE_CATEGORY_COUNT];
+} LoadTraceAsset;
+
+/** @brief Start recording into a ring of @p capacity events (0 = default), discarding any earlier trace. */
+bool LoadTrace_Start(int capacity);
+
+/** @brief Stop recording and free the buffer. */
+void LoadTrace_Stop();
+
+bool LoadTrace_IsActive();
+
+/** @brief Drop the recorded events but keep recording. */
+void LoadTrace_Clear();
+
+/** @brief Tag events recorded from now on with @p name (NULL or "" clears the tag). */
+void LoadTrace_SetAsset(const char* name);
+const char* LoadTrace_GetAsset();
+
+/** @brief Nanosecond timestamp for LoadTrace_Span(), or 0 while not recording. */
+uint64_t LoadTrace_Now();
+
+/** @brief Open a scope; pass the result to LoadTrace_End(). Prefer LOAD_TRACE_BEGIN(). */
+uint64_t LoadTrace_Begin();
+
+/** @brief Close the innermost scope and record it under @p category. */
+void LoadTrace_End(LoadTraceCategory category, uint64_t begin_ns);
+
+/** @brief Record a finished span for @p asset (NULL = the current tag); ignored if @p begin_ns is 0. */
+void LoadTrace_Span(LoadTraceCategory category, const char* asset, uint64_t begin_ns, uint64_t end_ns);
+
+/** @brief Events in the ring, oldest first. */
+int LoadTrace_GetEventCount();
+const LoadTraceEvent* LoadTrace_GetEvent(int index);
+
+/** @brief Events overwritten because the ring was full. */
+int LoadTrace_GetDropped();
+
+/** @brief Sum events per asset, in order of first appearance; returns how many assets were found. */
+int LoadTrace_Summarize(LoadTraceAsset* assets, int max_assets);
+
+/** @brief Write the ring as Chrome trace JSON. */
+bool LoadTrace_WriteChrome(const char* path);
+
+const char* LoadTrace_CategoryName(LoadTraceCategory category);
+
+#ifdef TRACY_ENABLE
+#include <string.h>
+#define LOAD_TRACE_ZONE_TEXT() TracyCZoneText(___tracy_sub_ctx, LoadTrace_GetAsset(), strlen(LoadTrace_GetAsset()))
+#else
+#define LOAD_TRACE_ZONE_TEXT() ((void)0)
+#endif
+
+// Scoped event: LOAD_TRACE_BEGIN(DECOMPRESS); ... LOAD_TRACE_END(DECOMPRESS);
+// Opens a brace scope like TRACE_SUB_BEGIN(), so don't jump out of it.
+#define LOAD_TRACE_BEGIN(cat)                                                                                          \
+    TRACE_SUB_BEGIN("Load " #cat);                                                                                     \
+    LOAD_TRACE_ZONE_TEXT();                                                                                            \
+    const uint64_t ___load_trace_begin = LoadTrace_Begin()
+#define LOAD_TRACE_END(cat)                                                                                            \
+    LoadTrace_End(LOAD_TRACE_##cat, ___load_trace_begin);                                                              \
+    TRACE_SUB_END()
+
+#endif // PORT_IO_LOAD_TRACE_H
@@ -0,0 +1,647 @@
+/**
+ * @file tile_cache.c
+ * @brief Persistent memory-mapped cache of decoded sprite tiles.
+ *
+ * File layout: a TileCacheHeader followed by append-only records, each a
+ * TileCacheRecord and its decoded bytes padded to TC_ALIGN. Only records
+ * below the header's data_end are trusted; data_end is rewritten after the
+ * appended records have been flushed to the OS, so a crashed or killed
+ * session loses at most its last few tiles and never leaves a torn record
+ * inside the trusted range. Nothing is synced to disk, so after a power
+ * loss a trusted record can still be torn; each record's data checksum is
+ * verified the first time the record is looked up, which rejects it.
+ *
+ * Records written this session are not remapped; they are served from the
+ * next boot on.
+ */
+#include "port/io/tile_cache.h"
+
+#include <SDL3/SDL.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define TC_MAGIC 0x33435354 // "TSC3"
+#define TC_VERSION 1
+#define TC_RECORD_TAG 0x454C4954 // "TILE"
+#define TC_ALIGN 16
+#define TC_MAX_TILE_BYTES 0x1000
+#define TC_MAX_FILE_BYTES (256u << 20)
+#define TC_MAX_RANGES 32
+#define TC_COMMIT_INTERVAL 64 // Records appended between data_end commits
+#define TC_INDEX_MIN 1024
+
+#define TC_PRIME1 0x9E3779B185EBCA87ull
+#define TC_PRIME2 0xC2B2AE3D27D4EB4Full
+#define TC_PRIME3 0x165667B19E3779F9ull
+
+typedef struct TileCacheHeader {
+    Uint32 magic;
+    Uint32 version;
+    Uint64 afs_hash;
+    Uint64 data_end;
+    Uint64 reserved;
+} TileCacheHeader;
+
+typedef struct TileCacheRecord {
+    Uint32 tag;
+    Uint16 file_num;
+    Uint16 size;
+    Uint32 offset; // Offset of the compressed source within the AFS file
+    Uint32 check;  // Checksum of the decoded bytes
+    Uint64 file_hash;
+    Uint64 reserved;
+} TileCacheRecord;
+
+_Static_assert(sizeof(TileCacheHeader) % TC_ALIGN == 0, "TileCacheHeader must keep records aligned");
+_Static_assert(sizeof(TileCacheRecord) % TC_ALIGN == 0, "TileCacheRecord must keep tile data aligned");
+
+typedef enum TileCacheState {
+    TC_EMPTY,
+    TC_MAPPED,   // In the mapped file, checksum not verified yet
+    TC_VERIFIED, // In the mapped file, checksum verified
+    TC_BAD,      // In the mapped file, checksum mismatch
+    TC_PENDING,  // Written this session, not mapped
+} TileCacheState;
+
+typedef struct TileCacheEntry {
+    Uint64 file_hash;
+    Uint32 offset;
+    Uint16 file_num;
+    Uint16 size;
+    Uint32 pos; // Record position in the mapped file
+    Uint32 state;
+} TileCacheEntry;
+
+typedef struct TileCacheRange {
+    const Uint8* base;
+    unsigned int size;
+    int file_num;
+    Uint64 file_hash;
+    Uint32 bound; // bind_clock when registered; the smallest is evicted first
+} TileCacheRange;
+
+static struct {
+    SDL_Mutex* lock;
+    SDL_IOStream* io;
+    const Uint8* map;
+    size_t map_size;
+    Uint64 afs_hash;
+    Uint64 data_end;
+    int uncommitted;
+    TileCacheEntry* index;
+    Uint32 index_cap;
+    Uint32 index_count;
+    TileCacheRange ranges[TC_MAX_RANGES];
+    int num_ranges;
+    Uint32 bind_clock;
+    bool ranges_overflowed;
+    unsigned int hits;
+    unsigned int misses;
+    unsigned int stored;
+} tc;
+
+static inline Uint64 rotl64(Uint64 x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+/** @brief Fast 64-bit content hash (xxhash-style mixing, 8 bytes per step). */
+uint64_t TileCache_Hash(const void* data, unsigned int size, uint64_t seed) {
+    const Uint8* p = (const Uint8*)data;
+    Uint64 h = seed ^ ((Uint64)size * TC_PRIME1);
+    Uint64 w;
+
+    while (size >= 8) {
+        SDL_memcpy(&w, p, 8);
+        h ^= rotl64(w * TC_PRIME2, 31) * TC_PRIME1;
+        h = rotl64(h, 27) * TC_PRIME1 + TC_PRIME3;
+        p += 8;
+        size -= 8;
+    }
+
+    while (size--) {
+        h ^= *p++ * TC_PRIME3;
+        h = rotl64(h, 11) * TC_PRIME1;
+    }
+
+    h ^= h >> 33;
+    h *= TC_PRIME2;
+    h ^= h >> 29;
+    h *= TC_PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+static inline Uint32 record_span(Uint32 size) {
+    return sizeof(TileCacheRecord) + ((size + TC_ALIGN - 1) & ~(TC_ALIGN - 1));
+}
+
+// Memory mapping
+
+static bool map_file(const char* path) {
+#if defined(_WIN32)
+    int wlen = MultiByteToWideChar(CP_UTF8, 0, path, -1, NULL, 0);
+    WCHAR* wpath = SDL_malloc(wlen * sizeof(WCHAR));
+    HANDLE file;
+    HANDLE mapping;
+    LARGE_INTEGER size;
+    void* view;
+
+    if (wpath == NULL) {
+        return false;
+    }
+
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, wpath, wlen);
+    file = CreateFileW(wpath,
+                       GENERIC_READ,
+                       FILE_SHARE_READ | FILE_SHARE_WRITE,
+                       NULL,
+                       OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL,
+                       NULL);
+    SDL_free(wpath);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    if (!GetFileSizeEx(file, &size) || (size.QuadPart < (LONGLONG)sizeof(TileCacheHeader))) {
+        CloseHandle(file);
+        return false;
+    }
+
+    mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+
+    if (mapping == NULL) {
+        return false;
+    }
+
+    view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (view == NULL) {
+        return false;
+    }
+
+    tc.map = (const Uint8*)view;
+    tc.map_size = (size_t)size.QuadPart;
+    return true;
+#else
+    struct stat st;
+    void* view;
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    if ((fstat(fd, &st) != 0) || (st.st_size < (off_t)sizeof(TileCacheHeader))) {
+        close(fd);
+        return false;
+    }
+
+    view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (view == MAP_FAILED) {
+        return false;
+    }
+
+    tc.map = (const Uint8*)view;
+    tc.map_size = (size_t)st.st_size;
+    return true;
+#endif
+}
+
+static void unmap_file() {
+    if (tc.map == NULL) {
+        return;
+    }
+
+#if defined(_WIN32)
+    UnmapViewOfFile((void*)tc.map);
+#else
+    munmap((void*)tc.map, tc.map_size);
+#endif
+
+    tc.map = NULL;
+    tc.map_size = 0;
+}
+
+// Index
+
+static inline Uint32 key_hash(Uint64 file_hash, int file_num, Uint32 offset, unsigned int size) {
+    Uint64 h = file_hash ^ ((Uint64)offset << 16) ^ ((Uint64)file_num << 48) ^ size;
+    h *= TC_PRIME1;
+    return (Uint32)(h >> 32);
+}
+
+static TileCacheEntry* index_find(Uint64 file_hash, int file_num, Uint32 offset, unsigned int size) {
+    Uint32 mask = tc.index_cap - 1;
+    Uint32 i = key_hash(file_hash, file_num, offset, size) & mask;
+
+    while (tc.index[i].state != TC_EMPTY) {
+        TileCacheEntry* e = &tc.index[i];
+
+        if ((e->file_hash == file_hash) && (e->offset == offset) && (e->file_num == file_num) && (e->size == size)) {
+            return e;
+        }
+
+        i = (i + 1) & mask;
+    }
+
+    return &tc.index[i];
+}
+
+static bool index_grow() {
+    TileCacheEntry* old = tc.index;
+    Uint32 old_cap = tc.index_cap;
+    Uint32 cap = (old_cap != 0) ? (old_cap * 2) : TC_INDEX_MIN;
+    TileCacheEntry* index = SDL_calloc(cap, sizeof(TileCacheEntry));
+    Uint32 i;
+
+    if (index == NULL) {
+        return false;
+    }
+
+    tc.index = index;
+    tc.index_cap = cap;
+
+    for (i = 0; i < old_cap; i++) {
+        if (old[i].state != TC_EMPTY) {
+            *index_find(old[i].file_hash, old[i].file_num, old[i].offset, old[i].size) = old[i];
+        }
+    }
+
+    SDL_free(old);
+    return true;
+}
+
+static bool index_insert(const TileCacheRecord* rec, Uint32 pos, TileCacheState state) {
+    TileCacheEntry* e;
+
+    if (((tc.index_count + 1) * 2 > tc.index_cap) && !index_grow()) {
+        return false;
+    }
+
+    e = index_find(rec->file_hash, rec->file_num, rec->offset, rec->size);
+
+    if (e->state == TC_EMPTY) {
+        tc.index_count++;
+    }
+
+    e->file_hash = rec->file_hash;
+    e->offset = rec->offset;
+    e->file_num = rec->file_num;
+    e->size = rec->size;
+    e->pos = pos;
+    e->state = state;
+    return true;
+}
+
+/** @brief Validate the mapped header and index every record below data_end. */
+static bool load_mapped() {
+    const TileCacheHeader* hdr = (const TileCacheHeader*)tc.map;
+    Uint64 pos = sizeof(TileCacheHeader);
+    Uint64 end;
+
+    if ((hdr->magic != TC_MAGIC) || (hdr->version != TC_VERSION) || (hdr->afs_hash != tc.afs_hash)) {
+        return false;
+    }
+
+    end = hdr->data_end;
+
+    if ((end < sizeof(TileCacheHeader)) || (end > tc.map_size)) {
+        return false;
+    }
+
+    while (pos + sizeof(TileCacheRecord) <= end) {
+        const TileCacheRecord* rec = (const TileCacheRecord*)(tc.map + pos);
+
+        if ((rec->tag != TC_RECORD_TAG) || (rec->size == 0) || (rec->size > TC_MAX_TILE_BYTES) ||
+            (pos + record_span(rec->size) > end)) {
+            break;
+        }
+
+        if (!index_insert(rec, (Uint32)pos, TC_MAPPED)) {
+            break;
+        }
+
+        pos += record_span(rec->size);
+    }
+
+    tc.data_end = pos;
+    return true;
+}
+
+/** @brief Flush appended records to the OS, then publish them by rewriting data_end. */
+static void commit_locked() {
+    TileCacheHeader hdr;
+
+    if ((tc.io == NULL) || (tc.uncommitted == 0)) {
+        return;
+    }
+
+    SDL_FlushIO(tc.io);
+
+    hdr.magic = TC_MAGIC;
+    hdr.version = TC_VERSION;
+    hdr.afs_hash = tc.afs_hash;
+    hdr.data_end = tc.data_end;
+    hdr.reserved = 0;
+
+    SDL_SeekIO(tc.io, 0, SDL_IO_SEEK_SET);
+    SDL_WriteIO(tc.io, &hdr, sizeof(hdr));
+    SDL_FlushIO(tc.io);
+    tc.uncommitted = 0;
+}
+
+/**
+ * @brief Open or create the cache file.
+ *
+ * @param path      Cache file location
+ * @param afs_hash  AFS_GetArchiveHash() of the mounted archive
+ * @return true if the cache is usable
+ */
+bool TileCache_Init(const char* path, uint64_t afs_hash) {
+    TileCacheHeader hdr;
+    bool reuse = false;
+
+    if (tc.lock != NULL) {
+        return true;
+    }
+
+    tc.afs_hash = afs_hash;
+    tc.lock = SDL_CreateMutex();
+
+    if ((tc.lock == NULL) || !index_grow()) {
+        TileCache_Finish();
+        return false;
+    }
+
+    if (map_file(path)) {
+        reuse = load_mapped();
+
+        if (!reuse) {
+            SDL_Log("[tile_cache] %s is stale, rebuilding", path);
+            unmap_file();
+            SDL_memset(tc.index, 0, tc.index_cap * sizeof(TileCacheEntry));
+            tc.index_count = 0;
+        }
+    }
+
+    if (reuse) {
+        tc.io = SDL_IOFromFile(path, "r+b");
+    } else {
+        tc.data_end = sizeof(TileCacheHeader);
+        tc.io = SDL_IOFromFile(path, "w+b");
+
+        if (tc.io != NULL) {
+            SDL_zero(hdr);
+            hdr.magic = TC_MAGIC;
+            hdr.version = TC_VERSION;
+            hdr.afs_hash = afs_hash;
+            hdr.data_end = tc.data_end;
+            SDL_WriteIO(tc.io, &hdr, sizeof(hdr));
+        }
+    }
+
+    if (tc.io == NULL) {
+        SDL_Log("[tile_cache] cannot open %s: %s", path, SDL_GetError());
+        TileCache_Finish();
+        return false;
+    }
+
+    SDL_SeekIO(tc.io, (Sint64)tc.data_end, SDL_IO_SEEK_SET);
+    SDL_Log("[tile_cache] %s: %u tile(s) mapped", path, tc.index_count);
+    return true;
+}
+
+/** @brief Commit pending records and release the mapping. */
+void TileCache_Finish() {
+    if (tc.lock != NULL) {
+        SDL_LockMutex(tc.lock);
+    }
+
+    if (tc.io != NULL) {
+        commit_locked();
+        SDL_CloseIO(tc.io);
+    }
+
+    if (tc.lock != NULL) {
+        SDL_Log("[tile_cache] session: %u hit(s), %u miss(es), %u stored", tc.hits, tc.misses, tc.stored);
+    }
+
+    unmap_file();
+    SDL_free(tc.index);
+
+    if (tc.lock != NULL) {
+        SDL_UnlockMutex(tc.lock);
+        SDL_DestroyMutex(tc.lock);
+    }
+
+    SDL_zero(tc);
+}
+
+bool TileCache_IsEnabled() {
+    return tc.lock != NULL;
+}
+
+/**
+ * @brief Register a loaded AFS file so tiles decoded from it can be keyed.
+ *
+ * Hashes the file contents; must be called once the load has completed.
+ */
+void TileCache_BindFile(int file_num, const void* base, unsigned int size) {
+    TileCacheRange* r;
+    Uint64 file_hash;
+    int i;
+
+    if ((tc.lock == NULL) || (base == NULL) || (size == 0)) {
+        return;
+    }
+
+    file_hash = TileCache_Hash(base, size, (Uint64)file_num);
+    SDL_LockMutex(tc.lock);
+
+    // Drop any stale range the new file was loaded over.
+    for (i = 0; i < tc.num_ranges;) {
+        r = &tc.ranges[i];
+
+        if ((r->base < (const Uint8*)base + size) && ((const Uint8*)base < r->base + r->size)) {
+            *r = tc.ranges[--tc.num_ranges];
+        } else {
+            i++;
+        }
+    }
+
+    if (tc.num_ranges < TC_MAX_RANGES) {
+        r = &tc.ranges[tc.num_ranges++];
+    } else {
+        // Full: the oldest file is the least likely to still be drawn
+        r = &tc.ranges[0];
+
+        for (i = 1; i < tc.num_ranges; i++) {
+            if (tc.ranges[i].bound < r->bound) {
+                r = &tc.ranges[i];
+            }
+        }
+
+        if (!tc.ranges_overflowed) {
+            SDL_Log("[tile_cache] more than %d files bound, uncaching the oldest", TC_MAX_RANGES);
+            tc.ranges_overflowed = true;
+        }
+    }
+
+    r->base = (const Uint8*)base;
+    r->size = size;
+    r->file_num = file_num;
+    r->file_hash = file_hash;
+    r->bound = ++tc.bind_clock;
+
+    SDL_UnlockMutex(tc.lock);
+}
+
+/** @brief Forget a file registered with TileCache_BindFile() (its memory is being released). */
+void TileCache_UnbindFile(const void* base) {
+    int i;
+
+    if (tc.lock == NULL) {
+        return;
+    }
+
+    SDL_LockMutex(tc.lock);
+
+    for (i = 0; i < tc.num_ranges; i++) {
+        if (tc.ranges[i].base == base) {
+            tc.ranges[i] = tc.ranges[--tc.num_ranges];
+            break;
+        }
+    }
+
+    SDL_UnlockMutex(tc.lock);
+}
+
+static const TileCacheRange* find_range(const Uint8* src) {
+    int i;
+
+    for (i = 0; i < tc.num_ranges; i++) {
+        const TileCacheRange* r = &tc.ranges[i];
+
+        if ((src >= r->base) && (src < r->base + r->size)) {
+            return r;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find the decoded bytes for a compressed tile.
+ *
+ * @return Pointer into the mapped cache (valid until TileCache_Finish()),
+ *         or NULL on a miss
+ */
+const void* TileCache_Lookup(const void* src, unsigned int size) {
+    const TileCacheRange* r;
+    TileCacheEntry* e;
+    const Uint8* data = NULL;
+
+    if ((tc.map == NULL) || (size > TC_MAX_TILE_BYTES)) {
+        return NULL;
+    }
+
+    SDL_LockMutex(tc.lock);
+    r = find_range((const Uint8*)src);
+
+    if (r != NULL) {
+        e = index_find(r->file_hash, r->file_num, (Uint32)((const Uint8*)src - r->base), size);
+
+        if (e->state == TC_MAPPED) {
+            const TileCacheRecord* rec = (const TileCacheRecord*)(tc.map + e->pos);
+
+            e->state = ((Uint32)TileCache_Hash(rec + 1, size, 0) == rec->check) ? TC_VERIFIED : TC_BAD;
+        }
+
+        if (e->state == TC_VERIFIED) {
+            data = tc.map + e->pos + sizeof(TileCacheRecord);
+        }
+    }
+
+    if (data != NULL) {
+        tc.hits++;
+    } else {
+        tc.misses++;
+    }
+
+    SDL_UnlockMutex(tc.lock);
+    return data;
+}
+
+/** @brief Append a freshly decoded tile to the cache file. */
+void TileCache_Store(const void* src, unsigned int size, const void* data) {
+    static const Uint8 zero_pad[TC_ALIGN] = { 0 };
+    const TileCacheRange* r;
+    TileCacheEntry* e;
+    TileCacheRecord rec;
+    Uint32 pad;
+
+    if ((tc.io == NULL) || (size == 0) || (size > TC_MAX_TILE_BYTES)) {
+        return;
+    }
+
+    SDL_LockMutex(tc.lock);
+    r = find_range((const Uint8*)src);
+
+    if ((r == NULL) || (tc.data_end + record_span(size) > TC_MAX_FILE_BYTES)) {
+        SDL_UnlockMutex(tc.lock);
+        return;
+    }
+
+    SDL_zero(rec);
+    rec.tag = TC_RECORD_TAG;
+    rec.file_num = (Uint16)r->file_num;
+    rec.size = (Uint16)size;
+    rec.offset = (Uint32)((const Uint8*)src - r->base);
+    rec.check = (Uint32)TileCache_Hash(data, size, 0);
+    rec.file_hash = r->file_hash;
+
+    e = index_find(rec.file_hash, rec.file_num, rec.offset, size);
+
+    // Already stored (or stored but corrupt — keep the index stable either way).
+    if ((e->state != TC_EMPTY) && (e->state != TC_BAD)) {
+        SDL_UnlockMutex(tc.lock);
+        return;
+    }
+
+    pad = record_span(size) - sizeof(TileCacheRecord) - size;
+    SDL_SeekIO(tc.io, (Sint64)tc.data_end, SDL_IO_SEEK_SET);
+
+    if ((SDL_WriteIO(tc.io, &rec, sizeof(rec)) != sizeof(rec)) || (SDL_WriteIO(tc.io, data, size) != size) ||
+        (SDL_WriteIO(tc.io, zero_pad, pad) != pad)) {
+        // Disk full or read-only: stop appending, keep serving mapped tiles.
+        SDL_Log("[tile_cache] write failed, disabling store: %s", SDL_GetError());
+        SDL_CloseIO(tc.io);
+        tc.io = NULL;
+        SDL_UnlockMutex(tc.lock);
+        return;
+    }
+
+    index_insert(&rec, 0, TC_PENDING);
+    tc.data_end += record_span(size);
+    tc.stored++;
+
+    if (++tc.uncommitted >= TC_COMMIT_INTERVAL) {
+        commit_locked();
+    }
+
+    SDL_UnlockMutex(tc.lock);
+}
@@ -0,0 +1,33 @@
+/**
+ * @file tile_cache.h
+ * @brief Persistent memory-mapped cache of decoded sprite tiles.
+ *
+ * Decoded tiles are appended to a cache file as they are first
+ * decompressed and mapped read-only on the next boot, so tiles seen in
+ * earlier sessions skip LZ77 decoding entirely.
+ *
+ * Tiles are keyed by (AFS file, chunk offset, decoded size) plus a hash
+ * of the loaded file contents. Compressed sources are resolved to that
+ * key through the address ranges registered with TileCache_BindFile().
+ * The whole cache is discarded when the AFS table of contents hash
+ * recorded in its header no longer matches.
+ */
+#ifndef PORT_IO_TILE_CACHE_H
+#define PORT_IO_TILE_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+bool TileCache_Init(const char* path, uint64_t afs_hash);
+void TileCache_Finish();
+bool TileCache_IsEnabled();
+
+void TileCache_BindFile(int file_num, const void* base, unsigned int size);
+void TileCache_UnbindFile(const void* base);
+
+const void* TileCache_Lookup(const void* src, unsigned int size);
+void TileCache_Store(const void* src, unsigned int size, const void* data);
+
+uint64_t TileCache_Hash(const void* data, unsigned int size, uint64_t seed);
+
+#endif
@@ -0,0 +1,145 @@
+/**
+ * @file load_bench.c
+ * @brief Load benchmark (--bench-loads): every character and stage load set, timed.
+ */
+#include "port/load_bench.h"
+#include "port/io/afs.h"
+#include "port/io/load_trace.h"
+#include "sf33rd/Source/Game/io/gd3rd.h"
+#include "sf33rd/Source/Game/system/ramcnt.h"
+
+#include <SDL3/SDL.h>
+
+#define LOAD_BENCH_TIMEOUT_NS (10 * SDL_NS_PER_SECOND)
+#define LOAD_BENCH_MAX_ASSETS 512
+
+typedef void (*LoadBenchPush)(s16 ix);
+
+static void push_player(s16 ix) {
+    Push_LDREQ_Queue_Player(0, ix);
+}
+
+static void push_bg(s16 ix) {
+    Push_LDREQ_Queue_BG(ix);
+}
+
+static double ms(Uint64 ns) {
+    return ns / 1e6;
+}
+
+/** @brief Release every key the set pulled (which also purges its texture groups). */
+static void release_new_keys(const bool* in_use) {
+    for (s16 key = 1; key < RCKEY_WORK_MAX; key++) {
+        if (rckey_work[key].use && !in_use[key]) {
+            Push_ramcnt_key_original_2(key);
+        }
+    }
+}
+
+/** @brief Load one set and wait for the queue to drain; returns its wall time, or 0 on timeout. */
+static Uint64 run_set(const char* kind, s16 ix, LoadBenchPush push) {
+    bool in_use[RCKEY_WORK_MAX];
+    Uint64 begin;
+    Uint64 elapsed;
+
+    for (s16 key = 0; key < RCKEY_WORK_MAX; key++) {
+        in_use[key] = rckey_work[key].use;
+    }
+
+    begin = SDL_GetTicksNS();
+    push(ix);
+
+    // Poll as fast as possible: frame pacing would only add up to a frame per request
+    while (!Check_LDREQ_Clear()) {
+        AFS_RunServer();
+        Check_LDREQ_Queue();
+
+        if (SDL_GetTicksNS() - begin > LOAD_BENCH_TIMEOUT_NS) {
+            // Cancelled reads may still land in their buffers, so the set's keys are left allocated
+            Request_LDREQ_Break();
+            Check_LDREQ_Queue();
+            SDL_Log("Load bench: %s %2d timed out", kind, ix);
+            return 0;
+        }
+    }
+
+    elapsed = SDL_GetTicksNS() - begin;
+    release_new_keys(in_use);
+    SDL_Log("Load bench: %s %2d  %8.3f ms", kind, ix, ms(elapsed));
+    return elapsed;
+}
+
+static void print_assets() {
+    LoadTraceAsset* assets = SDL_malloc(LOAD_BENCH_MAX_ASSETS * sizeof(LoadTraceAsset));
+    int count;
+
+    if (assets == NULL) {
+        return;
+    }
+
+    count = LoadTrace_Summarize(assets, LOAD_BENCH_MAX_ASSETS);
+    SDL_Log("Load bench: %-24s %10s %10s %10s %10s %10s %5s",
+            "asset",
+            "io-wait",
+            "decompress",
+            "convert",
+            "alloc",
+            "request",
+            "loads");
+
+    for (int i = 0; i < count; i++) {
+        const LoadTraceAsset* asset = &assets[i];
+
+        SDL_Log("Load bench: %-24s %10.3f %10.3f %10.3f %10.3f %10.3f %5d",
+                (asset->name[0] != '\0') ? asset->name : "(untagged)",
+                ms(asset->ns[LOAD_TRACE_IO_WAIT]),
+                ms(asset->ns[LOAD_TRACE_DECOMPRESS]),
+                ms(asset->ns[LOAD_TRACE_CONVERT]),
+                ms(asset->ns[LOAD_TRACE_ALLOC]),
+                ms(asset->ns[LOAD_TRACE_REQUEST]),
+                asset->count[LOAD_TRACE_REQUEST]);
+    }
+
+    if (LoadTrace_GetDropped() > 0) {
+        SDL_Log("Load bench: %d early trace events were dropped", LoadTrace_GetDropped());
+    }
+
+    SDL_free(assets);
+}
+
+bool LoadBench_Run() {
+    Uint64 total = 0;
+    Uint64 elapsed;
+    int failed = 0;
+
+    // A trace already running (--load-trace) keeps its earlier events
+    if (!LoadTrace_IsActive() && !LoadTrace_Start(0)) {
+        SDL_Log("Load bench: can't allocate the load trace");
+        return false;
+    }
+
+    Init_Load_Request_Queue_1st();
+    SDL_Log("Load bench: %d character and %d stage sets, %s AFS",
+            LDREQ_PLAYER_SETS,
+            LDREQ_BG_SETS,
+            AFS_IsMemoryMapped() ? "mapped" : "preloaded");
+
+    for (s16 ix = 0; ix < LDREQ_PLAYER_SETS; ix++) {
+        elapsed = run_set("character", ix, push_player);
+        total += elapsed;
+        failed += (elapsed == 0);
+    }
+
+    for (s16 ix = 0; ix < LDREQ_BG_SETS; ix++) {
+        elapsed = run_set("stage", ix, push_bg);
+        total += elapsed;
+        failed += (elapsed == 0);
+    }
+
+    print_assets();
+    SDL_Log("Load bench: total %.3f ms over %d sets%s",
+            ms(total),
+            LDREQ_PLAYER_SETS + LDREQ_BG_SETS - failed,
+            (failed > 0) ? " (some timed out)" : "");
+    return failed == 0;
+}
@@ -3,15 +3,20 @@
  * @brief Debug HUD implementation: FPS measurement, history, and on-screen overlay.
  *
  * Contains the frame-end-time ring buffer, rolling FPS computation, unbounded
- * FPS history buffer, and text rendering for the debug HUD on all backends.
+ * FPS history buffer, and text rendering for the debug HUD on all backends,
+ * including the simulation profile table when one is selected (PgUp/PgDn).
  */
 #include "port/sdl/app/sdl_app_debug_hud.h"
 
 #include "port/config/config.h"
+#include "port/heap_report.h"
+#include "port/io/afs.h"
 #include "port/rendering/sdl_bezel.h"
+#include "port/sim_profile.h"
 #include "port/sdl/app/sdl_app.h"
 #include "port/sdl/app/sdl_app_scale.h"
 #include "port/sdl/app/sdl_app_shader_config.h"
+#include "port/sdl/renderer/sdl_game_renderer.h"
 #include "port/sdl/renderer/sdl_text_renderer.h"
 
 #include <SDL3/SDL.h>
@@ -37,6 +42,22 @@ static int fps_history_capacity = 0;
 
 bool show_debug_hud = false;
 
+/* ── Simulation profile table ───────────────────────────────────────── */
+
+#define SIM_PROFILE_HUD_LINES 13
+
+/** @brief Draw the selected simulation profile table, one line per row, starting at @p y. */
+static void draw_sim_profile(float x, float y, float scale, int win_w, int win_h) {
+    char lines[SIM_PROFILE_HUD_LINES][SIM_PROFILE_LINE_LENGTH];
+    const int count = SimProfile_FormatOverlay(lines, SIM_PROFILE_HUD_LINES);
+
+    for (int i = 0; i < count; i++) {
+        SDLTextRenderer_DrawText(lines[i], x + 1, y + 1, scale, 0.0f, 0.0f, 0.0f, (float)win_w, (float)win_h);
+        SDLTextRenderer_DrawText(lines[i], x, y, scale, 1.0f, 1.0f, 1.0f, (float)win_w, (float)win_h);
+        y += 10.0f * scale;
+    }
+}
+
 /* ── Public API ─────────────────────────────────────────────────────── */
 
 void SDLAppDebugHud_NoteFrameEnd(void) {
@@ -78,9 +99,26 @@ void SDLAppDebugHud_Render(int win_w, int win_h, const SDL_FRect* viewport) {
     char fps_text[64];
     char mode_text[128];
     char shader_text[128];
+    char draw_text[64];
+    char afs_text[64];
+    char heap_text[256];
 
     snprintf(fps_text, sizeof(fps_text), "FPS: %.2f%s", fps, SDLApp_IsFrameRateUncapped() ? " UNCAPPED [F5]" : "");
 
+    SDLGameRenderer_DrawStats draw_stats;
+    SDLGameRenderer_GetDrawStats(&draw_stats);
+    snprintf(draw_text, sizeof(draw_text), "Draws: %d/%d quads", draw_stats.draw_calls, draw_stats.tasks);
+
+    AFSPreloadStats afs_stats;
+    AFS_GetPreloadStats(&afs_stats);
+    snprintf(afs_text,
+             sizeof(afs_text),
+             "AFS: %d/%d (%d hit, %d miss)",
+             afs_stats.loaded,
+             afs_stats.total,
+             afs_stats.hits,
+             afs_stats.misses);
+
     if (SDLAppShader_IsLibretroMode()) {
         if (SDLAppShader_GetAvailableCount() > 0) {
             snprintf(mode_text,
@@ -103,7 +141,14 @@ void SDLAppDebugHud_Render(int win_w, int win_h, const SDL_FRect* viewport) {
              "Shader Mode: %s [F4]",
              SDLAppShader_IsLibretroMode() ? "Libretro" : "Internal");
 
-    snprintf(debug_text, sizeof(debug_text), "%s | %s | %s", fps_text, shader_text, mode_text);
+    snprintf(debug_text,
+             sizeof(debug_text),
+             "%s | %s | %s | %s | %s",
+             fps_text,
+             draw_text,
+             afs_text,
+             shader_text,
+             mode_text);
 
     float overlay_scale = ((float)win_h / 480.0f) * 0.8f;
     float base_x = viewport->x + (10.0f * overlay_scale);
@@ -115,12 +160,23 @@ void SDLAppDebugHud_Render(int win_w, int win_h, const SDL_FRect* viewport) {
     SDLTextRenderer_DrawText(debug_text, base_x + 1, base_y + 1, overlay_scale, 0.0f, 0.0f, 0.0f, win_w, win_h);
     SDLTextRenderer_DrawText(debug_text, base_x, base_y, overlay_scale, 1.0f, 1.0f, 1.0f, win_w, win_h);
 
+    // Second line: game heap usage and fragmentation
+    HeapReport_FormatOverlay(heap_text, sizeof(heap_text));
+    base_y += 10.0f * overlay_scale;
+    SDLTextRenderer_DrawText(heap_text, base_x + 1, base_y + 1, overlay_scale, 0.0f, 0.0f, 0.0f, win_w, win_h);
+    SDLTextRenderer_DrawText(heap_text, base_x, base_y, overlay_scale, 1.0f, 1.0f, 1.0f, win_w, win_h);
+
+    // Then the simulation profile table, if one is selected
+    draw_sim_profile(base_x, base_y + 10.0f * overlay_scale, overlay_scale, win_w, win_h);
+
     SDLTextRenderer_SetBackgroundEnabled(0);
 }
 
 void SDLAppDebugHud_RenderSDL2D(int win_w, int win_h, const SDL_FRect* dst_rect) {
     char debug_text[64];
-    snprintf(debug_text, sizeof(debug_text), "FPS: %.2f", fps);
+    SDLGameRenderer_DrawStats draw_stats;
+    SDLGameRenderer_GetDrawStats(&draw_stats);
+    snprintf(debug_text, sizeof(debug_text), "FPS: %.2f | Draws: %d/%d", fps, draw_stats.draw_calls, draw_stats.tasks);
     float overlay_scale = (float)win_h / 480.0f;
     float base_x = dst_rect->x + (10.0f * overlay_scale);
     float base_y = dst_rect->y + (2.0f * overlay_scale);
@@ -136,6 +192,7 @@ void SDLAppDebugHud_RenderSDL2D(int win_w, int win_h, const SDL_FRect* dst_rect)
         debug_text, base_x, base_y + 1, overlay_scale, 0.0f, 0.0f, 0.0f, (float)win_w, (float)win_h);
 
     SDLTextRenderer_DrawText(debug_text, base_x, base_y, overlay_scale, 1.0f, 1.0f, 1.0f, (float)win_w, (float)win_h);
+    draw_sim_profile(base_x, base_y + 10.0f * overlay_scale, overlay_scale, win_w, win_h);
     SDLTextRenderer_Flush();
 }
 
@@ -159,3 +216,15 @@ void SDLAppDebugHud_Toggle(void) {
     Config_SetBool(CFG_KEY_DEBUG_HUD, show_debug_hud);
     SDL_Log("Debug HUD %s", show_debug_hud ? "ON" : "OFF");
 }
+
+void SDLAppDebugHud_HandleKey(const SDL_KeyboardEvent* event) {
+    if (!show_debug_hud || !event->down || event->repeat) {
+        return;
+    }
+
+    if (event->key == SDLK_PAGEUP) {
+        SimProfile_CycleView();
+    } else if (event->key == SDLK_PAGEDOWN) {
+        SimProfile_CycleSort();
+    }
+}
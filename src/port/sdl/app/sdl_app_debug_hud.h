@@ -4,7 +4,8 @@
  *
  * Provides frame-time measurement, rolling FPS computation, an unbounded FPS
  * history buffer (for netplay graphs), and text-based debug overlay rendering
- * on GL, GPU, and SDL2D backends.
+ * on GL, GPU, and SDL2D backends. While the HUD is visible, PgUp and PgDn
+ * pick and sort a simulation profile table (see sim_profile.h) below it.
  */
 #ifndef SDL_APP_DEBUG_HUD_H
 #define SDL_APP_DEBUG_HUD_H
@@ -51,6 +52,9 @@ bool SDLAppDebugHud_IsVisible(void);
 /** @brief Toggle debug HUD visibility and persist to config. */
 void SDLAppDebugHud_Toggle(void);
 
+/** @brief Handle the HUD's own keys (PgUp/PgDn for the simulation profile) while it is visible. */
+void SDLAppDebugHud_HandleKey(const SDL_KeyboardEvent* event);
+
 #ifdef __cplusplus
 }
 #endif
@@ -13,6 +13,7 @@
 #include "port/rendering/sdl_bezel.h"
 #include "port/sdl/app/sdl_app.h"
 #include "port/sdl/app/sdl_app_config.h"
+#include "port/sdl/app/sdl_app_debug_hud.h"
 #include "port/sdl/app/sdl_app_internal.h"
 #include "port/sdl/app/sdl_app_shader_config.h"
 #include "port/sdl/input/control_mapping.h"
@@ -104,6 +105,7 @@ bool SDLAppInput_HandleEvent(SDL_Event* event) {
             set_screenshot_flag_if_needed(&event->key);
             handle_fullscreen_toggle(&event->key);
             handle_scale_mode_toggle(&event->key);
+            SDLAppDebugHud_HandleKey(&event->key);
             // handle_texture_dump(&event->key); // F12 reserved for RmlUi native debugger
 
             if (event->key.key == SDLK_F7 && event->key.down && !event->key.repeat) {
@@ -169,6 +171,7 @@ bool SDLAppInput_HandleEvent(SDL_Event* event) {
             set_screenshot_flag_if_needed(&event->key);
             handle_fullscreen_toggle(&event->key);
             handle_scale_mode_toggle(&event->key);
+            SDLAppDebugHud_HandleKey(&event->key);
             handle_texture_dump(&event->key);
 
             if (event->key.key == SDLK_F7 && event->key.down && !event->key.repeat) {
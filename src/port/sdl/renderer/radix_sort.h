@@ -9,10 +9,15 @@
  * Usage:
  *   Provide arrays of z-values (float) and scratch space. The function
  *   writes the sorted permutation into the output order[] array.
+ *
+ * Also provides a 64-bit state sort key (z | blend | texture | palette)
+ * and a matching LSD radix sort, so backends can order tasks by depth and
+ * group equal-depth tasks by GPU state in a single pass.
  */
 #ifndef RADIX_SORT_H
 #define RADIX_SORT_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -116,4 +121,147 @@ static inline void radix_sort_render_task_indices(int* order, const float* z_val
      * So after pass 3, src == order. ✓ */
 }
 
+/* ─── 64-bit state sort key ──────────────────────────────────────────── */
+
+/**
+ * Key layout (most significant first):
+ *
+ *   [63..32] sortable z        — painter's order, never reordered across z
+ *   [31..30] blend mode        — RENDER_SORT_BLEND_*
+ *   [29..14] texture / layer   — backend-defined 16-bit texture identity
+ *   [13..0]  palette slot
+ *
+ * The low 32 bits only pull tasks that share GPU state next to each other
+ * within one z value. Ties on the full key keep submission order. Equal-z
+ * tasks that overlap on screen still depend on submission order, so callers
+ * run render_sort_restore_overlaps() after the sort.
+ */
+#define RENDER_SORT_BLEND_ALPHA 0u
+#define RENDER_SORT_TEXTURE_MASK 0xFFFFu
+#define RENDER_SORT_PALETTE_MASK 0x3FFFu
+
+static inline uint64_t render_sort_key(float z, unsigned int blend, unsigned int texture, unsigned int palette) {
+    const uint32_t state = ((uint32_t)(blend & 0x3u) << 30) | ((uint32_t)(texture & RENDER_SORT_TEXTURE_MASK) << 14) |
+                           (uint32_t)(palette & RENDER_SORT_PALETTE_MASK);
+    return ((uint64_t)radix_float_to_sortable(z) << 32) | state;
+}
+
+/**
+ * Stable ascending radix sort of task indices by 64-bit key.
+ *
+ * Sorts `order[0..count-1]` such that `keys[order[i]]` is non-decreasing;
+ * equal keys keep ascending submission index. 8-bit LSD passes whose digit
+ * is identical for every key are skipped, so a frame whose tasks all share
+ * one palette or one blend mode only pays for the bytes that differ.
+ *
+ * @param order    Output: sorted index permutation (must hold `count` ints)
+ * @param keys     Input: sort key per task (indexed by task index)
+ * @param count    Number of tasks to sort
+ * @param scratch  Scratch: int[count] for intermediate permutation
+ */
+static inline void radix_sort_indices_by_key64(int* order, const uint64_t* keys, int count, int* scratch) {
+    for (int i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    if (count <= 1)
+        return;
+
+    /* Bits that differ between any two keys — passes outside this mask are no-ops */
+    uint64_t all_and = ~(uint64_t)0;
+    uint64_t all_or = 0;
+    for (int i = 0; i < count; i++) {
+        all_and &= keys[i];
+        all_or |= keys[i];
+    }
+    const uint64_t varying = all_and ^ all_or;
+
+    int* src = order;
+    int* dst = scratch;
+
+    for (int pass = 0; pass < 8; pass++) {
+        const int shift = pass * 8;
+        if (((varying >> shift) & 0xFF) == 0)
+            continue;
+
+        int counts[256] = { 0 };
+        for (int i = 0; i < count; i++) {
+            counts[(keys[src[i]] >> shift) & 0xFF]++;
+        }
+
+        int offsets[256];
+        offsets[0] = 0;
+        for (int i = 1; i < 256; i++) {
+            offsets[i] = offsets[i - 1] + counts[i - 1];
+        }
+
+        for (int i = 0; i < count; i++) {
+            const uint32_t digit = (uint32_t)(keys[src[i]] >> shift) & 0xFF;
+            dst[offsets[digit]++] = src[i];
+        }
+
+        int* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    /* Odd number of executed passes leaves the result in scratch */
+    if (src != order) {
+        memcpy(order, src, (size_t)count * sizeof(int));
+    }
+}
+
+/* Equal-z groups longer than this keep submission order without an overlap scan */
+#define RENDER_SORT_OVERLAP_CHECK_MAX 128
+
+/**
+ * Undo state grouping inside equal-z runs where it would break painter's order.
+ *
+ * For every run of equal z in a key-sorted `order`, checks whether any pair of
+ * tasks that changed relative order also overlaps on screen. If so (or if the
+ * run is too long to check cheaply) the run is put back into submission order.
+ * Non-overlapping runs — tile rows, HUD glyphs — keep their state grouping.
+ *
+ * @param order   In/out: permutation produced by radix_sort_indices_by_key64()
+ * @param keys    Sort key per task (indexed by task index)
+ * @param bounds  Screen bounds per task: bounds[i * 4 + 0..3] = x0, y0, x1, y1
+ * @param count   Number of tasks
+ */
+static inline void render_sort_restore_overlaps(int* order, const uint64_t* keys, const float* bounds, int count) {
+    int run_start = 0;
+    while (run_start < count) {
+        const uint32_t z = (uint32_t)(keys[order[run_start]] >> 32);
+        int run_end = run_start + 1;
+        while (run_end < count && (uint32_t)(keys[order[run_end]] >> 32) == z)
+            run_end++;
+
+        const int run_len = run_end - run_start;
+        bool conflict = run_len > RENDER_SORT_OVERLAP_CHECK_MAX;
+        for (int i = run_start; i < run_end && !conflict; i++) {
+            const float* a = &bounds[order[i] * 4];
+            for (int j = i + 1; j < run_end; j++) {
+                if (order[i] < order[j])
+                    continue; // relative order unchanged
+                const float* b = &bounds[order[j] * 4];
+                if (a[0] < b[2] && b[0] < a[2] && a[1] < b[3] && b[1] < a[3]) {
+                    conflict = true;
+                    break;
+                }
+            }
+        }
+
+        if (conflict) {
+            for (int i = run_start + 1; i < run_end; i++) {
+                const int key = order[i];
+                int j = i - 1;
+                while (j >= run_start && order[j] > key) {
+                    order[j + 1] = order[j];
+                    j--;
+                }
+                order[j + 1] = key;
+            }
+        }
+        run_start = run_end;
+    }
+}
+
 #endif /* RADIX_SORT_H */
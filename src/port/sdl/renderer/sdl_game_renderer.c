@@ -80,6 +80,29 @@ void SDLGameRenderer_ResetBatchState() {
     // unlikely with their simpler stacks.  Add stubs if needed.
 }
 
+void SDLGameRenderer_GetDrawStats(SDLGameRenderer_DrawStats* out) {
+    RendererBackend r = SDLApp_GetRenderer();
+    if (r == RENDERER_SDLGPU) {
+        SDLGameRendererGPU_GetDrawStats(out);
+    } else if (r == RENDERER_SDL2D_CLASSIC) {
+        // Classic is the unoptimized reference path — no stats
+        out->tasks = 0;
+        out->draw_calls = 0;
+    } else if (r == RENDERER_SDL2D) {
+        SDLGameRendererSDL_GetDrawStats(out);
+    } else {
+        SDLGameRendererGL_GetDrawStats(out);
+    }
+}
+
+void SDLGameRenderer_BenchmarkSprite2(int chips) {
+    if (SDLApp_GetRenderer() != RENDERER_SDL2D) {
+        SDL_Log("--bench-sprite2 requires the SDL2D backend (--renderer sdl)");
+        return;
+    }
+    SDLGameRendererSDL_BenchmarkSprite2(chips);
+}
+
 void SDLGameRenderer_CreateTexture(unsigned int th) {
     RendererBackend r = SDLApp_GetRenderer();
     if (r == RENDERER_SDLGPU) {
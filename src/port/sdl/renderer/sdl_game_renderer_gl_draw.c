@@ -9,6 +9,7 @@
 #include "port/mods/modded_stage.h"
 #include "port/sdl/app/sdl_app.h"
 #include "port/sdl/app/sdl_app_config.h"
+#include "port/sdl/renderer/radix_sort.h"
 #include "port/sdl/renderer/sdl_game_renderer_gl_internal.h"
 #include "port/tracy_gpu.h"
 #include "port/tracy_zones.h"
@@ -19,6 +20,21 @@
 
 // --- Render Task Management ---
 
+/**
+ * @brief Map a task's GL binding to the 16-bit texture field of its sort key.
+ *
+ * Array tasks (R8UI and RGBA layers) share one draw regardless of layer, so
+ * they keep bit 15 clear and sort ahead of legacy tasks within a z value.
+ * Legacy tasks need one glBindTexture per run, so they are keyed by name.
+ */
+static inline unsigned int gl_sort_texture_id(GLuint texture, int array_layer) {
+    if (array_layer >= 0)
+        return (unsigned int)array_layer;
+    if (array_layer <= -2)
+        return 0x4000u | (unsigned int)(-(array_layer + 2));
+    return 0x8000u | (texture & 0x7FFFu);
+}
+
 static void push_render_task(GLuint texture, const SDL_Vertex* vertices, float z, int array_layer, int pal_slot) {
     if (gl_state.render_task_count >= RENDER_TASK_MAX) {
         SDL_Log("Warning: render task buffer full, skipping task");
@@ -40,6 +56,8 @@ static void push_render_task(GLuint texture, const SDL_Vertex* vertices, float z
     task->index = gl_state.render_task_count;
     task->array_layer = array_layer;
     task->palette_slot = pal_slot;
+    gl_state.sort_keys[gl_state.render_task_count] =
+        render_sort_key(z, RENDER_SORT_BLEND_ALPHA, gl_sort_texture_id(texture, array_layer), (unsigned int)pal_slot);
 
     gl_state.render_task_count++;
 }
@@ -49,59 +67,34 @@ static void clear_render_tasks(void) {
 }
 
 /**
- * ⚡ Bolt: Ping-pong merge sort — eliminates per-pass memcpy.
- *
- * Instead of merging into merge_temp and copying back every pass, we
- * alternate source/destination buffers each pass.  Only one final memcpy
- * is needed if the result lands in merge_temp.
+ * ⚡ Bolt: State-keyed radix sort — one 64-bit key per task.
  *
- * Impact: ~hundreds of render tasks per frame, each 28 bytes.
- * Saves O(n × log n) bytes of memcpy per frame.
+ * Keys pack z (painter's order) above blend/texture/palette, so a single
+ * stable O(n) sort both orders by depth and clusters equal-z tasks that can
+ * share a draw. Equal-z runs whose regrouping would swap overlapping quads are
+ * put back into submission order, matching the old z-only merge sort.
  */
-static void stable_sort_render_tasks(void) {
+static void sort_render_tasks(void) {
     const int n = gl_state.render_task_count;
     if (n <= 1)
         return;
 
-    RenderTask* src = gl_state.render_tasks;
-    RenderTask* dst = gl_state.merge_temp;
-
-    for (int width = 1; width < n; width *= 2) {
-        for (int left = 0; left < n; left += 2 * width) {
-            const int mid = left + width;
-            int right = left + 2 * width;
-            if (mid >= n) {
-                /* Left run covers rest — copy tail unchanged */
-                memcpy(&dst[left], &src[left], (size_t)(n - left) * sizeof(RenderTask));
-                break;
-            }
-            if (right > n)
-                right = n;
-
-            int i = left, j = mid, k = left;
-            while (i < mid && j < right) {
-                if (src[i].z <= src[j].z) {
-                    dst[k++] = src[i++];
-                } else {
-                    dst[k++] = src[j++];
-                }
-            }
-            while (i < mid)
-                dst[k++] = src[i++];
-            while (j < right)
-                dst[k++] = src[j++];
-        }
+    radix_sort_indices_by_key64(gl_state.sort_order, gl_state.sort_keys, n, gl_state.sort_scratch);
 
-        /* Swap source and destination for next pass */
-        RenderTask* tmp = src;
-        src = dst;
-        dst = tmp;
+    for (int i = 0; i < n; i++) {
+        const SDL_Vertex* v = &gl_state.batch_vertices[gl_state.render_tasks[i].vertex_offset];
+        float* b = &gl_state.sort_bounds[i * 4];
+        b[0] = SDL_min(SDL_min(v[0].position.x, v[1].position.x), SDL_min(v[2].position.x, v[3].position.x));
+        b[1] = SDL_min(SDL_min(v[0].position.y, v[1].position.y), SDL_min(v[2].position.y, v[3].position.y));
+        b[2] = SDL_max(SDL_max(v[0].position.x, v[1].position.x), SDL_max(v[2].position.x, v[3].position.x));
+        b[3] = SDL_max(SDL_max(v[0].position.y, v[1].position.y), SDL_max(v[2].position.y, v[3].position.y));
     }
+    render_sort_restore_overlaps(gl_state.sort_order, gl_state.sort_keys, gl_state.sort_bounds, n);
 
-    /* If the sorted result ended up in merge_temp, copy back */
-    if (src != gl_state.render_tasks) {
-        memcpy(gl_state.render_tasks, gl_state.merge_temp, (size_t)n * sizeof(RenderTask));
+    for (int i = 0; i < n; i++) {
+        gl_state.merge_temp[i] = gl_state.render_tasks[gl_state.sort_order[i]];
     }
+    memcpy(gl_state.render_tasks, gl_state.merge_temp, (size_t)n * sizeof(RenderTask));
 }
 
 // --- Frame ---
@@ -143,12 +136,14 @@ void SDLGameRendererGL_BeginFrame(void) {
 
 void SDLGameRendererGL_RenderFrame(void) {
     TRACE_ZONE_N("RenderFrame");
+    gl_state.stat_tasks = gl_state.render_task_count;
+    gl_state.stat_draw_calls = 0;
     if (gl_state.render_task_count == 0) {
         TRACE_ZONE_END();
         return;
     }
 
-    stable_sort_render_tasks();
+    sort_render_tasks();
 
     static const float projection[4][4] = { { 2.0f / 384.0f, 0.0f, 0.0f, 0.0f },
                                             { 0.0f, -2.0f / 224.0f, 0.0f, 0.0f },
@@ -319,6 +314,7 @@ void SDLGameRendererGL_RenderFrame(void) {
     TRACE_PLOT_INT("ArraySprites", stat_array_sprites);
     TRACE_PLOT_INT("LegacySprites", stat_legacy_sprites);
     TRACE_PLOT_INT("DrawCalls", stat_draw_calls);
+    gl_state.stat_draw_calls = stat_draw_calls;
     TRACE_PLOT_INT("R8UIFree", gl_state.tex_array_free_count);
     TRACE_PLOT_INT("RGBAFree", gl_state.tex_array_rgba_free_count);
 
@@ -331,6 +327,11 @@ void SDLGameRendererGL_RenderFrame(void) {
     TRACE_ZONE_END();
 }
 
+void SDLGameRendererGL_GetDrawStats(SDLGameRenderer_DrawStats* out) {
+    out->tasks = gl_state.stat_tasks;
+    out->draw_calls = gl_state.stat_draw_calls;
+}
+
 void SDLGameRendererGL_EndFrame(void) {
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     // destroy_textures(); // Handled in BeginFrame now, or explicit call?
@@ -510,7 +511,7 @@ void SDLGameRendererGL_DrawSprite2(const Sprite2* sprite2) {
  * and 2 intermediate vertex arrays per sprite. Caches texture/layer/palette state
  * on tex_code change and performs color swizzle + UV scale + Z conversion inline.
  *
- * GL backend preserves submission order for correct Z via stable_sort_render_tasks.
+ * GL backend preserves submission order for equal sort keys via sort_render_tasks.
  */
 void SDLGameRendererGL_FlushSprite2Batch(Sprite2* chips, const unsigned char* active_layers, int count) {
     // ⚡ Bolt: Batch stale-promotion — single O(pending + live) pass before draw
@@ -623,6 +624,8 @@ void SDLGameRendererGL_FlushSprite2Batch(Sprite2* chips, const unsigned char* ac
         task->index = task_idx;
         task->array_layer = cur_layer;
         task->palette_slot = cur_pal;
+        gl_state.sort_keys[task_idx] = render_sort_key(
+            z, RENDER_SORT_BLEND_ALPHA, gl_sort_texture_id(cur_texture, cur_layer), (unsigned int)cur_pal);
 
         gl_state.render_task_count++;
     }
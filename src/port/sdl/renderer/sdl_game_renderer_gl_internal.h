@@ -81,6 +81,12 @@ typedef struct {
     RenderTask render_tasks[RENDER_TASK_MAX];
     int render_task_count;
     RenderTask merge_temp[RENDER_TASK_MAX]; // For sorting
+    uint64_t sort_keys[RENDER_TASK_MAX];    // render_sort_key() per task, indexed by submission order
+    int sort_order[RENDER_TASK_MAX];
+    int sort_scratch[RENDER_TASK_MAX];
+    float sort_bounds[RENDER_TASK_MAX * 4]; // x0, y0, x1, y1 per task for the overlap check
+    int stat_draw_calls; // Draws issued by the last RenderFrame
+    int stat_tasks;      // Tasks submitted to the last RenderFrame
 
     SDL_Vertex batch_vertices[RENDER_TASK_MAX * 4];
     int batch_indices[RENDER_TASK_MAX * 6];
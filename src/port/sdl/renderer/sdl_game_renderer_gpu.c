@@ -10,6 +10,7 @@
 
 #include "port/mods/modded_stage.h"
 
+#include "port/sdl/renderer/radix_sort.h"
 #include "port/sdl/renderer/sdl_game_renderer_internal.h"
 #include "port/tracy_zones.h"
 #include "sf33rd/AcrSDK/ps2/flps2etc.h"
@@ -86,9 +87,32 @@ int s_tex_upload_count = 0;
 PaletteUploadJob s_pal_upload_jobs[MAX_COMPUTE_JOBS];
 int s_pal_upload_count = 0;
 
-QuadSortKey quad_sort_keys[MAX_QUADS];
+uint64_t quad_sort_keys[MAX_QUADS];
+float quad_sort_bounds[MAX_QUADS * 4];
+int quad_sort_order[MAX_QUADS];
+int quad_sort_scratch[MAX_QUADS];
 unsigned int quad_count = 0;
-QuadSortKey quad_sort_temp[MAX_QUADS];
+static unsigned int s_stat_quads = 0;
+static int s_stat_draw_calls = 0;
+
+/**
+ * @brief Record a quad's sort key and screen bounds.
+ *
+ * The GPU backend draws every quad in one indexed call, so the state half
+ * of the key only improves texture-array locality; layer is offset by one so
+ * solid quads (layer -1) key as 0, and palette -1 (direct RGBA) keys as 0.
+ */
+static inline void push_quad_sort_key(float z, float layer, float pal_idx, float x0, float y0, float x1, float y1) {
+    const unsigned int q = quad_count;
+    quad_sort_keys[q] = render_sort_key(z, RENDER_SORT_BLEND_ALPHA, (unsigned int)(int)(layer + 1.0f),
+                                        (unsigned int)(int)(pal_idx + 1.0f));
+    float* b = &quad_sort_bounds[q * 4];
+    b[0] = SDL_min(x0, x1);
+    b[1] = SDL_min(y0, y1);
+    b[2] = SDL_max(x0, x1);
+    b[3] = SDL_max(y0, y1);
+    quad_count++;
+}
 
 /** @brief Begin a new frame: acquire command buffer and swapchain texture. */
 void SDLGameRendererGPU_BeginFrame(void) {
@@ -188,42 +212,11 @@ void SDLGameRendererGPU_BeginFrame(void) {
     TRACE_ZONE_END();
 }
 
-/** @brief Bottom-up merge sort for QuadSortKeys — O(n log n) stable sort matching GL backend. */
-static void stable_sort_quads(void) {
-    const unsigned int n = quad_count;
-    if (n <= 1)
-        return;
-
-    QuadSortKey* src = quad_sort_keys;
-    QuadSortKey* tmp = quad_sort_temp;
-
-    for (unsigned int width = 1; width < n; width *= 2) {
-        for (unsigned int i = 0; i < n; i += 2 * width) {
-            unsigned int left = i;
-            unsigned int mid = (i + width < n) ? i + width : n;
-            unsigned int right = (i + 2 * width < n) ? i + 2 * width : n;
-            unsigned int l = left, r = mid, k = left;
-
-            while (l < mid && r < right) {
-                if (src[l].z <= src[r].z)
-                    tmp[k++] = src[l++];
-                else
-                    tmp[k++] = src[r++];
-            }
-            while (l < mid)
-                tmp[k++] = src[l++];
-            while (r < right)
-                tmp[k++] = src[r++];
-        }
-        // Swap src/tmp
-        QuadSortKey* swap = src;
-        src = tmp;
-        tmp = swap;
-    }
-
-    if (src != quad_sort_keys) {
-        memcpy(quad_sort_keys, src, n * sizeof(QuadSortKey));
-    }
+/** @brief Key-sort quads — O(n) stable radix sort sharing the GL backend's key layout. */
+static void sort_quads(void) {
+    const int n = (int)quad_count;
+    radix_sort_indices_by_key64(quad_sort_order, quad_sort_keys, n, quad_sort_scratch);
+    render_sort_restore_overlaps(quad_sort_order, quad_sort_keys, quad_sort_bounds, n);
 }
 
 /** @brief Flush buffered vertices to the GPU and execute the render pass. */
@@ -235,17 +228,17 @@ void SDLGameRendererGPU_RenderFrame(void) {
         return;
     }
 
-    // Z-depth sort
+    // Z-depth + state sort
     Uint16* sorted_indices = NULL;
     unsigned int index_count = 0;
+    s_stat_quads = quad_count;
+    s_stat_draw_calls = 0;
     if (quad_count > 0) {
-        if (quad_count > 1) {
-            stable_sort_quads();
-        }
+        sort_quads();
         sorted_indices = (Uint16*)SDL_MapGPUTransferBuffer(device, index_transfer_buffer, true);
         if (sorted_indices) {
             for (unsigned int i = 0; i < quad_count; i++) {
-                const int vert_offset = quad_sort_keys[i].original_index * 4;
+                const int vert_offset = quad_sort_order[i] * 4;
                 const int idx_offset = i * 6;
                 sorted_indices[idx_offset + 0] = vert_offset + 0;
                 sorted_indices[idx_offset + 1] = vert_offset + 1;
@@ -445,6 +438,7 @@ void SDLGameRendererGPU_RenderFrame(void) {
                 SDL_BindGPUFragmentSamplers(pass, 0, tex_bindings, 2);
 
                 SDL_DrawGPUIndexedPrimitives(pass, index_count, 1, 0, 0, 0);
+                s_stat_draw_calls = 1;
             }
             SDL_EndGPURenderPass(pass);
         }
@@ -472,6 +466,11 @@ void SDLGameRendererGPU_EndFrame(void) {
     TRACE_ZONE_END();
 }
 
+void SDLGameRendererGPU_GetDrawStats(SDLGameRenderer_DrawStats* out) {
+    out->tasks = (int)s_stat_quads;
+    out->draw_calls = s_stat_draw_calls;
+}
+
 SDL_GPUCommandBuffer* SDLGameRendererGPU_GetCommandBuffer(void) {
     return current_cmd_buf;
 }
@@ -513,9 +512,15 @@ static void draw_quad(const SDLGameRenderer_Vertex* vertices, bool textured) {
     }
 
     if (quad_count < MAX_QUADS) {
-        quad_sort_keys[quad_count].z = flPS2ConvScreenFZ(vertices[0].coord.z);
-        quad_sort_keys[quad_count].original_index = quad_count;
-        quad_count++;
+        float x0 = vertices[0].coord.x, x1 = x0;
+        float y0 = vertices[0].coord.y, y1 = y0;
+        for (int i = 1; i < 4; i++) {
+            x0 = SDL_min(x0, vertices[i].coord.x);
+            x1 = SDL_max(x1, vertices[i].coord.x);
+            y0 = SDL_min(y0, vertices[i].coord.y);
+            y1 = SDL_max(y1, vertices[i].coord.y);
+        }
+        push_quad_sort_key(flPS2ConvScreenFZ(vertices[0].coord.z), layer, palIdx, x0, y0, x1, y1);
     }
 
     vertex_count += 4;
@@ -612,7 +617,8 @@ void SDLGameRendererGPU_DrawSprite2(const Sprite2* sprite2) {
  * Inlines SetTexture + draw_quad to avoid per-sprite function call overhead,
  * and pre-computes color floats once per sprite.
  * Preserves original submission order — no tex_code sorting, because sprites
- * with the same Z value rely on draw order for correct layering.
+ * with the same Z value rely on draw order for correct layering. (The key sort
+ * in RenderFrame only regroups equal-Z quads that do not overlap.)
  */
 void SDLGameRendererGPU_FlushSprite2Batch(Sprite2* chips, const unsigned char* active_layers, int count) {
     if (!mapped_vertex_ptr || count <= 0)
@@ -709,9 +715,7 @@ void SDLGameRendererGPU_FlushSprite2Batch(Sprite2* chips, const unsigned char* a
         v[3].paletteIdx = palIdx;
 
         if (quad_count < MAX_QUADS) {
-            quad_sort_keys[quad_count].z = flPS2ConvScreenFZ(spr->v[0].z);
-            quad_sort_keys[quad_count].original_index = quad_count;
-            quad_count++;
+            push_quad_sort_key(flPS2ConvScreenFZ(spr->v[0].z), layer, palIdx, x0, y0, x1, y1);
         }
 
         vertex_count += 4;
@@ -53,12 +53,6 @@ typedef struct {
     Uint32 offset; /* byte offset in staging buffer */
 } PaletteUploadJob;
 
-/** @brief Z-depth key for stable quad sorting. */
-typedef struct {
-    float z;
-    int original_index; /* quad index in submission order */
-} QuadSortKey;
-
 /** @brief Per-vertex data layout for the GPU pipeline. */
 typedef struct GPUVertex {
     float x, y;
@@ -151,10 +145,12 @@ extern int s_tex_upload_count;
 extern PaletteUploadJob s_pal_upload_jobs[MAX_COMPUTE_JOBS];
 extern int s_pal_upload_count;
 
-/* Z-depth sorting */
-extern QuadSortKey quad_sort_keys[MAX_QUADS];
+/* Z-depth + state sorting (render_sort_key per quad, indexed by submission order) */
+extern uint64_t quad_sort_keys[MAX_QUADS];
+extern float quad_sort_bounds[MAX_QUADS * 4];
+extern int quad_sort_order[MAX_QUADS];
+extern int quad_sort_scratch[MAX_QUADS];
 extern unsigned int quad_count;
-extern QuadSortKey quad_sort_temp[MAX_QUADS];
 
 /* ─── Inline Helpers ──────────────────────────────────────────────────── */
 
@@ -33,6 +33,7 @@ void SDLGameRendererGL_DumpTextures(void);
 void SDLGameRendererGL_DumpPaletteStats(void);
 void SDLGameRendererGL_FlushSprite2Batch(Sprite2* chips, const unsigned char* active_layers, int count);
 void SDLGameRendererGL_ResetBatchState(void);
+void SDLGameRendererGL_GetDrawStats(SDLGameRenderer_DrawStats* out);
 
 // GPU Backend
 void SDLGameRendererGPU_Init(void);
@@ -57,6 +58,7 @@ void SDLGameRendererGPU_DrawSprite2(const Sprite2* sprite2);
 unsigned int SDLGameRendererGPU_GetCachedGLTexture(unsigned int texture_handle, unsigned int palette_handle);
 void SDLGameRendererGPU_DumpTextures(void);
 void SDLGameRendererGPU_FlushSprite2Batch(Sprite2* chips, const unsigned char* active_layers, int count);
+void SDLGameRendererGPU_GetDrawStats(SDLGameRenderer_DrawStats* out);
 // ⚡ Opt6: LZ77 GPU compute decompression
 int SDLGameRendererGPU_LZ77Available(void);
 int SDLGameRendererGPU_LZ77Enqueue(const u8* compressed, u32 comp_size, u32 decomp_size, int texture_handle,
@@ -83,6 +85,8 @@ unsigned int SDLGameRendererSDL_GetCachedGLTexture(unsigned int texture_handle,
 void SDLGameRendererSDL_DumpTextures(void);
 void SDLGameRendererSDL_FlushSprite2Batch(Sprite2* chips, const unsigned char* active_layers, int count);
 SDL_Texture* SDLGameRendererSDL_GetCanvas(void);
+void SDLGameRendererSDL_GetDrawStats(SDLGameRenderer_DrawStats* out);
+void SDLGameRendererSDL_BenchmarkSprite2(int chips);
 
 // SDL2D Classic Backend (simple reference renderer for benchmarking)
 void SDLGameRendererClassic_Init(void);
@@ -107,6 +107,8 @@ static int render_task_order[RENDER_TASK_MAX]; // ⚡ Sorted indices for indirec
 
 // ⚡ Sortedness tracking — count inversions during draw_quad to decide sort strategy
 static int sort_inversions = 0;
+static int stat_draw_calls = 0; // SDL_Render* calls issued by the last RenderFrame
+static int stat_tasks = 0;      // Tasks submitted to the last RenderFrame
 static float last_submitted_z = -1e30f;
 
 // ⚡ Cached texture binding — skip redundant SetTexture lookups
@@ -118,6 +120,11 @@ static SDL_Vertex batch_vertices[RENDER_TASK_MAX * 4];
 static int batch_indices[RENDER_TASK_MAX * 6];
 static bool batch_buffers_initialized = false;
 
+// ⚡ Geometry batching: submit every quad of a texture run (rect or not) through one
+// SDL_RenderGeometry call instead of one SDL_RenderTexture per Sprite2 chip.
+// false = legacy rect fast path (kept for A/B comparison via --bench-sprite2).
+static bool geometry_batching = true;
+
 // ⚡ Radix sort scratch buffers (used when sort_inversions > INSERTION_SORT_THRESHOLD)
 static uint32_t radix_keys[RENDER_TASK_MAX];
 static int radix_scratch[RENDER_TASK_MAX];
@@ -622,6 +629,11 @@ static void texture_subsort_equal_z_groups(int* order, int count) {
 
 // --- Public API ---
 
+void SDLGameRendererSDL_GetDrawStats(SDLGameRenderer_DrawStats* out) {
+    out->tasks = stat_tasks;
+    out->draw_calls = stat_draw_calls;
+}
+
 SDL_Texture* SDLGameRendererSDL_GetCanvas(void) {
     return cps3_canvas;
 }
@@ -733,9 +745,106 @@ void SDLGameRendererSDL_BeginFrame(void) {
     TRACE_SUB_END();
 }
 
+/** @brief Debug visualization: draw colored borders around every quad of the frame. */
+static void draw_debug_rect_borders(SDL_Renderer* renderer) {
+    const SDL_FColor red = { .r = 1.0f, .g = 0.0f, .b = 0.0f, .a = SDL_ALPHA_OPAQUE_FLOAT };
+    const SDL_FColor green = { .r = 0.0f, .g = 1.0f, .b = 0.0f, .a = SDL_ALPHA_OPAQUE_FLOAT };
+    SDL_FColor border_color;
+
+    for (int i = 0; i < render_task_count; i++) {
+        const int task_idx = render_task_order[i];
+        const float x0 = task_verts[task_idx][0].position.x;
+        const float y0 = task_verts[task_idx][0].position.y;
+        const float x1 = task_verts[task_idx][3].position.x;
+        const float y1 = task_verts[task_idx][3].position.y;
+        const SDL_FRect border_rect = { .x = x0, .y = y0, .w = (x1 - x0), .h = (y1 - y0) };
+
+        const float lerp_factor = (render_task_count > 1) ? (float)i / (float)(render_task_count - 1) : 0.5f;
+        lerp_fcolors(&border_color, &red, &green, lerp_factor);
+
+        SDL_SetRenderDrawColorFloat(renderer, border_color.r, border_color.g, border_color.b, border_color.a);
+        SDL_RenderRect(renderer, &border_rect);
+    }
+}
+
+/**
+ * @brief CPU-side cull test: true if the quad cannot touch the canvas.
+ *
+ * Rejects quads whose bounding box has zero area or lies entirely outside
+ * the 384×224 canvas. Partially visible quads are left to the rasterizer.
+ */
+static inline bool quad_is_culled(const SDL_Vertex v[4]) {
+    float min_x = v[0].position.x, max_x = v[0].position.x;
+    float min_y = v[0].position.y, max_y = v[0].position.y;
+
+    for (int k = 1; k < 4; k++) {
+        min_x = SDL_min(min_x, v[k].position.x);
+        max_x = SDL_max(max_x, v[k].position.x);
+        min_y = SDL_min(min_y, v[k].position.y);
+        max_y = SDL_max(max_y, v[k].position.y);
+    }
+
+    return (max_x <= 0.0f) || (max_y <= 0.0f) || (min_x >= (float)cps3_width) || (min_y >= (float)cps3_height) ||
+           (max_x - min_x <= 0.0f) || (max_y - min_y <= 0.0f);
+}
+
+/**
+ * ⚡ Geometry-batched submission: one SDL_RenderGeometry per texture run.
+ *
+ * Runs break on task_th only — rect and non-rect quads share the same
+ * vertex layout (TL, TR, BL, BR) and per-vertex color, so Sprite2 chips no
+ * longer cost one SDL_RenderTexture + two color-mod calls each. Culled quads
+ * are skipped while copying into batch_vertices.
+ */
+static void render_geometry_runs(SDL_Renderer* renderer) {
+    int run_start = 0;
+    int culled = 0;
+
+    while (run_start < render_task_count) {
+        const unsigned int th = task_th[render_task_order[run_start]];
+        int run_end = run_start + 1;
+
+        while (run_end < render_task_count && task_th[render_task_order[run_end]] == th) {
+            run_end++;
+        }
+
+        SDL_Texture* draw_texture = task_texture[render_task_order[run_start]];
+        const int batch_palette = HI_16_BITS(th);
+        const int batch_tex_handle = LO_16_BITS(th);
+
+        if (draw_texture != NULL && batch_palette > 0 && batch_palette <= FL_PALETTE_MAX && batch_tex_handle > 0) {
+            SDL_Texture* cached = lookup_idx_tex(renderer, batch_tex_handle - 1, batch_palette);
+            if (cached != NULL)
+                draw_texture = cached;
+        }
+
+        int quads = 0;
+        for (int j = run_start; j < run_end; j++) {
+            const int task_idx = render_task_order[j];
+            if (quad_is_culled(task_verts[task_idx])) {
+                culled++;
+                continue;
+            }
+            memcpy(&batch_vertices[quads * 4], task_verts[task_idx], 4 * sizeof(SDL_Vertex));
+            quads++;
+        }
+
+        if (quads > 0) {
+            SDL_RenderGeometry(renderer, draw_texture, batch_vertices, quads * 4, batch_indices, quads * 6);
+            stat_draw_calls++;
+        }
+
+        run_start = run_end;
+    }
+
+    TRACE_PLOT_INT("CulledQuads", culled);
+}
+
 void SDLGameRendererSDL_RenderFrame(void) {
     TRACE_ZONE_N("SDL2D:RenderFrame");
     TRACE_PLOT_INT("RenderTasks", render_task_count);
+    stat_tasks = render_task_count;
+    stat_draw_calls = 0;
     SDL_Renderer* renderer = SDLApp_GetSDLRenderer();
     SDL_SetRenderTarget(renderer, cps3_canvas);
 
@@ -782,6 +891,7 @@ void SDLGameRendererSDL_RenderFrame(void) {
                                .frame_clear_color = flPs2State.FrameClearColor };
     if (SWRaster_RenderFrame(&swctx)) {
         TRACE_PLOT_INT("SoftwareFrame", 1);
+        stat_draw_calls = 1;
         TRACE_ZONE_END();
         return;
     }
@@ -813,6 +923,16 @@ void SDLGameRendererSDL_RenderFrame(void) {
     // Re-bind render target (sw_render_frame may have changed it)
     SDL_SetRenderTarget(renderer, cps3_canvas);
 
+    if (geometry_batching) {
+        render_geometry_runs(renderer);
+        TRACE_PLOT_INT("DrawCalls", stat_draw_calls);
+        if (draw_rect_borders) {
+            draw_debug_rect_borders(renderer);
+        }
+        TRACE_ZONE_END();
+        return;
+    }
+
     // Batch rendering: group consecutive tasks with same texture+palette (task_th)
     // AND same rect/geometry classification.
     // ⚡ Pre-baked RGBA textures via lookup_idx_tex — pure pointer lookup, no blit.
@@ -890,6 +1010,7 @@ void SDLGameRendererSDL_RenderFrame(void) {
                         } else {
                             SDL_RenderTexture(renderer, draw_texture, &src, &dst);
                         }
+                        stat_draw_calls++;
                     }
                     // ⚡ Reset color/alpha mod to prevent leaking into subsequent
                     // SDL_RenderGeometry batches that may share this texture.
@@ -919,6 +1040,7 @@ void SDLGameRendererSDL_RenderFrame(void) {
                                                    geo_count * 4,
                                                    batch_indices,
                                                    geo_count * 6);
+                                stat_draw_calls++;
                             }
                             // ⚡ Normalize vertex order so v[0]=TL, v[3]=BR
                             normalize_rect_verts(task_verts[task_idx]);
@@ -951,6 +1073,7 @@ void SDLGameRendererSDL_RenderFrame(void) {
                             } else {
                                 SDL_RenderTexture(renderer, draw_texture, &rsrc, &rdst);
                             }
+                            stat_draw_calls++;
                             SDL_SetTextureColorModFloat(draw_texture, 1.0f, 1.0f, 1.0f);
                             SDL_SetTextureAlphaModFloat(draw_texture, 1.0f);
                             rect_fast_path_count++;
@@ -966,6 +1089,7 @@ void SDLGameRendererSDL_RenderFrame(void) {
                         }
                         SDL_RenderGeometry(
                             renderer, draw_texture, batch_vertices, geo_count * 4, batch_indices, geo_count * 6);
+                        stat_draw_calls++;
                     }
                 } else {
                     // Standard geometry path: copy vertices to batch buffer
@@ -978,6 +1102,7 @@ void SDLGameRendererSDL_RenderFrame(void) {
                     // Single draw call for entire batch
                     SDL_RenderGeometry(
                         renderer, draw_texture, batch_vertices, batch_size * 4, batch_indices, batch_size * 6);
+                    stat_draw_calls++;
                 }
             }
 
@@ -989,27 +1114,10 @@ void SDLGameRendererSDL_RenderFrame(void) {
         }
     }
     TRACE_PLOT_INT("RectFastPath", rect_fast_path_count);
+    TRACE_PLOT_INT("DrawCalls", stat_draw_calls);
 
-    // Debug visualization: draw colored borders around quads
     if (draw_rect_borders) {
-        const SDL_FColor red = { .r = 1.0f, .g = 0.0f, .b = 0.0f, .a = SDL_ALPHA_OPAQUE_FLOAT };
-        const SDL_FColor green = { .r = 0.0f, .g = 1.0f, .b = 0.0f, .a = SDL_ALPHA_OPAQUE_FLOAT };
-        SDL_FColor border_color;
-
-        for (int i = 0; i < render_task_count; i++) {
-            const int task_idx = render_task_order[i];
-            const float x0 = task_verts[task_idx][0].position.x;
-            const float y0 = task_verts[task_idx][0].position.y;
-            const float x1 = task_verts[task_idx][3].position.x;
-            const float y1 = task_verts[task_idx][3].position.y;
-            const SDL_FRect border_rect = { .x = x0, .y = y0, .w = (x1 - x0), .h = (y1 - y0) };
-
-            const float lerp_factor = (render_task_count > 1) ? (float)i / (float)(render_task_count - 1) : 0.5f;
-            lerp_fcolors(&border_color, &red, &green, lerp_factor);
-
-            SDL_SetRenderDrawColorFloat(renderer, border_color.r, border_color.g, border_color.b, border_color.a);
-            SDL_RenderRect(renderer, &border_rect);
-        }
+        draw_debug_rect_borders(renderer);
     }
     TRACE_ZONE_END();
 }
@@ -1705,3 +1813,142 @@ void SDLGameRendererSDL_FlushSprite2Batch(Sprite2* chips, const unsigned char* a
     TRACE_PLOT_INT("SetTextureCalls", set_texture_calls);
     TRACE_SUB_END();
 }
+
+// --- Sprite2 benchmark (--bench-sprite2) ---
+
+#define BENCH_TEXTURES 8
+#define BENCH_TEXTURE_SIZE 256
+#define BENCH_CHIP_SIZE 16
+#define BENCH_RUN_LENGTH 32 // consecutive chips sharing a texture, like one character's sprite
+#define BENCH_FRAMES 300
+#define BENCH_WARMUP_FRAMES 10
+
+/** @brief Fill the task arrays with @p chips synthetic Sprite2-style chips. */
+static void bench_fill_chips(SDL_Texture* const* textures, int chips) {
+    const float uv_step = (float)BENCH_CHIP_SIZE / (float)BENCH_TEXTURE_SIZE;
+    const SDL_FColor white = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+    clear_render_tasks();
+
+    for (int i = 0; i < chips; i++) {
+        const int t = (i / BENCH_RUN_LENGTH) % BENCH_TEXTURES;
+        const int cell = (i * 37) % ((BENCH_TEXTURE_SIZE / BENCH_CHIP_SIZE) * (BENCH_TEXTURE_SIZE / BENCH_CHIP_SIZE));
+        float s0 = (float)(cell % (BENCH_TEXTURE_SIZE / BENCH_CHIP_SIZE)) * uv_step;
+        float s1 = s0 + uv_step;
+        const float t0 = (float)(cell / (BENCH_TEXTURE_SIZE / BENCH_CHIP_SIZE)) * uv_step;
+        const float t1 = t0 + uv_step;
+        float x0 = (float)((i * 13) % (cps3_width + BENCH_CHIP_SIZE) - BENCH_CHIP_SIZE);
+        const float y0 = (float)((i * 7) % (cps3_height + BENCH_CHIP_SIZE) - BENCH_CHIP_SIZE);
+
+        // Every 8th chip is fully off-canvas (scrolled-out stage parts, projectiles)
+        if ((i & 7) == 7) {
+            x0 = -4.0f * BENCH_CHIP_SIZE;
+        }
+
+        // Mirror odd runs like a character facing left
+        if ((i / BENCH_RUN_LENGTH) & 1) {
+            const float tmp = s0;
+            s0 = s1;
+            s1 = tmp;
+        }
+
+        const float x1 = x0 + BENCH_CHIP_SIZE;
+        const float y1 = y0 + BENCH_CHIP_SIZE;
+        SDL_Vertex* v = task_verts[i];
+
+        v[0] = (SDL_Vertex) { { x0, y0 }, white, { s0, t0 } };
+        v[1] = (SDL_Vertex) { { x1, y0 }, white, { s1, t0 } };
+        v[2] = (SDL_Vertex) { { x0, y1 }, white, { s0, t1 } };
+        v[3] = (SDL_Vertex) { { x1, y1 }, white, { s1, t1 } };
+
+        task_texture[i] = textures[t];
+        task_th[i] = (unsigned int)(t + 1);
+        task_z[i] = (float)(i / (BENCH_RUN_LENGTH * BENCH_TEXTURES));
+        task_is_rect[i] = true;
+    }
+
+    render_task_count = chips;
+}
+
+/** @brief Render the prepared chips for BENCH_FRAMES frames; returns ms per frame. */
+static double bench_run(SDL_Renderer* renderer, bool batched, int* draw_calls) {
+    const SDL_Rect probe = { 0, 0, 1, 1 };
+    Uint64 start = 0;
+
+    geometry_batching = batched;
+
+    for (int f = 0; f < BENCH_WARMUP_FRAMES + BENCH_FRAMES; f++) {
+        if (f == BENCH_WARMUP_FRAMES) {
+            start = SDL_GetPerformanceCounter();
+        }
+
+        SDLGameRendererSDL_BeginFrame();
+        SDLGameRendererSDL_RenderFrame();
+
+        // Read back one pixel so the GPU work is inside the measurement
+        SDL_Surface* readback = SDL_RenderReadPixels(renderer, &probe);
+        SDL_DestroySurface(readback);
+    }
+
+    *draw_calls = stat_draw_calls;
+    return (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency() /
+           BENCH_FRAMES;
+}
+
+/**
+ * @brief Time Sprite2 chip submission with geometry batching on and off.
+ *
+ * Renders a synthetic scene of @p chips 16×16 chips spread over a few RGBA
+ * textures (1/8 of them off-canvas) and logs ms/frame and draw calls for
+ * both paths.
+ */
+void SDLGameRendererSDL_BenchmarkSprite2(int chips) {
+    SDL_Renderer* renderer = SDLApp_GetSDLRenderer();
+    SDL_Texture* textures[BENCH_TEXTURES] = { NULL };
+    const bool saved_batching = geometry_batching;
+    int legacy_calls = 0;
+    int batched_calls = 0;
+
+    chips = SDL_clamp(chips, 1, RENDER_TASK_MAX);
+
+    for (int t = 0; t < BENCH_TEXTURES; t++) {
+        textures[t] = SDL_CreateTexture(
+            renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, BENCH_TEXTURE_SIZE, BENCH_TEXTURE_SIZE);
+        if (!textures[t]) {
+            SDL_Log("Sprite2 bench: texture creation failed: %s", SDL_GetError());
+            goto cleanup;
+        }
+
+        for (int p = 0; p < BENCH_TEXTURE_SIZE * BENCH_TEXTURE_SIZE; p++) {
+            const uint32_t c = (uint32_t)(p * 2654435761u) ^ (uint32_t)(t * 0x01010101u);
+            rgba_scratch[p] = (c & 0xFFFFFF00u) | ((p & 3) ? 0xFF : 0x00); // some transparent texels
+        }
+
+        SDL_UpdateTexture(textures[t], NULL, rgba_scratch, BENCH_TEXTURE_SIZE * sizeof(uint32_t));
+        SDL_SetTextureBlendMode(textures[t], SDL_BLENDMODE_BLEND);
+        SDL_SetTextureScaleMode(textures[t], SDL_SCALEMODE_NEAREST);
+    }
+
+    bench_fill_chips(textures, chips);
+
+    const double legacy_ms = bench_run(renderer, false, &legacy_calls);
+    const double batched_ms = bench_run(renderer, true, &batched_calls);
+
+    SDL_Log("Sprite2 bench (%s): %d chips, %d textures, %d frames",
+            SDL_GetRendererName(renderer),
+            chips,
+            BENCH_TEXTURES,
+            BENCH_FRAMES);
+    SDL_Log("  rect fast path:  %7.3f ms/frame, %5d draw calls", legacy_ms, legacy_calls);
+    SDL_Log("  geometry batch:  %7.3f ms/frame, %5d draw calls", batched_ms, batched_calls);
+
+cleanup:
+    geometry_batching = saved_batching;
+    clear_render_tasks();
+
+    for (int t = 0; t < BENCH_TEXTURES; t++) {
+        if (textures[t]) {
+            SDL_DestroyTexture(textures[t]);
+        }
+    }
+}
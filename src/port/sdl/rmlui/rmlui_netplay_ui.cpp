@@ -5,7 +5,8 @@
  * Mirrors the ImGui rendering in sdl_netplay_ui.cpp using RmlUi data bindings.
  * Three overlay regions:
  *   1. Mini-HUD (top-right ping/rollback badge)
- *   2. Diagnostics panel (FPS line chart, netplay stats, ping/rb line charts)
+ *   2. Diagnostics panel (FPS line chart, SE audio latency, netplay stats,
+ *      ping/rb line charts)
  *   3. Toast notifications (centered top, timed pop-ups)
  *
  * The lobby state machine and C extern API remain in sdl_netplay_ui.cpp.
@@ -18,6 +19,10 @@
 #include <RmlUi/Core.h>
 #include <SDL3/SDL.h>
 
+extern "C" {
+#include "port/sound/spu.h"
+} // extern "C"
+
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
@@ -50,6 +55,8 @@ static Rml::String s_fps_text;
 static Rml::String s_fps_color_class = "ok";
 static std::vector<BarCell> s_fps_bars;
 static Rml::String s_fps_stats;
+static Rml::String s_audio_latency;
+static Rml::String s_audio_mode;
 static bool s_net_session_active = false;
 static Rml::String s_net_ping;
 static Rml::String s_net_rollback;
@@ -69,6 +76,8 @@ static bool s_prev_diag_visible = false;
 static Rml::String s_prev_fps_text;
 static Rml::String s_prev_fps_color_class;
 static Rml::String s_prev_fps_stats;
+static Rml::String s_prev_audio_latency;
+static Rml::String s_prev_audio_mode;
 static bool s_prev_net_session_active = false;
 static Rml::String s_prev_net_ping;
 static Rml::String s_prev_net_rollback;
@@ -151,6 +160,8 @@ extern "C" void rmlui_netplay_ui_init(void) {
     ctor.BindFunc("fps_color_class", [](Rml::Variant& v) { v = s_fps_color_class; });
     ctor.Bind("fps_bars", &s_fps_bars);
     ctor.BindFunc("fps_stats", [](Rml::Variant& v) { v = s_fps_stats; });
+    ctor.BindFunc("audio_latency", [](Rml::Variant& v) { v = s_audio_latency; });
+    ctor.BindFunc("audio_mode", [](Rml::Variant& v) { v = s_audio_mode; });
     ctor.BindFunc("net_session_active", [](Rml::Variant& v) { v = s_net_session_active; });
     ctor.BindFunc("net_ping", [](Rml::Variant& v) { v = s_net_ping; });
     ctor.BindFunc("net_rollback", [](Rml::Variant& v) { v = s_net_rollback; });
@@ -330,6 +341,43 @@ extern "C" void rmlui_netplay_ui_update(void) {
             }
         }
 
+        // SE audio latency — changes with every sound, so refresh at chart rate
+        if (update_charts) {
+            SPU_LatencyStats lat;
+            SPU_GetLatencyStats(&lat);
+            char buf[128];
+
+            if (lat.starts > 0) {
+                snprintf(buf,
+                         sizeof(buf),
+                         "SE latency: %.1f ms avg | %.1f ms peak | ~%.1f ms to output",
+                         lat.avg_us / 1000.0f,
+                         (lat.peak_us > 0 ? lat.peak_us : lat.last_us) / 1000.0f,
+                         lat.output_us / 1000.0f);
+            } else {
+                snprintf(buf, sizeof(buf), "SE latency: no sounds yet");
+            }
+            Rml::String new_latency(buf);
+            if (new_latency != s_prev_audio_latency) {
+                s_audio_latency = new_latency;
+                s_prev_audio_latency = new_latency;
+                s_model_handle.DirtyVariable("audio_latency");
+            }
+
+            snprintf(buf,
+                     sizeof(buf),
+                     "Audio: %s | %d-frame device period | %d-frame mix batches",
+                     lat.low_latency ? "low-latency" : "default",
+                     lat.device_frames,
+                     lat.batch_frames);
+            Rml::String new_mode(buf);
+            if (new_mode != s_prev_audio_mode) {
+                s_audio_mode = new_mode;
+                s_prev_audio_mode = new_mode;
+                s_model_handle.DirtyVariable("audio_mode");
+            }
+        }
+
         // Netplay section
         bool new_net_active = session_running;
         if (new_net_active != s_prev_net_session_active) {
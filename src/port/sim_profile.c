@@ -0,0 +1,336 @@
+/**
+ * @file sim_profile.c
+ * @brief Counting CPU profiler for the game simulation: task slots, effect IDs, script commands.
+ */
+#include "port/sim_profile.h"
+
+#include <SDL3/SDL.h>
+
+#define SIM_PROFILE_OVERLAY_ROWS 12
+
+typedef struct SimProfileCounter {
+    Uint64 ticks; // Performance counter ticks, converted when read
+    Uint64 calls;
+} SimProfileCounter;
+
+typedef enum SimProfileView {
+    SIM_PROFILE_VIEW_OFF,
+    SIM_PROFILE_VIEW_TASKS,
+    SIM_PROFILE_VIEW_EFFECTS,
+    SIM_PROFILE_VIEW_COMMANDS,
+    SIM_PROFILE_VIEW_COUNT
+} SimProfileView;
+
+bool sim_profile_active = false;
+
+static SimProfileCounter tasks[SIM_PROFILE_TASKS];
+static SimProfileCounter effects[SIM_PROFILE_EFFECTS];
+static SimProfileCounter commands[SIM_PROFILE_COMMANDS];
+static Uint64 frames = 0;
+
+static SimProfileView view = SIM_PROFILE_VIEW_OFF;
+static SimProfileSort sort_by = SIM_PROFILE_BY_TIME;
+static bool enabled_by_view = false; // The HUD turned the profiler on, so it may turn it off again
+
+static const char* const task_names[SIM_PROFILE_TASKS] = {
+    "Init", "Entry", "Reset", "Menu", "Pause", "Game", "Saver", NULL, NULL, "Debug", NULL,
+};
+
+static const char* const kind_names[SIM_PROFILE_KIND_COUNT] = { "task", "effect", "command" };
+static const char* const sort_names[SIM_PROFILE_SORT_COUNT] = { "time", "calls", "average" };
+
+static SimProfileCounter* counters(SimProfileKind kind, int* count) {
+    switch (kind) {
+    case SIM_PROFILE_TASK:
+        *count = SIM_PROFILE_TASKS;
+        return tasks;
+
+    case SIM_PROFILE_EFFECT:
+        *count = SIM_PROFILE_EFFECTS;
+        return effects;
+
+    case SIM_PROFILE_COMMAND:
+        *count = SIM_PROFILE_COMMANDS;
+        return commands;
+
+    default:
+        *count = 0;
+        return NULL;
+    }
+}
+
+static Uint64 ticks_to_ns(Uint64 ticks) {
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+
+    // Split to keep ticks * 1e9 from overflowing on long sessions
+    return (ticks / freq) * SDL_NS_PER_SECOND + (ticks % freq) * SDL_NS_PER_SECOND / freq;
+}
+
+void SimProfile_Reset() {
+    SDL_zeroa(tasks);
+    SDL_zeroa(effects);
+    SDL_zeroa(commands);
+    frames = 0;
+}
+
+void SimProfile_SetEnabled(bool enabled) {
+    if (enabled && !sim_profile_active) {
+        SimProfile_Reset();
+    }
+
+    sim_profile_active = enabled;
+    enabled_by_view = false;
+}
+
+bool SimProfile_IsEnabled() {
+    return sim_profile_active;
+}
+
+void SimProfile_NoteFrame() {
+    if (sim_profile_active) {
+        frames += 1;
+    }
+}
+
+uint64_t SimProfile_GetFrames() {
+    return frames;
+}
+
+void SimProfile_Record(SimProfileKind kind, int id, uint64_t begin) {
+    const Uint64 end = SDL_GetPerformanceCounter();
+    SimProfileCounter* table;
+    int count;
+
+    // Calls that straddle the profiler being turned off are dropped
+    if (!sim_profile_active) {
+        return;
+    }
+
+    table = counters(kind, &count);
+
+    if ((id < 0) || (id >= count)) {
+        return;
+    }
+
+    table[id].ticks += end - begin;
+    table[id].calls += 1;
+}
+
+static int compare_time(const void* a, const void* b) {
+    const SimProfileRow* x = a;
+    const SimProfileRow* y = b;
+
+    if (x->ns != y->ns) {
+        return (x->ns < y->ns) ? 1 : -1;
+    }
+
+    return x->id - y->id;
+}
+
+static int compare_calls(const void* a, const void* b) {
+    const SimProfileRow* x = a;
+    const SimProfileRow* y = b;
+
+    if (x->calls != y->calls) {
+        return (x->calls < y->calls) ? 1 : -1;
+    }
+
+    return compare_time(a, b);
+}
+
+static int compare_average(const void* a, const void* b) {
+    const SimProfileRow* x = a;
+    const SimProfileRow* y = b;
+    const double avg_x = (double)x->ns / x->calls;
+    const double avg_y = (double)y->ns / y->calls;
+
+    if (avg_x != avg_y) {
+        return (avg_x < avg_y) ? 1 : -1;
+    }
+
+    return compare_time(a, b);
+}
+
+int SimProfile_GetRows(SimProfileKind kind, SimProfileSort sort, SimProfileRow* rows, int max_rows) {
+    static int (*const compare[SIM_PROFILE_SORT_COUNT])(const void*, const void*) = {
+        compare_time,
+        compare_calls,
+        compare_average,
+    };
+    SimProfileRow all[SIM_PROFILE_EFFECTS];
+    const SimProfileCounter* table;
+    int count;
+    int found = 0;
+
+    table = counters(kind, &count);
+
+    for (int id = 0; id < count; id++) {
+        if (table[id].calls == 0) {
+            continue;
+        }
+
+        all[found].kind = kind;
+        all[found].id = id;
+        all[found].ns = ticks_to_ns(table[id].ticks);
+        all[found].calls = table[id].calls;
+        found += 1;
+    }
+
+    if ((sort < 0) || (sort >= SIM_PROFILE_SORT_COUNT)) {
+        sort = SIM_PROFILE_BY_TIME;
+    }
+
+    SDL_qsort(all, found, sizeof(SimProfileRow), compare[sort]);
+
+    if (found > max_rows) {
+        found = max_rows;
+    }
+
+    SDL_memcpy(rows, all, found * sizeof(SimProfileRow));
+    return found;
+}
+
+void SimProfile_FormatName(SimProfileKind kind, int id, char* buf, size_t size) {
+    switch (kind) {
+    case SIM_PROFILE_TASK:
+        if ((id >= 0) && (id < SIM_PROFILE_TASKS) && (task_names[id] != NULL)) {
+            SDL_snprintf(buf, size, "Task:%s", task_names[id]);
+        } else {
+            SDL_snprintf(buf, size, "Task:Slot%d", id);
+        }
+
+        break;
+
+    case SIM_PROFILE_EFFECT:
+        // effect_00..effect_99, then A0..M9 for 100 and up (see effmovejptbl)
+        if ((id >= 100) && (id < SIM_PROFILE_EFFECTS)) {
+            SDL_snprintf(buf, size, "effect_%c%d", 'A' + (id / 10 - 10), id % 10);
+        } else {
+            SDL_snprintf(buf, size, "effect_%02d", id);
+        }
+
+        break;
+
+    default:
+        SDL_snprintf(buf, size, "cmd_%d", id);
+        break;
+    }
+}
+
+const char* SimProfile_KindName(SimProfileKind kind) {
+    if ((kind < 0) || (kind >= SIM_PROFILE_KIND_COUNT)) {
+        return "?";
+    }
+
+    return kind_names[kind];
+}
+
+const char* SimProfile_SortName(SimProfileSort sort) {
+    if ((sort < 0) || (sort >= SIM_PROFILE_SORT_COUNT)) {
+        return "?";
+    }
+
+    return sort_names[sort];
+}
+
+bool SimProfile_WriteCSV(const char* path) {
+    SDL_IOStream* io = SDL_IOFromFile(path, "w");
+    SimProfileRow rows[SIM_PROFILE_EFFECTS];
+    const double per_frame = (frames > 0) ? (double)frames : 1.0;
+
+    if (io == NULL) {
+        SDL_Log("Sim profile: can't open %s: %s", path, SDL_GetError());
+        return false;
+    }
+
+    SDL_IOprintf(io, "kind,id,name,calls,total_us,avg_us,us_per_frame\n");
+
+    for (int kind = 0; kind < SIM_PROFILE_KIND_COUNT; kind++) {
+        const int count = SimProfile_GetRows(kind, SIM_PROFILE_BY_TIME, rows, SIM_PROFILE_EFFECTS);
+
+        for (int i = 0; i < count; i++) {
+            char name[32];
+
+            SimProfile_FormatName(kind, rows[i].id, name, sizeof(name));
+            SDL_IOprintf(io,
+                         "%s,%d,%s,%llu,%.3f,%.3f,%.3f\n",
+                         kind_names[kind],
+                         rows[i].id,
+                         name,
+                         (unsigned long long)rows[i].calls,
+                         rows[i].ns / 1e3,
+                         rows[i].ns / 1e3 / rows[i].calls,
+                         rows[i].ns / 1e3 / per_frame);
+        }
+    }
+
+    if (!SDL_CloseIO(io)) {
+        SDL_Log("Sim profile: failed writing %s: %s", path, SDL_GetError());
+        return false;
+    }
+
+    SDL_Log("Sim profile written to %s (%llu frames)", path, (unsigned long long)frames);
+    return true;
+}
+
+void SimProfile_CycleView() {
+    view = (view + 1) % SIM_PROFILE_VIEW_COUNT;
+
+    if ((view != SIM_PROFILE_VIEW_OFF) && !sim_profile_active) {
+        SimProfile_SetEnabled(true);
+        enabled_by_view = true;
+    } else if ((view == SIM_PROFILE_VIEW_OFF) && enabled_by_view) {
+        // Left running when --sim-profile turned it on, since the CSV still needs it
+        SimProfile_SetEnabled(false);
+    }
+}
+
+void SimProfile_CycleSort() {
+    sort_by = (sort_by + 1) % SIM_PROFILE_SORT_COUNT;
+}
+
+int SimProfile_FormatOverlay(char (*lines)[SIM_PROFILE_LINE_LENGTH], int max_lines) {
+    SimProfileRow rows[SIM_PROFILE_OVERLAY_ROWS];
+    SimProfileKind kind;
+    Uint64 sim_ns = 0;
+    double per_frame;
+    int count;
+
+    if ((view == SIM_PROFILE_VIEW_OFF) || (max_lines <= 0)) {
+        return 0;
+    }
+
+    kind = (SimProfileKind)(view - SIM_PROFILE_VIEW_TASKS);
+    per_frame = (frames > 0) ? (double)frames : 1.0;
+
+    // Shares are of the time spent in task slots, which don't nest
+    for (int id = 0; id < SIM_PROFILE_TASKS; id++) {
+        sim_ns += ticks_to_ns(tasks[id].ticks);
+    }
+
+    SDL_snprintf(lines[0],
+                 SIM_PROFILE_LINE_LENGTH,
+                 "Sim profile: %s by %s, %llu frames, %.1f us/frame [PgUp/PgDn]",
+                 kind_names[kind],
+                 sort_names[sort_by],
+                 (unsigned long long)frames,
+                 sim_ns / 1e3 / per_frame);
+
+    count = SimProfile_GetRows(kind, sort_by, rows, SDL_min(max_lines - 1, SIM_PROFILE_OVERLAY_ROWS));
+
+    for (int i = 0; i < count; i++) {
+        char name[32];
+
+        SimProfile_FormatName(kind, rows[i].id, name, sizeof(name));
+        SDL_snprintf(lines[i + 1],
+                     SIM_PROFILE_LINE_LENGTH,
+                     "%-12s %10llu calls %9.2f us/call %9.2f us/frame %5.1f%%",
+                     name,
+                     (unsigned long long)rows[i].calls,
+                     rows[i].ns / 1e3 / rows[i].calls,
+                     rows[i].ns / 1e3 / per_frame,
+                     (sim_ns > 0) ? rows[i].ns * 100.0 / sim_ns : 0.0);
+    }
+
+    return count + 1;
+}
@@ -2,15 +2,32 @@
  * @file adx.c
  * @brief CRI ADX audio playback engine with loop support.
  *
- * Manages multi-track ADX playback via SDL3 audio streams, including
- * file loading from AFS archives, ADX frame decoding, seamless loop
- * handling, and a pre-allocated buffer pool to avoid heap churn.
+ * Manages multi-track ADX playback, including file loading from AFS
+ * archives, ADX frame decoding, seamless loop handling, and a
+ * pre-allocated buffer pool to avoid heap churn.
+ *
+ * Three threads are involved:
+ * - The game thread calls the public API. Track changes are posted to the
+ *   decode worker over a wait-free command queue, and the state the game
+ *   polls (file count, play end) is derived from counters the worker
+ *   publishes, so no call waits on decoding or disk I/O.
+ * - The decode worker owns every track. It streams files in chunks through
+ *   AFS async I/O, starts decoding as soon as the first chunk lands, and
+ *   keeps ADX_QUEUE_MS of PCM in a lock-free ring.
+ * - The audio device callback drains the ring.
+ *
+ * In offline mode (ADX_SetOffline) there is no worker and no device:
+ * commands apply inline and ADX_ReadOffline() decodes on demand with
+ * blocking I/O, so the output only depends on the calls made.
  */
 #include "port/sound/adx.h"
 #include "common.h"
 #include "port/io/afs.h"
 #include "port/sound/adx_decoder.h"
+#include "port/sound/cmd_queue.h"
 #include "port/sound/modded_bgm.h"
+#include "port/sound/pcm_ring.h"
+#include "port/tracy_zones.h"
 
 #include <SDL3/SDL.h>
 
@@ -57,10 +74,25 @@ static void pool_free(void* ptr) {
 #define SAMPLE_RATE 48000
 #define N_CHANNELS 2
 #define BYTES_PER_SAMPLE 2
-#define MIN_QUEUED_DATA_MS 400
-#define MIN_QUEUED_DATA (int)((float)SAMPLE_RATE * MIN_QUEUED_DATA_MS / 1000 * N_CHANNELS * BYTES_PER_SAMPLE)
+#define BYTES_PER_FRAME (N_CHANNELS * BYTES_PER_SAMPLE)
 #define TRACKS_MAX 10
 
+// ⚡ PCM kept decoded ahead of the device. This used to be 400 ms in the SDL
+// stream, topped up once per game frame by the game thread; the worker
+// refills on demand, so a much shallower queue is enough.
+#define ADX_QUEUE_MS 80
+#define ADX_QUEUE_FRAMES (SAMPLE_RATE * ADX_QUEUE_MS / 1000)
+#define ADX_RING_FRAMES 8192     // Power of two; queue target plus a decode batch of slack
+#define ADX_DECODE_FRAMES 2048   // Largest single ADX_Decode call
+#define ADX_READ_SECTORS 32      // 64 KB per streamed read, over a second of stereo ADX
+#define ADX_WORKER_POLL_MS 5     // Worker wake-up when nobody signals it (I/O completion)
+#define ADX_CMD_QUEUE_SIZE 64
+
+// A seamless track counts as finished for ADX_GetNumFiles() this long before
+// its last sample is decoded, so the next entry has time to load. Matches
+// the lead the old 400 ms stream queue gave.
+#define ADX_ENTRY_LOOKAHEAD_MS 400
+
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 
@@ -87,40 +119,64 @@ typedef struct ADXTrack {
     ADXLoopInfo loop_info;
     ADXContext ctx;
     bool is_modded; // True if ModdedBGM is handling this track
+
+    int file_id;          // AFS file being streamed, -1 for in-memory tracks
+    bool looping_allowed;
+    int loaded_bytes;     // Bytes of data present so far
+    int pending_bytes;    // Size of the read in flight (0 if none)
+    bool ready;           // Header parsed, decoding may start
+    bool failed;          // Load or decode error; the track is dropped
+    bool retire_reported; // Already counted in tracks_retired
 } ADXTrack;
 
-static SDL_AudioStream* stream = NULL;
+typedef enum ADXCommandType {
+    ADX_CMD_ADD_TRACK,
+    ADX_CMD_STOP,
+} ADXCommandType;
+
+typedef struct ADXCommand {
+    ADXCommandType type;
+    int file_id;
+    void* buf;
+    size_t size;
+    bool looping;
+    bool modded;
+} ADXCommand;
+
+// Worker-owned (game thread only when there is no worker)
 static ADXTrack tracks[TRACKS_MAX] = { 0 };
 static int num_tracks = 0;
 static int first_track_index = 0;
+static SDL_AsyncIOQueue* io_queue = NULL;
+static int reads_in_flight = 0;
+static int cmds_processed = 0;
+
+// Shared between threads
+static s16 pcm_storage[ADX_RING_FRAMES * N_CHANNELS];
+static PcmRing pcm_ring;
+static ADXCommand cmd_storage[ADX_CMD_QUEUE_SIZE];
+static CmdQueue cmd_queue;
+static SDL_AtomicInt tracks_retired; // Cumulative tracks finished or dropped (worker → game)
+static SDL_AtomicInt idle_at_cmd;    // cmds_processed when the worker last ran dry, -1 while busy
+static SDL_AtomicInt stops_posted;   // ADX_Stop() calls (game → audio callback)
+static SDL_AtomicInt stops_done;     // Stops applied and ring discarded (worker → audio callback)
+static SDL_AtomicInt worker_quit;
+static SDL_Thread* worker = NULL;
+static SDL_Semaphore* worker_wake = NULL;
+
+// Game-thread-owned
+static SDL_AudioStream* stream = NULL;
+static bool offline_mode = false;
+static bool offline_paused = true; // Device streams also start paused
+static float offline_gain = 1.0f;
 static bool has_tracks = false;
+static int cmds_posted = 0;
+static int tracks_entered = 0;
+static int tracks_stop_base = 0; // tracks_entered at the last ADX_Stop()
 
-static int stream_data_needed() {
-    return MIN_QUEUED_DATA - SDL_GetAudioStreamQueued(stream);
-}
-
-static bool stream_needs_data() {
-    return stream_data_needed() > 0;
-}
-
-static bool stream_is_empty() {
-    return SDL_GetAudioStreamQueued(stream) <= 0;
-}
-
-static void* load_file(int file_id, int* size) {
-    const unsigned int file_size = AFS_GetSize(file_id);
-    *size = file_size;
-    const unsigned int sectors = (file_size + 2048 - 1) / 2048;
-    const size_t buff_size = (size_t)sectors * 2048;
-    // ⚡ Bolt: Use static buffer pool instead of malloc — eliminates heap
-    // churn during scene transitions with multiple music/SFX changes.
-    void* buff = pool_alloc(buff_size);
-
-    AFSHandle handle = AFS_Open(file_id);
-    AFS_ReadSync(handle, sectors, buff);
-    AFS_Close(handle);
-
-    return buff;
+/** @brief Frames the ring should hold before the worker stops decoding. */
+static bool ring_needs_data(u32 target) {
+    return PcmRing_Pending(&pcm_ring) < target;
 }
 
 static bool track_reached_eof(ADXTrack* track) {
@@ -161,6 +217,10 @@ static bool track_exhausted(ADXTrack* track) {
     if (track->is_modded)
         return false;
 
+    if (track->failed) {
+        return true;
+    }
+
     if (track->loop_info.looping_enabled) {
         return false; // Track is never exhausted, because it can be looped infinitely
     } else {
@@ -198,7 +258,6 @@ static int track_add_samples_to_loop(ADXTrack* track, uint8_t* buf, int num_samp
     track->processed_samples += num_samples;
     return overflow;
 }
-
 static void loop_info_init(ADXLoopInfo* info, const uint8_t* data) {
     const uint8_t version = data[0x12];
 
@@ -243,33 +302,149 @@ static void loop_info_destroy(ADXLoopInfo* info) {
     SDL_zerop(info);
 }
 
-static void process_track(ADXTrack* track) {
-    if (track->is_modded)
+
+// Worker side
+
+/** @brief Count @p track as finished for ADX_GetNumFiles(), once. */
+static void track_retire(ADXTrack* track) {
+    if (!track->retire_reported) {
+        track->retire_reported = true;
+        SDL_AddAtomicInt(&tracks_retired, 1);
+    }
+}
+
+/** @brief Parse the header once enough of the file has arrived. */
+static void track_start_decoding(ADXTrack* track) {
+    if (ADX_InitContext(&track->ctx, track->data, track->loaded_bytes) < 0) {
+        SDL_Log("Failed to initialize ADX context");
+        track->failed = true;
+        return;
+    }
+
+    track->used_bytes = track->ctx.data_offset;
+    track->processed_samples = 0;
+
+    if (track->looping_allowed) {
+        loop_info_init(&track->loop_info, track->data);
+    }
+
+    track->ready = true;
+}
+
+static void track_chunk_loaded(ADXTrack* track, int bytes) {
+    track->loaded_bytes = MIN(track->loaded_bytes + bytes, track->size);
+
+    if (!track->ready && !track->failed) {
+        track_start_decoding(track);
+    }
+}
+
+static void process_read_outcome(const SDL_AsyncIOOutcome* outcome) {
+    ADXTrack* track = (ADXTrack*)outcome->userdata;
+
+    if (outcome->type != SDL_ASYNCIO_TASK_READ) {
+        return;
+    }
+
+    reads_in_flight -= 1;
+
+    if (outcome->result == SDL_ASYNCIO_COMPLETE) {
+        track_chunk_loaded(track, track->pending_bytes);
+    } else {
+        SDL_Log("ADX: read of file %d failed", track->file_id);
+        track->failed = true;
+    }
+
+    track->pending_bytes = 0;
+}
+
+/** @brief Issue the next streamed read for @p track. Returns false while a read is in flight. */
+static bool track_request_data(ADXTrack* track) {
+    const int sector = track->loaded_bytes / 2048;
+    const int total_sectors = (track->size + 2048 - 1) / 2048;
+    const int sectors = MIN(ADX_READ_SECTORS, total_sectors - sector);
+
+    switch (AFS_ReadAsync(track->file_id, sector, sectors, track->data + sector * 2048, io_queue, track)) {
+    case AFS_READ_STATE_FINISHED:
+        // Preloaded entry: copied already
+        track_chunk_loaded(track, sectors * 2048);
+        return true;
+
+    case AFS_READ_STATE_READING:
+        track->pending_bytes = sectors * 2048;
+        reads_in_flight += 1;
+        return false;
+
+    default:
+        track->failed = true;
+        return true;
+    }
+}
+
+/** @brief Collect finished reads, then keep one read in flight for the oldest track still loading. */
+static void pump_loads(void) {
+    SDL_AsyncIOOutcome outcome;
+
+    while (SDL_GetAsyncIOResult(io_queue, &outcome)) {
+        process_read_outcome(&outcome);
+    }
+
+    for (int i = 0; i < num_tracks; i++) {
+        ADXTrack* track = &tracks[(first_track_index + i) % TRACKS_MAX];
+
+        if (track->file_id == -1 || track->is_modded) {
+            continue;
+        }
+
+        if (track->pending_bytes > 0) {
+            return;
+        }
+
+        while (!track->failed && track->loaded_bytes < track->size) {
+            if (!track_request_data(track)) {
+                return;
+            }
+        }
+    }
+}
+
+/** @brief Block until the read into @p track has landed, so its buffer can be released. */
+static void track_wait_read(ADXTrack* track) {
+    SDL_AsyncIOOutcome outcome;
+
+    while (track->pending_bytes > 0 && SDL_WaitAsyncIOResult(io_queue, &outcome, -1)) {
+        process_read_outcome(&outcome);
+    }
+}
+
+static void process_track(ADXTrack* track, u32 target) {
+    if (track->is_modded || !track->ready || track->failed)
         return;
 
     // Decode samples and queue them for playback
     // Use a stack buffer for decoding chunk
-    int16_t decode_buf[2048 * N_CHANNELS]; // 2048 samples per channel
-    const int max_samples = 2048 * N_CHANNELS;
+    int16_t decode_buf[ADX_DECODE_FRAMES * N_CHANNELS];
 
-    while (stream_needs_data() && track_needs_decoding(track)) {
-        int samples_to_decode = max_samples;
+    while (ring_needs_data(target) && track_needs_decoding(track)) {
+        int samples_to_decode = MIN(ADX_DECODE_FRAMES, (int)PcmRing_Space(&pcm_ring)) * N_CHANNELS;
         int bytes_consumed = 0;
 
+        // Only whole frames that have already been streamed in
         int ret = ADX_Decode(&track->ctx,
                              track->data + track->used_bytes,
-                             track->size - track->used_bytes,
+                             track->loaded_bytes - track->used_bytes,
                              decode_buf,
                              &samples_to_decode,
                              &bytes_consumed);
 
         if (ret < 0) {
             SDL_Log("ADX decoding error");
+            track->failed = true;
             break;
         }
 
         if (samples_to_decode == 0) {
-            // No more full frames available
+            // Next chunk not loaded yet, or no room in the ring
             break;
         }
 
@@ -283,71 +458,72 @@ static void process_track(ADXTrack* track) {
         int samples_to_queue = samples_to_decode - samples_overflow;
 
         if (samples_to_queue > 0) {
-            int bytes_to_queue = samples_to_queue * sizeof(int16_t);
-            SDL_PutAudioStreamData(stream, decode_buf, bytes_to_queue);
+            PcmRing_Write(&pcm_ring, decode_buf, samples_to_queue / N_CHANNELS);
         }
     }
 
     // Queue looped samples (if needed)
-    while (track_loop_filled(track) && stream_needs_data()) {
-        const int available_data = track->loop_info.data_size - track->loop_info.position;
-        const int data_to_queue = MIN(stream_data_needed(), available_data);
-        SDL_PutAudioStreamData(stream, track->loop_info.data + track->loop_info.position, data_to_queue);
-        track->loop_info.position += data_to_queue;
+    while (track_loop_filled(track) && ring_needs_data(target)) {
+        const int available_frames = (track->loop_info.data_size - track->loop_info.position) / BYTES_PER_FRAME;
+        const int wanted_frames = (int)(target - PcmRing_Pending(&pcm_ring));
+        const u32 written = PcmRing_Write(&pcm_ring,
+                                          (const s16*)(track->loop_info.data + track->loop_info.position),
+                                          MIN(wanted_frames, available_frames));
+
+        if (written == 0) {
+            break;
+        }
+
+        track->loop_info.position += written * BYTES_PER_FRAME;
 
         if (track->loop_info.position == track->loop_info.data_size) {
             track->loop_info.position = 0;
         }
     }
-}
 
-static void track_init(ADXTrack* track, int file_id, void* buf, size_t buf_size, bool looping_allowed) {
-    if (file_id == -1 && buf == NULL) {
-        fatal_error("One of file_id or buf must be valid.");
-    }
+    // Let the game queue the next seamless entry while this one still has a lead
+    if (!track->loop_info.looping_enabled && track->ctx.frame_size > 0) {
+        const int frames_left = (track->size - track->used_bytes) / track->ctx.frame_size;
 
-    // Try Modded BGM first if it's a file ID
-    if (file_id != -1 && ModdedBGM_Play(file_id)) {
-        track->is_modded = true;
-        track->data = NULL;
-        track->size = 0;
-        track->should_free_data_after_use = false;
-        track->used_bytes = 0;
-        track->processed_samples = 0;
-        SDL_zerop(&track->loop_info);
-        SDL_zerop(&track->ctx);
-        return;
+        if (frames_left * track->ctx.samples_per_block < track->ctx.sample_rate * ADX_ENTRY_LOOKAHEAD_MS / 1000) {
+            track_retire(track);
+        }
     }
+}
 
-    track->is_modded = false;
-
-    if (file_id != -1) {
-        track->data = load_file(file_id, &track->size);
-        track->should_free_data_after_use = true;
-    } else {
-        track->data = buf;
-        track->size = (int)buf_size;
-        track->should_free_data_after_use = false;
-    }
+static void track_init(ADXTrack* track, const ADXCommand* cmd) {
+    SDL_zerop(track);
+    track->file_id = -1;
+    track->looping_allowed = cmd->looping;
 
-    // Initialize Decoder
-    if (ADX_InitContext(&track->ctx, track->data, track->size) < 0) {
-        SDL_Log("Failed to initialize ADX context");
-        // Handle error gracefully?
+    if (cmd->modded) {
+        track->is_modded = true;
         return;
     }
 
-    track->used_bytes = track->ctx.data_offset;
-    track->processed_samples = 0;
+    if (cmd->file_id != -1) {
+        const unsigned int file_size = AFS_GetSize(cmd->file_id);
+        const unsigned int sectors = (file_size + 2048 - 1) / 2048;
 
-    if (looping_allowed) {
-        loop_info_init(&track->loop_info, track->data);
+        // ⚡ Bolt: Use static buffer pool instead of malloc — eliminates heap
+        // churn during scene transitions with multiple music/SFX changes.
+        track->file_id = cmd->file_id;
+        track->size = (int)file_size;
+        track->data = pool_alloc((size_t)sectors * 2048);
+        track->should_free_data_after_use = true;
+        return; // Streamed in by pump_loads()
     }
 
-    process_track(track); // Feed first batch of data to the stream
+    track->data = cmd->buf;
+    track->size = (int)cmd->size;
+    track->loaded_bytes = track->size;
+    track->should_free_data_after_use = false;
+    track_start_decoding(track);
 }
 
 static void track_destroy(ADXTrack* track) {
+    track_wait_read(track);
+    track_retire(track);
     loop_info_destroy(&track->loop_info);
 
     if (track->should_free_data_after_use) {
@@ -360,26 +536,50 @@ static void track_destroy(ADXTrack* track) {
 static ADXTrack* alloc_track() {
     const int index = (first_track_index + num_tracks) % TRACKS_MAX;
     num_tracks += 1;
-    has_tracks = true;
     return &tracks[index];
 }
 
-void ADX_ProcessTracks() {
-    if (!stream)
-        return;
+static void destroy_all_tracks(void) {
+    for (int i = 0; i < num_tracks; i++) {
+        const int j = (first_track_index + i) % TRACKS_MAX;
+        track_destroy(&tracks[j]);
+    }
 
-    // ⚡ Bolt: Skip entirely when audio buffer is healthy — avoids
-    // track iteration, loop bookkeeping, and exhaustion checks.
-    if (!stream_needs_data())
-        return;
+    num_tracks = 0;
+    first_track_index = 0;
+}
+
+static void apply_command(const ADXCommand* cmd) {
+    switch (cmd->type) {
+    case ADX_CMD_ADD_TRACK:
+        if (num_tracks == TRACKS_MAX) {
+            SDL_Log("ADX: track queue full, dropping file %d", cmd->file_id);
+            SDL_AddAtomicInt(&tracks_retired, 1);
+            break;
+        }
+
+        track_init(alloc_track(), cmd);
+        break;
+
+    case ADX_CMD_STOP:
+        destroy_all_tracks();
+        PcmRing_Discard(&pcm_ring);
+        SDL_AddAtomicInt(&stops_done, 1);
+        break;
+    }
+
+    cmds_processed += 1;
+}
 
+/** @brief Decode the oldest tracks into the ring until it holds @p target frames. */
+static void decode_tracks(u32 target) {
     const int first_track_index_old = first_track_index;
     const int num_tracks_old = num_tracks;
 
     for (int i = 0; i < num_tracks_old; i++) {
         const int j = (first_track_index_old + i) % TRACKS_MAX;
         ADXTrack* track = &tracks[j];
-        process_track(track);
+        process_track(track, target);
 
         if (!track_exhausted(track)) {
             // No need to continue if the current track is not exhausted yet
@@ -390,49 +590,292 @@ void ADX_ProcessTracks() {
         num_tracks -= 1;
 
         if (num_tracks > 0) {
-            first_track_index += 1;
+            first_track_index = (first_track_index + 1) % TRACKS_MAX;
         } else {
             first_track_index = 0;
         }
     }
 }
 
+/** @brief True while the oldest track can still produce PCM (is loading, decoding or looping). */
+static bool worker_has_work(void) {
+    if (num_tracks == 0) {
+        return false;
+    }
+
+    ADXTrack* track = &tracks[first_track_index % TRACKS_MAX];
+    return !track->is_modded && !track_exhausted(track);
+}
+
+/**
+ * @brief One worker pass: apply commands, advance streaming, decode up to @p target frames.
+ *
+ * With @p wait_io the pass blocks on outstanding reads until the target is
+ * met or nothing is left to decode (offline mode).
+ */
+static void worker_step(u32 target, bool wait_io) {
+    const ADXCommand* cmd;
+
+    TRACE_ZONE_N("ADX_Decode");
+
+    while ((cmd = CmdQueue_Peek(&cmd_queue)) != NULL) {
+        apply_command(cmd);
+        CmdQueue_Pop(&cmd_queue);
+    }
+
+    for (;;) {
+        pump_loads();
+        decode_tracks(target);
+
+        if (!wait_io || !ring_needs_data(target) || reads_in_flight == 0) {
+            break;
+        }
+
+        SDL_AsyncIOOutcome outcome;
+        if (SDL_WaitAsyncIOResult(io_queue, &outcome, -1)) {
+            process_read_outcome(&outcome);
+        }
+    }
+
+    SDL_SetAtomicInt(&idle_at_cmd, worker_has_work() ? -1 : cmds_processed);
+    TRACE_PLOT_INT("AdxQueuedFrames", PcmRing_Pending(&pcm_ring));
+    TRACE_ZONE_END();
+}
+
+static int adx_worker(void* arg) {
+    (void)arg;
+    TRACE_THREAD_NAME("ADX decode");
+
+    while (!SDL_GetAtomicInt(&worker_quit)) {
+        worker_step(ADX_QUEUE_FRAMES, false);
+
+        // Woken early by commands and by the audio callback when the ring runs low
+        SDL_WaitSemaphoreTimeout(worker_wake, ADX_WORKER_POLL_MS);
+    }
+
+    return 0;
+}
+
+static void wake_worker(void) {
+    if (worker_wake && SDL_GetSemaphoreValue(worker_wake) == 0) {
+        SDL_SignalSemaphore(worker_wake);
+    }
+}
+
+// Audio thread
+
+static void adx_audio_cb(void* user, SDL_AudioStream* audio_stream, int additional_amount, int total_amount) {
+    static s16 buf[1024 * N_CHANNELS];
+    static int underruns = 0;
+    int frames = additional_amount / BYTES_PER_FRAME;
+
+    (void)user;
+    (void)total_amount;
+
+    // Until the worker has applied a Stop, the ring may still hold the old track
+    if (SDL_GetAtomicInt(&stops_posted) != SDL_GetAtomicInt(&stops_done)) {
+        return;
+    }
+
+    while (frames > 0) {
+        const u32 n = PcmRing_Read(&pcm_ring, buf, MIN(frames, 1024));
+
+        if (n == 0) {
+            // Running dry is only an underrun if the worker still had something to play
+            if (SDL_GetAtomicInt(&idle_at_cmd) == -1) {
+                underruns += 1;
+                TRACE_PLOT_INT("AdxUnderruns", underruns);
+            }
+            break;
+        }
+
+        SDL_PutAudioStreamData(audio_stream, buf, (int)n * BYTES_PER_FRAME);
+        frames -= (int)n;
+    }
+
+    if (PcmRing_Pending(&pcm_ring) < ADX_QUEUE_FRAMES / 2) {
+        wake_worker();
+    }
+}
+
+// Game thread
+
+static void post_command(const ADXCommand* cmd) {
+    ADXCommand* slot;
+
+    cmds_posted += 1;
+
+    if (!worker) {
+        apply_command(cmd);
+        return;
+    }
+
+    // 64 slots vs. a handful of commands per frame: only a stalled worker fills it
+    while ((slot = CmdQueue_Reserve(&cmd_queue)) == NULL) {
+        wake_worker();
+        SDL_Delay(1);
+    }
+
+    *slot = *cmd;
+    CmdQueue_Push(&cmd_queue);
+    wake_worker();
+}
+
+static void post_track(int file_id, void* buf, size_t size, bool looping) {
+    ADXCommand cmd = { .type = ADX_CMD_ADD_TRACK, .file_id = file_id, .buf = buf, .size = size, .looping = looping };
+
+    if (file_id == -1 && buf == NULL) {
+        fatal_error("One of file_id or buf must be valid.");
+    }
+
+    // Try Modded BGM first if it's a file ID
+    if (file_id != -1 && ModdedBGM_Play(file_id)) {
+        cmd.modded = true;
+    }
+
+    tracks_entered += 1;
+    has_tracks = true;
+    post_command(&cmd);
+}
+
+/** @brief Nothing left to hear: the worker has applied every command and run dry, and the queues are empty. */
+static bool stream_is_empty() {
+    if (SDL_GetAtomicInt(&idle_at_cmd) != cmds_posted) {
+        return false;
+    }
+
+    if (PcmRing_Pending(&pcm_ring) > 0) {
+        return false;
+    }
+
+    return !stream || SDL_GetAudioStreamQueued(stream) <= 0;
+}
+
+void ADX_ProcessTracks() {
+    // Offline mode decodes on demand in ADX_ReadOffline()
+    if (offline_mode) {
+        return;
+    }
+
+    // No worker thread: decode on the game thread, once per frame
+    if (!worker) {
+        worker_step(ADX_QUEUE_FRAMES * 2, false);
+    }
+}
+
 void ADX_Init() {
     const SDL_AudioSpec spec = { .format = SDL_AUDIO_S16, .channels = N_CHANNELS, .freq = SAMPLE_RATE };
-    stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, NULL, NULL);
+
+    PcmRing_Init(&pcm_ring, pcm_storage, ADX_RING_FRAMES);
+    CmdQueue_Init(&cmd_queue, cmd_storage, sizeof(ADXCommand), ADX_CMD_QUEUE_SIZE);
+    SDL_SetAtomicInt(&tracks_retired, 0);
+    SDL_SetAtomicInt(&idle_at_cmd, 0);
+    SDL_SetAtomicInt(&stops_posted, 0);
+    SDL_SetAtomicInt(&stops_done, 0);
+    cmds_posted = 0;
+    cmds_processed = 0;
+    tracks_entered = 0;
+    tracks_stop_base = 0;
+
+    io_queue = SDL_CreateAsyncIOQueue();
+
+    if (!offline_mode) {
+        stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, adx_audio_cb, NULL);
+
+        SDL_SetAtomicInt(&worker_quit, 0);
+        worker_wake = SDL_CreateSemaphore(0);
+        worker = SDL_CreateThread(adx_worker, "ADX_Decode", NULL);
+
+        if (!worker) {
+            SDL_Log("ADX: no decode worker (%s); decoding on the game thread", SDL_GetError());
+        }
+    } else {
+        offline_paused = true;
+    }
 
     ModdedBGM_Init();
 }
 
 void ADX_Exit() {
     ADX_Stop();
+
+    if (worker) {
+        SDL_SetAtomicInt(&worker_quit, 1);
+        SDL_SignalSemaphore(worker_wake);
+        SDL_WaitThread(worker, NULL);
+        worker = NULL;
+    }
+
     SDL_DestroyAudioStream(stream);
     stream = NULL;
 
+    // The worker is gone: apply anything it left behind on this thread
+    worker_step(0, false);
+    destroy_all_tracks();
+
+    SDL_DestroySemaphore(worker_wake);
+    worker_wake = NULL;
+    SDL_DestroyAsyncIOQueue(io_queue);
+    io_queue = NULL;
+
     ModdedBGM_Exit();
 }
 
 void ADX_Stop() {
+    const ADXCommand cmd = { .type = ADX_CMD_STOP };
+
     ADX_Pause(true);
-    SDL_ClearAudioStream(stream);
-    ModdedBGM_Stop();
 
-    for (int i = 0; i < num_tracks; i++) {
-        const int j = (first_track_index + i) % TRACKS_MAX;
-        track_destroy(&tracks[j]);
+    if (stream) {
+        SDL_ClearAudioStream(stream);
     }
 
-    num_tracks = 0;
-    first_track_index = 0;
+    ModdedBGM_Stop();
+
+    // Raised before posting, so the callback holds off until the ring is discarded
+    SDL_AddAtomicInt(&stops_posted, 1);
+    post_command(&cmd);
+
+    tracks_stop_base = tracks_entered;
     has_tracks = false;
 }
 
+void ADX_SetOffline(bool enable) {
+    offline_mode = enable;
+}
+
+int ADX_ReadOffline(int16_t* output, int count) {
+    u32 got = 0;
+
+    if (!offline_paused) {
+        // Decode exactly what this read needs now, waiting for I/O if necessary
+        worker_step(MAX((u32)count, ADX_QUEUE_FRAMES), true);
+        got = PcmRing_Read(&pcm_ring, output, (u32)count);
+
+        if (offline_gain != 1.0f) {
+            for (u32 i = 0; i < got * N_CHANNELS; i++) {
+                output[i] = (int16_t)SDL_clamp((int)(output[i] * offline_gain), INT16_MIN, INT16_MAX);
+            }
+        }
+    }
+
+    // An underrun is silence, exactly as the device would play it
+    memset(output + got * N_CHANNELS, 0, (count - got) * BYTES_PER_FRAME);
+    return (int)got;
+}
+
 int ADX_IsPaused() {
+    if (offline_mode) {
+        return offline_paused;
+    }
+
     return SDL_AudioStreamDevicePaused(stream);
 }
 
 void ADX_Pause(int pause) {
-    if (pause) {
+    if (offline_mode) {
+        offline_paused = pause;
+    } else if (pause) {
         SDL_PauseAudioStreamDevice(stream);
     } else {
         SDL_ResumeAudioStreamDevice(stream);
@@ -442,18 +885,17 @@ void ADX_Pause(int pause) {
 
 void ADX_StartMem(void* buf, size_t size) {
     ADX_Stop();
-
-    ADXTrack* track = alloc_track();
-    track_init(track, -1, buf, size, true);
+    post_track(-1, buf, size, true);
 }
 
 int ADX_GetNumFiles() {
-    return num_tracks;
+    // A Stop discards everything entered before it, whether or not the worker got to it yet
+    const int retired = SDL_GetAtomicInt(&tracks_retired);
+    return tracks_entered - MAX(retired, tracks_stop_base);
 }
 
 void ADX_EntryAfs(int file_id) {
-    ADXTrack* track = alloc_track();
-    track_init(track, file_id, NULL, 0, false);
+    post_track(file_id, NULL, 0, false);
 }
 
 void ADX_StartSeamless() {
@@ -466,15 +908,18 @@ void ADX_ResetEntry() {
 
 void ADX_StartAfs(int file_id) {
     ADX_Stop();
-
-    ADXTrack* track = alloc_track();
-    track_init(track, file_id, NULL, 0, true);
+    post_track(file_id, NULL, 0, true);
 }
 
 void ADX_SetOutVol(int volume) {
     // Convert volume (dB * 10) to linear gain
     const float gain = powf(10.0f, (float)volume / 200.0f);
-    SDL_SetAudioStreamGain(stream, gain);
+
+    if (offline_mode) {
+        offline_gain = gain;
+    } else {
+        SDL_SetAudioStreamGain(stream, gain);
+    }
     ModdedBGM_SetVolume(volume);
 }
 
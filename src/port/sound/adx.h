@@ -7,6 +7,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 typedef enum ADXState {
     ADX_STATE_STOP,
@@ -17,6 +18,12 @@ typedef enum ADXState {
 void ADX_ProcessTracks();
 
 void ADX_Init();
+
+/** @brief Open no device or decode worker in ADX_Init(); playback is then pulled with ADX_ReadOffline(). */
+void ADX_SetOffline(bool enable);
+
+/** @brief Offline mode: read @p count stereo samples (silence-padded); returns samples actually decoded. */
+int ADX_ReadOffline(int16_t* output, int count);
 void ADX_Exit();
 void ADX_Stop();
 int ADX_IsPaused();
@@ -6,11 +6,22 @@
  * headers (v3/v4), computes prediction coefficients from a 500 Hz
  * cutoff filter, and decodes 4-bit ADPCM blocks into 16-bit PCM
  * with per-channel state tracking.
+ *
+ * Standard 18-byte blocks take a SIMD path: the nibbles of a whole block
+ * are unpacked and scaled in vector registers, then only the two-tap
+ * predictor (which is inherently serial) runs per sample. Stereo frames
+ * run both channels' predictors in the same loop and write interleaved
+ * output directly. Other block sizes use the per-nibble reference path,
+ * which ADX_DecodeReference() also exposes for verification.
  */
 #include "port/sound/adx_decoder.h"
 #include <math.h>
+#include <simde/x86/sse2.h>
 #include <string.h>
 
+#define ADX_SIMD_BLOCK_SIZE 18 // 2-byte scale + 16 data bytes
+#define ADX_SIMD_BLOCK_SAMPLES 32
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -95,6 +106,7 @@ int ADX_InitContext(ADXContext* ctx, const u8* header, size_t header_size) {
     return 0;
 }
 
+/** @brief Per-nibble reference decoder; writes every @p stride-th sample. */
 static void decode_block(ADXContext* ctx, int channel, const u8* block, s16* out, int stride) {
     int scale = read_u16be(block);
     int c1 = ctx->coeff1;
@@ -129,8 +141,101 @@ static void decode_block(ADXContext* ctx, int channel, const u8* block, s16* out
     ctx->ch_state[channel].prev2 = p2;
 }
 
-int ADX_Decode(ADXContext* ctx, const u8* in_buffer, size_t in_size, s16* out_buffer, s32* out_samples,
-               s32* bytes_consumed) {
+/**
+ * @brief Expand one 18-byte block into 32 scaled deltas (nibble × scale).
+ *
+ * Each data byte is widened to a 16-bit lane and both nibbles are
+ * sign-extended with a shift pair. The product with the unsigned 16-bit
+ * scale is formed with madd on (d, d << 8) × (scale & 0xFF, scale >> 8), so
+ * every partial product fits in s16 and the s32 sum is exact.
+ */
+static void unpack_block_deltas(const u8* block, s32* deltas) {
+    const int scale = read_u16be(block);
+    const simde__m128i bytes = simde_mm_loadu_si128((const simde__m128i*)(block + 2));
+    const simde__m128i zero = simde_mm_setzero_si128();
+    const simde__m128i k = simde_mm_set1_epi32((scale >> 8) << 16 | (scale & 0xFF));
+    const simde__m128i halves[2] = { simde_mm_unpacklo_epi8(bytes, zero), simde_mm_unpackhi_epi8(bytes, zero) };
+
+    for (int h = 0; h < 2; h++) {
+        const simde__m128i w = halves[h];
+        const simde__m128i hi = simde_mm_srai_epi16(simde_mm_slli_epi16(w, 8), 12);
+        const simde__m128i lo = simde_mm_srai_epi16(simde_mm_slli_epi16(w, 12), 12);
+        // Sample order within a byte is high nibble first
+        const simde__m128i nib[2] = { simde_mm_unpacklo_epi16(hi, lo), simde_mm_unpackhi_epi16(hi, lo) };
+
+        for (int q = 0; q < 2; q++) {
+            const simde__m128i d = nib[q];
+            const simde__m128i d8 = simde_mm_slli_epi16(d, 8);
+            simde__m128i* dst = (simde__m128i*)&deltas[h * 16 + q * 8];
+
+            simde_mm_storeu_si128(dst, simde_mm_madd_epi16(simde_mm_unpacklo_epi16(d, d8), k));
+            simde_mm_storeu_si128(dst + 1, simde_mm_madd_epi16(simde_mm_unpackhi_epi16(d, d8), k));
+        }
+    }
+}
+
+/** @brief SIMD-unpacked mono block; the predictor state stays in locals for the whole block. */
+static void decode_block_mono(ADXContext* ctx, const u8* block, s16* out) {
+    s32 deltas[ADX_SIMD_BLOCK_SAMPLES];
+    const int c1 = ctx->coeff1;
+    const int c2 = ctx->coeff2;
+    int p1 = ctx->ch_state[0].prev1;
+    int p2 = ctx->ch_state[0].prev2;
+
+    unpack_block_deltas(block, deltas);
+
+    for (int i = 0; i < ADX_SIMD_BLOCK_SAMPLES; i++) {
+        const int s = clamp16(deltas[i] + ((c1 * p1 + c2 * p2) >> 12));
+
+        out[i] = (s16)s;
+        p2 = p1;
+        p1 = s;
+    }
+
+    ctx->ch_state[0].prev1 = p1;
+    ctx->ch_state[0].prev2 = p2;
+}
+
+/**
+ * @brief SIMD-unpacked stereo frame (L block then R block).
+ *
+ * ⚡ The two channels' predictor chains are independent, so running them
+ * side by side lets the CPU overlap one chain's multiply latency with the
+ * other's, and each frame is stored interleaved without a stride pass.
+ */
+static void decode_frame_stereo(ADXContext* ctx, const u8* frame, s16* out) {
+    s32 dl[ADX_SIMD_BLOCK_SAMPLES];
+    s32 dr[ADX_SIMD_BLOCK_SAMPLES];
+    const int c1 = ctx->coeff1;
+    const int c2 = ctx->coeff2;
+    int l1 = ctx->ch_state[0].prev1;
+    int l2 = ctx->ch_state[0].prev2;
+    int r1 = ctx->ch_state[1].prev1;
+    int r2 = ctx->ch_state[1].prev2;
+
+    unpack_block_deltas(frame, dl);
+    unpack_block_deltas(frame + ADX_SIMD_BLOCK_SIZE, dr);
+
+    for (int i = 0; i < ADX_SIMD_BLOCK_SAMPLES; i++) {
+        const int l = clamp16(dl[i] + ((c1 * l1 + c2 * l2) >> 12));
+        const int r = clamp16(dr[i] + ((c1 * r1 + c2 * r2) >> 12));
+
+        out[i * 2 + 0] = (s16)l;
+        out[i * 2 + 1] = (s16)r;
+        l2 = l1;
+        l1 = l;
+        r2 = r1;
+        r1 = r;
+    }
+
+    ctx->ch_state[0].prev1 = l1;
+    ctx->ch_state[0].prev2 = l2;
+    ctx->ch_state[1].prev1 = r1;
+    ctx->ch_state[1].prev2 = r2;
+}
+
+static int decode_frames(ADXContext* ctx, const u8* in_buffer, size_t in_size, s16* out_buffer, s32* out_samples,
+                         s32* bytes_consumed, bool reference) {
     if (!ctx || !in_buffer || !out_buffer || !out_samples || !bytes_consumed) {
         return -1;
     }
@@ -156,13 +261,22 @@ int ADX_Decode(ADXContext* ctx, const u8* in_buffer, size_t in_size, s16* out_bu
 
     const u8* src = in_buffer;
     s16* dst = out_buffer;
+    const bool simd = !reference && ctx->block_size == ADX_SIMD_BLOCK_SIZE;
 
     for (int f = 0; f < frames_to_decode; f++) {
         // For stereo: Block L (18 bytes), then Block R (18 bytes).
-        // decode_block writes interleaved samples to dst.
-        for (int ch = 0; ch < ctx->channels; ch++) {
-            decode_block(ctx, ch, src, dst + ch, ctx->channels);
-            src += ctx->block_size;
+        // Both paths write interleaved samples to dst.
+        if (simd && ctx->channels == 2) {
+            decode_frame_stereo(ctx, src, dst);
+            src += ctx->frame_size;
+        } else if (simd) {
+            decode_block_mono(ctx, src, dst);
+            src += ctx->frame_size;
+        } else {
+            for (int ch = 0; ch < ctx->channels; ch++) {
+                decode_block(ctx, ch, src, dst + ch, ctx->channels);
+                src += ctx->block_size;
+            }
         }
 
         s32 samples_produced = samples_per_frame_total;
@@ -176,3 +290,13 @@ int ADX_Decode(ADXContext* ctx, const u8* in_buffer, size_t in_size, s16* out_bu
 
     return 0;
 }
+
+int ADX_Decode(ADXContext* ctx, const u8* in_buffer, size_t in_size, s16* out_buffer, s32* out_samples,
+               s32* bytes_consumed) {
+    return decode_frames(ctx, in_buffer, in_size, out_buffer, out_samples, bytes_consumed, false);
+}
+
+int ADX_DecodeReference(ADXContext* ctx, const u8* in_buffer, size_t in_size, s16* out_buffer, s32* out_samples,
+                        s32* bytes_consumed) {
+    return decode_frames(ctx, in_buffer, in_size, out_buffer, out_samples, bytes_consumed, true);
+}
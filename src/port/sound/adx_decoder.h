@@ -44,4 +44,9 @@ int ADX_InitContext(ADXContext* ctx, const u8* header, size_t header_size);
 int ADX_Decode(ADXContext* ctx, const u8* in_buffer, size_t in_size, s16* out_buffer, s32* out_samples,
                s32* bytes_consumed);
 
+// Same contract as ADX_Decode, but always uses the per-nibble scalar decoder.
+// Bit-exact reference for verifying and benchmarking the SIMD block path.
+int ADX_DecodeReference(ADXContext* ctx, const u8* in_buffer, size_t in_size, s16* out_buffer, s32* out_samples,
+                        s32* bytes_consumed);
+
 #endif
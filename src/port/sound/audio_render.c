@@ -0,0 +1,117 @@
+/**
+ * @file audio_render.c
+ * @brief Offline, game-loop-driven audio rendering to WAV.
+ *
+ * Replaces the SDL audio devices with the game loop as the clock: every
+ * game frame pulls the exact number of samples that frame spans at
+ * 48 kHz, mixes the SPU (which runs the 250 Hz eml workTick itself) with
+ * the ADX stream, and appends the result to a WAV file. The output depends
+ * only on the game's inputs, not on wall-clock time, so it can be diffed
+ * against golden files and rendered faster than real time.
+ *
+ * Modded BGM plays through SDL_mixer's own device and is not captured.
+ */
+#include "port/sound/audio_render.h"
+#include "port/sound/adx.h"
+#include "port/sound/spu.h"
+#include "port/sound/wav_writer.h"
+#include "port/tracy_zones.h"
+
+#include <SDL3/SDL.h>
+
+#define SAMPLE_RATE 48000
+#define N_CHANNELS 2
+#define MIX_CHUNK 1024
+
+// Game tick rate as a fraction (59.59949 Hz, matches target_fps in sdl_app.c)
+#define FRAME_RATE_NUM 5959949ull
+#define FRAME_RATE_DEN 100000ull
+
+static bool active = false;
+static WavWriter wav;
+static bool wav_open = false;
+static u64 frames_rendered = 0;
+static s16 spu_buf[MIX_CHUNK * N_CHANNELS];
+static s16 adx_buf[MIX_CHUNK * N_CHANNELS];
+static s16 frame_buf[MIX_CHUNK * N_CHANNELS];
+
+/** @brief Total samples from the start of the render to the start of frame @p frame. */
+static u64 samples_before_frame(u64 frame) {
+    return frame * SAMPLE_RATE * FRAME_RATE_DEN / FRAME_RATE_NUM;
+}
+
+bool AudioRender_Begin(const char* wav_path) {
+    // Open the file first so a failure leaves the audio device in use
+    if (wav_path) {
+        wav_open = WavWriter_Open(&wav, wav_path, SAMPLE_RATE, N_CHANNELS);
+        if (!wav_open) {
+            return false;
+        }
+        SDL_Log("Rendering audio offline to %s", wav_path);
+    }
+
+    SPU_SetOffline(true);
+    ADX_SetOffline(true);
+    active = true;
+    frames_rendered = 0;
+    return true;
+}
+
+bool AudioRender_IsActive(void) {
+    return active;
+}
+
+void AudioRender_Mix(s16* output, int count) {
+    while (count > 0) {
+        const int chunk = SDL_min(count, MIX_CHUNK);
+        const int n = chunk * N_CHANNELS;
+
+        SPU_RenderOffline(spu_buf, chunk);
+        ADX_ReadOffline(adx_buf, chunk);
+
+        // Same saturation the device's mixer applies when summing two streams
+        for (int i = 0; i < n; i++) {
+            output[i] = (s16)SDL_clamp((s32)spu_buf[i] + adx_buf[i], INT16_MIN, INT16_MAX);
+        }
+
+        output += n;
+        count -= chunk;
+    }
+}
+
+void AudioRender_Frame(void) {
+    if (!active) {
+        return;
+    }
+
+    TRACE_ZONE_N("AudioRender_Frame");
+
+    // Integer frame boundaries: the fractional 805.37 samples/frame never drifts
+    const int count = (int)(samples_before_frame(frames_rendered + 1) - samples_before_frame(frames_rendered));
+    frames_rendered++;
+
+    AudioRender_Mix(frame_buf, count);
+
+    if (wav_open) {
+        WavWriter_Write(&wav, frame_buf, count);
+    }
+
+    TRACE_PLOT_INT("AudioRenderFrames", (int64_t)frames_rendered);
+    TRACE_ZONE_END();
+}
+
+void AudioRender_Finish(void) {
+    if (!active) {
+        return;
+    }
+
+    if (wav_open) {
+        SDL_Log("Offline audio: %llu frames, %llu samples",
+                (unsigned long long)frames_rendered,
+                (unsigned long long)samples_before_frame(frames_rendered));
+        WavWriter_Close(&wav);
+        wav_open = false;
+    }
+
+    active = false;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file audio_render.h
+ * @brief Offline, game-loop-driven audio rendering to WAV.
+ */
+#ifndef AUDIO_RENDER_H
+#define AUDIO_RENDER_H
+
+#include "types.h"
+#include <stdbool.h>
+
+/**
+ * @brief Switch sound output to offline rendering.
+ *
+ * Must be called before the sound system is initialised: SPU and ADX then
+ * open no audio device, and nothing plays until the game loop pulls
+ * samples. @p wav_path may be NULL to mix without writing a file.
+ *
+ * @return false, with sound output left unchanged, if the WAV can't be created.
+ */
+bool AudioRender_Begin(const char* wav_path);
+
+/** @brief True between AudioRender_Begin() and AudioRender_Finish(). */
+bool AudioRender_IsActive(void);
+
+/** @brief Mix @p count stereo samples of SPU + ADX output into @p output (no file I/O). */
+void AudioRender_Mix(s16* output, int count);
+
+/** @brief Render and write exactly one game frame of audio (805–806 samples at 59.6 Hz). */
+void AudioRender_Frame(void);
+
+/** @brief Finalise the WAV file and leave offline mode bookkeeping. */
+void AudioRender_Finish(void);
+
+#endif // AUDIO_RENDER_H
@@ -0,0 +1,71 @@
+/**
+ * @file cmd_queue.h
+ * @brief Wait-free single-producer / single-consumer queue of fixed-size records.
+ *
+ * Carries sound commands from the game thread to the SPU audio thread.
+ * The producer only writes `head` and the consumer only writes `tail`, so
+ * neither side ever waits on the other: a full queue is reported to the
+ * producer and an empty one to the consumer.
+ */
+#ifndef CMD_QUEUE_H
+#define CMD_QUEUE_H
+
+#include "types.h"
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+
+typedef struct CmdQueue {
+    u8* slots;
+    u32 slot_size;
+    u32 mask;           // capacity - 1 (capacity is a power of two)
+    SDL_AtomicInt head; // Next slot to write (producer-owned, free-running)
+    SDL_AtomicInt tail; // Next slot to read (consumer-owned, free-running)
+} CmdQueue;
+
+/** @brief Attach @p storage (capacity × slot_size bytes, capacity a power of two). */
+static inline void CmdQueue_Init(CmdQueue* q, void* storage, u32 slot_size, u32 capacity) {
+    q->slots = (u8*)storage;
+    q->slot_size = slot_size;
+    q->mask = capacity - 1;
+    SDL_SetAtomicInt(&q->head, 0);
+    SDL_SetAtomicInt(&q->tail, 0);
+}
+
+/** @brief Commands queued but not yet consumed. */
+static inline u32 CmdQueue_Count(CmdQueue* q) {
+    return (u32)SDL_GetAtomicInt(&q->head) - (u32)SDL_GetAtomicInt(&q->tail);
+}
+
+/** @brief Producer: slot to fill, or NULL if the queue is full. Publish with CmdQueue_Push(). */
+static inline void* CmdQueue_Reserve(CmdQueue* q) {
+    const u32 head = (u32)SDL_GetAtomicInt(&q->head);
+
+    if (head - (u32)SDL_GetAtomicInt(&q->tail) > q->mask) {
+        return NULL;
+    }
+
+    return q->slots + (head & q->mask) * q->slot_size;
+}
+
+/** @brief Producer: publish the slot returned by CmdQueue_Reserve(). */
+static inline void CmdQueue_Push(CmdQueue* q) {
+    SDL_SetAtomicInt(&q->head, SDL_GetAtomicInt(&q->head) + 1);
+}
+
+/** @brief Consumer: oldest unconsumed slot, or NULL if the queue is empty. */
+static inline const void* CmdQueue_Peek(CmdQueue* q) {
+    const u32 tail = (u32)SDL_GetAtomicInt(&q->tail);
+
+    if (tail == (u32)SDL_GetAtomicInt(&q->head)) {
+        return NULL;
+    }
+
+    return q->slots + (tail & q->mask) * q->slot_size;
+}
+
+/** @brief Consumer: release the slot returned by CmdQueue_Peek(). */
+static inline void CmdQueue_Pop(CmdQueue* q) {
+    SDL_SetAtomicInt(&q->tail, SDL_GetAtomicInt(&q->tail) + 1);
+}
+
+#endif // CMD_QUEUE_H
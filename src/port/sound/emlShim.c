@@ -6,14 +6,27 @@
  * allocates/frees 48 SPU voices with priority-based eviction, handles
  * key-on/key-off/stop requests, volume/pan/pitch updates with LFO
  * modulation, and note-to-pitch conversion via ps2sdk tables.
+ *
+ * Active voices are a 64-bit set and free voices a LIFO stack, so allocation
+ * is O(1). The stack reproduces the reuse order of the original free list,
+ * which matters because the SPU keeps decoder history per voice number. The
+ * active voices are also kept in a binary min-heap ordered like the original
+ * steal scan (lowest prio, then oldest, then most recently allocated), so a
+ * full pool gives up its victim without a walk. The 250 Hz tick only
+ * recomputes volume/pan/pitch for voices that are dirty or whose LFO output
+ * moved.
+ *
+ * All voice state is owned by the SPU audio thread: the public entry
+ * points only post commands (SPU_PostCommand) that are applied there
+ * between mixing batches, alongside the 250 Hz workTick.
  */
 #include "port/sound/emlShim.h"
 
 #include "common.h"
-#include "port/sound/list.h"
 #include "port/sound/spu.h"
 #include "port/tracy_zones.h"
 
+#include <SDL3/SDL.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -61,20 +74,45 @@ struct VWork {
     u32 freq;
     u16 adsr1, adsr2;
     struct LFO lfo_pitch, lfo_vol;
-    struct list_head list;
+    u32 seq;         // Allocation order; breaks steal ties in favour of the newest voice
+    u8 heap_pos;     // Index in steal_heap while active
+    bool dirty;      // Parameters changed since the last UpdateVolPanPitch
+    int lfo_vol_val; // LFO outputs used by the last UpdateVolPanPitch
+    int lfo_pitch_val;
 };
 
 static short masterVolume;
 static short assignedBankVolume[16];
 static short bankVolume[16];
 
-static struct VWork vpool[48];
+#define VOICE_COUNT 48
+
+static struct VWork vpool[VOICE_COUNT];
+
+static u64 active_voices; // Voices allocated to an SE (bit = voice_num)
+static u8 free_voices[VOICE_COUNT]; // Stack; the top is reused first
+static int free_count;
+static u32 alloc_seq;
 
-static LIST_HEAD(active_voices);
-static LIST_HEAD(free_voices);
+// Min-heap of active voices; the root is the voice a full pool steals
+static struct VWork* steal_heap[VOICE_COUNT];
+static int steal_heap_size;
+
+/** @brief Iterate @p var over the voices in @p set, lowest voice number first. */
+#define for_each_voice(var, set)                                                                                       \
+    for (u64 _set = (set); _set && ((var) = &vpool[__builtin_ctzll(_set)], 1); _set &= _set - 1)
 
 #define clamp(val, min, max) (((val) > (max)) ? (max) : (((val) < (min)) ? (min) : (val)))
 
+/** @brief Queued SE start; the post time feeds the SPU latency stats. */
+typedef struct {
+    CSE_SYS_PARAM_SNDSTART param;
+    u64 posted_ns;
+} StartSoundCmd;
+
+_Static_assert(sizeof(StartSoundCmd) <= SPU_CMD_PAYLOAD_MAX, "SNDSTART exceeds SPU command payload");
+_Static_assert(sizeof(CSE_SYS_PARAM_LFO) <= SPU_CMD_PAYLOAD_MAX, "LFO param exceeds SPU command payload");
+
 static const u16 NotePitchTable[] = {
     0x8000, 0x879C, 0x8FAC, 0x9837, 0xA145, 0xAADC, 0xB504, 0xBFC8, 0xCB2F, 0xD744, 0xE411, 0xF1A1, 0x8000, 0x800E,
     0x801D, 0x802C, 0x803B, 0x804A, 0x8058, 0x8067, 0x8076, 0x8085, 0x8094, 0x80A3, 0x80B1, 0x80C0, 0x80CF, 0x80DE,
@@ -187,7 +225,8 @@ static int GetLfoVal(struct LFO* lfo) {
 static void workTick() {
     struct VWork* i;
 
-    list_for_each (i, &active_voices, list) {
+    // Every active tick advances together, so steal_heap order is unaffected
+    for_each_voice (i, active_voices) {
         i->tick++;
         MoveLFO(&i->lfo_pitch);
         MoveLFO(&i->lfo_vol);
@@ -196,7 +235,11 @@ static void workTick() {
             SPU_VoiceKeyOff(i->voice_num);
         }
 
-        UpdateVolPanPitch(i);
+        // ⚡ The LFOs are square waves: most ticks leave both outputs (and so
+        // the SPU conf) unchanged, and the note-to-pitch conversion is skipped.
+        if (i->dirty || GetLfoVal(&i->lfo_vol) != i->lfo_vol_val || GetLfoVal(&i->lfo_pitch) != i->lfo_pitch_val) {
+            UpdateVolPanPitch(i);
+        }
     }
 
     gcVoices();
@@ -205,14 +248,10 @@ static void workTick() {
 void emlShimInit() {
     memset(vpool, 0, sizeof(vpool));
 
-    list_init(&active_voices);
-    list_init(&free_voices);
-
-    SPU_Init(workTick);
-
-    TRACE_LOCK_BEFORE(soundLockCtx);
-    SDL_LockMutex(soundLock);
-    TRACE_LOCK_AFTER(soundLockCtx);
+    active_voices = 0;
+    free_count = 0;
+    alloc_seq = 0;
+    steal_heap_size = 0;
 
     masterVolume = 0x3fff;
     for (int i = 0; i < 16; i++) {
@@ -220,63 +259,150 @@ void emlShimInit() {
         assignedBankVolume[i] = 0x3fff;
     }
 
-    for (int i = 0; i < 48; i++) {
+    for (int i = 0; i < VOICE_COUNT; i++) {
         vpool[i].voice_num = i;
-        list_init(&vpool[i].list);
-        list_insert(&free_voices, &vpool[i].list);
+        free_voices[free_count++] = (u8)i;
+    }
+
+    // Start the audio thread last: workTick touches the voice lists from there
+    SPU_Init(workTick);
+}
+
+/** @brief Steal order: lower prio first, then older (higher tick), then the later allocation. */
+static bool stealsBefore(const struct VWork* a, const struct VWork* b) {
+    if (a->id.prio != b->id.prio) {
+        return a->id.prio < b->id.prio;
     }
 
-    SDL_UnlockMutex(soundLock);
-    TRACE_LOCK_UNLOCK(soundLockCtx);
+    if (a->tick != b->tick) {
+        return a->tick > b->tick;
+    }
+
+    return (s32)(a->seq - b->seq) > 0;
+}
+
+static void heapPlace(struct VWork* v, int pos) {
+    steal_heap[pos] = v;
+    v->heap_pos = (u8)pos;
+}
+
+static void heapSiftUp(int pos) {
+    struct VWork* v = steal_heap[pos];
+
+    while (pos > 0) {
+        const int parent = (pos - 1) / 2;
+
+        if (!stealsBefore(v, steal_heap[parent])) {
+            break;
+        }
+
+        heapPlace(steal_heap[parent], pos);
+        pos = parent;
+    }
+
+    heapPlace(v, pos);
+}
+
+static void heapSiftDown(int pos) {
+    struct VWork* v = steal_heap[pos];
+
+    for (;;) {
+        int child = pos * 2 + 1;
+
+        if (child >= steal_heap_size) {
+            break;
+        }
+        if (child + 1 < steal_heap_size && stealsBefore(steal_heap[child + 1], steal_heap[child])) {
+            child++;
+        }
+        if (!stealsBefore(steal_heap[child], v)) {
+            break;
+        }
+
+        heapPlace(steal_heap[child], pos);
+        pos = child;
+    }
+
+    heapPlace(v, pos);
+}
+
+static void heapRemove(struct VWork* v) {
+    const int pos = v->heap_pos;
+    struct VWork* last = steal_heap[--steal_heap_size];
+
+    if (last == v) {
+        return;
+    }
+
+    heapPlace(last, pos);
+    heapSiftUp(pos);
+    heapSiftDown(last->heap_pos);
+}
+
+/** @brief Return an active voice to the free set. */
+static void releaseVoice(struct VWork* v) {
+    const u64 bit = 1ULL << v->voice_num;
+
+    heapRemove(v);
+    active_voices &= ~bit;
+    free_voices[free_count++] = (u8)v->voice_num;
 }
 
 static int gcVoices() {
-    struct VWork *i, *n;
+    struct VWork* finished[VOICE_COUNT];
+    struct VWork* i;
     int numFreed = 0;
 
-    TRACE_LOCK_BEFORE(soundLockCtx);
-    SDL_LockMutex(soundLock);
-    TRACE_LOCK_AFTER(soundLockCtx);
-
-    list_for_each_safe (i, n, &active_voices, list) {
+    for_each_voice (i, active_voices) {
         if (SPU_VoiceIsFinished(i->voice_num)) {
-            list_remove(&i->list);
-            list_insert(&free_voices, &i->list);
-            numFreed++;
+            // Newest allocation first, as the original active-list walk freed them
+            int n = numFreed++;
+
+            for (; n > 0 && (s32)(i->seq - finished[n - 1]->seq) > 0; n--) {
+                finished[n] = finished[n - 1];
+            }
+            finished[n] = i;
         }
     }
 
-    SDL_UnlockMutex(soundLock);
-    TRACE_LOCK_UNLOCK(soundLockCtx);
+    for (int n = 0; n < numFreed; n++) {
+        releaseVoice(finished[n]);
+    }
 
     return numFreed;
 }
 
-static struct VWork* allocVoice() {
+/**
+ * @brief Take a free voice for @p reqp, stealing from a full pool if needed.
+ *
+ * The voice enters the steal heap with the request's prio and a zero tick.
+ */
+static struct VWork* allocVoice(const CSE_REQP* reqp) {
     struct VWork* voice;
 
-    if (list_empty(&free_voices)) {
+    if (!free_count) {
         if (!gcVoices()) {
-            /* No naturally finished voices — steal the lowest priority one.
-             * Use a match-all request (flags=0) so getLowestPrioWk scans
-             * every active voice and picks the one with the lowest prio
-             * (oldest tick as tiebreaker). */
-            CSE_REQP steal_req;
-            memset(&steal_req, 0, sizeof(steal_req));
-            struct VWork* victim = getLowestPrioWk(&steal_req);
-            if (victim) {
-                SPU_VoiceKeyOff(victim->voice_num);
-                list_remove(&victim->list);
-                list_insert(&free_voices, &victim->list);
-            } else {
+            /* No naturally finished voices — steal the lowest priority one
+             * (oldest tick as tiebreaker), which is the root of the heap. */
+            if (!steal_heap_size) {
                 return NULL;
             }
+
+            struct VWork* victim = steal_heap[0];
+            SPU_VoiceKeyOff(victim->voice_num);
+            releaseVoice(victim);
         }
     }
 
-    voice = list_first_entry(&free_voices, struct VWork, list);
-    list_remove(&voice->list);
-    list_insert(&active_voices, &voice->list);
+    voice = &vpool[free_voices[--free_count]];
+    active_voices |= 1ULL << voice->voice_num;
+
+    voice->id.prio = reqp->prio;
+    voice->tick = 0;
+    voice->seq = alloc_seq++;
+    voice->dirty = true;
+    heapPlace(voice, steal_heap_size++);
+    heapSiftUp(voice->heap_pos);
 
     return voice;
 }
@@ -374,12 +500,16 @@ static void UpdateVolPanPitch(struct VWork* voice) {
     int volume, bankvol, pan, voll, volr, note, pitch;
     struct SPUVConf conf;
 
+    voice->lfo_vol_val = GetLfoVal(&voice->lfo_vol);
+    voice->lfo_pitch_val = GetLfoVal(&voice->lfo_pitch);
+    voice->dirty = false;
+
     bankvol = bankVolume[voice->id.bank & 0xf];
     volume = (bankvol * voice->req_vol) / 0x3fff;
     volume = (volume * voice->ph_vol) / 0x3fff;
-    volume = clamp(volume + GetLfoVal(&voice->lfo_vol), 0, 0x3fff);
+    volume = clamp(volume + voice->lfo_vol_val, 0, 0x3fff);
     pan = clamp((voice->ph_pan + voice->req_pan) - 64, 0, 127);
-    note = clamp(voice->ph_pitch + voice->req_pitch + GetLfoVal(&voice->lfo_pitch), -6000, 6000);
+    note = clamp(voice->ph_pitch + voice->req_pitch + voice->lfo_pitch_val, -6000, 6000);
     pitch = (voice->freq * sceSdNote2Pitch(0x3c, 0, note / 100 + 60, note % 100)) / 48000;
 
     voll = 0x3fff * ((volume * (127 - pan)) / 127) / 0x3fff;
@@ -400,7 +530,7 @@ static int getCategoryVoiceNum(CSE_REQP* reqp) {
     struct VWork* i;
     int count = 0;
 
-    list_for_each (i, &active_voices, list) {
+    for_each_voice (i, active_voices) {
         if (checkConditions(&i->id, reqp, cond)) {
             count++;
         }
@@ -414,22 +544,14 @@ static struct VWork* getLowestPrioWk(CSE_REQP* reqp) {
     struct VWork* lowest = NULL;
     struct VWork* i;
 
-    list_for_each (i, &active_voices, list) {
-        if (checkConditions(&i->id, reqp, cond)) {
-            if (!lowest) {
-                lowest = i;
-                continue;
-            }
-
-            if (i->id.prio < lowest->id.prio) {
-                lowest = i;
-                continue;
-            }
+    // A match-all request wants the global steal order
+    if (!cond) {
+        return steal_heap_size ? steal_heap[0] : NULL;
+    }
 
-            if (i->id.prio == lowest->id.prio && lowest->tick < i->tick) {
-                lowest = i;
-                continue;
-            }
+    for_each_voice (i, active_voices) {
+        if (checkConditions(&i->id, reqp, cond) && (!lowest || stealsBefore(i, lowest))) {
+            lowest = i;
         }
     }
 
@@ -458,7 +580,7 @@ static int doSeDrop(CSE_REQP* reqp) {
             }
         }
     } else if (reqp->flags & 1) {
-        list_for_each (v, &active_voices, list) {
+        for_each_voice (v, active_voices) {
             if (checkConditions(&v->id, reqp, cond)) {
                 if (reqp->prio < v->id.prio) {
                     ret = 0;
@@ -477,23 +599,21 @@ static int doSeDrop(CSE_REQP* reqp) {
     return ret;
 }
 
-void emlShimStartSound(CSE_SYS_PARAM_SNDSTART* param) {
+// --- Commands, run on the audio thread ---
+
+static void cmdStartSound(const void* payload) {
+    const StartSoundCmd* cmd = payload;
+    CSE_SYS_PARAM_SNDSTART sndstart = cmd->param;
+    CSE_SYS_PARAM_SNDSTART* param = &sndstart;
     struct VWork* voice;
 
-    TRACE_LOCK_BEFORE(soundLockCtx);
-    SDL_LockMutex(soundLock);
-    TRACE_LOCK_AFTER(soundLockCtx);
     if (!doSeDrop(&param->reqp)) {
-        SDL_UnlockMutex(soundLock);
-        TRACE_LOCK_UNLOCK(soundLockCtx);
         return;
     }
 
-    voice = allocVoice();
+    voice = allocVoice(&param->reqp);
     if (!voice) {
         printf("no free voices!\n");
-        SDL_UnlockMutex(soundLock);
-        TRACE_LOCK_UNLOCK(soundLockCtx);
         return;
     }
 
@@ -527,65 +647,47 @@ void emlShimStartSound(CSE_SYS_PARAM_SNDSTART* param) {
 
     SPU_VoiceStart(voice->voice_num, param->phdp.s_addr >> 1);
 
-    SDL_UnlockMutex(soundLock);
-    TRACE_LOCK_UNLOCK(soundLockCtx);
+    // Runs at a batch boundary, so this batch is the first to mix the voice
+    SPU_NoteStartLatency(cmd->posted_ns);
 }
 
-void emlShimSeKeyOff(CSE_REQP* pReqp) {
-    u32 cond = makeConditions(pReqp);
+static void cmdSeKeyOff(const void* payload) {
+    CSE_REQP reqp = *(const CSE_REQP*)payload;
+    u32 cond = makeConditions(&reqp);
     struct VWork* i;
 
-    TRACE_LOCK_BEFORE(soundLockCtx);
-    SDL_LockMutex(soundLock);
-    TRACE_LOCK_AFTER(soundLockCtx);
-
-    list_for_each (i, &active_voices, list) {
-        if (checkConditions(&i->id, pReqp, cond)) {
+    for_each_voice (i, active_voices) {
+        if (checkConditions(&i->id, &reqp, cond)) {
             SPU_VoiceKeyOff(i->voice_num);
         }
     }
-
-    SDL_UnlockMutex(soundLock);
-    TRACE_LOCK_UNLOCK(soundLockCtx);
 }
 
-void emlShimSeStop(CSE_REQP* pReqp) {
-    u32 cond = makeConditions(pReqp);
+static void cmdSeStop(const void* payload) {
+    CSE_REQP reqp = *(const CSE_REQP*)payload;
+    u32 cond = makeConditions(&reqp);
     struct VWork* i;
 
-    TRACE_LOCK_BEFORE(soundLockCtx);
-    SDL_LockMutex(soundLock);
-    TRACE_LOCK_AFTER(soundLockCtx);
-
-    list_for_each (i, &active_voices, list) {
-        if (checkConditions(&i->id, pReqp, cond)) {
+    for_each_voice (i, active_voices) {
+        if (checkConditions(&i->id, &reqp, cond)) {
             SPU_VoiceStop(i->voice_num);
         }
     }
-
-    SDL_UnlockMutex(soundLock);
-    TRACE_LOCK_UNLOCK(soundLockCtx);
 }
 
-void emlShimSeStopAll() {
+static void cmdSeStopAll(const void* payload) {
     struct VWork* i;
 
-    TRACE_LOCK_BEFORE(soundLockCtx);
-    SDL_LockMutex(soundLock);
-    TRACE_LOCK_AFTER(soundLockCtx);
+    (void)payload;
 
-    list_for_each (i, &active_voices, list) {
+    for_each_voice (i, active_voices) {
         SPU_VoiceStop(i->voice_num);
     }
-
-    SDL_UnlockMutex(soundLock);
-    TRACE_LOCK_UNLOCK(soundLockCtx);
 }
 
-void emlShimSysSetVolume(CSE_SYS_PARAM_BANKVOL* param) {
-    TRACE_LOCK_BEFORE(soundLockCtx);
-    SDL_LockMutex(soundLock);
-    TRACE_LOCK_AFTER(soundLockCtx);
+static void cmdSysSetVolume(const void* payload) {
+    const CSE_SYS_PARAM_BANKVOL* param = payload;
+    struct VWork* voice;
 
     if (param->bank == 0xff) {
         masterVolume = param->vol ? (param->vol * 0x3fff) / 0x7f : 0;
@@ -597,20 +699,20 @@ void emlShimSysSetVolume(CSE_SYS_PARAM_BANKVOL* param) {
         bankVolume[i] = (masterVolume * assignedBankVolume[i]) / 0x3fff;
     }
 
-    SDL_UnlockMutex(soundLock);
-    TRACE_LOCK_UNLOCK(soundLockCtx);
+    for_each_voice (voice, active_voices) {
+        voice->dirty = true;
+    }
 }
 
-void emlShimSeSetLfo(CSE_SYS_PARAM_LFO* param) {
+static void cmdSeSetLfo(const void* payload) {
+    CSE_SYS_PARAM_LFO lfo = *(const CSE_SYS_PARAM_LFO*)payload;
+    CSE_SYS_PARAM_LFO* param = &lfo;
     u32 cond = makeConditions(&param->reqp);
     struct VWork* i;
 
-    TRACE_LOCK_BEFORE(soundLockCtx);
-    SDL_LockMutex(soundLock);
-    TRACE_LOCK_AFTER(soundLockCtx);
-
-    list_for_each (i, &active_voices, list) {
+    for_each_voice (i, active_voices) {
         if (checkConditions(&i->id, &param->reqp, cond)) {
+            i->dirty = true;
             i->lfo_pitch.state = 0;
             i->lfo_pitch.speed = param->pmd_speed;
             i->lfo_pitch.depth = param->pmd_depth;
@@ -620,9 +722,36 @@ void emlShimSeSetLfo(CSE_SYS_PARAM_LFO* param) {
             i->lfo_vol.depth = param->amd_depth;
         }
     }
+}
 
-    SDL_UnlockMutex(soundLock);
-    TRACE_LOCK_UNLOCK(soundLockCtx);
+// --- Public API, called from the game thread ---
+
+void emlShimStartSound(CSE_SYS_PARAM_SNDSTART* param) {
+    StartSoundCmd cmd;
+
+    cmd.param = *param;
+    cmd.posted_ns = SDL_GetTicksNS();
+    SPU_PostCommand(cmdStartSound, &cmd, sizeof(cmd));
+}
+
+void emlShimSeKeyOff(CSE_REQP* pReqp) {
+    SPU_PostCommand(cmdSeKeyOff, pReqp, sizeof(*pReqp));
+}
+
+void emlShimSeStop(CSE_REQP* pReqp) {
+    SPU_PostCommand(cmdSeStop, pReqp, sizeof(*pReqp));
+}
+
+void emlShimSeStopAll() {
+    SPU_PostCommand(cmdSeStopAll, NULL, 0);
+}
+
+void emlShimSysSetVolume(CSE_SYS_PARAM_BANKVOL* param) {
+    SPU_PostCommand(cmdSysSetVolume, param, sizeof(*param));
+}
+
+void emlShimSeSetLfo(CSE_SYS_PARAM_LFO* param) {
+    SPU_PostCommand(cmdSeSetLfo, param, sizeof(*param));
 }
 
 void emlShimSysSetMono(CSE_SYS_PARAM_MONO* param) {
@@ -8,10 +8,20 @@
  * - Fade-out transitions
  * - Voice line replacement from assets/voice_mod/{name}.{ext}
  * - Track counting for UI display
+ *
+ * ⚡ Both mod folders are indexed once in ModdedBGM_Init(), so lookups never
+ * touch the filesystem. Tracks announced with ModdedBGM_Prefetch() (the
+ * next stage's BGM during the VS screen) are fully decoded by a loader
+ * thread into a small LRU cache bounded by `modded-bgm-cache-mb`;
+ * ModdedBGM_Play() then just binds the cached audio to the music track.
+ * A track that wasn't prefetched is opened for streaming on the game
+ * thread, as before.
  */
 #include "port/sound/modded_bgm.h"
 #include "port/config/config.h"
 #include "port/config/paths.h"
+#include "port/tracy_zones.h"
+#include "types.h"
 
 #include <SDL3/SDL.h>
 #include <SDL3_mixer/SDL_mixer.h>
@@ -19,24 +29,577 @@
 #include <stdio.h>
 #include <string.h>
 
+#define MOD_PATH_MAX 1024
+#define MOD_VOICE_NAME_MAX 32
+#define MOD_CACHE_SLOTS 16
+#define MOD_EXTENSION_COUNT 5
+
+typedef struct ModBgmFile {
+    int id;
+    u8 ext;            // Index into mod_extensions
+    Sint64 loop_start; // From a sidecar .loop file, -1 if none
+} ModBgmFile;
+
+typedef struct ModVoiceFile {
+    char name[MOD_VOICE_NAME_MAX];
+    u8 ext;
+} ModVoiceFile;
+
+typedef enum ModSlotState {
+    MOD_SLOT_FREE,
+    MOD_SLOT_QUEUED,  // Waiting for the loader thread
+    MOD_SLOT_LOADING, // Being decoded by the loader thread
+    MOD_SLOT_READY,
+} ModSlotState;
+
+typedef struct ModCacheSlot {
+    ModSlotState state;
+    char path[MOD_PATH_MAX];
+    MIX_Audio* audio; // Predecoded
+    size_t bytes;
+    u64 last_used;
+    bool pinned; // Bound to a track, never evicted
+} ModCacheSlot;
+
+// Supported formats (SDL3_mixer decoders), in lookup priority order:
+//   ogg  — Vorbis (stb_vorbis / libvorbisfile) — supports LOOPSTART/LOOPLENGTH tags
+//   flac — FLAC (drflac / libflac)
+//   opus — Opus (libopusfile)
+//   mp3  — MP3 (drmp3 / mpg123)
+//   wav  — WAV (built-in)
+static const char* const mod_extensions[MOD_EXTENSION_COUNT] = { "ogg", "flac", "opus", "mp3", "wav" };
+
 static bool is_initialized = false;
 static MIX_Mixer* mixer = NULL;
 static MIX_Track* music_track = NULL;
 static MIX_Track* voice_track = NULL;
 static MIX_Audio* current_audio = NULL;
 static MIX_Audio* current_voice_audio = NULL;
+static int current_slot = -1;       // Cache slot behind current_audio, -1 if it is a private streaming load
+static int current_voice_slot = -1; // Same for current_voice_audio
 
 /* Fade-out state — not needed, MIX_StopTrack has native fade.
  * We track whether a fade is in progress to avoid restarting. */
 static bool fade_active = false;
 
-/* Cached track count to avoid per-frame filesystem scans */
-static int cached_bgm_count = -1; /* -1 = needs refresh */
+/* Mod folder index, built once at init */
+static ModBgmFile* bgm_files = NULL; /* Sorted by id */
+static int bgm_file_count = 0;
+static int bgm_found_count = 0; /* Every audio file in bgm_mod/, for the mods menu */
+static ModVoiceFile* voice_files = NULL;
+static int voice_file_count = 0;
+
+/* Decoded audio cache, shared with the loader thread under cache_lock */
+static ModCacheSlot cache[MOD_CACHE_SLOTS];
+static size_t cache_bytes = 0;
+static size_t cache_budget = 0;
+static u64 cache_clock = 0;
+static SDL_Mutex* cache_lock = NULL;
+static SDL_Condition* cache_cond = NULL;
+static SDL_Thread* loader = NULL;
+static bool loader_quit = false;
+
+/**
+ * @brief Parse a sidecar .loop file for LOOPSTART / LOOPLENGTH values.
+ * @return true if both values were successfully parsed.
+ */
+static bool parse_loop_file(const char* loop_path, Sint64* loop_start, Sint64* loop_length) {
+    SDL_IOStream* io = SDL_IOFromFile(loop_path, "r");
+    if (!io)
+        return false;
+
+    char buf[256];
+    *loop_start = -1;
+    *loop_length = -1;
+
+    /* Read the entire small sidecar file at once */
+    size_t capacity = sizeof(buf) - 1;
+    size_t read = SDL_ReadIO(io, buf, capacity);
+    buf[read] = '\0';
+    SDL_CloseIO(io);
+
+    /* Parse LOOPSTART=N and LOOPLENGTH=N */
+    const char* p = buf;
+    while (*p) {
+        /* Skip whitespace and comments */
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+            p++;
+        if (*p == '#' || *p == ';') {
+            while (*p && *p != '\n')
+                p++;
+            continue;
+        }
+
+        if (SDL_strncasecmp(p, "LOOPSTART=", 10) == 0) {
+            *loop_start = SDL_strtoll(p + 10, NULL, 10);
+        } else if (SDL_strncasecmp(p, "LOOPLENGTH=", 11) == 0) {
+            *loop_length = SDL_strtoll(p + 11, NULL, 10);
+        }
+
+        /* Advance to next line */
+        while (*p && *p != '\n')
+            p++;
+    }
+
+    if (*loop_start >= 0 && *loop_length > 0) {
+        SDL_Log("ModdedBGM: Parsed loop file: start=%lld length=%lld", (long long)*loop_start, (long long)*loop_length);
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Build a path in assets/{subdir}/{name}.{ext}.
+ */
+static void build_asset_path(char* out, size_t out_size, const char* subdir, const char* name, const char* ext) {
+    const char* base = Paths_GetBasePath();
+    snprintf(out, out_size, "%sassets/%s/%s.%s", base ? base : "", subdir, name, ext);
+}
+
+static void build_asset_dir(char* out, size_t out_size, const char* subdir) {
+    const char* base = Paths_GetBasePath();
+    snprintf(out, out_size, "%sassets/%s", base ? base : "", subdir);
+}
+
+/* ── Mod folder index ── */
+
+static int compare_bgm_files(const void* a, const void* b) {
+    const ModBgmFile* fa = a;
+    const ModBgmFile* fb = b;
+
+    return (fa->id > fb->id) - (fa->id < fb->id);
+}
+
+static const ModBgmFile* find_bgm_file(int file_id) {
+    const ModBgmFile key = { .id = file_id };
+
+    if (bgm_file_count == 0)
+        return NULL;
+
+    return SDL_bsearch(&key, bgm_files, bgm_file_count, sizeof(ModBgmFile), compare_bgm_files);
+}
+
+static const ModVoiceFile* find_voice_file(const char* voice_name) {
+    for (int i = 0; i < voice_file_count; i++) {
+        if (SDL_strcmp(voice_files[i].name, voice_name) == 0)
+            return &voice_files[i];
+    }
+    return NULL;
+}
+
+/** @brief Strip ".{ext}" from a glob result; false if the stem doesn't fit. */
+static bool file_stem(const char* file_name, char* stem, size_t stem_size) {
+    const char* dot = SDL_strrchr(file_name, '.');
+    const size_t len = dot ? (size_t)(dot - file_name) : SDL_strlen(file_name);
+
+    if (len == 0 || len >= stem_size)
+        return false;
+
+    SDL_memcpy(stem, file_name, len);
+    stem[len] = '\0';
+    return true;
+}
+
+static void index_bgm_dir(void) {
+    char dir_path[MOD_PATH_MAX];
+    build_asset_dir(dir_path, sizeof(dir_path), "bgm_mod");
+
+    for (u8 e = 0; e < MOD_EXTENSION_COUNT; e++) {
+        char pattern[32];
+        int num_results = 0;
+        snprintf(pattern, sizeof(pattern), "*.%s", mod_extensions[e]);
+
+        char** results = SDL_GlobDirectory(dir_path, pattern, 0, &num_results);
+        if (!results)
+            continue;
+
+        bgm_found_count += num_results;
+        ModBgmFile* grown = SDL_realloc(bgm_files, (bgm_file_count + num_results) * sizeof(ModBgmFile));
+        if (!grown) {
+            SDL_free(results);
+            continue;
+        }
+        bgm_files = grown;
+
+        for (int i = 0; i < num_results; i++) {
+            char stem[32];
+            char* end;
+
+            if (!file_stem(results[i], stem, sizeof(stem)))
+                continue;
+
+            const long id = SDL_strtol(stem, &end, 10);
+            if (*end != '\0' || id < 0)
+                continue;
+
+            /* Extensions are scanned in priority order: the first one found for an id wins */
+            bool known = false;
+            for (int k = 0; k < bgm_file_count && !known; k++)
+                known = bgm_files[k].id == (int)id;
+            if (known)
+                continue;
+
+            bgm_files[bgm_file_count++] = (ModBgmFile){ .id = (int)id, .ext = e, .loop_start = -1 };
+        }
+
+        SDL_free(results);
+    }
+
+    if (bgm_file_count > 0)
+        SDL_qsort(bgm_files, bgm_file_count, sizeof(ModBgmFile), compare_bgm_files);
+
+    /* Sidecar loop points for formats without embedded tags */
+    {
+        int num_results = 0;
+        char** results = SDL_GlobDirectory(dir_path, "*.loop", 0, &num_results);
+
+        for (int i = 0; results && i < num_results; i++) {
+            char stem[32];
+            char* end;
+
+            if (!file_stem(results[i], stem, sizeof(stem)))
+                continue;
+
+            const long id = SDL_strtol(stem, &end, 10);
+            ModBgmFile* file = (ModBgmFile*)(*end == '\0' ? find_bgm_file((int)id) : NULL);
+            if (!file)
+                continue;
+
+            char loop_path[MOD_PATH_MAX];
+            Sint64 loop_start, loop_length;
+            build_asset_path(loop_path, sizeof(loop_path), "bgm_mod", stem, "loop");
+
+            /* SDL3_mixer play API only supports loop_start_frame.
+             * LOOPLENGTH from sidecar files isn't supported at the play API level —
+             * the OGG vorbis comment parser handles it natively for OGG files.
+             * For non-OGG, we can at least set the loop start point. */
+            if (parse_loop_file(loop_path, &loop_start, &loop_length))
+                file->loop_start = loop_start;
+        }
+
+        SDL_free(results);
+    }
+}
+
+static void index_voice_dir(void) {
+    char dir_path[MOD_PATH_MAX];
+    build_asset_dir(dir_path, sizeof(dir_path), "voice_mod");
+
+    for (u8 e = 0; e < MOD_EXTENSION_COUNT; e++) {
+        char pattern[32];
+        int num_results = 0;
+        snprintf(pattern, sizeof(pattern), "*.%s", mod_extensions[e]);
+
+        char** results = SDL_GlobDirectory(dir_path, pattern, 0, &num_results);
+        if (!results)
+            continue;
+
+        ModVoiceFile* grown = SDL_realloc(voice_files, (voice_file_count + num_results) * sizeof(ModVoiceFile));
+        if (!grown) {
+            SDL_free(results);
+            continue;
+        }
+        voice_files = grown;
+
+        for (int i = 0; i < num_results; i++) {
+            ModVoiceFile* file = &voice_files[voice_file_count];
+
+            if (!file_stem(results[i], file->name, sizeof(file->name)) || find_voice_file(file->name))
+                continue;
+
+            file->ext = e;
+            voice_file_count += 1;
+        }
+
+        SDL_free(results);
+    }
+}
+
+static void free_index(void) {
+    SDL_free(bgm_files);
+    SDL_free(voice_files);
+    bgm_files = NULL;
+    voice_files = NULL;
+    bgm_file_count = 0;
+    bgm_found_count = 0;
+    voice_file_count = 0;
+}
+
+/* ── Decoded audio cache ── */
+
+/** @brief Memory held by a predecoded audio (SDL_mixer keeps it as float samples). */
+static size_t audio_bytes(MIX_Audio* audio) {
+    SDL_AudioSpec spec;
+    const Sint64 frames = MIX_GetAudioDuration(audio);
+
+    if (frames <= 0 || !MIX_GetAudioFormat(audio, &spec))
+        return 0;
+
+    return (size_t)frames * spec.channels * sizeof(float);
+}
+
+static int find_slot(const char* path) {
+    for (int i = 0; i < MOD_CACHE_SLOTS; i++) {
+        if (cache[i].state != MOD_SLOT_FREE && SDL_strcmp(cache[i].path, path) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static void free_slot(ModCacheSlot* slot) {
+    if (slot->audio) {
+        MIX_DestroyAudio(slot->audio);
+        cache_bytes -= slot->bytes;
+    }
+
+    slot->state = MOD_SLOT_FREE;
+    slot->path[0] = '\0';
+    slot->audio = NULL;
+    slot->bytes = 0;
+    slot->pinned = false;
+}
+
+/** @brief Least recently used slot that may be dropped, or -1. Caller holds cache_lock. */
+static int lru_victim(int keep) {
+    int victim = -1;
+
+    for (int i = 0; i < MOD_CACHE_SLOTS; i++) {
+        const ModCacheSlot* slot = &cache[i];
+
+        if (i == keep || slot->state != MOD_SLOT_READY || slot->pinned)
+            continue;
+        if (victim < 0 || slot->last_used < cache[victim].last_used)
+            victim = i;
+    }
+
+    return victim;
+}
+
+/** @brief Drop LRU entries until the cache fits its budget. Caller holds cache_lock. */
+static void enforce_budget(int keep) {
+    while (cache_bytes > cache_budget) {
+        const int victim = lru_victim(keep);
+
+        if (victim < 0)
+            break;
+
+        SDL_Log("ModdedBGM: Evicting %s (%zu KB)", cache[victim].path, cache[victim].bytes / 1024);
+        free_slot(&cache[victim]);
+    }
+
+    TRACE_PLOT_INT("ModdedBgmCacheKB", (int64_t)(cache_bytes / 1024));
+}
+
+/** @brief Claim a slot for @p path, evicting the LRU entry if all are taken. Caller holds cache_lock. */
+static int claim_slot(const char* path, ModSlotState state) {
+    int index = -1;
+
+    for (int i = 0; i < MOD_CACHE_SLOTS && index < 0; i++) {
+        if (cache[i].state == MOD_SLOT_FREE)
+            index = i;
+    }
+
+    if (index < 0) {
+        index = lru_victim(-1);
+        if (index < 0)
+            return -1;
+        free_slot(&cache[index]);
+    }
+
+    cache[index].state = state;
+    cache[index].last_used = ++cache_clock;
+    SDL_strlcpy(cache[index].path, path, sizeof(cache[index].path));
+    return index;
+}
+
+/** @brief Decode @p path and store it in @p index. Called with cache_lock held; drops it while decoding. */
+static void load_slot(int index) {
+    char path[MOD_PATH_MAX];
+
+    cache[index].state = MOD_SLOT_LOADING;
+    SDL_strlcpy(path, cache[index].path, sizeof(path));
+    SDL_UnlockMutex(cache_lock);
+
+    TRACE_ZONE_NC("ModdedBGM_Decode", TRACE_COLOR_SOUND);
+    const Uint64 start = SDL_GetTicksNS();
+    MIX_Audio* audio = MIX_LoadAudio(mixer, path, true);
+    const size_t bytes = audio ? audio_bytes(audio) : 0;
+    TRACE_ZONE_END();
+
+    if (audio) {
+        SDL_Log("ModdedBGM: Decoded %s (%zu KB) in %.1f ms",
+                path,
+                bytes / 1024,
+                (double)(SDL_GetTicksNS() - start) / SDL_NS_PER_MS);
+    } else {
+        SDL_Log("ModdedBGM: Failed to decode %s: %s", path, SDL_GetError());
+    }
+
+    SDL_LockMutex(cache_lock);
+    ModCacheSlot* slot = &cache[index];
+
+    if (audio) {
+        slot->audio = audio;
+        slot->bytes = bytes;
+        slot->state = MOD_SLOT_READY;
+        cache_bytes += bytes;
+        enforce_budget(index);
+    } else {
+        free_slot(slot);
+    }
+
+    SDL_BroadcastCondition(cache_cond);
+}
+
+static int loader_main(void* data) {
+    (void)data;
+    TRACE_THREAD_NAME("ModdedBGM_Load");
+
+    SDL_LockMutex(cache_lock);
+
+    while (!loader_quit) {
+        int next = -1;
+
+        // Oldest request first: the track needed soonest was announced first
+        for (int i = 0; i < MOD_CACHE_SLOTS; i++) {
+            if (cache[i].state == MOD_SLOT_QUEUED && (next < 0 || cache[i].last_used < cache[next].last_used))
+                next = i;
+        }
+
+        if (next < 0) {
+            SDL_WaitCondition(cache_cond, cache_lock);
+            continue;
+        }
+
+        load_slot(next);
+    }
+
+    SDL_UnlockMutex(cache_lock);
+    return 0;
+}
+
+/** @brief Queue @p path for decoding on the loader thread unless it is already cached or on its way. */
+static void prefetch_path(const char* path) {
+    if (!loader || cache_budget == 0)
+        return;
+
+    SDL_LockMutex(cache_lock);
+
+    const int index = find_slot(path);
+    if (index >= 0) {
+        cache[index].last_used = ++cache_clock;
+    } else if (claim_slot(path, MOD_SLOT_QUEUED) >= 0) {
+        SDL_SignalCondition(cache_cond);
+    }
+
+    SDL_UnlockMutex(cache_lock);
+}
+
+/**
+ * @brief Take the cached audio for @p path and pin it, or NULL on a miss.
+ *
+ * A request that is queued or still being decoded counts as a miss, so the
+ * caller streams from disk instead of stalling on a full decode; the loader
+ * still finishes it for the next play.
+ */
+static MIX_Audio* acquire_audio(const char* path, int* slot_out) {
+    MIX_Audio* audio = NULL;
+
+    *slot_out = -1;
+
+    if (!cache_lock || cache_budget == 0)
+        return NULL;
+
+    SDL_LockMutex(cache_lock);
+
+    const int index = find_slot(path);
+    if (index >= 0 && cache[index].state == MOD_SLOT_READY) {
+        cache[index].pinned = true;
+        cache[index].last_used = ++cache_clock;
+        audio = cache[index].audio;
+        *slot_out = index;
+    }
+
+    SDL_UnlockMutex(cache_lock);
+    return audio;
+}
+
+/** @brief Detach @p audio from @p track and give it back to the cache (or free a private load). */
+static void release_audio(MIX_Track* track, MIX_Audio** audio, int* slot) {
+    if (!*audio)
+        return;
+
+    MIX_SetTrackAudio(track, NULL);
+
+    if (*slot >= 0) {
+        SDL_LockMutex(cache_lock);
+        cache[*slot].pinned = false;
+        enforce_budget(-1);
+        SDL_UnlockMutex(cache_lock);
+    } else {
+        MIX_DestroyAudio(*audio);
+    }
+
+    *audio = NULL;
+    *slot = -1;
+}
+
+static void start_loader(void) {
+    cache_budget = (size_t)SDL_max(Config_GetInt(CFG_KEY_MODDED_BGM_CACHE_MB), 0) * 1024 * 1024;
+    cache_bytes = 0;
+    cache_clock = 0;
+    loader_quit = false;
+    SDL_memset(cache, 0, sizeof(cache));
+
+    cache_lock = SDL_CreateMutex();
+    cache_cond = SDL_CreateCondition();
+    if (!cache_lock || !cache_cond || cache_budget == 0)
+        return;
+
+    loader = SDL_CreateThread(loader_main, "ModdedBGM_Load", NULL);
+    if (!loader) {
+        SDL_Log("ModdedBGM: no loader thread (%s); mods stream from disk", SDL_GetError());
+        return;
+    }
+}
+
+static void stop_loader(void) {
+    if (loader) {
+        SDL_LockMutex(cache_lock);
+        loader_quit = true;
+        SDL_BroadcastCondition(cache_cond);
+        SDL_UnlockMutex(cache_lock);
+
+        SDL_WaitThread(loader, NULL);
+        loader = NULL;
+    }
+
+    for (int i = 0; i < MOD_CACHE_SLOTS; i++) {
+        free_slot(&cache[i]);
+    }
+
+    if (cache_cond) {
+        SDL_DestroyCondition(cache_cond);
+        cache_cond = NULL;
+    }
+    if (cache_lock) {
+        SDL_DestroyMutex(cache_lock);
+        cache_lock = NULL;
+    }
+}
 
 void ModdedBGM_Init(void) {
     if (is_initialized)
         return;
 
+    // The index also feeds the mods menu, so it is built even if the mixer can't start
+    if (!bgm_files && !voice_files) {
+        index_bgm_dir();
+        index_voice_dir();
+        SDL_Log("ModdedBGM: Indexed %d BGM and %d voice mods", bgm_file_count, voice_file_count);
+    }
+
     if (!MIX_Init()) {
         SDL_Log("ModdedBGM: MIX_Init failed: %s", SDL_GetError());
         return;
@@ -77,23 +640,30 @@ void ModdedBGM_Init(void) {
     is_initialized = true;
     current_audio = NULL;
     current_voice_audio = NULL;
+    current_slot = -1;
+    current_voice_slot = -1;
     fade_active = false;
-    cached_bgm_count = -1;
+
+    start_loader();
 }
 
 void ModdedBGM_Exit(void) {
-    if (!is_initialized)
+    if (!is_initialized) {
+        // Init still indexes the mods when the mixer fails to start
+        free_index();
         return;
+    }
 
     ModdedBGM_Stop();
 
     if (current_voice_audio) {
         MIX_StopTrack(voice_track, 0);
-        MIX_SetTrackAudio(voice_track, NULL);
-        MIX_DestroyAudio(current_voice_audio);
-        current_voice_audio = NULL;
+        release_audio(voice_track, &current_voice_audio, &current_voice_slot);
     }
 
+    stop_loader();
+    free_index();
+
     if (voice_track) {
         MIX_DestroyTrack(voice_track);
         voice_track = NULL;
@@ -110,81 +680,49 @@ void ModdedBGM_Exit(void) {
     is_initialized = false;
 }
 
-/**
- * @brief Parse a sidecar .loop file for LOOPSTART / LOOPLENGTH values.
- * @return true if both values were successfully parsed.
- */
-static bool parse_loop_file(const char* loop_path, Sint64* loop_start, Sint64* loop_length) {
-    SDL_IOStream* io = SDL_IOFromFile(loop_path, "r");
-    if (!io)
-        return false;
-
-    char buf[256];
-    *loop_start = -1;
-    *loop_length = -1;
-
-    /* Read the entire small sidecar file at once */
-    size_t capacity = sizeof(buf) - 1;
-    size_t read = SDL_ReadIO(io, buf, capacity);
-    buf[read] = '\0';
-    SDL_CloseIO(io);
+void ModdedBGM_Prefetch(int file_id) {
+    if (!is_initialized || !Config_GetBool(CFG_KEY_MODDED_BGM_ENABLED))
+        return;
 
-    /* Parse LOOPSTART=N and LOOPLENGTH=N */
-    const char* p = buf;
-    while (*p) {
-        /* Skip whitespace and comments */
-        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
-            p++;
-        if (*p == '#' || *p == ';') {
-            while (*p && *p != '\n')
-                p++;
-            continue;
-        }
+    const ModBgmFile* file = find_bgm_file(file_id);
+    if (!file)
+        return;
 
-        if (SDL_strncasecmp(p, "LOOPSTART=", 10) == 0) {
-            *loop_start = SDL_strtoll(p + 10, NULL, 10);
-        } else if (SDL_strncasecmp(p, "LOOPLENGTH=", 11) == 0) {
-            *loop_length = SDL_strtoll(p + 11, NULL, 10);
-        }
+    char path[MOD_PATH_MAX];
+    char id_str[32];
+    snprintf(id_str, sizeof(id_str), "%d", file_id);
+    build_asset_path(path, sizeof(path), "bgm_mod", id_str, mod_extensions[file->ext]);
+    prefetch_path(path);
+}
 
-        /* Advance to next line */
-        while (*p && *p != '\n')
-            p++;
-    }
+bool ModdedBGM_Play(int file_id) {
+    if (!is_initialized)
+        return false;
 
-    if (*loop_start >= 0 && *loop_length > 0) {
-        SDL_Log("ModdedBGM: Parsed loop file: start=%lld length=%lld", (long long)*loop_start, (long long)*loop_length);
-        return true;
+    // Must be enabled in config
+    if (!Config_GetBool(CFG_KEY_MODDED_BGM_ENABLED)) {
+        return false;
     }
 
-    return false;
-}
+    ModdedBGM_Stop();
 
-/**
- * @brief Build a path in assets/{subdir}/{name}.{ext}.
- */
-static void build_asset_path(char* out, size_t out_size, const char* subdir, const char* name, const char* ext) {
-    const char* base = Paths_GetBasePath();
-    snprintf(out, out_size, "%sassets/%s/%s.%s", base ? base : "", subdir, name, ext);
-}
+    const ModBgmFile* file = find_bgm_file(file_id);
+    if (!file)
+        return false;
 
-static bool try_load_and_play(const char* ext, int file_id) {
-    char path[1024];
+    char path[MOD_PATH_MAX];
     char id_str[32];
     snprintf(id_str, sizeof(id_str), "%d", file_id);
-    build_asset_path(path, sizeof(path), "bgm_mod", id_str, ext);
-
-    // Check if file exists by opening via SDL IO
-    SDL_IOStream* io = SDL_IOFromFile(path, "rb");
-    if (!io) {
-        return false;
-    }
-    SDL_CloseIO(io);
+    build_asset_path(path, sizeof(path), "bgm_mod", id_str, mod_extensions[file->ext]);
 
-    current_audio = MIX_LoadAudio(mixer, path, false);
+    current_audio = acquire_audio(path, &current_slot);
     if (!current_audio) {
-        SDL_Log("ModdedBGM: Found file %s but failed to load: %s", path, SDL_GetError());
-        return false;
+        // Not decoded yet (or still decoding): stream it, which only has to open the file
+        current_audio = MIX_LoadAudio(mixer, path, false);
+        if (!current_audio) {
+            SDL_Log("ModdedBGM: Found file %s but failed to load: %s", path, SDL_GetError());
+            return false;
+        }
     }
 
     MIX_SetTrackAudio(music_track, current_audio);
@@ -193,22 +731,8 @@ static bool try_load_and_play(const char* ext, int file_id) {
     SDL_PropertiesID props = SDL_CreateProperties();
     SDL_SetNumberProperty(props, MIX_PROP_PLAY_LOOPS_NUMBER, -1);
 
-    /* Check for sidecar .loop file (for non-OGG formats without embedded tags) */
-    {
-        char loop_path[1024];
-        snprintf(loop_path,
-                 sizeof(loop_path),
-                 "%sassets/bgm_mod/%d.loop",
-                 Paths_GetBasePath() ? Paths_GetBasePath() : "",
-                 file_id);
-        Sint64 loop_start, loop_length;
-        if (parse_loop_file(loop_path, &loop_start, &loop_length)) {
-            /* SDL3_mixer play API only supports loop_start_frame.
-             * LOOPLENGTH from sidecar files isn't supported at the play API level —
-             * the OGG vorbis comment parser handles it natively for OGG files.
-             * For non-OGG, we can at least set the loop start point. */
-            SDL_SetNumberProperty(props, MIX_PROP_PLAY_LOOP_START_FRAME_NUMBER, loop_start);
-        }
+    if (file->loop_start >= 0) {
+        SDL_SetNumberProperty(props, MIX_PROP_PLAY_LOOP_START_FRAME_NUMBER, file->loop_start);
     }
 
     bool ok = MIX_PlayTrack(music_track, props);
@@ -216,55 +740,22 @@ static bool try_load_and_play(const char* ext, int file_id) {
 
     if (!ok) {
         SDL_Log("ModdedBGM: Failed to play %s: %s", path, SDL_GetError());
-        MIX_DestroyAudio(current_audio);
-        current_audio = NULL;
+        release_audio(music_track, &current_audio, &current_slot);
         return false;
     }
 
     fade_active = false;
-    cached_bgm_count = -1; /* New track added/removed — invalidate cache */
-    SDL_Log("ModdedBGM: Playing %s", path);
+    SDL_Log("ModdedBGM: Playing %s%s", path, current_slot >= 0 ? " (predecoded)" : "");
     return true;
 }
 
-bool ModdedBGM_Play(int file_id) {
-    if (!is_initialized)
-        return false;
-
-    // Must be enabled in config
-    if (!Config_GetBool(CFG_KEY_MODDED_BGM_ENABLED)) {
-        return false;
-    }
-
-    ModdedBGM_Stop();
-
-    // Supported formats (SDL3_mixer decoders):
-    //   ogg  — Vorbis (stb_vorbis / libvorbisfile) — supports LOOPSTART/LOOPLENGTH tags
-    //   flac — FLAC (drflac / libflac)
-    //   opus — Opus (libopusfile)
-    //   mp3  — MP3 (drmp3 / mpg123)
-    //   wav  — WAV (built-in)
-    static const char* extensions[] = { "ogg", "flac", "opus", "mp3", "wav" };
-    for (int i = 0; i < (int)(sizeof(extensions) / sizeof(extensions[0])); i++) {
-        if (try_load_and_play(extensions[i], file_id))
-            return true;
-    }
-
-    return false;
-}
-
 void ModdedBGM_Stop(void) {
     if (!is_initialized)
         return;
 
     fade_active = false;
     MIX_StopTrack(music_track, 0);
-    if (current_audio) {
-        MIX_SetTrackAudio(music_track, NULL);
-        MIX_DestroyAudio(current_audio);
-        current_audio = NULL;
-    }
-    cached_bgm_count = -1; /* Track state changed — invalidate */
+    release_audio(music_track, &current_audio, &current_slot);
 }
 
 void ModdedBGM_Pause(bool pause) {
@@ -312,33 +803,41 @@ void ModdedBGM_FadeOut(int fade_ms) {
     fade_active = true;
     MIX_StopTrack(music_track, fade_frames);
     /* Note: after fade completes, track stops automatically.
-     * We still need to clean up current_audio — this happens
+     * We still need to release current_audio — this happens
      * on the next call to ModdedBGM_Stop() or ModdedBGM_Play(). */
 }
 
 /* ── Voice Line Support ── */
 
-static bool try_load_voice(const char* voice_name, const char* ext) {
-    char path[1024];
-    build_asset_path(path, sizeof(path), "voice_mod", voice_name, ext);
+bool ModdedBGM_PlayVoice(const char* voice_name) {
+    if (!is_initialized || !voice_name)
+        return false;
 
-    SDL_IOStream* io = SDL_IOFromFile(path, "rb");
-    if (!io)
+    if (!Config_GetBool(CFG_KEY_MODDED_VOICE_ENABLED))
         return false;
-    SDL_CloseIO(io);
+
+    const ModVoiceFile* file = find_voice_file(voice_name);
+    if (!file)
+        return false;
+
+    char path[MOD_PATH_MAX];
+    build_asset_path(path, sizeof(path), "voice_mod", voice_name, mod_extensions[file->ext]);
 
     /* Stop any previously playing voice */
     if (current_voice_audio) {
         MIX_StopTrack(voice_track, 0);
-        MIX_SetTrackAudio(voice_track, NULL);
-        MIX_DestroyAudio(current_voice_audio);
-        current_voice_audio = NULL;
+        release_audio(voice_track, &current_voice_audio, &current_voice_slot);
     }
 
-    current_voice_audio = MIX_LoadAudio(mixer, path, false);
+    current_voice_audio = acquire_audio(path, &current_voice_slot);
     if (!current_voice_audio) {
-        SDL_Log("ModdedBGM: Found voice %s but failed to load: %s", path, SDL_GetError());
-        return false;
+        // Stream this play and have the loader decode the clip for the next one
+        prefetch_path(path);
+        current_voice_audio = MIX_LoadAudio(mixer, path, false);
+        if (!current_voice_audio) {
+            SDL_Log("ModdedBGM: Found voice %s but failed to load: %s", path, SDL_GetError());
+            return false;
+        }
     }
 
     MIX_SetTrackAudio(voice_track, current_voice_audio);
@@ -351,8 +850,7 @@ static bool try_load_voice(const char* voice_name, const char* ext) {
 
     if (!ok) {
         SDL_Log("ModdedBGM: Failed to play voice %s: %s", path, SDL_GetError());
-        MIX_DestroyAudio(current_voice_audio);
-        current_voice_audio = NULL;
+        release_audio(voice_track, &current_voice_audio, &current_voice_slot);
         return false;
     }
 
@@ -360,65 +858,13 @@ static bool try_load_voice(const char* voice_name, const char* ext) {
     return true;
 }
 
-bool ModdedBGM_PlayVoice(const char* voice_name) {
-    if (!is_initialized || !voice_name)
-        return false;
-
-    if (!Config_GetBool(CFG_KEY_MODDED_VOICE_ENABLED))
-        return false;
-
-    static const char* extensions[] = { "ogg", "flac", "opus", "mp3", "wav" };
-    for (int i = 0; i < (int)(sizeof(extensions) / sizeof(extensions[0])); i++) {
-        if (try_load_voice(voice_name, extensions[i]))
-            return true;
-    }
-
-    return false;
-}
-
 bool ModdedBGM_IsVoiceModded(const char* voice_name) {
     if (!voice_name)
         return false;
 
-    static const char* extensions[] = { "ogg", "flac", "opus", "mp3", "wav" };
-    for (int i = 0; i < (int)(sizeof(extensions) / sizeof(extensions[0])); i++) {
-        char path[1024];
-        build_asset_path(path, sizeof(path), "voice_mod", voice_name, extensions[i]);
-        SDL_IOStream* io = SDL_IOFromFile(path, "rb");
-        if (io) {
-            SDL_CloseIO(io);
-            return true;
-        }
-    }
-    return false;
+    return find_voice_file(voice_name) != NULL;
 }
 
 int ModdedBGM_CountModdedTracks(void) {
-    /* Return cached value if available to avoid per-frame filesystem scans */
-    if (cached_bgm_count >= 0)
-        return cached_bgm_count;
-
-    char dir_path[1024];
-    const char* base = Paths_GetBasePath();
-    snprintf(dir_path, sizeof(dir_path), "%sassets/bgm_mod", base ? base : "");
-
-    int count = 0;
-    static const char* extensions[] = { "ogg", "flac", "opus", "mp3", "wav" };
-
-    SDL_GlobFlags flags = 0;
-    int num_results = 0;
-
-    for (int e = 0; e < (int)(sizeof(extensions) / sizeof(extensions[0])); e++) {
-        char pattern[32];
-        snprintf(pattern, sizeof(pattern), "*.%s", extensions[e]);
-
-        char** results = SDL_GlobDirectory(dir_path, pattern, flags, &num_results);
-        if (results) {
-            count += num_results;
-            SDL_free(results);
-        }
-    }
-
-    cached_bgm_count = count;
-    return count;
+    return bgm_found_count;
 }
@@ -30,6 +30,15 @@ void ModdedBGM_Exit(void);
  */
 bool ModdedBGM_Play(int file_id);
 
+/**
+ * @brief Start decoding the modded track for file_id in the background.
+ *
+ * Call ahead of ModdedBGM_Play() (e.g. during the VS screen) so playback
+ * starts from memory instead of opening and decoding the file on the game
+ * thread. Does nothing if the track isn't modded or is already cached.
+ */
+void ModdedBGM_Prefetch(int file_id);
+
 void ModdedBGM_Stop(void);
 void ModdedBGM_SetVolume(int volume_db10);
 void ModdedBGM_Pause(bool pause);
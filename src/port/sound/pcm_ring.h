@@ -0,0 +1,103 @@
+/**
+ * @file pcm_ring.h
+ * @brief Wait-free single-producer / single-consumer ring of stereo s16 frames.
+ *
+ * Carries decoded BGM from the ADX decode worker to the audio device
+ * callback. Like CmdQueue, the producer only writes `head` and the consumer
+ * only writes `tail`. A flush is requested by the producer with
+ * PcmRing_Discard(): it publishes a mark and the consumer skips everything
+ * before it on its next read, so neither side ever touches the other's index.
+ */
+#ifndef PCM_RING_H
+#define PCM_RING_H
+
+#include "types.h"
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define PCM_RING_CHANNELS 2
+
+typedef struct PcmRing {
+    s16* frames;           // capacity × PCM_RING_CHANNELS interleaved samples
+    u32 mask;              // capacity - 1 (capacity is a power of two)
+    SDL_AtomicInt head;    // Next frame to write (producer-owned, free-running)
+    SDL_AtomicInt tail;    // Next frame to read (consumer-owned, free-running)
+    SDL_AtomicInt discard; // Consumer drops frames before this mark (producer-owned)
+} PcmRing;
+
+/** @brief Attach @p storage (capacity frames, capacity a power of two). */
+static inline void PcmRing_Init(PcmRing* r, s16* storage, u32 capacity) {
+    r->frames = storage;
+    r->mask = capacity - 1;
+    SDL_SetAtomicInt(&r->head, 0);
+    SDL_SetAtomicInt(&r->tail, 0);
+    SDL_SetAtomicInt(&r->discard, 0);
+}
+
+/** @brief Frames written but not yet read, including frames pending discard (exact on the producer). */
+static inline u32 PcmRing_Count(PcmRing* r) {
+    const u32 tail = (u32)SDL_GetAtomicInt(&r->tail);
+
+    return (u32)SDL_GetAtomicInt(&r->head) - tail;
+}
+
+/** @brief Frames the consumer will still deliver (excludes frames pending discard). */
+static inline u32 PcmRing_Pending(PcmRing* r) {
+    // Indices first, head last: head only grows, so the difference can't underflow
+    const u32 tail = (u32)SDL_GetAtomicInt(&r->tail);
+    const u32 discard = (u32)SDL_GetAtomicInt(&r->discard);
+    const u32 head = (u32)SDL_GetAtomicInt(&r->head);
+
+    return (s32)(discard - tail) > 0 ? head - discard : head - tail;
+}
+
+/** @brief Producer: frames that can be written without overwriting unread data. */
+static inline u32 PcmRing_Space(PcmRing* r) {
+    return r->mask + 1 - PcmRing_Count(r);
+}
+
+/** @brief Producer: append up to @p count frames; returns the number written. */
+static inline u32 PcmRing_Write(PcmRing* r, const s16* src, u32 count) {
+    const u32 head = (u32)SDL_GetAtomicInt(&r->head);
+    const u32 space = PcmRing_Space(r);
+    const u32 n = count < space ? count : space;
+    const u32 start = head & r->mask;
+    const u32 first = SDL_min(n, r->mask + 1 - start);
+
+    memcpy(&r->frames[start * PCM_RING_CHANNELS], src, first * PCM_RING_CHANNELS * sizeof(s16));
+    memcpy(r->frames, src + first * PCM_RING_CHANNELS, (n - first) * PCM_RING_CHANNELS * sizeof(s16));
+
+    // Publish after the copy: the atomic store orders the frame data before head
+    SDL_SetAtomicInt(&r->head, (int)(head + n));
+    return n;
+}
+
+/** @brief Producer: make the consumer drop every frame written so far. */
+static inline void PcmRing_Discard(PcmRing* r) {
+    SDL_SetAtomicInt(&r->discard, SDL_GetAtomicInt(&r->head));
+}
+
+/** @brief Consumer: read up to @p count frames into @p dst; returns the number read. */
+static inline u32 PcmRing_Read(PcmRing* r, s16* dst, u32 count) {
+    const u32 discard = (u32)SDL_GetAtomicInt(&r->discard);
+    u32 tail = (u32)SDL_GetAtomicInt(&r->tail);
+
+    // The mark never passes head, so jumping to it is always a valid position
+    if ((s32)(discard - tail) > 0) {
+        tail = discard;
+    }
+
+    const u32 avail = (u32)SDL_GetAtomicInt(&r->head) - tail;
+    const u32 n = count < avail ? count : avail;
+    const u32 start = tail & r->mask;
+    const u32 first = SDL_min(n, r->mask + 1 - start);
+
+    memcpy(dst, &r->frames[start * PCM_RING_CHANNELS], first * PCM_RING_CHANNELS * sizeof(s16));
+    memcpy(dst + first * PCM_RING_CHANNELS, r->frames, (n - first) * PCM_RING_CHANNELS * sizeof(s16));
+
+    SDL_SetAtomicInt(&r->tail, (int)(tail + n));
+    return n;
+}
+
+#endif // PCM_RING_H
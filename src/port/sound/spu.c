@@ -6,12 +6,31 @@
  * runs per-voice ADSR envelopes, applies pitch interpolation, and
  * mixes 48 voices into a stereo output stream via SDL3 audio callback.
  * Uses an active-voice bitmask for efficient tick processing.
+ *
+ * The audio callback renders voice-major: each active voice runs for a
+ * whole block into a scratch buffer, then the block is summed with SIMD.
+ * SPU_Tick() is the per-sample reference path the block renderer must
+ * match bit-for-bit.
+ *
+ * Game-thread requests (uploads, sound-engine voice operations) are posted
+ * to a wait-free SPSC command queue and applied by the audio thread at
+ * batch boundaries, so the game thread never waits on mixing.
+ *
+ * In offline mode (SPU_SetOffline) no device is opened: the game loop pulls
+ * samples with SPU_RenderOffline() and commands apply immediately.
+ *
+ * Low-latency mode (SPU_SetLowLatency) requests a small device period and
+ * mixes in batches of that period, so commands are picked up every period.
+ * Sound-effect starts are timed from the game-thread request to the batch
+ * that first mixes them (SPU_GetLatencyStats).
  */
 #include "port/sound/spu.h"
+#include "port/sound/cmd_queue.h"
 #include "port/tracy_zones.h"
 
 #include "common.h"
 #include <SDL3/SDL.h>
+#include <simde/x86/sse2.h>
 #include <stdbool.h>
 #include <string.h>
 
@@ -20,6 +39,11 @@
 #define clamp(val, min, max) (((val) > (max)) ? (max) : (((val) < (min)) ? (min) : (val)))
 
 #define VOICE_COUNT 48
+#define SPU_BLOCK_MAX 256 // Samples per voice-major block (matches the callback batch)
+#define SPU_SAMPLE_RATE 48000
+#define SPU_LOW_LATENCY_FRAMES 128 // ~2.7 ms device period requested in low-latency mode
+#define SPU_MIN_BATCH 32
+#define SPU_LATENCY_WINDOW 64 // SE starts per published peak
 
 #include "interp_table.inc"
 
@@ -68,13 +92,48 @@ struct SPU_Voice {
     u32 decRPos, decWPos, decLeft;
 };
 
-SDL_Mutex* soundLock;
-#ifdef TRACY_ENABLE
-TracyCLockCtx soundLockCtx;
-#endif
+#define SPU_CMD_QUEUE_SIZE 1024 // Power of two; far more than one batch of SE traffic
+
+typedef struct {
+    SPU_CommandFn fn;
+    union {
+        u8 bytes[SPU_CMD_PAYLOAD_MAX];
+        u64 align;
+    } payload;
+} SPU_Command;
+
+typedef struct {
+    u32 dst;
+    u32 size;
+    void* data;
+} SPU_UploadCmd;
+
+static SPU_Command cmd_storage[SPU_CMD_QUEUE_SIZE];
+static CmdQueue cmd_queue;
+static int cmd_dropped = 0;
 
 static void (*timer_cb)();
 static SDL_AudioStream* stream;
+static bool offline_mode = false;
+static bool low_latency = false;
+static int device_frames = 0;           // Device period in our sample frames (0 until opened)
+static u32 batch_frames = SPU_BLOCK_MAX; // Samples mixed per command-queue drain
+
+// SE latency, accumulated on the audio thread and published for the diagnostics panel
+static int ahead_frames = 0; // Frames that play before the batch being mixed
+static int lat_avg_us = 0;
+static int lat_out_us = 0;
+static int lat_window_peak = 0;
+static int lat_window_count = 0;
+static SDL_AtomicInt lat_starts;
+static SDL_AtomicInt lat_last_pub;
+static SDL_AtomicInt lat_avg_pub;
+static SDL_AtomicInt lat_peak_pub;
+static SDL_AtomicInt lat_out_pub;
+
+// We need to run the eml callback at 250hz
+// 48000 / 250 = 192
+static int cb_timer = 192;
 static struct SPU_Voice voices[VOICE_COUNT];
 static u16 ram[(2 * 1024 * 1024) >> 1];
 static s16 adpcm_coefs[5][2] = {
@@ -86,6 +145,13 @@ static s16 adpcm_coefs[5][2] = {
 // brute-forcing all 48 voices. Saves ~33 branch checks × 48K ticks/sec.
 static uint64_t active_voices = 0;
 
+// ⚡ Block-mixing scratch: one voice's interleaved stereo output for the block,
+// the 32-bit running mix, and per-sample last_sample history so a pmon voice
+// can read its predecessor's output for every sample of the block.
+static s16 voice_buf[SPU_BLOCK_MAX * 2];
+static s32 mix_buf[SPU_BLOCK_MAX * 2];
+static s32 pmon_hist[2][SPU_BLOCK_MAX];
+
 static s16 SPU_ApplyVolume(s16 sample, s32 volume) {
     return (sample * volume) >> 15;
 }
@@ -345,6 +411,143 @@ void SPU_VoiceStart(int vnum, u32 start_addr) {
     v->nax = (v->nax + 1) & 0xfffff;
 }
 
+/**
+ * @brief Run one voice for @p count samples into voice_buf.
+ *
+ * @param pmon_src Predecessor's per-sample last_sample, or NULL to use @p pmon_const.
+ * @param hist     Receives this voice's last_sample after every sample.
+ *
+ * A voice that stops mid-block contributes silence and a frozen last_sample
+ * for the rest of the block, as the per-sample path does by skipping it.
+ */
+static void SPU_VoiceRenderBlock(int vnum, int count, const s32* pmon_src, s32 pmon_const, s32* hist) {
+    struct SPU_Voice* v = &voices[vnum];
+    const uint64_t bit = 1ULL << vnum;
+    s32 vout[2];
+    int n = 0;
+
+    while (n < count) {
+        SPU_VoiceTick(v, vout, pmon_src ? pmon_src[n] : pmon_const);
+        voice_buf[n * 2 + 0] = (s16)vout[0];
+        voice_buf[n * 2 + 1] = (s16)vout[1];
+        hist[n] = v->last_sample;
+        n++;
+
+        if (!(active_voices & bit)) {
+            break;
+        }
+    }
+
+    for (; n < count; n++) {
+        voice_buf[n * 2 + 0] = 0;
+        voice_buf[n * 2 + 1] = 0;
+        hist[n] = v->last_sample;
+    }
+}
+
+/** @brief Widen voice_buf to 32 bits and add it into mix_buf (8 lanes per step). */
+static void SPU_MixVoiceBuf(int count) {
+    const int total = count * 2;
+    int n = 0;
+
+    for (; n + 8 <= total; n += 8) {
+        const simde__m128i s = simde_mm_loadu_si128((const simde__m128i*)&voice_buf[n]);
+        const simde__m128i lo = simde_mm_srai_epi32(simde_mm_unpacklo_epi16(s, s), 16);
+        const simde__m128i hi = simde_mm_srai_epi32(simde_mm_unpackhi_epi16(s, s), 16);
+        simde__m128i* acc = (simde__m128i*)&mix_buf[n];
+
+        simde_mm_storeu_si128(acc, simde_mm_add_epi32(simde_mm_loadu_si128(acc), lo));
+        simde_mm_storeu_si128(acc + 1, simde_mm_add_epi32(simde_mm_loadu_si128(acc + 1), hi));
+    }
+
+    for (; n < total; n++) {
+        mix_buf[n] += voice_buf[n];
+    }
+}
+
+/** @brief Render up to SPU_BLOCK_MAX stereo samples voice-major. */
+static void SPU_RenderBlock(s16* output, int count) {
+    const int total = count * 2;
+    uint64_t mask = active_voices;
+    int prev = -1;
+    int h = 0;
+    int n = 0;
+
+    memset(mix_buf, 0, total * sizeof(s32));
+
+    // Ascending voice order keeps pmon chains identical to SPU_Tick: voice i
+    // sees voice i-1's last_sample from the same sample index.
+    while (mask) {
+        const int i = __builtin_ctzll(mask);
+        const s32* pmon_src = NULL;
+        s32 pmon_const = 0;
+
+        mask &= mask - 1;
+
+        if (i > 0 && voices[i].pmon) {
+            if (prev == i - 1) {
+                pmon_src = pmon_hist[h ^ 1];
+            } else {
+                pmon_const = voices[i - 1].last_sample;
+            }
+        }
+
+        SPU_VoiceRenderBlock(i, count, pmon_src, pmon_const, pmon_hist[h]);
+        SPU_MixVoiceBuf(count);
+        prev = i;
+        h ^= 1;
+    }
+
+    // Saturating pack is the same clamp SPU_Tick applies per sample
+    for (; n + 8 <= total; n += 8) {
+        const simde__m128i a = simde_mm_loadu_si128((const simde__m128i*)&mix_buf[n]);
+        const simde__m128i b = simde_mm_loadu_si128((const simde__m128i*)&mix_buf[n + 4]);
+        simde_mm_storeu_si128((simde__m128i*)&output[n], simde_mm_packs_epi32(a, b));
+    }
+
+    for (; n < total; n++) {
+        output[n] = clamp(mix_buf[n], INT16_MIN, INT16_MAX);
+    }
+}
+
+void SPU_Render(s16* output, int count) {
+    while (count > 0) {
+        const int block = min(count, SPU_BLOCK_MAX);
+
+        SPU_RenderBlock(output, block);
+        output += block * 2;
+        count -= block;
+    }
+}
+
+void SPU_Reset(void) {
+    memset(voices, 0, sizeof(voices));
+    active_voices = 0;
+    cb_timer = 192;
+}
+
+/**
+ * @brief Render @p count samples, firing the eml timer every 192 samples.
+ *
+ * ⚡ Voice-major block rendering, split at eml timer boundaries so voice
+ * changes made by timer_cb land on the same sample as they would with
+ * per-sample SPU_Tick.
+ */
+static void SPU_RenderTimed(s16* output, u32 count) {
+    while (count) {
+        const u32 run = min(count, (u32)cb_timer);
+        SPU_Render(output, run);
+        output += run * 2;
+        count -= run;
+
+        cb_timer -= run;
+        if (!cb_timer) {
+            timer_cb();
+            cb_timer = 192;
+        }
+    }
+}
+
 void SPU_SDL_CB(void* user, SDL_AudioStream* stream, int additional_amount, int total_amount) {
     TRACE_ZONE_N("SPU_AudioCB");
     static bool thread_named = false;
@@ -357,50 +560,57 @@ void SPU_SDL_CB(void* user, SDL_AudioStream* stream, int additional_amount, int
     // SPU_Tick writes 2 elements per call, so max safe batch = 4096 / 2 = 2048.
     static s16 outbuf[4096] = {};
 
-    // We need to run the eml callback at 250hz
-    // 48000 / 250 = 192
-    static int cb_timer = 192;
+    // Everything already queued, plus the period the device is playing, is heard first
+    ahead_frames = SDL_GetAudioStreamQueued(stream) / (int)(sizeof(s16) * 2) + device_frames;
 
     while (samples_per_channel) {
-        // ⚡ Bolt: Cap at 256 — previously 2048, which held soundLock for up to
-        // ~42ms at 48kHz. Game-thread sound calls (emlShimStartSound, SeKeyOff)
-        // blocked on this lock, causing ~17ms spikes in GameTasks. 256 samples
-        // caps worst-case hold to ~5ms while the outer loop still processes the
-        // full request.
-        u32 batch_count = min(samples_per_channel, 256);
-
-        // ⚡ Bolt: Hold soundLock only during the mixing loop — not during
-        // SDL_PutAudioStreamData (which may block on SDL's internal lock).
-        // Previously the lock spanned the entire callback, causing the game
-        // thread to stall whenever it needed soundLock (voice setup, key-off,
-        // volume changes). Now the game thread only contends during mixing.
-        TRACE_LOCK_BEFORE(soundLockCtx);
-        SDL_LockMutex(soundLock);
-        TRACE_LOCK_AFTER(soundLockCtx);
-
-        s16* p = outbuf;
-        for (int i = 0; i < batch_count; i++) {
-            SPU_Tick(p);
-            p += 2;
-
-            cb_timer--;
-            if (!cb_timer) {
-                timer_cb();
-                cb_timer = 192;
-            }
-        }
-
-        SDL_UnlockMutex(soundLock);
-        TRACE_LOCK_UNLOCK(soundLockCtx);
+        // ⚡ Bolt: Cap at 256 samples (~5ms), or one device period in
+        // low-latency mode, so queued game-thread commands are applied with
+        // at most one batch of latency.
+        u32 batch_count = min(samples_per_channel, batch_frames);
+
+        // ⚡ Game-thread requests are applied here, at the batch boundary.
+        // This thread owns all voice state, so mixing takes no lock and
+        // game-side sound calls (previously blocked on soundLock for up to a
+        // batch, ~17ms GameTasks spikes) never wait on audio.
+        SPU_RunCommands();
+        SPU_RenderTimed(outbuf, batch_count);
 
         SDL_PutAudioStreamData(stream, outbuf, (batch_count * sizeof(s16)) << 1);
         samples_per_channel -= batch_count;
+        ahead_frames += batch_count;
     }
     TRACE_ZONE_END();
 }
 
 static void nullcb() {}
 
+/** @brief Read back the device period and size mixing batches to it in low-latency mode. */
+static void SPU_ConfigureBatches(void) {
+    SDL_AudioSpec dev_spec;
+    int frames = 0;
+
+    batch_frames = SPU_BLOCK_MAX;
+
+    if (!SDL_GetAudioDeviceFormat(SDL_GetAudioStreamDevice(stream), &dev_spec, &frames) || frames <= 0) {
+        device_frames = 0;
+        return;
+    }
+
+    // The period is reported at the device rate; express it in our 48 kHz frames
+    device_frames = (int)((s64)frames * SPU_SAMPLE_RATE / (dev_spec.freq > 0 ? dev_spec.freq : SPU_SAMPLE_RATE));
+
+    if (low_latency) {
+        batch_frames = (u32)clamp(device_frames, SPU_MIN_BATCH, SPU_BLOCK_MAX);
+    }
+
+    SDL_Log("SPU: %s audio, device period %d frames @ %d Hz, mixing %u-frame batches",
+            low_latency ? "low-latency" : "default",
+            frames,
+            dev_spec.freq,
+            batch_frames);
+}
+
 void SPU_Init(void (*cb)()) {
     SDL_AudioSpec spec;
 
@@ -410,31 +620,176 @@ void SPU_Init(void (*cb)()) {
     }
 
     memset(voices, 0, sizeof(voices));
-    soundLock = SDL_CreateMutex();
-    TRACE_LOCK_ANNOUNCE(soundLockCtx);
-    TRACE_LOCK_NAME(soundLockCtx, "soundLock", 9);
+    CmdQueue_Init(&cmd_queue, cmd_storage, sizeof(SPU_Command), SPU_CMD_QUEUE_SIZE);
+    SDL_SetAtomicInt(&lat_starts, 0);
+
+    if (offline_mode) {
+        // The game loop drives mixing; with no stream, commands apply inline
+        SDL_Log("SPU: offline rendering, no audio device opened");
+        return;
+    }
 
     spec.channels = 2;
     spec.format = SDL_AUDIO_S16;
-    spec.freq = 48000;
+    spec.freq = SPU_SAMPLE_RATE;
+
+    if (low_latency) {
+        char frames[16];
+
+        // Applies when the physical device opens; backends may round it up
+        SDL_snprintf(frames, sizeof(frames), "%d", SPU_LOW_LATENCY_FRAMES);
+        SDL_SetHint(SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES, frames);
+    }
 
     stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, SPU_SDL_CB, NULL);
     if (!stream) {
         SDL_Log("Couldn't create SDL audio stream: %s", SDL_GetError());
+    } else {
+        SPU_ConfigureBatches();
     }
 
     SDL_ResumeAudioStreamDevice(stream);
 }
 
+void SPU_SetLowLatency(bool enable) {
+    low_latency = enable;
+}
+
+void SPU_NoteStartLatency(u64 posted_ns) {
+    int mix_us;
+    int out_us;
+
+    // Without a device, commands run inline on the game thread: nothing to measure
+    if (!stream) {
+        return;
+    }
+
+    mix_us = (int)((SDL_GetTicksNS() - posted_ns) / 1000);
+    out_us = mix_us + (int)((s64)ahead_frames * 1000000 / SPU_SAMPLE_RATE);
+
+    if (SDL_GetAtomicInt(&lat_starts) == 0) {
+        lat_avg_us = mix_us;
+        lat_out_us = out_us;
+    } else {
+        lat_avg_us += (mix_us - lat_avg_us) / 8;
+        lat_out_us += (out_us - lat_out_us) / 8;
+    }
+
+    lat_window_peak = max(lat_window_peak, mix_us);
+    if (++lat_window_count == SPU_LATENCY_WINDOW) {
+        SDL_SetAtomicInt(&lat_peak_pub, lat_window_peak);
+        lat_window_peak = 0;
+        lat_window_count = 0;
+    }
+
+    SDL_SetAtomicInt(&lat_last_pub, mix_us);
+    SDL_SetAtomicInt(&lat_avg_pub, lat_avg_us);
+    SDL_SetAtomicInt(&lat_out_pub, lat_out_us);
+    SDL_AddAtomicInt(&lat_starts, 1);
+
+    TRACE_PLOT_INT("SeLatencyUs", mix_us);
+    TRACE_PLOT_INT("SeOutputLatencyUs", out_us);
+}
+
+void SPU_GetLatencyStats(SPU_LatencyStats* stats) {
+    stats->starts = SDL_GetAtomicInt(&lat_starts);
+    stats->last_us = SDL_GetAtomicInt(&lat_last_pub);
+    stats->avg_us = SDL_GetAtomicInt(&lat_avg_pub);
+    stats->peak_us = SDL_GetAtomicInt(&lat_peak_pub);
+    stats->output_us = SDL_GetAtomicInt(&lat_out_pub);
+    stats->device_frames = device_frames;
+    stats->batch_frames = (int)batch_frames;
+    stats->low_latency = low_latency;
+}
+
+void SPU_SetOffline(bool enable) {
+    offline_mode = enable;
+}
+
+void SPU_RenderOffline(s16* output, int count) {
+    TRACE_ZONE_N("SPU_RenderOffline");
+    SPU_RunCommands();
+    SPU_RenderTimed(output, (u32)count);
+    TRACE_ZONE_END();
+}
+
+bool SPU_PostCommand(SPU_CommandFn fn, const void* payload, u32 size) {
+    SPU_Command* cmd;
+
+    SDL_assert(size <= SPU_CMD_PAYLOAD_MAX);
+
+    // No audio thread (device failed to open): nothing else touches SPU state
+    if (!stream) {
+        fn(payload);
+        return true;
+    }
+
+    cmd = CmdQueue_Reserve(&cmd_queue);
+    if (!cmd) {
+        cmd_dropped++;
+        TRACE_PLOT_INT("SndCmdDropped", cmd_dropped);
+        return false;
+    }
+
+    cmd->fn = fn;
+    if (size) {
+        memcpy(cmd->payload.bytes, payload, size);
+    }
+    CmdQueue_Push(&cmd_queue);
+    return true;
+}
+
+void SPU_RunCommands(void) {
+    const SPU_Command* cmd;
+
+    TRACE_PLOT_INT("SndCmdQueue", CmdQueue_Count(&cmd_queue));
+
+    while ((cmd = CmdQueue_Peek(&cmd_queue)) != NULL) {
+        cmd->fn(cmd->payload.bytes);
+        CmdQueue_Pop(&cmd_queue);
+    }
+}
+
+static void SPU_ApplyUpload(const void* payload) {
+    const SPU_UploadCmd* up = payload;
+
+    memcpy(&ram[up->dst >> 1], up->data, up->size);
+    SDL_free(up->data); // Rare (bank loads), so freeing on the audio thread is acceptable
+}
+
 void SPU_Upload(u32 dst, void* src, u32 size) {
-    TRACE_LOCK_BEFORE(soundLockCtx);
-    SDL_LockMutex(soundLock);
-    TRACE_LOCK_AFTER(soundLockCtx);
+    SPU_UploadCmd up;
+
+    if (!stream) {
+        memcpy(&ram[dst >> 1], src, size);
+        return;
+    }
 
-    memcpy(&ram[dst >> 1], src, size);
+    // The caller may reuse src as soon as we return, so the queue carries a copy
+    up.dst = dst;
+    up.size = size;
+    up.data = SDL_malloc(size);
 
-    SDL_UnlockMutex(soundLock);
-    TRACE_LOCK_UNLOCK(soundLockCtx);
+    if (up.data == NULL) {
+        // No room for the copy: let earlier commands land, then write with the callback held off
+        SDL_Log("SPU: no memory to queue a %u-byte upload, copying directly", size);
+
+        while (CmdQueue_Count(&cmd_queue) != 0) {
+            SDL_Delay(1);
+        }
+
+        SDL_LockAudioStream(stream);
+        memcpy(&ram[dst >> 1], src, size);
+        SDL_UnlockAudioStream(stream);
+        return;
+    }
+
+    memcpy(up.data, src, size);
+
+    // Sample data must not be lost: wait out a full queue (only if the audio thread stalls)
+    while (!SPU_PostCommand(SPU_ApplyUpload, &up, sizeof(up))) {
+        SDL_Delay(1);
+    }
 }
 
 void SPU_Tick(s16* output) {
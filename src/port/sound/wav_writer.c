@@ -0,0 +1,104 @@
+/**
+ * @file wav_writer.c
+ * @brief Streaming 16-bit PCM WAV file writer.
+ *
+ * Samples are appended as they are produced; the two size fields in the
+ * header are only known at the end, so WavWriter_Close() seeks back and
+ * patches them. A file from an interrupted run still has a valid header
+ * shape, just with zero sizes.
+ */
+#include "port/sound/wav_writer.h"
+
+#include <string.h>
+
+#define WAV_HEADER_SIZE 44
+#define WAV_RIFF_SIZE_OFFSET 4
+#define WAV_DATA_SIZE_OFFSET 40
+
+static void put_le16(u8* p, u16 v) {
+    p[0] = (u8)v;
+    p[1] = (u8)(v >> 8);
+}
+
+static void put_le32(u8* p, u32 v) {
+    p[0] = (u8)v;
+    p[1] = (u8)(v >> 8);
+    p[2] = (u8)(v >> 16);
+    p[3] = (u8)(v >> 24);
+}
+
+static bool write_le32_at(SDL_IOStream* io, Sint64 offset, u32 v) {
+    u8 buf[4];
+
+    put_le32(buf, v);
+    return SDL_SeekIO(io, offset, SDL_IO_SEEK_SET) == offset && SDL_WriteIO(io, buf, sizeof(buf)) == sizeof(buf);
+}
+
+bool WavWriter_Open(WavWriter* w, const char* path, u32 rate, u16 channels) {
+    const u16 block_align = channels * sizeof(s16);
+    u8 header[WAV_HEADER_SIZE];
+
+    SDL_zerop(w);
+
+    w->io = SDL_IOFromFile(path, "wb");
+    if (!w->io) {
+        SDL_Log("WavWriter: can't create %s: %s", path, SDL_GetError());
+        return false;
+    }
+
+    w->rate = rate;
+    w->channels = channels;
+
+    memcpy(header, "RIFF", 4);
+    put_le32(header + WAV_RIFF_SIZE_OFFSET, WAV_HEADER_SIZE - 8);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    put_le32(header + 16, 16); // fmt chunk size
+    put_le16(header + 20, 1);  // PCM
+    put_le16(header + 22, channels);
+    put_le32(header + 24, rate);
+    put_le32(header + 28, rate * block_align);
+    put_le16(header + 32, block_align);
+    put_le16(header + 34, 16); // bits per sample
+    memcpy(header + 36, "data", 4);
+    put_le32(header + WAV_DATA_SIZE_OFFSET, 0);
+
+    if (SDL_WriteIO(w->io, header, sizeof(header)) != sizeof(header)) {
+        SDL_Log("WavWriter: header write failed: %s", SDL_GetError());
+        SDL_CloseIO(w->io);
+        w->io = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+bool WavWriter_Write(WavWriter* w, const s16* samples, u32 frames) {
+    const size_t bytes = (size_t)frames * w->channels * sizeof(s16);
+
+    if (!w->io) {
+        return false;
+    }
+
+    // All supported targets are little-endian, which is WAV's byte order
+    if (SDL_WriteIO(w->io, samples, bytes) != bytes) {
+        SDL_Log("WavWriter: write failed: %s", SDL_GetError());
+        return false;
+    }
+
+    w->data_bytes += (u32)bytes;
+    return true;
+}
+
+bool WavWriter_Close(WavWriter* w) {
+    bool ok;
+
+    if (!w->io) {
+        return false;
+    }
+
+    ok = write_le32_at(w->io, WAV_RIFF_SIZE_OFFSET, WAV_HEADER_SIZE - 8 + w->data_bytes);
+    ok = write_le32_at(w->io, WAV_DATA_SIZE_OFFSET, w->data_bytes) && ok;
+    ok = SDL_CloseIO(w->io) && ok;
+    w->io = NULL;
+    return ok;
+}
@@ -0,0 +1,28 @@
+/**
+ * @file wav_writer.h
+ * @brief Streaming 16-bit PCM WAV file writer.
+ */
+#ifndef WAV_WRITER_H
+#define WAV_WRITER_H
+
+#include "types.h"
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+
+typedef struct WavWriter {
+    SDL_IOStream* io;
+    u32 rate;
+    u16 channels;
+    u32 data_bytes; // PCM bytes written so far
+} WavWriter;
+
+/** @brief Create @p path and write a header with placeholder sizes. */
+bool WavWriter_Open(WavWriter* w, const char* path, u32 rate, u16 channels);
+
+/** @brief Append @p frames interleaved sample frames. */
+bool WavWriter_Write(WavWriter* w, const s16* samples, u32 frames);
+
+/** @brief Patch the RIFF / data sizes into the header and close the file. */
+bool WavWriter_Close(WavWriter* w);
+
+#endif // WAV_WRITER_H
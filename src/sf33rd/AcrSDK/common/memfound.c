@@ -65,3 +65,18 @@ s32 mflRelease(u32 handle) {
 void* mflCompact() {
     return plmemCompact(&sysmemmgr);
 }
+
+/** @brief Compact the memory pool within a byte/time budget; 1 once fully compacted. */
+s32 mflCompactStep(size_t byte_budget, u64 ns_budget) {
+    return plmemCompactStep(&sysmemmgr, byte_budget, ns_budget);
+}
+
+/** @brief Install the callback told about blocks moved by compaction. */
+void mflSetMoveHook(MEM_MOVE_HOOK hook) {
+    plmemSetMoveHook(&sysmemmgr, hook);
+}
+
+/** @brief Usage and compaction statistics of the system memory pool. */
+void mflGetStats(MEM_MGR_STATS* stats) {
+    plmemGetStats(&sysmemmgr, stats);
+}
@@ -7,6 +7,14 @@
  * allocation (RegisterS), defragmentation via compaction, and temporary
  * allocations from the tail of the region.
  *
+ * Compaction runs either all at once (plmemCompact) or in budgeted steps
+ * (plmemCompactStep) that the main loop spreads over idle frame time.
+ * Blocks only ever slide towards memptr, so a half-compacted pool is still
+ * a valid pool, and a move hook lets the owner follow blocks that moved.
+ *
+ * Each manager counts its registrations, releases and failures, and times
+ * every compaction, for the heap report (plmemGetStats).
+ *
  * Part of the AcrSDK common module.
  * Originally from the PS2 SDK abstraction layer.
  */
@@ -14,6 +22,8 @@
 #include "common.h"
 #include "sf33rd/AcrSDK/common/prilay.h"
 
+#include <SDL3/SDL.h>
+
 #define ALIGN(ptr, len, alignment) ((~(alignment - 1)) & ((uintptr_t)(ptr) + len + alignment - 1))
 #define ALIGN_DOWN(ptr, len, alignment) ((~(alignment - 1)) & ((uintptr_t)(ptr) - len))
 
@@ -21,6 +31,64 @@ static u32 plmemPullHandle(MEM_MGR* memmgr);
 static void plmemAppendBlockList(MEM_MGR* memmgr, u32 han);
 static void plmemDeleteBlockList(MEM_MGR* memmgr, u32 han);
 
+/** @brief Count a successful registration and track the usage peak. */
+static void note_register(MEM_MGR* memmgr) {
+    memmgr->register_count += 1;
+
+    if (memmgr->used_size > memmgr->peak_used) {
+        memmgr->peak_used = memmgr->used_size;
+    }
+}
+
+/** @brief Compaction step: memmove one block, account for it and tell the owner. */
+static void compact_move(MEM_MGR* memmgr, u8* dst, MEM_BLOCK* block) {
+    u8* src = block->ptr;
+
+    plMemmove(dst, src, block->len);
+    block->ptr = dst;
+    memmgr->compact_moves += 1;
+    memmgr->compact_bytes += block->len;
+
+    if (memmgr->move_hook != NULL) {
+        memmgr->move_hook((u32)(block - memmgr->block) + 1, src, dst);
+    }
+}
+
+/** @brief Where compaction places @p block, given the block before it in the list (NULL for the head). */
+static u8* compact_target(MEM_MGR* memmgr, MEM_BLOCK* prev, MEM_BLOCK* block) {
+    if (memmgr->direction != 0) {
+        if (prev == NULL) {
+            return (u8*)ALIGN(memmgr->memptr, 0, memmgr->memalign);
+        }
+
+        return (u8*)ALIGN(prev->ptr, prev->len, memmgr->memalign);
+    }
+
+    if (prev == NULL) {
+        return (u8*)ALIGN_DOWN(memmgr->memptr, block->len, memmgr->memalign);
+    }
+
+    return (u8*)ALIGN_DOWN(prev->ptr, block->len, memmgr->memalign);
+}
+
+/** @brief Frontier of a fully compacted pool whose last block is @p last. */
+static u8* compact_frontier(MEM_MGR* memmgr, MEM_BLOCK* last) {
+    if (memmgr->direction != 0) {
+        return (u8*)ALIGN(last->ptr, last->len, memmgr->memalign);
+    }
+
+    return last->ptr;
+}
+
+/** @brief Add one compaction call's duration to the totals. */
+static void note_compact_time(MEM_MGR* memmgr, Uint64 elapsed) {
+    memmgr->compact_ns += elapsed;
+
+    if (elapsed > memmgr->compact_max_ns) {
+        memmgr->compact_max_ns = elapsed;
+    }
+}
+
 /** @brief Initialise the memory manager with a block pool and memory region. */
 void plmemInit(MEM_MGR* memmgr, MEM_BLOCK* block, s32 count, void* mem_ptr, s32 memsize, s32 memalign, s32 direction) {
     memmgr->cnt = count;
@@ -39,6 +107,17 @@ void plmemInit(MEM_MGR* memmgr, MEM_BLOCK* block, s32 count, void* mem_ptr, s32
     memmgr->used_size = 0;
     memmgr->tmemsize = 0;
     memmgr->blocklist = MEM_NULL_HANDLE;
+    memmgr->move_hook = NULL;
+    memmgr->peak_used = 0;
+    memmgr->register_count = 0;
+    memmgr->release_count = 0;
+    memmgr->fail_count = 0;
+    memmgr->compact_count = 0;
+    memmgr->compact_step_count = 0;
+    memmgr->compact_moves = 0;
+    memmgr->compact_bytes = 0;
+    memmgr->compact_ns = 0;
+    memmgr->compact_max_ns = 0;
 
     plMemset(block, 0, count * sizeof(MEM_BLOCK));
 }
@@ -53,6 +132,7 @@ u32 plmemRegisterAlign(MEM_MGR* memmgr, s32 len, s32 align) {
     u32 han;
 
     if (plmemGetFreeSpace(memmgr) <= len + align) {
+        memmgr->fail_count += 1;
         return 0;
     }
 
@@ -63,6 +143,7 @@ u32 plmemRegisterAlign(MEM_MGR* memmgr, s32 len, s32 align) {
     han = plmemPullHandle(memmgr);
 
     if (han == MEM_NULL_HANDLE) {
+        memmgr->fail_count += 1;
         return 0;
     }
 
@@ -81,6 +162,7 @@ u32 plmemRegisterAlign(MEM_MGR* memmgr, s32 len, s32 align) {
     }
 
     memmgr->used_size += len;
+    note_register(memmgr);
     plmemAppendBlockList(memmgr, han);
 
     return han + 1;
@@ -99,6 +181,7 @@ u32 plmemRegisterS(MEM_MGR* memmgr, s32 len) {
     han = plmemPullHandle(memmgr);
 
     if (han == MEM_NULL_HANDLE) {
+        memmgr->fail_count += 1;
         return 0;
     }
 
@@ -120,6 +203,7 @@ u32 plmemRegisterS(MEM_MGR* memmgr, s32 len) {
                 memmgr->block[han].align = memmgr->memalign;
                 memmgr->block[han].ptr = data_ptr;
                 memmgr->used_size += len;
+                note_register(memmgr);
                 plmemAppendBlockList(memmgr, han);
                 return han + 1;
             }
@@ -136,6 +220,7 @@ u32 plmemRegisterS(MEM_MGR* memmgr, s32 len) {
             memmgr->block[han].align = memmgr->memalign;
             memmgr->block[han].ptr = data_ptr;
             memmgr->used_size += len;
+            note_register(memmgr);
             plmemAppendBlockList(memmgr, han);
             return han + 1;
         }
@@ -151,6 +236,7 @@ u32 plmemRegisterS(MEM_MGR* memmgr, s32 len) {
                 memmgr->block[han].align = memmgr->memalign;
                 memmgr->block[han].ptr = now_block->ptr - size;
                 memmgr->used_size += len;
+                note_register(memmgr);
                 plmemAppendBlockList(memmgr, han);
                 return han + 1;
             }
@@ -166,6 +252,7 @@ u32 plmemRegisterS(MEM_MGR* memmgr, s32 len) {
             memmgr->block[han].align = memmgr->memalign;
             memmgr->block[han].ptr = now_block->ptr - size;
             memmgr->used_size += len;
+            note_register(memmgr);
             plmemAppendBlockList(memmgr, han);
             return han + 1;
         }
@@ -222,70 +309,107 @@ s32 plmemRelease(MEM_MGR* memmgr, u32 handle) {
     }
 
     memmgr->used_size -= memmgr->block[index].len;
+    memmgr->release_count += 1;
     memmgr->block[index].len = 0;
     memmgr->block[index].ptr = NULL;
     plmemDeleteBlockList(memmgr, index);
     return 1;
 }
 
+/** @brief Slide every block towards the base, closing the gaps between them. */
+static void compact_blocks(MEM_MGR* memmgr) {
+    MEM_BLOCK* prev = NULL;
+    MEM_BLOCK* block;
+    u8* data_ptr;
+
+    for (u32 han = memmgr->blocklist; han != MEM_NULL_HANDLE; han = block->next) {
+        block = &memmgr->block[han];
+        data_ptr = compact_target(memmgr, prev, block);
+
+        if (data_ptr != block->ptr) {
+            compact_move(memmgr, data_ptr, block);
+        }
+
+        prev = block;
+    }
+
+    memmgr->memnow = compact_frontier(memmgr, prev);
+}
+
 /** @brief Compact all blocks towards the base, eliminating gaps. */
 void* plmemCompact(MEM_MGR* memmgr) {
-    MEM_BLOCK* now_block;
-    MEM_BLOCK* next_block;
-    u8* data_ptr;
+    Uint64 start;
 
     if (memmgr->blocklist == MEM_NULL_HANDLE) {
         memmgr->memnow = memmgr->memptr;
         return memmgr->memnow;
     }
 
-    now_block = memmgr->block + memmgr->blocklist;
+    start = SDL_GetTicksNS();
+    compact_blocks(memmgr);
+    memmgr->compact_count += 1;
+    note_compact_time(memmgr, SDL_GetTicksNS() - start);
 
-    if (memmgr->direction != 0) {
-        data_ptr = (u8*)ALIGN(memmgr->memptr, 0, memmgr->memalign);
+    return memmgr->memnow;
+}
 
-        if (data_ptr != now_block->ptr) {
-            plMemmove(data_ptr, now_block->ptr, now_block->len);
-            now_block->ptr = data_ptr;
-        }
+/**
+ * @brief Move blocks towards the base until @p byte_budget bytes or @p ns_budget nanoseconds are spent.
+ *
+ * At least one block moves per call, so a block bigger than the budget still
+ * goes through. Nothing is kept between calls: every block before the first
+ * one out of place is already where a full compaction would put it, so the
+ * walk resumes there even if blocks were registered or released meanwhile.
+ * The frontier is pulled in once the walk reaches the end of the list.
+ *
+ * @return 1 when the pool is fully compacted, 0 when the budget ran out first.
+ */
+s32 plmemCompactStep(MEM_MGR* memmgr, size_t byte_budget, u64 ns_budget) {
+    MEM_BLOCK* prev = NULL;
+    MEM_BLOCK* block;
+    u8* data_ptr;
+    size_t moved = 0;
+    Uint64 start;
 
-        while (now_block->next != MEM_NULL_HANDLE) {
-            next_block = memmgr->block + now_block->next;
-            data_ptr = (u8*)ALIGN(now_block->ptr, now_block->len, memmgr->memalign);
+    if (memmgr->blocklist == MEM_NULL_HANDLE) {
+        memmgr->memnow = memmgr->memptr;
+        return 1;
+    }
 
-            if (data_ptr != next_block->ptr) {
-                plMemmove(data_ptr, next_block->ptr, next_block->len);
-                next_block->ptr = data_ptr;
-            }
+    start = SDL_GetTicksNS();
 
-            now_block = next_block;
-        }
+    for (u32 han = memmgr->blocklist; han != MEM_NULL_HANDLE; han = block->next) {
+        block = &memmgr->block[han];
+        data_ptr = compact_target(memmgr, prev, block);
 
-        memmgr->memnow = (u8*)ALIGN(now_block->ptr, now_block->len, memmgr->memalign);
-    } else {
-        data_ptr = (u8*)ALIGN_DOWN(memmgr->memptr, now_block->len, memmgr->memalign);
+        if (data_ptr != block->ptr) {
+            if ((moved > 0) &&
+                ((moved + block->len > byte_budget) || (SDL_GetTicksNS() - start >= ns_budget))) {
+                memmgr->compact_step_count += 1;
+                note_compact_time(memmgr, SDL_GetTicksNS() - start);
+                return 0;
+            }
 
-        if (data_ptr != now_block->ptr) {
-            plMemmove(data_ptr, now_block->ptr, now_block->len);
-            now_block->ptr = data_ptr;
+            compact_move(memmgr, data_ptr, block);
+            moved += block->len;
         }
 
-        while (now_block->next != MEM_NULL_HANDLE) {
-            next_block = memmgr->block + now_block->next;
-            data_ptr = (u8*)ALIGN_DOWN(now_block->ptr, next_block->len, memmgr->memalign);
+        prev = block;
+    }
 
-            if (data_ptr != next_block->ptr) {
-                plMemmove(data_ptr, next_block->ptr, next_block->len);
-                next_block->ptr = data_ptr;
-            }
+    memmgr->memnow = compact_frontier(memmgr, prev);
 
-            now_block = next_block;
-        }
-
-        memmgr->memnow = now_block->ptr;
+    if (moved > 0) {
+        memmgr->compact_step_count += 1;
+        note_compact_time(memmgr, SDL_GetTicksNS() - start);
     }
 
-    return memmgr->memnow;
+    return 1;
+}
+
+/** @brief Install @p hook to be told about every block compaction moves (NULL to remove). */
+void plmemSetMoveHook(MEM_MGR* memmgr, MEM_MOVE_HOOK hook) {
+    memmgr->move_hook = hook;
 }
 
 /** @brief Return total pool size minus used size. */
@@ -302,6 +426,57 @@ size_t plmemGetFreeSpace(MEM_MGR* memmgr) {
     return memmgr->memnow - (memmgr->memptr - memmgr->memsize) - memmgr->tmemsize;
 }
 
+/** @brief Fill @p stats for @p memmgr; walks the block list for the largest hole. */
+void plmemGetStats(MEM_MGR* memmgr, MEM_MGR_STATS* stats) {
+    MEM_BLOCK* now_block;
+    MEM_BLOCK* prev_block;
+    u8* lower;
+    u8* upper;
+
+    stats->size = memmgr->memsize;
+    stats->used = memmgr->used_size;
+    stats->peak_used = memmgr->peak_used;
+    stats->largest_free = plmemGetFreeSpace(memmgr);
+    stats->blocks = 0;
+    stats->registers = memmgr->register_count;
+    stats->releases = memmgr->release_count;
+    stats->failures = memmgr->fail_count;
+    stats->compactions = memmgr->compact_count;
+    stats->compact_steps = memmgr->compact_step_count;
+    stats->compact_moves = memmgr->compact_moves;
+    stats->compact_bytes = memmgr->compact_bytes;
+    stats->compact_ns = memmgr->compact_ns;
+    stats->compact_max_ns = memmgr->compact_max_ns;
+
+    // The list runs away from memptr; a hole is the space between one block's end and the next block
+    for (u32 han = memmgr->blocklist; han != MEM_NULL_HANDLE; han = now_block->next) {
+        size_t hole;
+
+        now_block = &memmgr->block[han];
+        stats->blocks += 1;
+
+        prev_block = (now_block->prev != MEM_NULL_HANDLE) ? &memmgr->block[now_block->prev] : NULL;
+
+        if (memmgr->direction != 0) {
+            lower = memmgr->memptr;
+            upper = now_block->ptr;
+
+            if (prev_block != NULL) {
+                lower = (u8*)ALIGN(prev_block->ptr, prev_block->len, memmgr->memalign);
+            }
+        } else {
+            lower = (u8*)ALIGN(now_block->ptr, now_block->len, memmgr->memalign);
+            upper = (prev_block != NULL) ? prev_block->ptr : memmgr->memptr;
+        }
+
+        hole = (upper > lower) ? (size_t)(upper - lower) : 0;
+
+        if (hole > stats->largest_free) {
+            stats->largest_free = hole;
+        }
+    }
+}
+
 /** @brief Find the first unused block slot and return its index. */
 u32 plmemPullHandle(MEM_MGR* memmgr) {
     s32 i;
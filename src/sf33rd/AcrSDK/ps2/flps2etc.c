@@ -14,6 +14,7 @@
 #include "sf33rd/AcrSDK/common/fbms.h"
 #include "sf33rd/AcrSDK/common/memfound.h"
 #include "sf33rd/AcrSDK/ps2/flps2debug.h"
+#include "sf33rd/AcrSDK/ps2/flps2vram.h"
 #include "sf33rd/AcrSDK/ps2/foundaps2.h"
 #include "structs.h"
 
@@ -86,6 +87,19 @@ void* flPS2GetSystemBuffAdrs(u32 handle) {
     return mflRetrieve(handle);
 }
 
+/** @brief Compaction moved @p handle: follow it with the temporary buffer cursors and renderer surfaces. */
+void flPS2SystemMemoryMoved(u32 handle, u8* old_ptr, u8* new_ptr) {
+    const intptr_t delta = new_ptr - old_ptr;
+
+    if (handle == flPs2State.SystemTmpBuffHandle[flPs2State.SystemIndex]) {
+        flPs2State.SystemTmpBuffStartAdrs += delta;
+        flPs2State.SystemTmpBuffEndAdrs += delta;
+        flPs2State.SystemTmpBuffNow += delta;
+    }
+
+    flPS2TextureMemoryMoved(handle);
+}
+
 // ============================================================================
 // Temporary Buffer Management
 // ============================================================================
@@ -29,6 +29,9 @@
 #define ERR_STOP                                                                                                       \
     while (1) {}
 
+// Textures that have a renderer surface wrapping their system memory
+static u8 texture_bound[FL_TEXTURE_MAX];
+
 static s32 flPS2ConvertTextureFromContext(plContext* lpcontext, FLTexture* lpflTexture, u32 type);
 static u32 flPS2GetTextureSize(u32 format, s32 dw, s32 dh, s32 bnum);
 s32 flPS2LockTexture(Rect* /* unused */, FLTexture* lpflTexture, plContext* lpcontext, u32 flag, s32 /* unused */);
@@ -180,9 +183,25 @@ s32 flPS2GetTextureInfoFromContext(plContext* bits, s32 bnum, u32 th, u32 flag)
 /** @brief Finalise a texture handle by creating the GPU resource. */
 s32 flPS2CreateTextureHandle(u32 th, u32 flag) {
     SDLGameRenderer_CreateTexture(th);
+    texture_bound[LO_16_BITS(th) - 1] = 1;
     return 1;
 }
 
+/**
+ * @brief Re-wrap the renderer surfaces of textures whose system memory was moved by compaction.
+ *
+ * Surfaces point straight at the pixels, so they're rebuilt on the new
+ * address. Palettes are copied when created and need nothing.
+ */
+void flPS2TextureMemoryMoved(u32 mem_handle) {
+    for (s32 i = 0; i < FL_TEXTURE_MAX; i++) {
+        if (flTexture[i].be_flag && texture_bound[i] && (flTexture[i].mem_handle == mem_handle)) {
+            SDLGameRenderer_DestroyTexture(i + 1);
+            SDLGameRenderer_CreateTexture(i + 1);
+        }
+    }
+}
+
 /** @brief Find the first unused slot in the texture array. */
 u32 flPS2GetTextureHandle() {
     s32 i;
@@ -319,6 +338,7 @@ s32 flReleaseTextureHandle(u32 texture_handle) {
     }
 
     SDLGameRenderer_DestroyTexture(texture_handle);
+    texture_bound[texture_handle - 1] = 0;
 
     if (lpflTexture->mem_handle != 0) {
         flPS2ReleaseSystemMemory(lpflTexture->mem_handle);
@@ -1029,6 +1049,64 @@ static u32 flPS2GetTextureSize(u32 format, s32 dw, s32 dh, s32 bnum) {
     return tex_size;
 }
 
+/** @brief Set @p tcon's pixel layout to the GS-native one for a direct-colour @p format. */
+static void flPS2SetGSPixelFormat(u32 format, plContext* tcon) {
+    switch (format) {
+    case SCE_GS_PSMCT16:
+        tcon->pixelformat.rl = 5;
+        tcon->pixelformat.rs = 0xA;
+        tcon->pixelformat.rm = 0x1F;
+        tcon->pixelformat.gl = 5;
+        tcon->pixelformat.gs = 5;
+        tcon->pixelformat.gm = 0x1F;
+        tcon->pixelformat.bl = 5;
+        tcon->pixelformat.bs = 0;
+        tcon->pixelformat.bm = 0x1F;
+        tcon->pixelformat.al = 1;
+        tcon->pixelformat.as = 0xF;
+        tcon->pixelformat.am = 1;
+        tcon->pixelformat.rs = 0;
+        tcon->pixelformat.bs = 0xA;
+        tcon->pixelformat.gl = 5;
+        tcon->pixelformat.gm = 0x1F;
+        break;
+
+    case SCE_GS_PSMCT24:
+        tcon->pixelformat.rl = 8;
+        tcon->pixelformat.rs = 0x10;
+        tcon->pixelformat.rm = 0xFF;
+        tcon->pixelformat.gl = 8;
+        tcon->pixelformat.gs = 8;
+        tcon->pixelformat.gm = 0xFF;
+        tcon->pixelformat.bl = 8;
+        tcon->pixelformat.bs = 0;
+        tcon->pixelformat.bm = 0xFF;
+        tcon->pixelformat.al = 0;
+        tcon->pixelformat.as = 0;
+        tcon->pixelformat.am = 0;
+        tcon->pixelformat.rs = 0;
+        tcon->pixelformat.bs = 0x10;
+        break;
+
+    case SCE_GS_PSMCT32:
+        tcon->pixelformat.rl = 8;
+        tcon->pixelformat.rs = 0x10;
+        tcon->pixelformat.rm = 0xFF;
+        tcon->pixelformat.gl = 8;
+        tcon->pixelformat.gs = 8;
+        tcon->pixelformat.gm = 0xFF;
+        tcon->pixelformat.bl = 8;
+        tcon->pixelformat.bs = 0;
+        tcon->pixelformat.bm = 0xFF;
+        tcon->pixelformat.al = 8;
+        tcon->pixelformat.as = 0x18;
+        tcon->pixelformat.am = 0xFF;
+        tcon->pixelformat.rs = 0;
+        tcon->pixelformat.bs = 0x10;
+        break;
+    }
+}
+
 /** @brief Convert a plContext into a GS-native pixel format and store in system memory. */
 static s32 flPS2ConvertTextureFromContext(plContext* lpcontext, FLTexture* lpflTexture, u32 type) {
     s32 lp0;
@@ -1070,62 +1148,15 @@ static s32 flPS2ConvertTextureFromContext(plContext* lpcontext, FLTexture* lpflT
         case SCE_GS_PSMCT16:
             tex_size = dw * dh * 2;
             tcon.ptr = dst_ptr;
-            tcon.pixelformat.rl = 5;
-            tcon.pixelformat.rs = 0xA;
-            tcon.pixelformat.rm = 0x1F;
-            tcon.pixelformat.gl = 5;
-            tcon.pixelformat.gs = 5;
-            tcon.pixelformat.gm = 0x1F;
-            tcon.pixelformat.bl = 5;
-            tcon.pixelformat.bs = 0;
-            tcon.pixelformat.bm = 0x1F;
-            tcon.pixelformat.al = 1;
-            tcon.pixelformat.as = 0xF;
-            tcon.pixelformat.am = 1;
-            tcon.pixelformat.rs = 0;
-            tcon.pixelformat.bs = 0xA;
-            tcon.pixelformat.gl = 5;
-            tcon.pixelformat.gm = 0x1F;
+            flPS2SetGSPixelFormat(lpflTexture->format, &tcon);
             flPS2ConvertContext(lpcontext, &tcon, 0, type);
             break;
 
         case SCE_GS_PSMCT24:
-            tex_size = dw * dh * 4;
-            tcon.ptr = dst_ptr;
-            tcon.pixelformat.rl = 8;
-            tcon.pixelformat.rs = 0x10;
-            tcon.pixelformat.rm = 0xFF;
-            tcon.pixelformat.gl = 8;
-            tcon.pixelformat.gs = 8;
-            tcon.pixelformat.gm = 0xFF;
-            tcon.pixelformat.bl = 8;
-            tcon.pixelformat.bs = 0;
-            tcon.pixelformat.bm = 0xFF;
-            tcon.pixelformat.al = 0;
-            tcon.pixelformat.as = 0;
-            tcon.pixelformat.am = 0;
-            tcon.pixelformat.rs = 0;
-            tcon.pixelformat.bs = 0x10;
-            flPS2ConvertContext(lpcontext, &tcon, 0, type);
-            break;
-
         case SCE_GS_PSMCT32:
             tex_size = dw * dh * 4;
             tcon.ptr = dst_ptr;
-            tcon.pixelformat.rl = 8;
-            tcon.pixelformat.rs = 0x10;
-            tcon.pixelformat.rm = 0xFF;
-            tcon.pixelformat.gl = 8;
-            tcon.pixelformat.gs = 8;
-            tcon.pixelformat.gm = 0xFF;
-            tcon.pixelformat.bl = 8;
-            tcon.pixelformat.bs = 0;
-            tcon.pixelformat.bm = 0xFF;
-            tcon.pixelformat.al = 8;
-            tcon.pixelformat.as = 0x18;
-            tcon.pixelformat.am = 0xFF;
-            tcon.pixelformat.rs = 0;
-            tcon.pixelformat.bs = 0x10;
+            flPS2SetGSPixelFormat(lpflTexture->format, &tcon);
             flPS2ConvertContext(lpcontext, &tcon, 0, type);
             break;
         }
@@ -1139,6 +1170,67 @@ static s32 flPS2ConvertTextureFromContext(plContext* lpcontext, FLTexture* lpflT
     return 1;
 }
 
+/**
+ * @brief Create a texture handle whose system memory the caller fills in place.
+ *
+ * @p pixels receives the texture's memory, laid out like @p bits. The
+ * caller writes source pixels there, converts each run of rows with
+ * flPS2ConvertTextureRows(), then calls flPS2CreateTextureHandle(). The
+ * result is the same as flCreateTextureHandle() on a separate buffer,
+ * without the buffer or the copy out of it.
+ */
+u32 flCreateTextureHandleInPlace(plContext* bits, u32 flag, u8** pixels) {
+    FLTexture* lpflTexture;
+    u32 th = flPS2GetTextureHandle();
+
+    if (th == 0) {
+        return 0;
+    }
+
+    lpflTexture = &flTexture[LO_16_BITS(th) - 1];
+
+    if (lpflTexture->be_flag) {
+        flReleaseTextureHandle(th);
+    }
+
+    flPS2GetTextureInfoFromContext(bits, 1, th, flag);
+    lpflTexture->mem_handle = flPS2GetSystemMemoryHandle(lpflTexture->size, 2);
+    *pixels = flPS2GetSystemBuffAdrs(lpflTexture->mem_handle);
+    return th;
+}
+
+/**
+ * @brief Convert rows [@p y, @p y + @p rows) of an in-place texture to the GS-native layout.
+ *
+ * Direct-colour pixels keep their size and position, so each is read and
+ * rewritten where it lies. Indexed pixels are already in their final form.
+ */
+s32 flPS2ConvertTextureRows(u32 th, plContext* bits, s32 y, s32 rows) {
+    FLTexture* lpflTexture = &flTexture[LO_16_BITS(th) - 1];
+    plContext scon = *bits;
+    plContext tcon;
+
+    switch (lpflTexture->format) {
+    case SCE_GS_PSMCT16:
+    case SCE_GS_PSMCT32:
+        break;
+
+    default:
+        return 1;
+    }
+
+    scon.ptr = (u8*)flPS2GetSystemBuffAdrs(lpflTexture->mem_handle) + (y * bits->pitch);
+    scon.height = rows;
+    tcon.ptr = scon.ptr;
+    tcon.desc = bits->desc;
+    tcon.bitdepth = bits->bitdepth;
+    tcon.width = bits->width;
+    tcon.height = rows;
+    tcon.pitch = tcon.width * tcon.bitdepth;
+    flPS2SetGSPixelFormat(lpflTexture->format, &tcon);
+    return flPS2ConvertContext(&scon, &tcon, 0, 0);
+}
+
 /** @brief Convert pixels between two plContext surfaces with optional CLUT re-ordering. */
 s32 flPS2ConvertContext(plContext* lpSrc, plContext* lpDst, u32 direction, u32 type) {
     s32 x;
@@ -77,6 +77,7 @@ static s32 system_work_init() {
     const int system_memory_size = 0xA00000;
     temp = flAllocMemoryS(system_memory_size);
     mflInit(temp, system_memory_size, FMS_ALIGNMENT);
+    mflSetMoveHook(flPS2SystemMemoryMoved);
 
     return 1;
 }
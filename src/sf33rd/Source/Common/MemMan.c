@@ -6,14 +6,304 @@
  * allocation within a pre-allocated memory region. Memory cells are
  * linked in address order; allocation finds the smallest gap that fits.
  *
+ * ⚡ Every free gap is also kept in a treap ordered by (size, address),
+ * so the best fit is an O(log n) search instead of a walk over every
+ * cell. Ties resolve exactly like the walk did (lowest address going
+ * forward, highest going in reverse), so heap layouts are unchanged. A
+ * heap without an index (out of memory for nodes, slot taken over by a
+ * newer heap, or mmSetGapIndexEnabled(0)) falls back to the walk.
+ *
+ * Every initialised heap is also listed (most recent MM_HEAP_LIST_MAX) so
+ * diagnostics can enumerate them with mmGetHeapCount()/mmGetHeap().
+ *
  * Part of the Common module.
  * Originally from the PS2 memory management module.
  */
 #include "sf33rd/Source/Common/MemMan.h"
 #include "common.h"
 
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MM_GAP_INDEX_SLOTS 8
+#define MM_HEAP_LIST_MAX 8
+#define MM_NIL -1
+
+typedef struct {
+    ssize_t size;   // Free bytes after the cell
+    uintptr_t cell; // Cell the gap follows
+    s32 left;
+    s32 right;
+    u32 prio;
+} MMGapNode;
+
+typedef struct {
+    const _MEMMAN_OBJ* owner; // NULL when the slot is free
+    MMGapNode* nodes;
+    s32 capacity;
+    s32 free_list; // Chained through left
+    s32 root;
+    u32 seed;
+} MMGapIndex;
+
 u32 mmInitialNumber;
 
+static MMGapIndex gap_index[MM_GAP_INDEX_SLOTS];
+static s32 gap_index_next; // Slot to take over when all are owned
+static s32 gap_index_enabled = 1;
+static _MEMMAN_OBJ* heap_list[MM_HEAP_LIST_MAX];
+static s32 heap_list_count;
+
+// Gap index (treap keyed by size, then address)
+
+static s32 gap_key_less(ssize_t size_a, uintptr_t cell_a, ssize_t size_b, uintptr_t cell_b) {
+    return (size_a < size_b) || ((size_a == size_b) && (cell_a < cell_b));
+}
+
+static MMGapIndex* gap_index_of(const _MEMMAN_OBJ* mmobj) {
+    for (s32 i = 0; i < MM_GAP_INDEX_SLOTS; i++) {
+        if (gap_index[i].owner == mmobj) {
+            return &gap_index[i];
+        }
+    }
+
+    return NULL;
+}
+
+/** @brief Give up on the index; the heap falls back to walking its cells. */
+static void gap_index_drop(MMGapIndex* gi) {
+    free(gi->nodes);
+    gi->owner = NULL;
+    gi->nodes = NULL;
+    gi->capacity = 0;
+    gi->free_list = MM_NIL;
+}
+
+static s32 gap_node_new(MMGapIndex* gi, ssize_t size, uintptr_t cell) {
+    s32 n;
+
+    if (gi->free_list == MM_NIL) {
+        const s32 capacity = gi->capacity ? gi->capacity * 2 : 64;
+        MMGapNode* nodes = realloc(gi->nodes, capacity * sizeof(MMGapNode));
+
+        if (nodes == NULL) {
+            return MM_NIL;
+        }
+
+        for (s32 i = gi->capacity; i < capacity; i++) {
+            nodes[i].left = (i + 1 < capacity) ? i + 1 : MM_NIL;
+        }
+
+        gi->nodes = nodes;
+        gi->free_list = gi->capacity;
+        gi->capacity = capacity;
+    }
+
+    n = gi->free_list;
+    gi->free_list = gi->nodes[n].left;
+    gi->seed = gi->seed * 1664525u + 1013904223u;
+    gi->nodes[n].size = size;
+    gi->nodes[n].cell = cell;
+    gi->nodes[n].left = MM_NIL;
+    gi->nodes[n].right = MM_NIL;
+    gi->nodes[n].prio = gi->seed;
+    return n;
+}
+
+/** @brief Split @p t into keys below (size, cell) and keys at or above it. */
+static void gap_split(MMGapIndex* gi, s32 t, ssize_t size, uintptr_t cell, s32* lo, s32* hi) {
+    if (t == MM_NIL) {
+        *lo = *hi = MM_NIL;
+        return;
+    }
+
+    MMGapNode* node = &gi->nodes[t];
+
+    if (gap_key_less(node->size, node->cell, size, cell)) {
+        gap_split(gi, node->right, size, cell, &node->right, hi);
+        *lo = t;
+    } else {
+        gap_split(gi, node->left, size, cell, lo, &node->left);
+        *hi = t;
+    }
+}
+
+static s32 gap_merge(MMGapIndex* gi, s32 lo, s32 hi) {
+    if (lo == MM_NIL) {
+        return hi;
+    }
+
+    if (hi == MM_NIL) {
+        return lo;
+    }
+
+    if (gi->nodes[lo].prio > gi->nodes[hi].prio) {
+        gi->nodes[lo].right = gap_merge(gi, gi->nodes[lo].right, hi);
+        return lo;
+    }
+
+    gi->nodes[hi].left = gap_merge(gi, lo, gi->nodes[hi].left);
+    return hi;
+}
+
+static void gap_insert(MMGapIndex* gi, ssize_t size, struct _MEMMAN_CELL* cell) {
+    s32 lo;
+    s32 hi;
+    s32 n;
+
+    if (size <= 0) {
+        return;
+    }
+
+    n = gap_node_new(gi, size, (uintptr_t)cell);
+
+    if (n == MM_NIL) {
+        gap_index_drop(gi);
+        return;
+    }
+
+    gap_split(gi, gi->root, size, (uintptr_t)cell, &lo, &hi);
+    gi->root = gap_merge(gi, gap_merge(gi, lo, n), hi);
+}
+
+static void gap_remove(MMGapIndex* gi, ssize_t size, struct _MEMMAN_CELL* cell) {
+    s32* link = &gi->root;
+
+    if (size <= 0) {
+        return;
+    }
+
+    while (*link != MM_NIL) {
+        MMGapNode* node = &gi->nodes[*link];
+
+        if ((node->size == size) && (node->cell == (uintptr_t)cell)) {
+            const s32 n = *link;
+
+            *link = gap_merge(gi, node->left, node->right);
+            gi->nodes[n].left = gi->free_list;
+            gi->free_list = n;
+            return;
+        }
+
+        link = gap_key_less(size, (uintptr_t)cell, node->size, node->cell) ? &node->left : &node->right;
+    }
+}
+
+/** @brief Smallest gap of at least @p size bytes; the lowest (or with @p highest, highest) address among ties. */
+static const MMGapNode* gap_best_fit(const MMGapIndex* gi, ssize_t size, s32 highest) {
+    const MMGapNode* best = NULL;
+    s32 t = gi->root;
+
+    while (t != MM_NIL) {
+        const MMGapNode* node = &gi->nodes[t];
+
+        if (node->size >= size) {
+            best = node;
+            t = node->left;
+        } else {
+            t = node->right;
+        }
+    }
+
+    if ((best == NULL) || !highest) {
+        return best;
+    }
+
+    // Last node with key <= (best->size, max address)
+    const ssize_t fit = best->size;
+    t = gi->root;
+
+    while (t != MM_NIL) {
+        const MMGapNode* node = &gi->nodes[t];
+
+        if (node->size <= fit) {
+            if (node->size == fit) {
+                best = node;
+            }
+
+            t = node->right;
+        } else {
+            t = node->left;
+        }
+    }
+
+    return best;
+}
+
+static ssize_t gap_after(const struct _MEMMAN_CELL* cell) {
+    return (intptr_t)cell->next - (intptr_t)cell - cell->size;
+}
+
+static void gap_index_attach(_MEMMAN_OBJ* mmobj) {
+    MMGapIndex* gi = gap_index_of(mmobj);
+
+    if (!gap_index_enabled) {
+        if (gi != NULL) {
+            gap_index_drop(gi);
+        }
+
+        return;
+    }
+
+    if (gi == NULL) {
+        gi = gap_index_of(NULL);
+    }
+
+    // All slots owned (heaps that went away never say so): the previous
+    // owner just stops finding its index and walks its cells again
+    if (gi == NULL) {
+        gi = &gap_index[gap_index_next];
+        gap_index_next = (gap_index_next + 1) % MM_GAP_INDEX_SLOTS;
+    }
+
+    // Reuse the node pool when a heap is re-initialised
+    gi->owner = mmobj;
+    gi->root = MM_NIL;
+    gi->free_list = MM_NIL;
+    gi->seed = 0x9E3779B9u;
+
+    for (s32 i = gi->capacity - 1; i >= 0; i--) {
+        gi->nodes[i].left = gi->free_list;
+        gi->free_list = i;
+    }
+
+    gap_insert(gi, gap_after(mmobj->cell_1st), mmobj->cell_1st);
+}
+
+/** @brief Size of the largest gap in the index (its rightmost node). */
+static ssize_t gap_largest(const MMGapIndex* gi) {
+    s32 t = gi->root;
+    ssize_t size = 0;
+
+    while (t != MM_NIL) {
+        size = gi->nodes[t].size;
+        t = gi->nodes[t].right;
+    }
+
+    return size;
+}
+
+static void heap_list_add(_MEMMAN_OBJ* mmobj) {
+    for (s32 i = 0; i < heap_list_count; i++) {
+        if (heap_list[i] == mmobj) {
+            return;
+        }
+    }
+
+    if (heap_list_count == MM_HEAP_LIST_MAX) {
+        memmove(&heap_list[0], &heap_list[1], (MM_HEAP_LIST_MAX - 1) * sizeof(heap_list[0]));
+        heap_list_count -= 1;
+    }
+
+    heap_list[heap_list_count++] = mmobj;
+}
+
+/** @brief Use the gap index for heaps initialised from now on (default on). For tests and benchmarks. */
+void mmSetGapIndexEnabled(s32 enable) {
+    gap_index_enabled = enable;
+}
+
 /** @brief Reset the global heap instance counter. */
 void mmSystemInitialize() {
     mmInitialNumber = 0;
@@ -37,6 +327,12 @@ void mmHeapInitialize(_MEMMAN_OBJ* mmobj, u8* adrs, s32 size, s32 unit, s8* form
     mmobj->cell_fin->prev = mmobj->cell_1st;
     mmobj->cell_fin->next = NULL;
     mmobj->cell_fin->size = mmobj->ownUnit;
+    mmobj->name = format;
+    mmobj->allocCount = 0;
+    mmobj->freeCount = 0;
+    mmobj->failCount = 0;
+    gap_index_attach(mmobj);
+    heap_list_add(mmobj);
 }
 
 /** @brief Round a value up to the next alignment boundary. */
@@ -69,9 +365,11 @@ u8* mmAlloc(_MEMMAN_OBJ* mmobj, ssize_t size, s32 flag) {
     struct _MEMMAN_CELL* cell = mmAllocSub(mmobj, size, flag);
 
     if (cell == NULL) {
+        mmobj->failCount += 1;
         return NULL;
     }
 
+    mmobj->allocCount += 1;
     mmobj->remainder -= cell->size;
 
     if (mmobj->remainderMin > mmobj->remainder) {
@@ -81,6 +379,43 @@ u8* mmAlloc(_MEMMAN_OBJ* mmobj, ssize_t size, s32 flag) {
     return (u8*)cell + mmobj->ownUnit;
 }
 
+/** @brief mmAllocSub() through the gap index; picks the same gap the walk would. */
+static struct _MEMMAN_CELL* alloc_indexed(_MEMMAN_OBJ* mmobj, MMGapIndex* gi, ssize_t sizeTrue, s32 flag) {
+    const MMGapNode* fit = gap_best_fit(gi, sizeTrue, flag == 1);
+    struct _MEMMAN_CELL* cell;
+    struct _MEMMAN_CELL* myself;
+    ssize_t gap;
+
+    // The walk only takes gaps with less than 0x7FFFFFFF bytes to spare
+    if ((fit == NULL) || ((fit->size - sizeTrue) >= 0x7FFFFFFF)) {
+        return NULL;
+    }
+
+    cell = (struct _MEMMAN_CELL*)fit->cell;
+    gap = fit->size;
+    gap_remove(gi, gap, cell);
+
+    if (flag != 1) {
+        myself = (struct _MEMMAN_CELL*)((uintptr_t)cell + cell->size);
+        myself->prev = cell;
+        myself->next = cell->next;
+        myself->size = sizeTrue;
+        cell->next->prev = myself;
+        cell->next = myself;
+        gap_insert(gi, gap - sizeTrue, myself);
+    } else {
+        myself = (struct _MEMMAN_CELL*)((uintptr_t)cell->next - sizeTrue);
+        myself->prev = cell;
+        myself->next = cell->next;
+        myself->size = sizeTrue;
+        cell->next->prev = myself;
+        cell->next = myself;
+        gap_insert(gi, gap - sizeTrue, cell);
+    }
+
+    return myself;
+}
+
 /** @brief Best-fit allocation subroutine — finds and links a new cell. */
 struct _MEMMAN_CELL* mmAllocSub(_MEMMAN_OBJ* mmobj, ssize_t size, s32 flag) {
     struct _MEMMAN_CELL* myself;
@@ -89,11 +424,16 @@ struct _MEMMAN_CELL* mmAllocSub(_MEMMAN_OBJ* mmobj, ssize_t size, s32 flag) {
     ssize_t sizeTrue;
     ptrdiff_t gap;
     ptrdiff_t gapMin;
+    MMGapIndex* gi;
 
     sizeTrue = mmobj->ownUnit + mmRoundUp(mmobj->ownUnit, size);
     gapMin = 0x7FFFFFFF;
     cell = NULL;
 
+    if ((gi = gap_index_of(mmobj)) != NULL) {
+        return alloc_indexed(mmobj, gi, sizeTrue, flag);
+    }
+
     if (flag != 1) {
         myself = mmobj->cell_1st;
 
@@ -166,13 +506,68 @@ struct _MEMMAN_CELL* mmAllocSub(_MEMMAN_OBJ* mmobj, ssize_t size, s32 flag) {
 /** @brief Free a previously allocated block by unlinking its cell. */
 void mmFree(_MEMMAN_OBJ* mmobj, u8* adrs) {
     struct _MEMMAN_CELL* cell;
+    MMGapIndex* gi;
 
     if (adrs != NULL) {
         cell = (struct _MEMMAN_CELL*)((intptr_t)adrs - mmobj->ownUnit);
         mmobj->remainder += cell->size;
+        mmobj->freeCount += 1;
+
+        if ((gi = gap_index_of(mmobj)) != NULL) {
+            const ssize_t gapPrev = gap_after(cell->prev);
+            const ssize_t gapSelf = gap_after(cell);
+
+            gap_remove(gi, gapPrev, cell->prev);
+            gap_remove(gi, gapSelf, cell);
+            gap_insert(gi, gapPrev + cell->size + gapSelf, cell->prev);
+        }
+
         cell->prev->next = cell->next;
         cell->next->prev = cell->prev;
     } else {
         return;
     }
 }
+
+/** @brief Fill @p stats for @p mmobj. The largest gap comes from the gap index, or a cell walk without one. */
+void mmGetStats(_MEMMAN_OBJ* mmobj, MMHeapStats* stats) {
+    const ssize_t size = mmobj->memSize - (mmobj->ownUnit * 2);
+    const MMGapIndex* gi = gap_index_of(mmobj);
+
+    stats->name = mmobj->name;
+    stats->size = size;
+    stats->live = size - mmobj->remainder;
+    stats->peak = size - mmobj->remainderMin;
+    stats->allocs = mmobj->allocCount;
+    stats->frees = mmobj->freeCount;
+    stats->failures = mmobj->failCount;
+    stats->blocks = mmobj->allocCount - mmobj->freeCount;
+    stats->largest_free = 0;
+
+    if (gi != NULL) {
+        stats->largest_free = gap_largest(gi);
+        return;
+    }
+
+    for (struct _MEMMAN_CELL* cell = mmobj->cell_1st; cell->next != NULL; cell = cell->next) {
+        const ssize_t gap = gap_after(cell);
+
+        if (gap > stats->largest_free) {
+            stats->largest_free = gap;
+        }
+    }
+}
+
+/** @brief Number of heaps initialised so far (at most the last MM_HEAP_LIST_MAX). */
+s32 mmGetHeapCount() {
+    return heap_list_count;
+}
+
+/** @brief The @p index-th listed heap, oldest first, or NULL. */
+_MEMMAN_OBJ* mmGetHeap(s32 index) {
+    if ((index < 0) || (index >= heap_list_count)) {
+        return NULL;
+    }
+
+    return heap_list[index];
+}
@@ -0,0 +1,200 @@
+/**
+ * @file PPGChunkDir.c
+ * @brief Cached chunk directory for loaded PPG/PPL/PPX buffers.
+ *
+ * Each directory lists the chunks of one buffer grouped by kind, so a
+ * lookup is an index into a flat array. A handful of directories are kept
+ * and the least recently used one is rebuilt when a new buffer shows up.
+ *
+ * Part of the Common module.
+ */
+#include "sf33rd/Source/Common/PPGChunkDir.h"
+
+#include <SDL3/SDL.h>
+
+#define PPG_DIR_SLOTS 8
+#define PPG_CHUNK_HEADER_SIZE 16
+
+typedef struct {
+    const u8* adrs;             // NULL when the slot is free
+    u8 head[8];                 // First chunk's magic and size, to catch a buffer reused without a forget
+    u32 last_use;               // For LRU replacement
+    s32 first[PPG_CHUNK_KINDS]; // Index of the kind's first chunk in chunks
+    s32 count[PPG_CHUNK_KINDS]; // Chunks of each kind
+    PPGChunkInfo* chunks;       // Grouped by kind, file order within a kind
+} PPGChunkDir;
+
+static PPGChunkDir dirs[PPG_DIR_SLOTS];
+static u32 use_clock;
+static PPGChunkDirStats stats;
+
+static u32 read_be32(const u8* p) {
+    return ((u32)p[0] << 24) | ((u32)p[1] << 16) | ((u32)p[2] << 8) | p[3];
+}
+
+static s32 chunk_kind(u32 magic) {
+    switch (magic) {
+    case 0x70434D50: // pCMP
+        return PPG_CHUNK_CMP;
+
+    case 0x7050414C: // pPAL
+        return PPG_CHUNK_PAL;
+
+    case 0x70544558: // pTEX
+        return PPG_CHUNK_TEX;
+
+    default:
+        return -1;
+    }
+}
+
+/** @brief Walk the chain once: count chunks per kind, or with @p fill, record them. Returns the number seen. */
+static s32 walk_chunks(const u8* adrs, PPGChunkDir* dir, s32* fill) {
+    u32 ofs = 0;
+    s32 n = 0;
+
+    while (1) {
+        const u8* chunk = adrs + ofs;
+        const u32 magic = read_be32(chunk);
+        const u32 size = read_be32(chunk + 4);
+
+        if (magic == 0x70454E44) { // pEND
+            break;
+        }
+
+        // A chunk smaller than its own header would loop forever; treat it as the end
+        if (size < PPG_CHUNK_HEADER_SIZE) {
+            break;
+        }
+
+        const s32 kind = chunk_kind(magic);
+
+        if (kind >= 0) {
+            if (fill != NULL) {
+                PPGChunkInfo* info = &dir->chunks[fill[kind]++];
+
+                info->ofs = ofs;
+                info->size = size;
+                info->compress = chunk[10] & 3; // Same offset in PPG, PPL and PPX headers
+            } else {
+                dir->count[kind] += 1;
+            }
+
+            n += 1;
+        }
+
+        ofs += (size + 3) & ~3;
+    }
+
+    return n;
+}
+
+static void release_dir(PPGChunkDir* dir) {
+    SDL_free(dir->chunks);
+    SDL_zerop(dir);
+}
+
+static PPGChunkDir* build_dir(const u8* adrs) {
+    PPGChunkDir* dir = &dirs[0];
+    s32 fill[PPG_CHUNK_KINDS];
+    s32 total;
+
+    for (s32 i = 0; i < PPG_DIR_SLOTS; i++) {
+        if (dirs[i].adrs == NULL) {
+            dir = &dirs[i];
+            break;
+        }
+
+        if (dirs[i].last_use < dir->last_use) {
+            dir = &dirs[i];
+        }
+    }
+
+    release_dir(dir);
+    stats.builds += 1;
+
+    // Count per kind, then place each kind's chunks in one contiguous run
+    total = walk_chunks(adrs, dir, NULL);
+
+    for (s32 k = 0, next = 0; k < PPG_CHUNK_KINDS; k++) {
+        dir->first[k] = next;
+        fill[k] = next;
+        next += dir->count[k];
+    }
+
+    if (total > 0) {
+        dir->chunks = SDL_malloc(total * sizeof(PPGChunkInfo));
+
+        if (dir->chunks == NULL) {
+            SDL_zerop(dir);
+            return NULL;
+        }
+
+        walk_chunks(adrs, dir, fill);
+    }
+
+    dir->adrs = adrs;
+    SDL_memcpy(dir->head, adrs, sizeof(dir->head));
+    return dir;
+}
+
+static PPGChunkDir* get_dir(const u8* adrs) {
+    PPGChunkDir* dir = NULL;
+
+    stats.lookups += 1;
+
+    if (adrs == NULL) {
+        return NULL;
+    }
+
+    for (s32 i = 0; i < PPG_DIR_SLOTS; i++) {
+        if (dirs[i].adrs == adrs) {
+            dir = &dirs[i];
+            break;
+        }
+    }
+
+    if ((dir != NULL) && (SDL_memcmp(dir->head, adrs, sizeof(dir->head)) != 0)) {
+        release_dir(dir);
+        dir = NULL;
+    }
+
+    if (dir == NULL) {
+        dir = build_dir(adrs);
+
+        if (dir == NULL) {
+            return NULL;
+        }
+    }
+
+    dir->last_use = ++use_clock;
+    return dir;
+}
+
+const PPGChunkInfo* ppgChunkDirFind(const u8* adrs, PPGChunkKind kind, s32 num) {
+    const PPGChunkDir* dir = get_dir(adrs);
+
+    if ((dir == NULL) || (num < 0) || (num >= dir->count[kind])) {
+        return NULL;
+    }
+
+    return &dir->chunks[dir->first[kind] + num];
+}
+
+s32 ppgChunkDirCount(const u8* adrs, PPGChunkKind kind) {
+    const PPGChunkDir* dir = get_dir(adrs);
+
+    return (dir != NULL) ? dir->count[kind] : 0;
+}
+
+void ppgChunkDirForget(const u8* adrs) {
+    for (s32 i = 0; i < PPG_DIR_SLOTS; i++) {
+        if ((dirs[i].adrs != NULL) && ((adrs == NULL) || (dirs[i].adrs == adrs))) {
+            release_dir(&dirs[i]);
+        }
+    }
+}
+
+void ppgChunkDirGetStats(PPGChunkDirStats* out) {
+    *out = stats;
+}
@@ -12,6 +12,7 @@
  */
 #include "sf33rd/Source/Common/PPGFile.h"
 #include "common.h"
+#include "port/io/load_trace.h"
 #include "port/rendering/renderer.h"
 #include "port/sdl/renderer/sdl_game_renderer.h"
 #include "sf33rd/AcrSDK/common/plcommon.h"
@@ -20,13 +21,14 @@
 #include "sf33rd/AcrSDK/ps2/flps2vram.h"
 #include "sf33rd/AcrSDK/ps2/foundaps2.h"
 #include "sf33rd/Source/Common/MemMan.h"
+#include "sf33rd/Source/Common/PPGChunkDir.h"
+#include "sf33rd/Source/Common/PPGStream.h"
 #include "sf33rd/Source/Compress/Lz77/Lz77Dec.h"
 #include "sf33rd/Source/Compress/zlibApp.h"
 #include "structs.h"
 
 #include <SDL3/SDL.h>
 
-#define MAGIC_TO_INT(str) ((str[0] << 0x18) | (str[1] << 0x10) | (str[2] << 0x8) | (str[3]))
 #define REVERT_U32(val)                                                                                                \
     (((val & 0xFF) << 0x18) | ((val & 0xFF00) << 8) | ((val >> 8) & 0xFF00) | ((val >> 0x18) & 0xFF))
 #define REVERT_U16(val) (((val >> 8) & 0xFF) | ((val & 0xFF) << 8))
@@ -57,6 +59,15 @@ typedef struct {
     TexCoord t;
 } _Vertex;
 
+/** @brief A texture being expanded into its own memory by ppgStreamDecompress(). */
+typedef struct {
+    u32 th;
+    plContext* bits;
+    u8* base; // The texture's memory; windows are converted by row
+    s32 dendL;
+    s32 col4;
+} PPGTexStream;
+
 const u8 pplColorModeWidth[4] = { 0xF, 0x3F, 0xFF, 0 };
 
 PPG_W ppg_w;
@@ -465,6 +476,169 @@ s32 ppgWriteQuadUseTrans(Vertex* pos, u32 col, PPGDataList* tb, s32 tix, s32 cix
     return 1;
 }
 
+/**
+ * @brief Resolve a texture's trans sub-rectangles into a replayable quad list.
+ *
+ * Performs the handle, palette and trans-table lookups of ppgWriteQuadUseTrans()
+ * (flip 0) once, so the result can be cached and re-emitted every frame with
+ * ppgWriteTransQuads(). Trans rectangles tile the texture without overlapping,
+ * so runs of adjacent cells sharing a palette are merged into one quad.
+ *
+ * @return Number of quads written, 0 if nothing would be drawn, or -1 if the
+ *         list does not fit in @p max or the texture cannot be resolved.
+ */
+s32 ppgBuildTransQuads(PPGDataList* tb, s32 tix, s32 cix, s32 pal, PPGTransQuad* out, s32 max, u8* cellsW,
+                       u8* cellsH) {
+    PPGFileHeader* ppg;
+    PPGTransQuad* q;
+    u16* phan = NULL;
+    u16 palhan = 0;
+    u16 texhan;
+    u16 ix_ofs;
+    u16 transTotal;
+    u8* tran;
+    s32 num = 0;
+    s32 i;
+    s32 j;
+
+    *cellsW = 1;
+    *cellsH = 1;
+
+    if (tb == NULL) {
+        tb = ppg_w.cur;
+
+        if (tb == NULL) {
+            return -1;
+        }
+    }
+
+    texhan = tb->tex->handle[tix - tb->tex->ixNum1st].b16[0];
+    ix_ofs = tb->tex->handle[tix - tb->tex->ixNum1st].b16[1];
+
+    if (texhan == 0) {
+        return 0;
+    }
+
+    if (ix_ofs & PPG_TEX_FLAG_CI) {
+        phan = tb->pal->handle;
+
+        if (phan == NULL) {
+            return 0;
+        }
+    }
+
+    if (tb->tex->srcAdrs != NULL) {
+        ppg = (PPGFileHeader*)(tb->tex->srcAdrs + tb->tex->offset[ix_ofs & PPG_TEX_OFFSET_MASK]);
+        transTotal = ((ppg->transNums >> 8) & 0xFF) | ((ppg->transNums & 0xFF) << 8);
+
+        if (transTotal != 0) {
+            *cellsW = ppg->width;
+            *cellsH = ppg->height;
+            tran = (u8*)&ppg[1];
+
+            for (i = 0; i < transTotal; i++, tran += 3) {
+                u32 texCode;
+                u8 sx = tran[1] % ppg->width;
+                u8 sy = tran[1] / ppg->width;
+                u8 xs = (tran[2] >> 4) + 1;
+                u8 ys = (tran[2] & 0xF) + 1;
+
+                if (ix_ofs & PPG_TEX_FLAG_CI) {
+                    palhan = phan[tran[0] + pal];
+                }
+
+                texCode = texhan | (palhan << 0x10);
+
+                if (num > 0) {
+                    q = &out[num - 1];
+
+                    if ((q->texCode == texCode) && (q->sy == sy) && (q->ys == ys) && ((q->sx + q->xs) == sx) &&
+                        ((q->xs + xs) <= 0xFF)) {
+                        q->xs += xs;
+                        continue;
+                    }
+                }
+
+                if (num >= max) {
+                    return -1;
+                }
+
+                q = &out[num++];
+                q->texCode = texCode;
+                q->sx = sx;
+                q->sy = sy;
+                q->xs = xs;
+                q->ys = ys;
+            }
+
+            // Fold row spans that continue a span directly above them.
+            for (i = 1; i < num; i++) {
+                for (j = 0; j < i; j++) {
+                    q = &out[j];
+
+                    if ((q->texCode == out[i].texCode) && (q->sx == out[i].sx) && (q->xs == out[i].xs) &&
+                        ((q->sy + q->ys) == out[i].sy) && ((q->ys + out[i].ys) <= 0xFF)) {
+                        q->ys += out[i].ys;
+                        out[i--] = out[--num];
+                        break;
+                    }
+                }
+            }
+
+            return num;
+        }
+    }
+
+    if (max < 1) {
+        return -1;
+    }
+
+    if (ix_ofs & PPG_TEX_FLAG_CI) {
+        palhan = (cix < 0) ? ppg_w.hanPal : phan[cix];
+    }
+
+    out->texCode = texhan | (palhan << 0x10);
+    out->sx = out->sy = 0;
+    out->xs = out->ys = 1;
+    return 1;
+}
+
+/** @brief Emit a quad list built by ppgBuildTransQuads() over the rectangle @p pos. */
+s32 ppgWriteTransQuads(Vertex* pos, u32 col, const PPGTransQuad* quads, s32 num, u8 cellsW, u8 cellsH) {
+    Vertex qvtx[4];
+    const PPGTransQuad* q;
+    s32 i;
+
+    if ((pos[0].x >= 384.0f) || (pos[3].x < 0.0f) || (pos[0].y >= 224.0f) || (pos[3].y < 0.0f)) {
+        return 0;
+    }
+
+    const f32 inv_cellsW = 1.0f / cellsW;
+    const f32 inv_cellsH = 1.0f / cellsH;
+    const f32 pxs_inv_cellsW = (pos[3].x - pos[0].x) * inv_cellsW;
+    const f32 pys_inv_cellsH = (pos[3].y - pos[0].y) * inv_cellsH;
+
+    qvtx[0].z = pos[0].z;
+    qvtx[3].z = pos[3].z;
+
+    for (i = 0, q = quads; i < num; i++, q++) {
+        qvtx[0].x = pos->x + (q->sx * pxs_inv_cellsW);
+        qvtx[3].x = pos->x + (pxs_inv_cellsW * (q->sx + q->xs));
+        qvtx[0].y = pos->y + (q->sy * pys_inv_cellsH);
+        qvtx[3].y = pos->y + (pys_inv_cellsH * (q->sy + q->ys));
+
+        if ((qvtx[0].x < 384.0f) && (qvtx[3].x >= 0.0f) && (qvtx[0].y < 224.0f) && (qvtx[3].y >= 0.0f)) {
+            qvtx[0].s = q->sx * inv_cellsW;
+            qvtx[3].s = (q->sx + q->xs) * inv_cellsW;
+            qvtx[0].t = q->sy * inv_cellsH;
+            qvtx[3].t = (q->sy + q->ys) * inv_cellsH;
+            ppgWriteQuadOnly2(qvtx, col, q->texCode);
+        }
+    }
+
+    return 1;
+}
+
 /** @brief Decompress data using the specified method (0=copy, 1=LZ77, 2=zlib). */
 static ssize_t ppgDecompress(s32 koCmpr, void* srcAdrs, s32 srcSize, void* dstAdrs, s32 dstSize) {
     u8* src;
@@ -501,42 +675,32 @@ static ssize_t ppgDecompress(s32 koCmpr, void* srcAdrs, s32 srcSize, void* dstAd
 
 /** @brief Locate and decompress a pCMP chunk by index from source data. */
 s32 ppgSetupCmpChunk(u8* srcAdrs, s32 num, u8* dstAdrs) {
+    const PPGChunkInfo* chunk;
     PPXFileHeader* ppx;
     void* cmpAdrs;
     s32 cmpSize;
     s32 mltSize;
+    ssize_t expSize;
     s32 koCmpr;
-    s32 ofs;
-
-    ofs = 0;
-
-    while (1) {
-        ppx = (PPXFileHeader*)(srcAdrs + ofs);
 
-        if (MAGIC_TO_INT("pEND") == REVERT_U32(ppx->magic)) {
-            return -1;
-        }
+    // ⚡ Chunk directory: the chain is walked once per buffer, not once per chunk
+    chunk = ppgChunkDirFind(srcAdrs, PPG_CHUNK_CMP, num);
 
-        if (MAGIC_TO_INT("pCMP") != REVERT_U32(ppx->magic)) {
-            ofs += (REVERT_U32(ppx->fileSize) + 3) & ~3;
-            continue;
-        }
-
-        if (num > 0) {
-            num -= 1;
-            ofs += (REVERT_U32(ppx->fileSize) + 3) & ~3;
-            continue;
-        }
-
-        break;
+    if (chunk == NULL) {
+        return -1;
     }
 
+    ppx = (PPXFileHeader*)(srcAdrs + chunk->ofs);
     mltSize = REVERT_U32(ppx->expSize);
-    cmpSize = REVERT_U32(ppx->fileSize) - 0x10;
+    cmpSize = chunk->size - 0x10;
     cmpAdrs = ppx + 1;
-    koCmpr = ppx->compress & 3;
+    koCmpr = chunk->compress;
+
+    LOAD_TRACE_BEGIN(DECOMPRESS);
+    expSize = ppgDecompress(koCmpr, cmpAdrs, cmpSize, dstAdrs, mltSize);
+    LOAD_TRACE_END(DECOMPRESS);
 
-    if (mltSize != ppgDecompress(koCmpr, cmpAdrs, cmpSize, dstAdrs, mltSize)) {
+    if (mltSize != expSize) {
         flLogOut("圧縮データの解凍に失敗しました。\n"); // Failed to decompress the compressed data.
         while (1) {}
     }
@@ -546,6 +710,7 @@ s32 ppgSetupCmpChunk(u8* srcAdrs, s32 num, u8* dstAdrs) {
 
 /** @brief Locate and load a pPAL palette chunk by index, creating GPU handles. */
 s32 ppgSetupPalChunk(Palette* pch, u8* adrs, s32 size, s32 ixNum1st, s32 num, s32 /* unused */) {
+    const PPGChunkInfo* chunk;
     PPLFileHeader* ppl;
     plContext bits;
     s32 i;
@@ -555,7 +720,6 @@ s32 ppgSetupPalChunk(Palette* pch, u8* adrs, s32 size, s32 ixNum1st, s32 num, s3
     s32 mltSize;
     void* cmpAdrs;
     void* mltAdrs;
-    u32 ofs = 0;
 
     if (pch == NULL) {
         pch = ppg_w.cur->pal;
@@ -573,33 +737,19 @@ s32 ppgSetupPalChunk(Palette* pch, u8* adrs, s32 size, s32 ixNum1st, s32 num, s3
     mltAdrs = NULL;
     koCmpr = 0;
 
-    while (1) {
-        ppl = (PPLFileHeader*)(adrs + ofs);
-
-        if (MAGIC_TO_INT("pEND") == REVERT_U32(ppl->magic)) {
-            return -1;
-        }
-
-        if (MAGIC_TO_INT("pPAL") != REVERT_U32(ppl->magic)) {
-            ofs += (REVERT_U32(ppl->fileSize) + 3) & ~3;
-            continue;
-        }
-
-        if (num > 0) {
-            num -= 1;
-            ofs += (REVERT_U32(ppl->fileSize) + 3) & ~3;
-            continue;
-        }
+    chunk = ppgChunkDirFind(adrs, PPG_CHUNK_PAL, num);
 
-        break;
+    if (chunk == NULL) {
+        return -1;
     }
 
-    cmpSize = REVERT_U32(ppl->fileSize) - 16;
+    ppl = (PPLFileHeader*)(adrs + chunk->ofs);
+    cmpSize = chunk->size - 16;
     cmpAdrs = ppl + 1;
     pch->c_mode = ppl->c_mode & 3;
     pch->total = REVERT_U16(ppl->palettes);
     col_items = pplColorModeWidth[pch->c_mode] + 1;
-    koCmpr = ppl->compress & 3;
+    koCmpr = chunk->compress;
     ppgSetupContextFromPPL(ppl, &bits);
     pch->handle = ppgMallocF(pch->total * 2);
 
@@ -610,11 +760,9 @@ s32 ppgSetupPalChunk(Palette* pch, u8* adrs, s32 size, s32 ixNum1st, s32 num, s3
 
         mltSize = bits.bitdepth * (pch->total * col_items);
 
-        if (koCmpr != 0) {
-            mltAdrs = ppgPullDecBuff(mltSize);
-        } else {
-            mltAdrs = cmpAdrs;
-        }
+        // Uncompressed palettes are copied too: the endian swap must not touch the source,
+        // which may be a read-only view of the AFS archive (see load_it_use_any_key2)
+        mltAdrs = ppgPullDecBuff(mltSize);
 
         if (mltAdrs == NULL) {
             // Failed to allocate palette data decompression area.
@@ -629,11 +777,6 @@ s32 ppgSetupPalChunk(Palette* pch, u8* adrs, s32 size, s32 ixNum1st, s32 num, s3
         }
 
         ppgChangeDataEndian(mltAdrs, mltSize, ppl->c_mode & 4, ppl->formARGB == 0x8888, bits.bitdepth, 0);
-
-        if (koCmpr == 0) {
-            ppl->c_mode |= 4;
-        }
-
         bits.ptr = mltAdrs;
 
         for (i = 0; i < pch->total; i++) {
@@ -641,11 +784,6 @@ s32 ppgSetupPalChunk(Palette* pch, u8* adrs, s32 size, s32 ixNum1st, s32 num, s3
 
             if (pch->handle[i] == 0) {
                 flLogOut("パレットハンドルの取得に失敗しました。\n"); // Failed to acquire palette handle.
-
-                if (koCmpr == 0) {
-                    goto error_handler;
-                }
-
                 ppgPushDecBuff(mltAdrs);
                 goto error_handler;
             }
@@ -653,9 +791,7 @@ s32 ppgSetupPalChunk(Palette* pch, u8* adrs, s32 size, s32 ixNum1st, s32 num, s3
             bits.ptr = (u8*)bits.ptr + (col_items * bits.bitdepth);
         }
 
-        if (koCmpr != 0) {
-            ppgPushDecBuff(mltAdrs);
-        }
+        ppgPushDecBuff(mltAdrs);
         pch->be = 1;
         return 1;
     }
@@ -1059,9 +1195,7 @@ s32 ppgRenewTexChunkSeqs(Texture* tch) {
 
 /** @brief First-pass setup of a texture chunk — scan for pTEX entries and build offset table. */
 s32 ppgSetupTexChunk_1st(Texture* tch, u8* adrs, ssize_t size, s32 ixNum1st, s32 ixNums, s32 ar, s32 arcnt) {
-    PPGFileHeader* ppg;
     s32 i;
-    s32 ofs;
 
     if (tch == NULL) {
         tch = ppg_w.cur->tex;
@@ -1094,21 +1228,7 @@ s32 ppgSetupTexChunk_1st(Texture* tch, u8* adrs, ssize_t size, s32 ixNum1st, s32
         tch->handle[i].b16[1] = PPG_TEX_FLAG_UNLINKED;
     }
 
-    ofs = 0;
-
-    while (1) {
-        ppg = (PPGFileHeader*)(tch->srcAdrs + ofs);
-
-        if (MAGIC_TO_INT("pEND") != REVERT_U32(ppg->magic)) {
-            if (MAGIC_TO_INT("pTEX") == REVERT_U32(ppg->magic)) {
-                tch->textures += 1;
-            }
-
-            ofs += (REVERT_U32(ppg->fileSize) + 3) & ~3;
-        } else {
-            break;
-        }
-    }
+    tch->textures = ppgChunkDirCount(tch->srcAdrs, PPG_CHUNK_TEX);
 
     if (tch->textures == 0) {
         flLogOut("テクスチャデータが見つかりませんでした。\n"); // Texture data was not found.
@@ -1123,20 +1243,8 @@ s32 ppgSetupTexChunk_1st(Texture* tch, u8* adrs, ssize_t size, s32 ixNum1st, s32
         goto error_handler;
     }
 
-    ofs = 0;
-
-    while (1) {
-        ppg = (PPGFileHeader*)(tch->srcAdrs + ofs);
-
-        if (MAGIC_TO_INT("pEND") != REVERT_U32(ppg->magic)) {
-            if (MAGIC_TO_INT("pTEX") == REVERT_U32(ppg->magic)) {
-                tch->offset[tch->accnum++] = ofs;
-            }
-
-            ofs += (REVERT_U32(ppg->fileSize) + 3) & ~3;
-        } else {
-            break;
-        }
+    for (i = 0; i < tch->textures; i++) {
+        tch->offset[i] = ppgChunkDirFind(tch->srcAdrs, PPG_CHUNK_TEX, i)->ofs;
     }
 
     tch->accnum = 0;
@@ -1200,18 +1308,29 @@ s32 ppgSetupTexChunk_2nd(Texture* tch, s32 ixNum) {
     return tch->accnum;
 }
 
+/** @brief Byte-swap and convert one window of a texture being expanded in place. */
+static void ppgTexStreamSink(u8* adrs, s32 size, void* user) {
+    PPGTexStream* stream = user;
+    const s32 pitch = stream->bits->pitch;
+
+    LOAD_TRACE_BEGIN(CONVERT);
+    ppgChangeDataEndian(adrs, size, stream->dendL, stream->col4, stream->bits->bitdepth, 0);
+    flPS2ConvertTextureRows(stream->th, stream->bits, (s32)(adrs - stream->base) / pitch, size / pitch);
+    LOAD_TRACE_END(CONVERT);
+}
+
 /** @brief Third-pass — decompress texture data and create the GPU texture handle. */
 s32 ppgSetupTexChunk_3rd(Texture* tch, s32 ixNum, u32 attribute) {
     plContext bits;
     PPGFileHeader* ppg;
     TextureHandle* hnof;
+    PPGTexStream stream;
     s32 koCmpr;
     s32 cmpSize;
     s32 mltSize;
+    ssize_t expSize;
     void* cmpAdrs;
-    void* mltAdrs;
-
-    s32 unused_s5;
+    u8* mltAdrs;
 
     if (tch == NULL) {
         tch = ppg_w.cur->tex;
@@ -1240,33 +1359,35 @@ s32 ppgSetupTexChunk_3rd(Texture* tch, s32 ixNum, u32 attribute) {
     cmpAdrs = (u8*)ppg + cmpSize;
     cmpSize = REVERT_U32(ppg->fileSize) - cmpSize;
     mltSize = bits.height * bits.pitch;
-    mltAdrs = ppgPullDecBuff(mltSize);
 
-    if (mltAdrs == NULL) {
-        // Failed to allocate texture data expansion area.
-        flLogOut("テクスチャデータ展開領域が確保できませんでした。\n");
-        while (1) {}
-    }
+    // ⚡ Expand straight into the texture's own memory and convert each window while it is still in cache,
+    // instead of expanding into a scratch buffer and making two more passes over it
+    hnof->b16[0] = flCreateTextureHandleInPlace(&bits, attribute, &mltAdrs);
 
-    if (mltSize != ppgDecompress(koCmpr, cmpAdrs, cmpSize, mltAdrs, mltSize)) {
-        // Failed to acquire sprite texture handle.
-        flLogOut("テクスチャデータの解凍に失敗しました。\n");
-        ppgPushDecBuff(mltAdrs);
+    if (hnof->b16[0] == 0) {
+        // Failed to acquire texture handle.
+        flLogOut("テクスチャハンドルの取得に失敗しました。\n");
         while (1) {}
     }
 
-    unused_s5 = 0;
-    ppgChangeDataEndian(mltAdrs, mltSize, ppg->pixel & 4, ppg->formARGB == 0x8888, bits.bitdepth, unused_s5);
-    bits.ptr = mltAdrs;
-    hnof->b16[0] = flCreateTextureHandle(ixNum, &bits, attribute);
-    ppgPushDecBuff(mltAdrs);
+    stream.th = hnof->b16[0];
+    stream.bits = &bits;
+    stream.base = mltAdrs;
+    stream.dendL = ppg->pixel & 4;
+    stream.col4 = ppg->formARGB == 0x8888;
 
-    if (hnof->b16[0] == 0) {
-        // Failed to acquire texture handle.
-        flLogOut("テクスチャハンドルの取得に失敗しました。\n");
+    // The sink's conversion is traced as its own scope nested in this one
+    LOAD_TRACE_BEGIN(DECOMPRESS);
+    expSize = ppgStreamDecompress(koCmpr, cmpAdrs, cmpSize, mltAdrs, mltSize, bits.pitch, ppgTexStreamSink, &stream);
+    LOAD_TRACE_END(DECOMPRESS);
+
+    if (mltSize != expSize) {
+        // Failed to acquire sprite texture handle.
+        flLogOut("テクスチャデータの解凍に失敗しました。\n");
         while (1) {}
     }
 
+    flPS2CreateTextureHandle(hnof->b16[0], attribute);
     return 1;
 }
 
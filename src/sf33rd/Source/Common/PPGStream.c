@@ -0,0 +1,92 @@
+/**
+ * @file PPGStream.c
+ * @brief Windowed decompression of PPG data straight into its final buffer.
+ *
+ * Part of the Common module.
+ */
+#include "sf33rd/Source/Common/PPGStream.h"
+#include "sf33rd/Source/Compress/Lz77/Lz77Dec.h"
+#include "sf33rd/Source/Compress/zlibApp.h"
+
+#include <SDL3/SDL.h>
+
+/** @brief Hand @p dst[*done, upto) to the sink in whole windows, plus any remainder when @p tail. */
+static void flush_windows(u8* dst, s32* done, s32 upto, s32 window, bool tail, PPGStreamSink sink, void* user) {
+    while (*done + window <= upto) {
+        sink(dst + *done, window, user);
+        *done += window;
+    }
+
+    if (tail && (*done < upto)) {
+        sink(dst + *done, upto - *done, user);
+        *done = upto;
+    }
+}
+
+ssize_t ppgStreamDecompress(s32 koCmpr, void* srcAdrs, s32 srcSize, void* dstAdrs, s32 dstSize, s32 unit,
+                            PPGStreamSink sink, void* user) {
+    const s32 window = SDL_max(PPG_STREAM_WINDOW - (PPG_STREAM_WINDOW % unit), unit);
+    u8* src = srcAdrs;
+    u8* dst = dstAdrs;
+    s32 done = 0;
+    LZ77Stream lz;
+
+    switch (koCmpr) {
+    default:
+        while (done < dstSize) {
+            const s32 size = SDL_min(window, dstSize - done);
+
+            if (src != dst) {
+                SDL_memcpy(dst + done, src + done, size);
+            }
+
+            sink(dst + done, size, user);
+            done += size;
+        }
+
+        return srcSize;
+
+    case 1:
+        if ((src == NULL) || (dst == NULL)) {
+            return 0;
+        }
+
+        lz.src = src;
+        lz.dst = dst;
+        lz.size = dstSize;
+
+        // ⚡ Decode one window ahead of the copy distance, then hand over what no copy can reach any more
+        while (lz.size > 0) {
+            decLZ77Stream(&lz, dst + done + LZ77_MAX_DISTANCE + window);
+
+            if (lz.size > 0) {
+                flush_windows(dst, &done, (s32)(lz.dst - dst) - LZ77_MAX_DISTANCE, window, false, sink, user);
+            }
+        }
+
+        if (lz.size != 0) {
+            return 0;
+        }
+
+        flush_windows(dst, &done, dstSize, window, true, sink, user);
+        return dstSize;
+
+    case 2:
+        if (!zlib_StreamBegin(src, srcSize, dst)) {
+            return 0;
+        }
+
+        while (done < dstSize) {
+            const s32 size = SDL_min(window, dstSize - done);
+
+            if (zlib_StreamRun(size) != done + size) {
+                break;
+            }
+
+            sink(dst + done, size, user);
+            done += size;
+        }
+
+        return zlib_StreamEnd();
+    }
+}
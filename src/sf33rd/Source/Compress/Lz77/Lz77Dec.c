@@ -21,10 +21,24 @@
  * @return 1 if the decompressed size exactly matches @p size, 0 otherwise.
  */
 s32 decLZ77withSizeCheck(u8* src, u8* dst, s32 size) {
+    LZ77Stream st;
+
     if (src == NULL || dst == NULL) {
         return 0;
     }
 
+    st.src = src;
+    st.dst = dst;
+    st.size = size;
+    decLZ77Stream(&st, dst + size);
+    return st.size == 0;
+}
+
+/** @brief Decode whole codes until the output reaches @p stop or the expected size is reached. */
+void decLZ77Stream(LZ77Stream* st, const u8* stop) {
+    u8* src = st->src;
+    u8* dst = st->dst;
+    s32 size = st->size;
     s32 j;
     s32 loop;
     u8* dic;
@@ -32,7 +46,7 @@ s32 decLZ77withSizeCheck(u8* src, u8* dst, s32 size) {
     u8 step;
     u16 offset;
 
-    while (size > 0) {
+    while ((size > 0) && (dst < stop)) {
         offset = *src++;
 
         if (offset & 0x80) {
@@ -193,5 +207,7 @@ s32 decLZ77withSizeCheck(u8* src, u8* dst, s32 size) {
         }
     }
 
-    return size == 0;
+    st->src = src;
+    st->dst = dst;
+    st->size = size;
 }
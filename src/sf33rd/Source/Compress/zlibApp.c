@@ -93,3 +93,63 @@ ssize_t zlib_Decompress(void* srcBuff, s32 srcSize, void* dstBuff, s32 dstSize)
 
     return zlib.info.total_out;
 }
+
+/**
+ * @brief Begin inflating a zlib-compressed buffer into the destination a window at a time.
+ *
+ * Drive it with zlib_StreamRun() and close it with zlib_StreamEnd(). Shares
+ * the wrapper's single stream with zlib_Decompress(), so only one may be in
+ * flight at a time.
+ */
+s32 zlib_StreamBegin(void* srcBuff, s32 srcSize, void* dstBuff) {
+    if (srcBuff == NULL || dstBuff == NULL) {
+        return 0;
+    }
+
+    zlib.info.next_in = srcBuff;
+    zlib.info.avail_in = srcSize;
+    zlib.info.next_out = dstBuff;
+    zlib.info.avail_out = 0;
+    zlib.state = Z_OK;
+
+    return inflateInit_(&zlib.info, ZLIB_VERSION, sizeof(z_stream)) == Z_OK;
+}
+
+/**
+ * @brief Inflate up to @p size more bytes after the output written so far.
+ *
+ * inflate() keeps its own copy of the history it can still refer back to,
+ * so the caller may rewrite earlier output in place between calls.
+ * Returns the total inflated so far, or -1 if the stream is corrupt.
+ */
+ssize_t zlib_StreamRun(s32 size) {
+    zlib.info.avail_out = size;
+
+    while ((zlib.info.avail_out > 0) && (zlib.state != Z_STREAM_END)) {
+        zlib.state = inflate(&zlib.info, Z_NO_FLUSH);
+
+        if ((zlib.state != Z_OK) && (zlib.state != Z_STREAM_END)) {
+            return -1;
+        }
+    }
+
+    return zlib.info.total_out;
+}
+
+/** @brief Close a stream; returns the total inflated, or 0 if it didn't end cleanly. */
+ssize_t zlib_StreamEnd() {
+    s32 ended;
+
+    // The end of the stream may still be unread once the last byte is out
+    while (zlib.state == Z_OK) {
+        zlib.state = inflate(&zlib.info, Z_NO_FLUSH);
+    }
+
+    ended = zlib.state == Z_STREAM_END;
+
+    if ((inflateEnd(&zlib.info) != Z_OK) || !ended) {
+        return 0;
+    }
+
+    return zlib.info.total_out;
+}
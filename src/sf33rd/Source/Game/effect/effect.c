@@ -5,6 +5,7 @@
 
 #include "sf33rd/Source/Game/effect/effect.h"
 #include "common.h"
+#include "port/sim_profile.h"
 #include "sf33rd/AcrSDK/ps2/flps2debug.h"
 #include "sf33rd/Source/Game/debug/Debug.h"
 #include "sf33rd/Source/Game/effect/effxx.h"
@@ -39,8 +40,12 @@ void move_effect_work(s16 index) {
         next_ix = c_addr->behind;
 
         if (c_addr->timing != exec_tm[index]) {
+            const s16 id = c_addr->id;
+            const u64 prof = SimProfile_Begin();
+
             c_addr->timing = exec_tm[index];
-            effmovejptbl[c_addr->id](c_addr);
+            effmovejptbl[id](c_addr);
+            SimProfile_End(SIM_PROFILE_EFFECT, id, prof);
         }
     }
 }
@@ -5,6 +5,7 @@
 
 #include "sf33rd/Source/Game/engine/charset.h"
 #include "common.h"
+#include "port/sim_profile.h"
 #include "sf33rd/Source/Game/effect/effect.h"
 #include "sf33rd/Source/Game/effect/effxx.h"
 #include "sf33rd/Source/Game/engine/cmd_data.h"
@@ -41,6 +42,16 @@ static u16 check_xcopy_filter_se_req(WORK* wk);
 static void check_cgd_patdat2(WORK* wk);
 static void setup_metamor_kezuri(WORK* wk);
 
+/** @brief Run one script command through decode_chcmd, charged to its opcode in the sim profile. */
+static s32 decode_chcmd_profiled(WORK* wk, UNK11* cpc) {
+    const u16 code = cpc->code;
+    const u64 prof = SimProfile_Begin();
+    const s32 result = decode_chcmd[code](wk, cpc);
+
+    SimProfile_End(SIM_PROFILE_COMMAND, code, prof);
+    return result;
+}
+
 /** @brief Initializes character animation move with a given index. */
 void set_char_move_init(WORK* wk, s16 koc, s16 index) {
     wk->now_koc = koc;
@@ -291,7 +302,7 @@ s32 char_move_cmms3(PLW* wk) {
             break;
         }
 
-        if (decode_chcmd[cpc->code](wk, cpc) != 0) {
+        if (decode_chcmd_profiled((WORK*)wk, cpc) != 0) {
             wk->wu.cg_ix += wk->wu.cgd_type;
         } else if (wk->meoshi_jump_flag != 0) {
             break;
@@ -353,7 +364,7 @@ void check_cm_extended_code(WORK* wk) {
             break;
         }
 
-        if (decode_chcmd[cpc->code](wk, cpc) == 0) {
+        if (decode_chcmd_profiled(wk, cpc) == 0) {
             break;
         }
 
@@ -0,0 +1,161 @@
+/**
+ * @file hitbox.c
+ * @brief World-space hitboxes for attack_hit_check(): pair culling and vectorised overlap depths.
+ *
+ * hit_check_subroutine() lives here too, as the reference the fast paths
+ * reproduce, so the equivalence test can link it without the rest of hitcheck.c.
+ */
+
+#include "sf33rd/Source/Game/engine/hitbox.h"
+#include "sf33rd/Source/Game/engine/hitcheck.h"
+
+#include <SDL3/SDL.h>
+#include <simde/x86/sse2.h>
+#include <stdint.h>
+
+/** @brief Low-level hitbox overlap test (AABB intersection check). */
+s16 hit_check_subroutine(WORK* wk1, WORK* wk2, const s16* hd1, const s16* hd2) {
+    s16 d0;
+    s16 d1;
+    s16 d2;
+    s16 d3;
+
+    d0 = *hd1++;
+    d1 = *hd1++;
+
+    if (wk1->rl_flag) {
+        d0 = -d0;
+        d0 -= d1;
+    }
+
+    d0 += wk1->xyz[0].disp.pos;
+    d2 = *hd2++;
+    d3 = *hd2++;
+
+    if (wk2->rl_flag) {
+        d2 = -d2;
+        d2 -= d3;
+    }
+
+    d2 += wk2->xyz[0].disp.pos;
+    d2 += d3 - d0;
+    d3 += d1;
+
+    if ((u32)d2 >= d3) {
+        return 0;
+    }
+
+    d0 = (wk1->xyz[1].disp.pos + *hd1++) - (wk2->xyz[1].disp.pos + *hd2++);
+    d0 += d1 = *hd1;
+    d1 += *hd2;
+
+    if ((u32)d0 >= d1) {
+        return 0;
+    }
+
+    if (d2 > (d3 - d2)) {
+        d2 = d3 - d2;
+    }
+
+    return d2;
+}
+
+static bool within_limit(s32 v) {
+    return (v >= -HITBOX_EXACT_LIMIT) && (v <= HITBOX_EXACT_LIMIT);
+}
+
+void hitbox_build(HitBoxGroup* group, const WORK* wk, const s16* const* boxes, s16 count) {
+    const s32 x = wk->xyz[0].disp.pos;
+    const s32 y = wk->xyz[1].disp.pos;
+
+    group->min_l = INT32_MAX;
+    group->max_r = INT32_MIN;
+    group->min_b = INT32_MAX;
+    group->max_t = INT32_MIN;
+    group->any = false;
+    group->exact = true;
+
+    for (s16 i = 0; i < HITBOX_LANES; i++) {
+        const s16* box = (i < count) ? boxes[i] : NULL;
+        s32 w;
+        s32 h;
+
+        // Empty boxes never hit; the lane is masked off and left out of the bounds
+        if ((box == NULL) || (box[1] == 0)) {
+            group->l[i] = group->r[i] = group->b[i] = group->t[i] = 0;
+            group->valid[i] = 0;
+            continue;
+        }
+
+        w = box[1];
+        h = box[3];
+        group->l[i] = wk->rl_flag ? (x - box[0] - w) : (x + box[0]);
+        group->r[i] = group->l[i] + w;
+        group->b[i] = y + box[2];
+        group->t[i] = group->b[i] + h;
+        group->valid[i] = -1;
+        group->any = true;
+
+        // Negative sizes and far-off edges make hit_check_subroutine()'s 16-bit compares wrap
+        if ((w < 0) || (h < 0) || !within_limit(group->l[i]) || !within_limit(group->r[i]) ||
+            !within_limit(group->b[i]) || !within_limit(group->t[i])) {
+            group->exact = false;
+        }
+
+        group->min_l = SDL_min(group->min_l, group->l[i]);
+        group->max_r = SDL_max(group->max_r, group->r[i]);
+        group->min_b = SDL_min(group->min_b, group->b[i]);
+        group->max_t = SDL_max(group->max_t, group->t[i]);
+    }
+}
+
+bool hitbox_may_touch(const HitBoxGroup* att, const HitBoxGroup* dm) {
+    // The box loops skip empty boxes whatever their coordinates
+    if (!att->any || !dm->any) {
+        return false;
+    }
+
+    if (!att->exact || !dm->exact) {
+        return true;
+    }
+
+    // Same edge rules as the per-box test: x touching counts, y touching counts only at the attack box's top
+    return (att->min_l <= dm->max_r) && (dm->min_l < att->max_r) && (dm->min_b <= att->max_t) &&
+           (att->min_b < dm->max_t);
+}
+
+/** @brief Depths for damage lanes @p i..i+3: min(dm.r - att.l, att.r - dm.l) where they overlap, else 0. */
+static simde__m128i lane_depths(const HitBoxGroup* att, s16 ix, const HitBoxGroup* dm, int i) {
+    const simde__m128i al = simde_mm_set1_epi32(att->l[ix]);
+    const simde__m128i ar = simde_mm_set1_epi32(att->r[ix]);
+    const simde__m128i ab = simde_mm_set1_epi32(att->b[ix]);
+    const simde__m128i at = simde_mm_set1_epi32(att->t[ix]);
+    const simde__m128i dl = simde_mm_loadu_si128((const simde__m128i*)&dm->l[i]);
+    const simde__m128i dr = simde_mm_loadu_si128((const simde__m128i*)&dm->r[i]);
+    const simde__m128i db = simde_mm_loadu_si128((const simde__m128i*)&dm->b[i]);
+    const simde__m128i dt = simde_mm_loadu_si128((const simde__m128i*)&dm->t[i]);
+    const simde__m128i valid = simde_mm_loadu_si128((const simde__m128i*)&dm->valid[i]);
+
+    const simde__m128i miss = simde_mm_or_si128(simde_mm_cmpgt_epi32(al, dr), simde_mm_cmpgt_epi32(db, at));
+    const simde__m128i reach = simde_mm_and_si128(simde_mm_cmpgt_epi32(ar, dl), simde_mm_cmpgt_epi32(dt, ab));
+    const simde__m128i hit = simde_mm_andnot_si128(miss, simde_mm_and_si128(reach, valid));
+
+    const simde__m128i from_left = simde_mm_sub_epi32(dr, al);
+    const simde__m128i from_right = simde_mm_sub_epi32(ar, dl);
+    const simde__m128i right_less = simde_mm_cmpgt_epi32(from_left, from_right);
+    const simde__m128i depth = simde_mm_or_si128(simde_mm_and_si128(right_less, from_right),
+                                                 simde_mm_andnot_si128(right_less, from_left));
+
+    return simde_mm_and_si128(depth, hit);
+}
+
+void hitbox_depths(const HitBoxGroup* att, s16 ix, const HitBoxGroup* dm, s16* depth) {
+    // ⚡ Three 4-lane compares replace up to eleven hit_check_subroutine() calls; exact
+    // groups keep every edge and depth well inside s16, so the packs never saturate
+    const simde__m128i d0 = lane_depths(att, ix, dm, 0);
+    const simde__m128i d1 = lane_depths(att, ix, dm, 4);
+    const simde__m128i d2 = lane_depths(att, ix, dm, 8);
+
+    simde_mm_storeu_si128((simde__m128i*)&depth[0], simde_mm_packs_epi32(d0, d1));
+    simde_mm_storel_epi64((simde__m128i*)&depth[8], simde_mm_packs_epi32(d2, d2));
+}
@@ -0,0 +1,57 @@
+/**
+ * @file hitbox.h
+ * @brief World-space hitboxes for attack_hit_check(): pair culling and vectorised overlap depths.
+ *
+ * A box is four s16s, {x, width, y, height}, relative to its owner and
+ * mirrored when the owner's rl_flag is set. HitBoxGroup stores a set of
+ * them already flipped and placed in the world, with the union of their
+ * bounds, so attack_hit_check() can reject a pair with one compare before
+ * its per-box loops and test one attack box against all eleven damage
+ * boxes at once.
+ *
+ * Both shortcuts give exactly what hit_check_subroutine() would. Its 16-bit
+ * arithmetic wraps, which 32-bit compares don't reproduce, so they are only
+ * used for groups flagged exact (every box well inside the s16 range, with a
+ * positive width and a non-negative height); other groups go through
+ * hit_check_subroutine() as before.
+ */
+#ifndef HITBOX_H
+#define HITBOX_H
+
+#include "structs.h"
+#include "types.h"
+
+#include <stdbool.h>
+
+#define HITBOX_LANES 12         // Eleven damage boxes, padded to a multiple of four
+#define HITBOX_EXACT_LIMIT 8191 // Edges within +/- this can't wrap in hit_check_subroutine()
+
+typedef struct HitBoxGroup {
+    s32 l[HITBOX_LANES];     // Left edge
+    s32 r[HITBOX_LANES];     // Right edge (l + width)
+    s32 b[HITBOX_LANES];     // Bottom edge
+    s32 t[HITBOX_LANES];     // Top edge (b + height)
+    s32 valid[HITBOX_LANES]; // -1 for boxes with a width, 0 for the empty ones the box loops skip
+    s32 min_l;
+    s32 max_r;
+    s32 min_b;
+    s32 max_t;
+    bool any;   // At least one box has a width
+    bool exact; // The fast paths match hit_check_subroutine() for this group
+} HitBoxGroup;
+
+/** @brief Place @p count (at most HITBOX_LANES) of @p wk's boxes in the world. */
+void hitbox_build(HitBoxGroup* group, const WORK* wk, const s16* const* boxes, s16 count);
+
+/** @brief False only if no attack box in @p att can hit any damage box in @p dm. */
+bool hitbox_may_touch(const HitBoxGroup* att, const HitBoxGroup* dm);
+
+/**
+ * @brief hit_check_subroutine() for attack box @p ix of @p att against every box of @p dm.
+ *
+ * Writes one overlap depth per lane of @p depth (0 for a miss or an empty
+ * box). Both groups must be exact.
+ */
+void hitbox_depths(const HitBoxGroup* att, s16 ix, const HitBoxGroup* dm, s16* depth);
+
+#endif
@@ -13,6 +13,7 @@
 #include "sf33rd/Source/Game/engine/cmb_win.h"
 #include "sf33rd/Source/Game/engine/cmd_main.h"
 #include "sf33rd/Source/Game/engine/grade.h"
+#include "sf33rd/Source/Game/engine/hitbox.h"
 #include "sf33rd/Source/Game/engine/hitefef.h"
 #include "sf33rd/Source/Game/engine/hitefpl.h"
 #include "sf33rd/Source/Game/engine/hitplef.h"
@@ -44,6 +45,10 @@ s16 mkm_wk[32];
 s16 hpq_in;
 s8 ca_check_flag;
 
+// World-space boxes of each hit-queue entry, rebuilt by every attack_hit_check()
+static HitBoxGroup att_boxes[32];
+static HitBoxGroup dm_boxes[32];
+
 /** @brief Calculates red-blocking freeze-stop time for a given character. */
 void make_red_blocking_time(s16 id, s16 ix, s16 num) {
     switch (ix) {
@@ -1587,6 +1592,10 @@ void attack_hit_check() {
     s16* assign1;
     s16* assign2;
 
+    u32 att_built = 0;
+    bool exact;
+    s16 depth[HITBOX_LANES];
+
     for (si = 0; si < hpq_in; si++) {
         if (hs[si].flag.results & 0x1101) {
             continue;
@@ -1604,6 +1613,7 @@ void attack_hit_check() {
         dmdat_adrs[8] = &sad->h_att->att_box[2][0];
         dmdat_adrs[9] = &sad->h_att->att_box[3][0];
         dmdat_adrs[10] = &sad->h_hos->hos_box[0];
+        hitbox_build(&dm_boxes[si], sad, (const s16* const*)dmdat_adrs, 11);
 
         for (mi = 0; mi < hpq_in; mi++) {
             if (mi == si) {
@@ -1643,6 +1653,21 @@ void attack_hit_check() {
                 continue;
             }
 
+            // ⚡ Broadphase: each attacker's boxes are placed once per check, and pairs whose
+            // bounds don't meet skip the box loops (they can't change any result)
+            if (!(att_built & (1u << mi))) {
+                const s16* att[4] = { mad->h_att->att_box[0], mad->h_att->att_box[1], mad->h_att->att_box[2],
+                                      mad->h_att->att_box[3] };
+
+                hitbox_build(&att_boxes[mi], mad, att, 4);
+                att_built |= 1u << mi;
+            }
+
+            if (!hitbox_may_touch(&att_boxes[mi], &dm_boxes[si])) {
+                continue;
+            }
+
+            exact = att_boxes[mi].exact && dm_boxes[si].exact;
             mh = &mad->h_att->att_box[0][0];
 
             for (lp = 0; lp < 4; lp++, assign2 = mh += 4) {
@@ -1650,6 +1675,10 @@ void attack_hit_check() {
                     continue;
                 }
 
+                if (exact) {
+                    hitbox_depths(&att_boxes[mi], lp, &dm_boxes[si], depth);
+                }
+
                 for (lp2 = 0; lp2 < 11; lp2++) {
                     if (lp2 > 3 && mad->att_hit_ok == 0) {
                         goto end;
@@ -1685,7 +1714,7 @@ void attack_hit_check() {
                         }
                     }
 
-                    mw = hit_check_subroutine(mad, sad, mh, dmdat_adrs[lp2]);
+                    mw = exact ? depth[lp2] : hit_check_subroutine(mad, sad, mh, dmdat_adrs[lp2]);
 
                     if (mw > mkm_wk[si]) {
                         hs[mi].flag.results |= 0x10;
@@ -1708,53 +1737,6 @@ void attack_hit_check() {
     }
 }
 
-/** @brief Low-level hitbox overlap test (AABB intersection check). */
-s16 hit_check_subroutine(WORK* wk1, WORK* wk2, const s16* hd1, const s16* hd2) {
-    s16 d0;
-    s16 d1;
-    s16 d2;
-    s16 d3;
-
-    d0 = *hd1++;
-    d1 = *hd1++;
-
-    if (wk1->rl_flag) {
-        d0 = -d0;
-        d0 -= d1;
-    }
-
-    d0 += wk1->xyz[0].disp.pos;
-    d2 = *hd2++;
-    d3 = *hd2++;
-
-    if (wk2->rl_flag) {
-        d2 = -d2;
-        d2 -= d3;
-    }
-
-    d2 += wk2->xyz[0].disp.pos;
-    d2 += d3 - d0;
-    d3 += d1;
-
-    if ((u32)d2 >= d3) {
-        return 0;
-    }
-
-    d0 = (wk1->xyz[1].disp.pos + *hd1++) - (wk2->xyz[1].disp.pos + *hd2++);
-    d0 += d1 = *hd1;
-    d1 += *hd2;
-
-    if ((u32)d0 >= d1) {
-        return 0;
-    }
-
-    if (d2 > (d3 - d2)) {
-        d2 = d3 - d2;
-    }
-
-    return d2;
-}
-
 /** @brief Hitbox overlap test on X-axis only (for push/proximity checks). */
 s32 hit_check_x_only(WORK* wk1, WORK* wk2, s16* hd1, s16* hd2) {
     s16 d0;
@@ -1,13 +1,14 @@
 #include "sf33rd/Source/Game/io/file_loader.h"
 #include "common.h"
 #include "port/io/afs.h"
+#include "port/io/load_trace.h"
 #include "sf33rd/AcrSDK/ps2/foundaps2.h"
 #include "sf33rd/Source/Game/debug/Debug.h"
 #include "sf33rd/Source/Game/io/fs_sys.h"
 #include "sf33rd/Source/Game/system/ramcnt.h"
 #include "sf33rd/Source/Game/system/work_sys.h"
 
-s32 load_it_use_any_key2(u16 fnum, void** adrs, s16* key, u8 kokey, u8 group) {
+static s32 load_any_key(u16 fnum, void** adrs, s16* key, u8 kokey, u8 group, bool borrow) {
     u32 size;
     u32 err;
 
@@ -16,7 +17,22 @@ s32 load_it_use_any_key2(u16 fnum, void** adrs, s16* key, u8 kokey, u8 group) {
         return 0;
     }
 
+    LoadTrace_SetAsset(AFS_GetName(fnum));
     size = fsGetFileSize(fnum);
+
+    // ⚡ Entries already resident (AFS mapping or preload) are used in place: no heap block, no copy.
+    // Only callers that never write to the buffer may borrow it.
+    const void* resident = borrow ? AFS_GetEntryPointer(fnum) : NULL;
+
+    if (resident != NULL) {
+        *key = Pull_ramcnt_key_borrowed(resident, size, kokey, group);
+
+        if (*key > 0) {
+            *adrs = (void*)resident;
+            return size;
+        }
+    }
+
     *key = Pull_ramcnt_key(fsCalSectorSize(size) << 11, kokey, group, 0);
     *adrs = (void*)Get_ramcnt_address(*key);
 
@@ -30,12 +46,18 @@ s32 load_it_use_any_key2(u16 fnum, void** adrs, s16* key, u8 kokey, u8 group) {
     return 0;
 }
 
+/** @brief Load a file for read-only use; resident AFS entries are borrowed instead of copied (PPG setup only). */
+s32 load_it_use_any_key2(u16 fnum, void** adrs, s16* key, u8 kokey, u8 group) {
+    return load_any_key(fnum, adrs, key, kokey, group, true);
+}
+
 s16 load_it_use_any_key(u16 fnum, u8 kokey, u8 group) {
     u32 err;
     void* adrs;
     s16 key;
 
-    err = load_it_use_any_key2(fnum, &adrs, &key, kokey, group);
+    // Palettes and texture groups may be patched in place, so these always get a private copy
+    err = load_any_key(fnum, &adrs, &key, kokey, group, false);
 
     if (err != 0) {
         return key;
@@ -4,26 +4,38 @@
 #include "sf33rd/AcrSDK/MiddleWare/PS2/CapSndEng/emlTSB.h"
 #include "sf33rd/Source/Game/debug/Debug.h"
 
-static AFSHandle afs_handle = AFS_NONE;
+#define FS_OPEN_MAX 32
+
+// Each request reads through its own AFS handle, so several reads can be in flight at once
+static AFSHandle open_handles[FS_OPEN_MAX];
+static s32 open_count = 0;
 
 s32 fsOpen(REQ* req) {
-    if (req->fnum >= AFS_GetFileCount()) {
+    if ((req->fnum >= AFS_GetFileCount()) || (open_count >= FS_OPEN_MAX)) {
         return 0;
     }
 
-    if (afs_handle != AFS_NONE) {
-        AFS_Close(afs_handle);
-    }
+    req->handle = AFS_Open(req->fnum);
 
-    afs_handle = AFS_Open(req->fnum);
+    if (req->handle == AFS_NONE) {
+        return 0;
+    }
 
+    open_handles[open_count++] = req->handle;
     req->info.number = 1;
     return 1;
 }
 
-void fsClose(REQ* /* unused */) {
-    AFS_Close(afs_handle);
-    afs_handle = AFS_NONE;
+void fsClose(REQ* req) {
+    for (s32 i = 0; i < open_count; i++) {
+        if (open_handles[i] == req->handle) {
+            open_handles[i] = open_handles[--open_count];
+            AFS_Close(req->handle);
+            break;
+        }
+    }
+
+    req->handle = AFS_NONE;
 }
 
 u32 fsGetFileSize(u16 fnum) {
@@ -38,42 +50,48 @@ u32 fsCalSectorSize(u32 size) {
     return (size + 2048 - 1) / 2048;
 }
 
-s32 fsCansel(REQ* /* unused */) {
-    if ((afs_handle != AFS_NONE) && (AFS_GetState(afs_handle) == AFS_READ_STATE_READING)) {
-        AFS_Stop(afs_handle);
+s32 fsCansel(REQ* req) {
+    if (req->handle == AFS_NONE) {
+        return 1;
+    }
+
+    if (AFS_GetState(req->handle) == AFS_READ_STATE_READING) {
+        AFS_Stop(req->handle);
     }
 
+    fsClose(req);
     return 1;
 }
 
+/** @brief Non-zero while any open request's read is still running (or failed and not yet closed). */
 s32 fsCheckCommandExecuting() {
-    if (afs_handle == AFS_NONE) {
-        return 0;
-    }
+    for (s32 i = 0; i < open_count; i++) {
+        const AFSReadState state = AFS_GetState(open_handles[i]);
 
-    const AFSReadState state = AFS_GetState(afs_handle);
+        switch (state) {
+        case AFS_READ_STATE_READING:
+        case AFS_READ_STATE_ERROR:
+            return 1;
 
-    switch (state) {
-    case AFS_READ_STATE_READING:
-    case AFS_READ_STATE_ERROR:
-        return 1;
+        case AFS_READ_STATE_IDLE:
+        case AFS_READ_STATE_FINISHED:
+            break;
 
-    case AFS_READ_STATE_IDLE:
-    case AFS_READ_STATE_FINISHED:
-        return 0;
-
-    default:
-        fatal_error("Unhandled AFS state: %d", state);
+        default:
+            fatal_error("Unhandled AFS state: %d", state);
+        }
     }
+
+    return 0;
 }
 
-s32 fsRequestFileRead(REQ* /* unused */, u32 sec, void* buff) {
-    AFS_Read(afs_handle, sec, buff);
+s32 fsRequestFileRead(REQ* req, u32 sec, void* buff) {
+    AFS_Read(req->handle, sec, buff);
     return 1;
 }
 
-s32 fsCheckFileReaded(REQ* /* unused */) {
-    const AFSReadState state = AFS_GetState(afs_handle);
+s32 fsCheckFileReaded(REQ* req) {
+    const AFSReadState state = AFS_GetState(req->handle);
 
     switch (state) {
     case AFS_READ_STATE_ERROR:
@@ -92,7 +110,7 @@ s32 fsCheckFileReaded(REQ* /* unused */) {
 }
 
 s32 fsFileReadSync(REQ* req, u32 sec, void* buff) {
-    AFS_ReadSync(afs_handle, sec, buff);
+    AFS_ReadSync(req->handle, sec, buff);
     const s32 rnum = fsCheckFileReaded(req);
     return (rnum == 1) ? 1 : 0;
 }
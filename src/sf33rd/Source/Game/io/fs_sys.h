@@ -8,7 +8,7 @@
 s32 fsOpen(REQ* req);
 
 /** @brief Close an open file */
-void fsClose(REQ* /* unused */);
+void fsClose(REQ* req);
 
 /** @brief Get the size of a file in bytes */
 u32 fsGetFileSize(u16 fnum);
@@ -16,10 +16,10 @@ u32 fsGetFileSize(u16 fnum);
 /** @brief Calculate sector size for file */
 u32 fsCalSectorSize(u32 size);
 
-/** @brief Cancel an asynchronous read */
+/** @brief Cancel an asynchronous read and close its file */
 s32 fsCansel(REQ* req);
 
-/** @brief Check if a command is currently executing */
+/** @brief Check if any open file still has a read executing */
 s32 fsCheckCommandExecuting();
 
 /** @brief Issue an asynchronous read request */
@@ -6,11 +6,19 @@
  * manages a queue of load requests for textures, palettes, and sounds,
  * and provides the load-request dispatch table.
  *
+ * The queue is a ring buffer. The head request runs exactly as it always
+ * has; up to ldreq_slots - 1 requests behind it may start their reads
+ * early, but only when that can't change what the serial queue would do
+ * (see ldreq_can_start_early). Requests still finish strictly in queue
+ * order, so results, ramcnt keys and memory contents match a serial run.
+ *
  * Part of the io module.
  */
 
 #include "sf33rd/Source/Game/io/gd3rd.h"
 #include "common.h"
+#include "port/io/afs.h"
+#include "port/io/load_trace.h"
 #include "sf33rd/AcrSDK/MiddleWare/PS2/CapSndEng/emlTSB.h"
 #include "sf33rd/AcrSDK/ps2/flps2debug.h"
 #include "sf33rd/AcrSDK/ps2/foundaps2.h"
@@ -34,8 +42,10 @@ typedef void (*LDREQ_Process_Func)(REQ*);
 #define LDREQ_PROCESS_COUNT 6
 #define LDREQ_QUEUE_SIZE 16
 #define LDREQ_TBL_SIZE 294
-#define LDREQ_IX_SIZE 43
+#define LDREQ_IX_SIZE (LDREQ_PLAYER_SETS + LDREQ_BG_SETS)
 #define LDREQ_RETRY_COUNT 0x40
+#define LDREQ_SLOTS_MAX 8
+#define LDREQ_SLOTS_DEFAULT 4
 #define PLAYER_COUNT 2
 #define CHAR_TWELVE 0x12
 #define METAMOR_BASE_INDEX 0xD4
@@ -50,6 +60,11 @@ u8 ldreq_break;
 REQ q_ldreq[LDREQ_QUEUE_SIZE];
 u8 ldreq_result[LDREQ_TBL_SIZE];
 
+static s16 ldreq_head = 0;  // Ring index of the oldest request
+static s16 ldreq_count = 0; // Requests in the ring
+static s16 ldreq_slots = LDREQ_SLOTS_DEFAULT;
+static u64 ldreq_pushed_ns[LDREQ_QUEUE_SIZE]; // Load trace: when each ring entry was pushed
+
 // forward decls
 static s32 Push_LDREQ_Queue(REQ* ldreq);
 static void Push_LDREQ_Queue_Metamor();
@@ -98,9 +113,27 @@ void Init_Load_Request_Queue_1st() {
         q_ldreq[i].type = 0;
     }
 
+    ldreq_head = 0;
+    ldreq_count = 0;
     ldreq_break = 0;
 }
 
+/** @brief How many queued requests may have reads in flight at once (1 = strictly one after another). */
+void Set_LDREQ_Slots(s32 slots) {
+    if (slots < 1) {
+        slots = 1;
+    } else if (slots > LDREQ_SLOTS_MAX) {
+        slots = LDREQ_SLOTS_MAX;
+    }
+
+    ldreq_slots = slots;
+}
+
+/** @brief The request @p pos places behind the head of the ring. */
+static REQ* ldreq_at(s16 pos) {
+    return &q_ldreq[(ldreq_head + pos) % LDREQ_QUEUE_SIZE];
+}
+
 /** @brief Signal the load-request queue to break (cancel pending loads). */
 void Request_LDREQ_Break() {
     ldreq_break = 1;
@@ -157,7 +190,7 @@ void Push_LDREQ_Queue_Player(s16 id, s16 ix) {
 
 /** @brief Enqueue load requests for a background stage's assets. */
 void Push_LDREQ_Queue_BG(s16 ix) {
-    Push_LDREQ_Queue_Union(ix + 20);
+    Push_LDREQ_Queue_Union(ix + LDREQ_PLAYER_SETS);
     Push_LDREQ_Queue_Metamor();
 }
 
@@ -225,22 +258,36 @@ void Push_LDREQ_Queue_Direct(s16 ix, s16 id) {
     Push_LDREQ_Queue(&ldreq);
 }
 
+/** @brief AFS file number a load request will read, or -1. */
+static s32 ldreq_file_number(const REQ* ldreq) {
+    switch (ldreq->type) {
+    case 1:
+        return (ldreq->ix < 100) ? texgrpdat[ldreq->ix].apfn : -1;
+
+    case 2:
+    case 3:
+    case 4:
+    case 5:
+        return color_file_number(ldreq->ix);
+
+    default:
+        return -1;
+    }
+}
+
 /** @brief Push a single load request onto the queue. */
 static s32 Push_LDREQ_Queue(REQ* ldreq) {
-    s16 i;
+    REQ* req;
     u8 masknum;
 
-    for (i = 0; i < LDREQ_QUEUE_SIZE; i++) {
-        if (q_ldreq[i].be == 0) {
-            break;
-        }
-    }
-
-    if (i != LDREQ_QUEUE_SIZE) {
-        q_ldreq[i] = ldreq[0];
-        q_ldreq[i].be = 2;
-        q_ldreq[i].rno = 0;
-        q_ldreq[i].retry = LDREQ_RETRY_COUNT;
+    if (ldreq_count < LDREQ_QUEUE_SIZE) {
+        req = ldreq_at(ldreq_count);
+        ldreq_count += 1;
+        *req = ldreq[0];
+        req->be = 2;
+        req->rno = 0;
+        req->retry = LDREQ_RETRY_COUNT;
+        req->handle = AFS_NONE;
 
         switch (ldreq->id) {
         case 0:
@@ -256,7 +303,11 @@ static s32 Push_LDREQ_Queue(REQ* ldreq) {
             break;
         }
 
-        *q_ldreq[i].result &= ~masknum;
+        *req->result &= ~masknum;
+        ldreq_pushed_ns[req - q_ldreq] = LoadTrace_Now();
+
+        // ⚡ Only a few requests read at once; let the AFS preloader fetch this file meanwhile
+        AFS_Hint(ldreq_file_number(ldreq));
         return 1;
     }
 
@@ -264,38 +315,176 @@ static s32 Push_LDREQ_Queue(REQ* ldreq) {
     return 0;
 }
 
-/** @brief Process pending load requests in FIFO order. */
+/** @brief Load trace tag for a request: its AFS entry's name, or the process name if it reads no file. */
+static const char* ldreq_asset_name(const REQ* ldreq) {
+    const char* name = AFS_GetName(ldreq_file_number(ldreq));
+
+    if ((name != NULL) && (name[0] != '\0')) {
+        return name;
+    }
+
+    return (ldreq->type < LDREQ_PROCESS_COUNT) ? (const char*)ldreq_process_name[ldreq->type] : NULL;
+}
+
+/** @brief Run one step of a request's load state machine. */
+static void ldreq_run(REQ* curr) {
+    LoadTrace_SetAsset(ldreq_asset_name(curr));
+
+    if (curr->type < LDREQ_PROCESS_COUNT) {
+        ldreq_process[curr->type](curr);
+    } else {
+        q_ldreq_error(curr);
+    }
+}
+
+/**
+ * @brief Whether the request @p pos places behind the head may start reading now.
+ *
+ * Starting early only moves the open, ramcnt pull and read issue forward;
+ * everything after the read completes still waits for the request to reach
+ * the head. That is only invisible to the game when:
+ *  - the request is a plain file read: a texture group that isn't resident
+ *    yet, or a palette/effect file (sound banks wait on the SPU);
+ *  - everything ahead of it has already pulled its key, so keys and ramcnt
+ *    blocks are handed out in queue order;
+ *  - nothing ahead of it that is still reading is a color request, whose
+ *    completion gives ramcnt keys back and would change later pulls;
+ *  - nothing ahead of it is loading the same texture group.
+ */
+static s32 ldreq_can_start_early(s16 pos) {
+    const REQ* curr = ldreq_at(pos);
+    const REQ* prev;
+    s32 slot = -1;
+    s16 i;
+
+    switch (curr->type) {
+    case 1:
+        slot = q_ldreq_texture_group_slot(curr->ix);
+
+        if (slot < 0) {
+            return 0;
+        }
+
+        break;
+
+    case 2:
+    case 3:
+    case 4:
+    case 5:
+        if ((color_file_number(curr->ix) < 0) || color_file_is_sound(curr->ix)) {
+            return 0;
+        }
+
+        break;
+
+    default:
+        return 0;
+    }
+
+    for (i = 0; i < pos; i++) {
+        prev = ldreq_at(i);
+
+        if (prev->be == 2) {
+            return 0;
+        }
+
+        if (prev->be != 1) {
+            continue;
+        }
+
+        if (prev->type != 1) {
+            return 0;
+        }
+
+        if ((curr->type == 1) && (prev->group == slot)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/** @brief Issue reads for requests behind the head while slots are free. */
+static void ldreq_start_early() {
+    const s16 end = (ldreq_count < ldreq_slots) ? ldreq_count : ldreq_slots;
+    REQ* curr;
+    s16 pos;
+
+    for (pos = 1; pos < end; pos++) {
+        curr = ldreq_at(pos);
+
+        if (curr->be != 2 || curr->rno != 0) {
+            continue;
+        }
+
+        if (!ldreq_can_start_early(pos)) {
+            break;
+        }
+
+        ldreq_run(curr);
+
+        if (curr->be == 2) {
+            // Couldn't open or read yet; try again next frame
+            break;
+        }
+    }
+}
+
+/** @brief Drop the finished head request. */
+static void ldreq_retire() {
+    REQ* head = ldreq_at(0);
+
+    LoadTrace_Span(LOAD_TRACE_REQUEST, ldreq_asset_name(head), ldreq_pushed_ns[head - q_ldreq], LoadTrace_Now());
+    head->be = 0;
+    head->type = 0;
+    ldreq_head = (ldreq_head + 1) % LDREQ_QUEUE_SIZE;
+    ldreq_count -= 1;
+}
+
+/**
+ * @brief Process pending load requests in FIFO order.
+ *
+ * The head request is serviced exactly as before. Requests behind it that
+ * started early only finish once they reach the head, so completions (and
+ * the result bits the game polls) keep queue order.
+ */
 void Check_LDREQ_Queue() {
+    REQ* head;
     s16 i;
 
     disp_ldreq_status();
 
-    if (!ldreq_break) {
-        if (q_ldreq->be != 0) {
-            if (q_ldreq->type < LDREQ_PROCESS_COUNT) {
-                ldreq_process[q_ldreq->type](q_ldreq);
-            } else {
-                q_ldreq_error(q_ldreq);
+    if (ldreq_break) {
+        for (i = 0; i < ldreq_count; i++) {
+            if (ldreq_at(i)->be == 1) {
+                fsCansel(ldreq_at(i));
             }
+        }
 
-            if (q_ldreq->be == 0) {
-                for (i = 0; i < LDREQ_QUEUE_SIZE - 1; i++) {
-                    q_ldreq[i] = q_ldreq[i + 1];
-                }
+        Init_Load_Request_Queue_1st();
+        return;
+    }
 
-                q_ldreq[i].be = 0;
-                q_ldreq[i].type = 0;
-            }
+    while (ldreq_count > 0) {
+        head = ldreq_at(0);
 
-            return;
-        }
-    } else {
-        if (q_ldreq->be == 1) {
-            fsCansel(q_ldreq);
+        if (head->be != 0) {
+            ldreq_run(head);
+
+            if (head->be != 0) {
+                break;
+            }
         }
 
-        Init_Load_Request_Queue_1st();
+        ldreq_retire();
+
+        // ⚡ A request that already started reading may have finished too; don't make it wait a frame
+        if ((ldreq_slots == 1) || (ldreq_count == 0) || (ldreq_at(0)->be == 2)) {
+            break;
+        }
     }
+
+    ldreq_start_early();
 }
 
 /** @brief Display the current load-request queue status (debug). */
@@ -306,9 +495,9 @@ static void disp_ldreq_status() {
 
     if (Debug_w[DEBUG_LDREQ_QUEUE]) {
         for (i = 0; i < LDREQ_QUEUE_SIZE; i++) {
-            flPrintL(2, i + 18, "%1d", q_ldreq[i].be);
-            if (q_ldreq[i].type < LDREQ_PROCESS_COUNT) {
-                flPrintL(3, i + 18, ldreq_process_name[q_ldreq[i].type]);
+            flPrintL(2, i + 18, "%1d", ldreq_at(i)->be);
+            if (ldreq_at(i)->type < LDREQ_PROCESS_COUNT) {
+                flPrintL(3, i + 18, ldreq_process_name[ldreq_at(i)->type]);
             }
         }
 
@@ -318,7 +507,7 @@ static void disp_ldreq_status() {
 
 /** @brief Check whether the load-request queue is empty. */
 s32 Check_LDREQ_Clear() {
-    return q_ldreq->be == 0 && q_ldreq[1].be == 0;
+    return ldreq_count == 0;
 }
 
 /** @brief Check whether a player's load requests have completed. */
@@ -13,11 +13,15 @@
 #include "structs.h"
 #include "types.h"
 
+#define LDREQ_PLAYER_SETS 20 // Load sets Push_LDREQ_Queue_Player() accepts, one per character
+#define LDREQ_BG_SETS 23     // Load sets Push_LDREQ_Queue_BG() accepts, one per stage
+
 extern s16 plt_req[2];
 extern const u8 lpr_wrdata[3];
 extern const u8 lpt_seldat[4];
 
 void Init_Load_Request_Queue_1st();
+void Set_LDREQ_Slots(s32 slots);
 void Request_LDREQ_Break();
 u8 Check_LDREQ_Break();
 void Push_LDREQ_Queue_Player(s16 id, s16 ix);
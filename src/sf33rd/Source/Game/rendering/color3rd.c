@@ -5,6 +5,7 @@
 
 #include "sf33rd/Source/Game/rendering/color3rd.h"
 #include "common.h"
+#include "port/io/load_trace.h"
 #include "port/sound/spu.h"
 #include "sf33rd/AcrSDK/MiddleWare/PS2/CapSndEng/cse.h"
 #include "sf33rd/AcrSDK/MiddleWare/PS2/CapSndEng/emlMemMap.h"
@@ -79,9 +80,7 @@ void q_ldreq_color_data(REQ* curr) {
 
     switch (curr->rno) {
     case 0:
-        if (fsCheckCommandExecuting() != 0) {
-            break;
-        }
+        // Requests read through their own handles, so there is no drive to wait for
         if (cfn->type == 10) {
             if (sndCheckVTransStatus(0) == 0) {
                 break;
@@ -147,7 +146,9 @@ void q_ldreq_color_data(REQ* curr) {
                 }
                 curr->rno = 5;
             } else {
+                LOAD_TRACE_BEGIN(CONVERT);
                 init_trans_color_ram(curr->id, curr->key, cfn->type, cfn->data);
+                LOAD_TRACE_END(CONVERT);
                 fsClose(curr);
                 *curr->result |= lpr_wrdata[curr->id];
                 curr->be = 0;
@@ -177,6 +178,20 @@ void q_ldreq_color_data(REQ* curr) {
     }
 }
 
+/** @brief AFS file number behind color file @p ix, or -1 if it has none. */
+s32 color_file_number(u16 ix) {
+    if (ix >= 161 || color_file[ix].apfn == 0xFFFF) {
+        return -1;
+    }
+
+    return color_file[ix].apfn;
+}
+
+/** @brief Whether color file @p ix is a sound bank (uploaded to the SPU rather than to color RAM). */
+s32 color_file_is_sound(u16 ix) {
+    return (ix < 161) && (color_file[ix].type == 10);
+}
+
 /** @brief Load a color palette by index into the specified key slot. */
 void load_any_color(u16 ix, u8 kokey) {
     col_file_data* cfn;
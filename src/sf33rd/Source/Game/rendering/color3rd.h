@@ -13,6 +13,8 @@ extern u16 ColorRAM[512][64];
 extern Col3rd_W col3rd_w;
 
 void q_ldreq_color_data(REQ* curr);
+s32 color_file_number(u16 ix);
+s32 color_file_is_sound(u16 ix);
 void load_any_color(u16 ix, u8 kokey);
 void set_hitmark_color();
 void init_trans_color_ram(s16 id, s16 key, u8 type, u16 data);
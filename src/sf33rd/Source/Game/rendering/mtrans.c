@@ -5,6 +5,8 @@
 
 #include "sf33rd/Source/Game/rendering/mtrans.h"
 #include "common.h"
+#include "port/io/load_trace.h"
+#include "port/io/tile_cache.h"
 #include "port/rendering/legacy_matrix.h"
 #include "port/rendering/renderer.h"
 #include "port/sdl/renderer/sdl_game_renderer.h"
@@ -19,6 +21,7 @@
 #include "sf33rd/Source/Game/rendering/color3rd.h"
 #include "sf33rd/Source/Game/rendering/texcash.h"
 #include "sf33rd/Source/Game/rendering/texgroup.h"
+#include "sf33rd/Source/Game/rendering/tile_decode.h"
 #include "sf33rd/Source/Game/system/work_sys.h"
 #include "structs.h"
 
@@ -288,7 +291,6 @@ static s32 get_mltbuf16_ext_2(MultiTexture* mt, u32 code, u32 palt, s32* ret, Pa
 static s32 get_mltbuf32(MultiTexture* mt, u32 code, u32 palt, s32* ret);
 
 static s32 get_mltbuf32_ext_2(MultiTexture* mt, u32 code, u32 palt, s32* ret, PatternInstance* cp);
-static void lz_ext_p6_fx(u8* srcptr, u8* dstptr, u32 len);
 static void lz_ext_p6_cx(u8* srcptr, u16* dstptr, u32 len, u16* palptr);
 static u16 x16_mapping_set(PatternMap* map, s32 code);
 static u16 x32_mapping_set(PatternMap* map, s32 code);
@@ -298,6 +300,10 @@ static u16 x32_mapping_set(PatternMap* map, s32 code);
  *
  * Tries to enqueue the tile for GPU compute decompression. If that fails
  * (staging full, GPU unavailable, etc.), falls back to CPU decode + upload.
+ * The CPU copy of the tile is handed to the tile decode pool and written by
+ * tileDecodeDrain() before the dirty textures are uploaded; it is only
+ * decoded inline when the pool cannot take it. Both paths serve tiles from
+ * the persistent tile cache when it holds them.
  *
  * @param src        Compressed data pointer
  * @param comp_bound Upper bound on compressed size
@@ -321,22 +327,140 @@ static void lz77_gpu_or_cpu(u8* src, u32 comp_bound, u32 size, MultiTexture* mt,
     s32 tex_handle = ppgGetUsingTextureHandle(NULL, gix_base + code_offset);
     s32 pal_handle = ppgGetUsingPaletteHandle(NULL, pal_bits & 0x1FF);
 
-    if (tex_handle > 0 &&
-        Renderer_LZ77Enqueue(src, comp_bound, size, tex_handle, pal_handle, (u32)code_local, tile_dim)) {
-        // GPU path succeeded — but also decompress to CPU buffer so that
-        // ppgRenewTexChunkSeqs → UnlockTexture → SetTexture re-uploads
-        // will contain correct tile data (not stale/empty buffer content).
-        lz_ext_p6_fx(src, mt->mltbuf, size);
-        Renderer_UpdateTexture(gix_base + code_offset, mt->mltbuf, code_local, size, 0, 0);
+    // GPU path may take the tile, but the CPU buffer is still filled so that
+    // ppgRenewTexChunkSeqs → UnlockTexture → SetTexture re-uploads will
+    // contain correct tile data (not stale/empty buffer content).
+    if (tex_handle > 0) {
+        Renderer_LZ77Enqueue(src, comp_bound, size, tex_handle, pal_handle, (u32)code_local, tile_dim);
+    }
 
+    if (tileDecodeSubmit(mt->texList.tex, gix_base + code_offset, (u32)code_local, src, size)) {
+        return;
+    }
+
+    // Inline fallback
+    const void* cached = TileCache_Lookup(src, size);
+
+    if (cached != NULL) {
+        Renderer_UpdateTexture(gix_base + code_offset, cached, code_local, size, 0, 0);
         return;
     }
 
-    // CPU fallback
     lz_ext_p6_fx(src, mt->mltbuf, size);
+    TileCache_Store(src, size, mt->mltbuf);
     Renderer_UpdateTexture(gix_base + code_offset, mt->mltbuf, code_local, size, 0, 0);
 }
 
+// ⚡ Lookahead tile decode: queue the tiles of the next few animation cells on the
+// decode pool so first-appearance frames of supers/throws find them pre-decoded.
+#define TILE_PREFETCH_CELLS 3
+#define TILE_PREFETCH_MEMO 32
+
+typedef struct {
+    const WORK* wk;
+    const u32* set_char_ad;
+    s16 cg_ix;
+} TilePrefetchMemo;
+
+static TilePrefetchMemo s_prefetch_memo[TILE_PREFETCH_MEMO];
+
+/** @brief Check whether a tile code is resident in a 16/32 tile cache (palette 0). */
+static s32 mlt_tile_resident(const MltHashEntry* ht, const PatternState* csh, u32 code) {
+    u32 h = mlt_hash(code);
+
+    for (s32 probe = 0; probe < MLT_HASH_SIZE; probe++) {
+        u32 idx = (h + probe) & MLT_HASH_MASK;
+
+        if (ht[idx].slot == MLT_HASH_EMPTY) {
+            return 0;
+        }
+
+        if (ht[idx].code == code && csh[ht[idx].slot].state == 0) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Queue speculative decodes for the cells @p wk's animation script shows next.
+ *
+ * Walks forward from the current cell until a script command (jumps, loops and
+ * branches are not predicted) and submits every tile that is not already in
+ * the tile cache. Runs once per cell change.
+ */
+static void mlt_obj_prefetch(MultiTexture* mt, WORK* wk) {
+    const u8* srcs[TILE_PREFETCH_CELLS * CG_CACHE_MAX_TILES];
+    u32 sizes[TILE_PREFETCH_CELLS * CG_CACHE_MAX_TILES];
+    TilePrefetchMemo* memo;
+    PatternCode cc;
+    s32 num = 0;
+    s32 ix;
+
+    if ((wk->set_char_ad == NULL) || ((wk->cgd_type != 4) && (wk->cgd_type != 6))) {
+        return;
+    }
+
+    memo = &s_prefetch_memo[((uintptr_t)wk >> 4) % TILE_PREFETCH_MEMO];
+
+    if ((memo->wk == wk) && (memo->set_char_ad == wk->set_char_ad) && (memo->cg_ix == wk->cg_ix)) {
+        return;
+    }
+
+    memo->wk = wk;
+    memo->set_char_ad = wk->set_char_ad;
+    memo->cg_ix = wk->cg_ix;
+    ix = wk->cg_ix;
+
+    for (s32 cell = 0; cell < TILE_PREFETCH_CELLS; cell++) {
+        ix += wk->cgd_type;
+
+        const u16* entry = (const u16*)(wk->set_char_ad + ix);
+        const u32 cg_number = entry[3];
+
+        // UNK11.code < 0x100 is a script command, not a cell
+        if ((entry[0] < 0x100) || (cg_number == 0)) {
+            break;
+        }
+
+        const s32 grp = obj_group_table[cg_number];
+
+        if ((grp == 0) || (texgrplds[grp].ok == 0)) {
+            break;
+        }
+
+        const CGTileCacheEntry* cge = cg_lookup_tile_descs(cg_number);
+
+        if (cge == NULL) {
+            break;
+        }
+
+        cc.parts.group = cge->group;
+
+        for (s32 t = 0; t < cge->count; t++) {
+            const CGTileDesc* d = &cge->tiles[t];
+            s32 resident;
+
+            cc.parts.offset = d->tile_code;
+
+            if (d->wh == 4) {
+                resident = mlt_tile_resident(s_hash32[mt->id], mt->mltcsh32, cc.code);
+            } else {
+                resident = mlt_tile_resident(s_hash16[mt->id], mt->mltcsh16, cc.code);
+            }
+
+            if (!resident) {
+                srcs[num] = d->tex_data;
+                sizes[num] = d->size;
+                num++;
+            }
+        }
+    }
+
+    tileDecodePrefetch(srcs, sizes, num);
+}
+
 /** @brief Replace tile map entries matching a source code/attribute with new values. */
 static void search_trsptr(uintptr_t trstbl, s32 i, s32 n, s32 cods, s32 atrs, s32 codd, s32 atrd) {
     s32 j;
@@ -866,6 +990,7 @@ void mlt_obj_trans(MultiTexture* mt, WORK* wk, s32 base_y) {
     PatternCode cc;
 
     ppgSetupCurrentDataList(&mt->texList);
+    mlt_obj_prefetch(mt, wk);
 
     if (mt->ext) {
         mlt_obj_trans_ext(mt, wk, base_y);
@@ -1222,6 +1347,7 @@ void mlt_obj_trans_cp3(MultiTexture* mt, WORK* wk, s32 base_y) {
     PatternCode cc;
 
     ppgSetupCurrentDataList(&mt->texList);
+    mlt_obj_prefetch(mt, wk);
 
     if (mt->ext) {
         mlt_obj_trans_cp3_ext(mt, wk, base_y);
@@ -1734,6 +1860,7 @@ void seqsInitialize(void* adrs) {
     seqs_w.chip = seqs_w.chip_buf0;
     seqs_w.buf_index = 0;
     seqs_w.sprMax = 0;
+    tileDecodeInit();
 }
 
 /** @brief Get the maximum number of sprites allowed. */
@@ -1761,6 +1888,12 @@ void seqsBeforeProcess() {
     TRACE_PLOT_INT("TileCacheHits", s_tile_cache_hits);
     TRACE_PLOT_INT("TileCacheMisses", s_tile_cache_misses);
     TRACE_PLOT_INT("CGCacheHits", s_cg_cache_hits);
+    TileDecodeStats tdec_stats;
+    tileDecodeGetStats(&tdec_stats);
+    TRACE_PLOT_INT("TileDecodePrefetchHits", tdec_stats.prefetch_hits);
+    TRACE_PLOT_INT("TileDecodeAsync", tdec_stats.async);
+    TRACE_PLOT_INT("TileDecodeSync", tdec_stats.sync);
+    TRACE_PLOT_INT("TileDecodePrefetched", tdec_stats.prefetched);
     s_lz77_decode_count = 0;
     s_tile_cache_hits = 0;
     s_tile_cache_misses = 0;
@@ -1784,6 +1917,9 @@ void seqsBeforeProcess() {
 void seqsAfterProcess() {
     s32 i;
 
+    // Phase 0: Write tiles decoded by the worker pool into their textures
+    tileDecodeDrain();
+
     if ((Debug_w[DEBUG_NO_DISP_TYPE_SB] != 3) && (seqs_w.sprTotal != 0)) {
         // Phase 1: Upload dirty texture data
 
@@ -2248,57 +2384,6 @@ static s32 get_free_patcash_index(PatternCollection* padr) {
     return 0x3F;
 }
 
-/** @brief Decompress LZ-compressed 4bpp fixed-palette texture data. */
-static void lz_ext_p6_fx(u8* srcptr, u8* dstptr, u32 len) {
-    u8* endptr = dstptr + len;
-    u8* tmpptr;
-    u32 tmp;
-    u32 flg;
-
-    while (dstptr < endptr) {
-        tmp = *srcptr++;
-
-        switch (tmp & 0xC0) {
-        case 0x0:
-            *dstptr++ = tmp;
-            break;
-
-        case 0x40:
-            tmp &= 0x3F;
-            tmpptr = (dstptr - (tmp >> 2)) - 1;
-            tmp = (tmp & 3) + 2;
-
-            while (tmp--) {
-                *dstptr++ = *tmpptr++;
-            }
-
-            break;
-
-        case 0x80:
-            tmp = ((tmp & 0x3F) << 8) | *srcptr++;
-            tmpptr = (dstptr - (tmp >> 6)) - 1;
-            tmp = (tmp & 0x3F) + 2;
-
-            while (tmp--) {
-                *dstptr++ = *tmpptr++;
-            }
-
-            break;
-
-        case 0xC0:
-            flg = tmp & 0x30;
-            tmp = (tmp & 0xF) + 2;
-
-            while (tmp--) {
-                *dstptr++ = flg | (*srcptr >> 4);
-                *dstptr++ = flg | (*srcptr++ & 0xF);
-            }
-
-            break;
-        }
-    }
-}
-
 /** @brief Decompress LZ-compressed paletted texture data with color lookup. */
 static void lz_ext_p6_cx(u8* srcptr, u16* dstptr, u32 len, u16* palptr) {
     u16* endptr = dstptr + len;
@@ -2371,6 +2456,9 @@ void mlt_obj_trans_init(MultiTexture* mt, s32 mode, u8* adrs) {
     PPGFileHeader ppg;
     s32 i;
 
+    // Pending pool jobs target the texture being re-initialised here
+    tileDecodeInvalidate();
+
     ppg.width = ppg.height = 16;
     ppg.compress = 0;
     ppg.formARGB = 0x1555;
@@ -2395,7 +2483,9 @@ void mlt_obj_trans_init(MultiTexture* mt, s32 mode, u8* adrs) {
     }
 
     mt->texList.tex->be = 0;
+    LOAD_TRACE_BEGIN(CONVERT);
     ppgSetupTexChunkSeqs(&mt->tex, &ppg, adrs, mt->mltgidx16, mt->mltnum, mt->attribute);
+    LOAD_TRACE_END(CONVERT);
 
     if (!(mode & 0x20)) {
         mc = mt->mltcsh16;
@@ -7,12 +7,14 @@
 #include "common.h"
 #include "main.h"
 #include "port/char_data.h"
+#include "port/io/tile_cache.h"
 #include "sf33rd/AcrSDK/ps2/foundaps2.h"
 #include "sf33rd/Source/Game/engine/charid.h"
 #include "sf33rd/Source/Game/engine/plcnt.h"
 #include "sf33rd/Source/Game/io/gd3rd.h"
 #include "sf33rd/Source/Game/rendering/chren3rd.h"
 #include "sf33rd/Source/Game/rendering/texcash.h"
+#include "sf33rd/Source/Game/rendering/tile_decode.h"
 #include "sf33rd/Source/Game/system/ramcnt.h"
 #include "structs.h"
 
@@ -150,10 +152,7 @@ void q_ldreq_texture_group(REQ* curr) {
 
     switch (curr->rno) {
     case 0:
-        if (fsCheckCommandExecuting() != 0) {
-            break;
-        }
-
+        // Requests read through their own handles, so there is no drive to wait for
         curr->rno = 1;
         curr->fnum = bsd->apfn;
 
@@ -259,6 +258,7 @@ void q_ldreq_texture_group(REQ* curr) {
         case 1:
             fsClose(curr);
             ldadr = Get_ramcnt_address(curr->key);
+            TileCache_BindFile(curr->fnum, (void*)ldadr, curr->size);
             curr->lds->texture_table = ldadr + bsd->to_tex;
             curr->lds->trans_table = ldadr;
             curr->lds->ok = 1;
@@ -343,6 +343,30 @@ void q_ldreq_texture_group(REQ* curr) {
     }
 }
 
+/**
+ * @brief texgrplds slot a texture group request will read into, or -1.
+ *
+ * -1 when the group has no file or is already loaded, i.e. when the request
+ * would finish without reading (the load queue only overlaps real reads).
+ */
+s32 q_ldreq_texture_group_slot(u8 ix) {
+    const TexGroupData* bsd;
+    u8 group;
+
+    if (ix >= 100) {
+        return -1;
+    }
+
+    bsd = &texgrpdat[ix];
+
+    if (bsd->apfn == -1) {
+        return -1;
+    }
+
+    group = obj_group_table[(bsd->num_of_1st == 0) ? 1 : bsd->num_of_1st];
+    return texgrplds[group].ok ? -1 : group;
+}
+
 /** @brief Initialize all texture group load state entries. */
 void Init_texgrplds_work() {
     s16 i;
@@ -391,6 +415,9 @@ void checkSelObjFileLoaded() {
 
     lds = &texgrplds[obj_group_table[0x69E0]];
 
+    // The other language's tiles are about to be overwritten in place
+    tileDecodeInvalidate();
+
     while (1) {
         rnum = load_it_use_this_key(bsd->apfn, lds->key);
 
@@ -400,6 +427,7 @@ void checkSelObjFileLoaded() {
     }
 
     ldadr = Get_ramcnt_address(lds->key);
+    TileCache_BindFile(bsd->apfn, (void*)ldadr, fsGetFileSize(bsd->apfn));
     lds->texture_table = ldadr + bsd->to_tex;
     lds->trans_table = ldadr;
     lds->ok = 1;
@@ -415,6 +443,8 @@ void purge_texture_group_of_this(u16 patnum) {
 /** @brief Purge all textures in a given texture group. */
 void purge_texture_group(u8 grp) {
     if (texgrplds[grp].ok != 0) {
+        // Decode workers may still be reading this group's tile data
+        tileDecodeInvalidate();
         texgrplds[grp].ok = 0;
         Push_ramcnt_key(texgrplds[grp].key);
     }
@@ -472,6 +502,7 @@ static s32 load_any_texture_grpnum(u8 grp, u8 kokey) {
 
     lds->key = load_it_use_any_key(bsd->apfn, kokey, grp);
     ldadr = Get_ramcnt_address(lds->key);
+    TileCache_BindFile(bsd->apfn, (void*)ldadr, fsGetFileSize(bsd->apfn));
     lds->texture_table = ldadr + bsd->to_tex;
     lds->trans_table = ldadr;
     lds->ok = 1;
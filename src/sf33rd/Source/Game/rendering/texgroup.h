@@ -13,6 +13,7 @@ extern TEX_GRP_LD texgrplds[100];
 extern const TexGroupData texgrpdat[100];
 
 void q_ldreq_texture_group(REQ* curr);
+s32 q_ldreq_texture_group_slot(u8 ix);
 void Init_texgrplds_work();
 void checkSelObjFileLoaded();
 s32 load_any_texture_patnum(u16 patnum, u8 kokey, u8 _unused);
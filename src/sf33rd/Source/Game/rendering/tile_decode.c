@@ -0,0 +1,578 @@
+/**
+ * @file tile_decode.c
+ * Worker-pool LZ77 decoder for sprite tiles
+ */
+
+#include "sf33rd/Source/Game/rendering/tile_decode.h"
+#include "port/io/tile_cache.h"
+#include "port/tracy_zones.h"
+#include "sf33rd/Source/Common/PPGFile.h"
+
+#include <SDL3/SDL.h>
+
+#define TDEC_WORKERS_MAX 4
+#define TDEC_SLOTS 512
+#define TDEC_SLOT_EMPTY (-1)
+#define TDEC_HASH_BITS 10
+#define TDEC_HASH_SIZE (1 << TDEC_HASH_BITS)
+#define TDEC_DEMAND_MAX 256 // Demand jobs buffered before Submit drains early
+#define TDEC_SPEC_MAX 512   // Speculative decode ring
+
+// lz_ext_p6_fx only checks the end pointer between tokens, so a copy token
+// can run up to 65 bytes past the requested length.
+#define TDEC_TILE_SLACK 0x50
+
+typedef enum {
+    TDEC_FREE,
+    TDEC_QUEUED,
+    TDEC_DECODING,
+    TDEC_READY,
+} TileDecodeState;
+
+typedef struct {
+    u8 data[TILE_DECODE_MAX_BYTES + TDEC_TILE_SLACK];
+    const u8* src;
+    u32 size;
+    s16 next; // Hash chain
+    u8 state; // TileDecodeState
+    u8 ref;   // Second-chance bit for eviction
+    u16 pins; // Pending demand jobs that still read data[]
+} TileDecodeSlot;
+
+typedef struct {
+    Texture* tex;
+    s32 gix;
+    u32 code;
+    u32 size;
+    s16 slot;
+} TileDecodeJob;
+
+typedef struct {
+    s16 buf[TDEC_SPEC_MAX];
+    s32 head;
+    s32 count;
+} TileDecodeRing;
+
+static struct {
+    SDL_Mutex* lock;
+    SDL_Condition* work_cv; // Signalled when a slot is queued
+    SDL_Condition* done_cv; // Signalled when a slot finishes decoding
+    SDL_Thread* threads[TDEC_WORKERS_MAX];
+    s32 num_threads;
+    bool quit;
+    s32 decoding;
+    u32 clock;
+    s16 hash[TDEC_HASH_SIZE];
+    TileDecodeSlot* slots;
+    TileDecodeRing demand; // Slots a demand job is waiting on (served first)
+    TileDecodeRing spec;   // Speculative slots
+    TileDecodeJob jobs[TDEC_DEMAND_MAX];
+    s32 num_jobs;
+    TileDecodeStats stats;
+} tdec;
+
+/** @brief Decompress LZ-compressed 4bpp fixed-palette texture data. */
+void lz_ext_p6_fx(const u8* srcptr, u8* dstptr, u32 len) {
+    u8* endptr = dstptr + len;
+    u8* tmpptr;
+    u32 tmp;
+    u32 flg;
+
+    while (dstptr < endptr) {
+        tmp = *srcptr++;
+
+        switch (tmp & 0xC0) {
+        case 0x0:
+            *dstptr++ = tmp;
+            break;
+
+        case 0x40:
+            tmp &= 0x3F;
+            tmpptr = (dstptr - (tmp >> 2)) - 1;
+            tmp = (tmp & 3) + 2;
+
+            while (tmp--) {
+                *dstptr++ = *tmpptr++;
+            }
+
+            break;
+
+        case 0x80:
+            tmp = ((tmp & 0x3F) << 8) | *srcptr++;
+            tmpptr = (dstptr - (tmp >> 6)) - 1;
+            tmp = (tmp & 0x3F) + 2;
+
+            while (tmp--) {
+                *dstptr++ = *tmpptr++;
+            }
+
+            break;
+
+        case 0xC0:
+            flg = tmp & 0x30;
+            tmp = (tmp & 0xF) + 2;
+
+            while (tmp--) {
+                *dstptr++ = flg | (*srcptr >> 4);
+                *dstptr++ = flg | (*srcptr++ & 0xF);
+            }
+
+            break;
+        }
+    }
+}
+
+static inline u32 tdec_hash(const u8* src) {
+    return ((u32)((uintptr_t)src >> 1) * 2654435761u) >> (32 - TDEC_HASH_BITS);
+}
+
+static void ring_push(TileDecodeRing* r, s16 slot) {
+    r->buf[(r->head + r->count) % TDEC_SPEC_MAX] = slot;
+    r->count++;
+}
+
+/** @brief Pop the next slot that is still waiting to be decoded. */
+static s16 ring_pop_queued(TileDecodeRing* r) {
+    while (r->count > 0) {
+        s16 slot = r->buf[r->head];
+
+        r->head = (r->head + 1) % TDEC_SPEC_MAX;
+        r->count--;
+
+        if (tdec.slots[slot].state == TDEC_QUEUED) {
+            return slot;
+        }
+    }
+
+    return TDEC_SLOT_EMPTY;
+}
+
+static s16 slot_lookup(const u8* src, u32 size) {
+    s16 s;
+
+    for (s = tdec.hash[tdec_hash(src)]; s != TDEC_SLOT_EMPTY; s = tdec.slots[s].next) {
+        if ((tdec.slots[s].src == src) && (tdec.slots[s].size == size)) {
+            return s;
+        }
+    }
+
+    return TDEC_SLOT_EMPTY;
+}
+
+static void slot_unlink(s16 slot) {
+    TileDecodeSlot* sp = &tdec.slots[slot];
+    s16* link;
+
+    if (sp->src == NULL) {
+        return;
+    }
+
+    for (link = &tdec.hash[tdec_hash(sp->src)]; *link != TDEC_SLOT_EMPTY; link = &tdec.slots[*link].next) {
+        if (*link == slot) {
+            *link = sp->next;
+            break;
+        }
+    }
+
+    sp->src = NULL;
+    sp->next = TDEC_SLOT_EMPTY;
+    sp->state = TDEC_FREE;
+}
+
+/** @brief Claim a free slot, evicting an unpinned decoded tile (second chance) if needed. */
+static s16 slot_alloc(const u8* src, u32 size) {
+    TileDecodeSlot* sp;
+    s32 i;
+    s16 slot = TDEC_SLOT_EMPTY;
+    u32 h;
+
+    for (i = 0; i < TDEC_SLOTS * 2; i++) {
+        s16 s = tdec.clock;
+
+        tdec.clock = (tdec.clock + 1) % TDEC_SLOTS;
+        sp = &tdec.slots[s];
+
+        if (sp->state == TDEC_FREE) {
+            slot = s;
+            break;
+        }
+
+        if ((sp->state != TDEC_READY) || (sp->pins != 0)) {
+            continue;
+        }
+
+        if (sp->ref) {
+            sp->ref = 0;
+            continue;
+        }
+
+        slot = s;
+        break;
+    }
+
+    if (slot == TDEC_SLOT_EMPTY) {
+        return TDEC_SLOT_EMPTY;
+    }
+
+    slot_unlink(slot);
+    sp = &tdec.slots[slot];
+    h = tdec_hash(src);
+    sp->src = src;
+    sp->size = size;
+    sp->state = TDEC_QUEUED;
+    sp->ref = 1;
+    sp->pins = 0;
+    sp->next = tdec.hash[h];
+    tdec.hash[h] = slot;
+    return slot;
+}
+
+/** @brief Decode one queued slot. Called and returns with the lock held. */
+static void slot_decode_locked(s16 slot) {
+    TileDecodeSlot* sp = &tdec.slots[slot];
+    const void* cached;
+
+    sp->state = TDEC_DECODING;
+    tdec.decoding++;
+    SDL_UnlockMutex(tdec.lock);
+
+    cached = TileCache_Lookup(sp->src, sp->size);
+
+    if (cached != NULL) {
+        SDL_memcpy(sp->data, cached, sp->size);
+    } else {
+        lz_ext_p6_fx(sp->src, sp->data, sp->size);
+        TileCache_Store(sp->src, sp->size, sp->data);
+    }
+
+    SDL_LockMutex(tdec.lock);
+    tdec.decoding--;
+    sp->state = TDEC_READY;
+    SDL_BroadcastCondition(tdec.done_cv);
+}
+
+static int tdec_worker(void* arg) {
+    (void)arg;
+
+    SDL_LockMutex(tdec.lock);
+
+    while (!tdec.quit) {
+        s16 slot = ring_pop_queued(&tdec.demand);
+
+        if (slot == TDEC_SLOT_EMPTY) {
+            slot = ring_pop_queued(&tdec.spec);
+        }
+
+        if (slot == TDEC_SLOT_EMPTY) {
+            SDL_WaitCondition(tdec.work_cv, tdec.lock);
+            continue;
+        }
+
+        slot_decode_locked(slot);
+    }
+
+    SDL_UnlockMutex(tdec.lock);
+    return 0;
+}
+
+/** @brief Reset the slot table and queues. Requires the lock and no decodes in flight. */
+static void tdec_reset_locked(void) {
+    s32 i;
+
+    for (i = 0; i < TDEC_HASH_SIZE; i++) {
+        tdec.hash[i] = TDEC_SLOT_EMPTY;
+    }
+
+    for (i = 0; i < TDEC_SLOTS; i++) {
+        tdec.slots[i].src = NULL;
+        tdec.slots[i].next = TDEC_SLOT_EMPTY;
+        tdec.slots[i].state = TDEC_FREE;
+        tdec.slots[i].ref = 0;
+        tdec.slots[i].pins = 0;
+    }
+
+    tdec.demand.head = tdec.demand.count = 0;
+    tdec.spec.head = tdec.spec.count = 0;
+    tdec.clock = 0;
+}
+
+/** @brief Start the decode workers (one per spare core, up to TDEC_WORKERS_MAX). */
+void tileDecodeInit(void) {
+    s32 n;
+    s32 i;
+
+    if (tdec.num_threads != 0) {
+        return;
+    }
+
+    n = SDL_GetNumLogicalCPUCores() - 1;
+
+    if (n > TDEC_WORKERS_MAX) {
+        n = TDEC_WORKERS_MAX;
+    }
+
+    if (n <= 0) {
+        SDL_Log("[tile_decode] single core; sprite tiles decode inline");
+        return;
+    }
+
+    tdec.slots = (TileDecodeSlot*)SDL_malloc(sizeof(TileDecodeSlot) * TDEC_SLOTS);
+    tdec.lock = SDL_CreateMutex();
+    tdec.work_cv = SDL_CreateCondition();
+    tdec.done_cv = SDL_CreateCondition();
+
+    if ((tdec.slots == NULL) || (tdec.lock == NULL) || (tdec.work_cv == NULL) || (tdec.done_cv == NULL)) {
+        SDL_Log("[tile_decode] init failed: %s", SDL_GetError());
+        tileDecodeShutdown();
+        return;
+    }
+
+    tdec_reset_locked();
+    tdec.quit = false;
+    tdec.num_jobs = 0;
+
+    for (i = 0; i < n; i++) {
+        tdec.threads[i] = SDL_CreateThread(tdec_worker, "TileDecode", NULL);
+
+        if (tdec.threads[i] == NULL) {
+            break;
+        }
+    }
+
+    tdec.num_threads = i;
+
+    if (tdec.num_threads == 0) {
+        tileDecodeShutdown();
+        return;
+    }
+
+    SDL_Log("[tile_decode] %d worker(s)", tdec.num_threads);
+}
+
+/** @brief Apply outstanding jobs, stop the workers and free the slot table. */
+void tileDecodeShutdown(void) {
+    s32 i;
+
+    if (tdec.num_threads != 0) {
+        tileDecodeDrain();
+        SDL_LockMutex(tdec.lock);
+        tdec.quit = true;
+        SDL_BroadcastCondition(tdec.work_cv);
+        SDL_UnlockMutex(tdec.lock);
+
+        for (i = 0; i < tdec.num_threads; i++) {
+            SDL_WaitThread(tdec.threads[i], NULL);
+            tdec.threads[i] = NULL;
+        }
+
+        tdec.num_threads = 0;
+    }
+
+    if (tdec.done_cv != NULL) {
+        SDL_DestroyCondition(tdec.done_cv);
+        tdec.done_cv = NULL;
+    }
+
+    if (tdec.work_cv != NULL) {
+        SDL_DestroyCondition(tdec.work_cv);
+        tdec.work_cv = NULL;
+    }
+
+    if (tdec.lock != NULL) {
+        SDL_DestroyMutex(tdec.lock);
+        tdec.lock = NULL;
+    }
+
+    if (tdec.slots != NULL) {
+        SDL_free(tdec.slots);
+        tdec.slots = NULL;
+    }
+}
+
+/**
+ * @brief Queue a tile decode into a texture slot, applied by tileDecodeDrain().
+ *
+ * The result is written with ppgRenewDotDataSeqs(tex, gix, ..., code, size),
+ * exactly as the inline path does. Tiles already decoded by a prefetch cost a
+ * copy only.
+ *
+ * Pending jobs are applied before returning 0, so an inline decode by the
+ * caller never lands ahead of an earlier queued write.
+ *
+ * @return 1 if queued, 0 if the caller must decode inline.
+ */
+s32 tileDecodeSubmit(Texture* tex, s32 gix, u32 code, const u8* src, u32 size) {
+    TileDecodeJob* job;
+    TileDecodeSlot* sp;
+    s16 slot;
+
+    if ((tdec.num_threads == 0) || (size > TILE_DECODE_MAX_BYTES)) {
+        tileDecodeDrain();
+        tdec.stats.sync++;
+        return 0;
+    }
+
+    if (tdec.num_jobs >= TDEC_DEMAND_MAX) {
+        tileDecodeDrain();
+    }
+
+    SDL_LockMutex(tdec.lock);
+    slot = slot_lookup(src, size);
+
+    if (slot == TDEC_SLOT_EMPTY) {
+        slot = slot_alloc(src, size);
+
+        if (slot == TDEC_SLOT_EMPTY) {
+            SDL_UnlockMutex(tdec.lock);
+            tileDecodeDrain();
+            tdec.stats.sync++;
+            return 0;
+        }
+
+        ring_push(&tdec.demand, slot);
+        SDL_SignalCondition(tdec.work_cv);
+        tdec.stats.async++;
+    } else {
+        sp = &tdec.slots[slot];
+
+        if (sp->state == TDEC_QUEUED) {
+            // Still waiting in the speculative ring; promote it.
+            ring_push(&tdec.demand, slot);
+            SDL_SignalCondition(tdec.work_cv);
+            tdec.stats.async++;
+        } else {
+            tdec.stats.prefetch_hits++;
+        }
+    }
+
+    sp = &tdec.slots[slot];
+    sp->pins++;
+    sp->ref = 1;
+    job = &tdec.jobs[tdec.num_jobs++];
+    job->tex = tex;
+    job->gix = gix;
+    job->code = code;
+    job->size = size;
+    job->slot = slot;
+    SDL_UnlockMutex(tdec.lock);
+    return 1;
+}
+
+/**
+ * @brief Queue speculative decodes for tiles that are likely to be needed soon.
+ *
+ * Tiles already cached or queued are skipped. Requests are dropped when the
+ * speculative ring or the slot table is full.
+ */
+void tileDecodePrefetch(const u8* const* srcs, const u32* sizes, s32 count) {
+    s32 queued = 0;
+    s32 i;
+    s16 slot;
+
+    if ((tdec.num_threads == 0) || (count <= 0)) {
+        return;
+    }
+
+    SDL_LockMutex(tdec.lock);
+
+    for (i = 0; i < count; i++) {
+        if (sizes[i] > TILE_DECODE_MAX_BYTES) {
+            continue;
+        }
+
+        slot = slot_lookup(srcs[i], sizes[i]);
+
+        if (slot != TDEC_SLOT_EMPTY) {
+            tdec.slots[slot].ref = 1;
+            continue;
+        }
+
+        if (tdec.spec.count >= TDEC_SPEC_MAX) {
+            break;
+        }
+
+        slot = slot_alloc(srcs[i], sizes[i]);
+
+        if (slot == TDEC_SLOT_EMPTY) {
+            break;
+        }
+
+        ring_push(&tdec.spec, slot);
+        queued++;
+    }
+
+    if (queued != 0) {
+        SDL_BroadcastCondition(tdec.work_cv);
+    }
+
+    tdec.stats.prefetched += queued;
+    SDL_UnlockMutex(tdec.lock);
+}
+
+/**
+ * @brief Wait for every submitted job and write it into its texture, in submission order.
+ *
+ * Jobs nobody has picked up yet are decoded on the calling thread rather than
+ * waited on.
+ */
+void tileDecodeDrain(void) {
+    TileDecodeJob* job;
+    TileDecodeSlot* sp;
+    s32 i;
+
+    if (tdec.num_jobs == 0) {
+        return;
+    }
+
+    TRACE_ZONE_N("tileDecodeDrain");
+    SDL_LockMutex(tdec.lock);
+
+    for (i = 0; i < tdec.num_jobs; i++) {
+        job = &tdec.jobs[i];
+        sp = &tdec.slots[job->slot];
+
+        while (sp->state != TDEC_READY) {
+            if (sp->state == TDEC_QUEUED) {
+                slot_decode_locked(job->slot);
+            } else {
+                SDL_WaitCondition(tdec.done_cv, tdec.lock);
+            }
+        }
+
+        // Pinned slots are never evicted or rewritten, so the copy can run unlocked.
+        SDL_UnlockMutex(tdec.lock);
+        ppgRenewDotDataSeqs(job->tex, job->gix, (u32*)sp->data, job->code, job->size);
+        SDL_LockMutex(tdec.lock);
+        sp->pins--;
+    }
+
+    // Every demand slot is decoded now; drop the leftover ring entries.
+    tdec.demand.head = tdec.demand.count = 0;
+    tdec.num_jobs = 0;
+    SDL_UnlockMutex(tdec.lock);
+    TRACE_ZONE_END();
+}
+
+/** @brief Apply pending jobs and forget every cached tile (texture groups were reloaded). */
+void tileDecodeInvalidate(void) {
+    if (tdec.num_threads == 0) {
+        return;
+    }
+
+    tileDecodeDrain();
+    SDL_LockMutex(tdec.lock);
+
+    // Compressed sources may be freed after this returns; wait out in-flight reads.
+    while (tdec.decoding != 0) {
+        SDL_WaitCondition(tdec.done_cv, tdec.lock);
+    }
+
+    tdec_reset_locked();
+    SDL_UnlockMutex(tdec.lock);
+}
+
+/** @brief Copy and reset the per-frame counters. */
+void tileDecodeGetStats(TileDecodeStats* out) {
+    *out = tdec.stats;
+    SDL_zero(tdec.stats);
+}
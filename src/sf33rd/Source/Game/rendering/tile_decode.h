@@ -0,0 +1,45 @@
+/**
+ * @file tile_decode.h
+ * @brief Worker-pool LZ77 decoder for sprite tiles.
+ *
+ * Sprite tiles are stored LZ77-compressed and decoded into the
+ * MultiTexture backing store the first time a chip is referenced.
+ * This service moves that work off the game thread: cache misses are
+ * queued as demand jobs and applied in submission order by
+ * tileDecodeDrain() before the dirty textures are uploaded, and tiles
+ * the animation script will show in the next few frames can be
+ * decoded speculatively with tileDecodePrefetch().
+ *
+ * Decoded tiles are keyed by their compressed source pointer, so
+ * tileDecodeInvalidate() must be called whenever texture group data
+ * is reloaded.
+ */
+#ifndef TILE_DECODE_H
+#define TILE_DECODE_H
+
+#include "structs.h"
+#include "types.h"
+
+/** @brief Largest decoded tile handled by the pool (32x32 at 8bpp). */
+#define TILE_DECODE_MAX_BYTES 0x400
+
+/** @brief Per-frame counters, reset by tileDecodeGetStats(). */
+typedef struct {
+    s32 prefetch_hits; // Demand misses served by a speculative decode
+    s32 async;         // Demand misses decoded by the pool
+    s32 sync;          // Demand misses the caller had to decode inline
+    s32 prefetched;    // Speculative jobs queued
+} TileDecodeStats;
+
+/** @brief Decompress LZ-compressed 4bpp fixed-palette texture data. */
+void lz_ext_p6_fx(const u8* srcptr, u8* dstptr, u32 len);
+
+void tileDecodeInit(void);
+void tileDecodeShutdown(void);
+s32 tileDecodeSubmit(Texture* tex, s32 gix, u32 code, const u8* src, u32 size);
+void tileDecodePrefetch(const u8* const* srcs, const u32* sizes, s32 count);
+void tileDecodeDrain(void);
+void tileDecodeInvalidate(void);
+void tileDecodeGetStats(TileDecodeStats* out);
+
+#endif // TILE_DECODE_H
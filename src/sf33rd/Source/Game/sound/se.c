@@ -40,18 +40,25 @@ const u16 BGM_Stage_Data[22] = { 46, 1, 13, 34, 31, 4, 7, 16, 25, 28, 34, 1, 28,
 const s16 SE_Shock_Data[7] = { 285, 286, 287, 288, 289, 305, 306 };
 const s16 Finish_SE_Data[2][7] = { { 305, 306, 285, 286, 287, 288, 272 }, { 292, 293, 290, 291, 287, 288, 272 } };
 
-/** @brief Select and play BGM for the given stage and round. */
-void Stage_BGM(u16 Stage_Number, u16 Round_Number) {
-    u16 code;
-
+/** @brief BGM request code for the given stage and round (0 if the stage has none). */
+static u16 stage_bgm_code(u16 Stage_Number, u16 Round_Number) {
     if (Stage_Number >= BGM_STAGE_DATA_SIZE) {
-        return;
+        return 0;
     }
 
     if (Mode_Type == MODE_ARCADE && Play_Type == 0 && My_char[COM_id] == 17 && Bonus_Game_Flag == 0) {
-        code = BGM_Stage_Data[17] + bgm_selector[sys_w.bgm_type][Round_Number & 7];
-    } else {
-        code = BGM_Stage_Data[Stage_Number] + bgm_selector[sys_w.bgm_type][Round_Number & 7];
+        return BGM_Stage_Data[17] + bgm_selector[sys_w.bgm_type][Round_Number & 7];
+    }
+
+    return BGM_Stage_Data[Stage_Number] + bgm_selector[sys_w.bgm_type][Round_Number & 7];
+}
+
+/** @brief Select and play BGM for the given stage and round. */
+void Stage_BGM(u16 Stage_Number, u16 Round_Number) {
+    const u16 code = stage_bgm_code(Stage_Number, Round_Number);
+
+    if (code == 0) {
+        return;
     }
 
     *gSeqStatus = 0;
@@ -64,6 +71,15 @@ void Stage_BGM(u16 Stage_Number, u16 Round_Number) {
     SsRequest(code);
 }
 
+/** @brief Get the first-round BGM of the given stage ready ahead of Stage_BGM(). */
+void Stage_BGM_Prefetch(u16 Stage_Number) {
+    const u16 code = stage_bgm_code(Stage_Number, 0);
+
+    if (code != 0) {
+        SsBgmPrefetch(code);
+    }
+}
+
 /** @brief Play a sound effect by code (no panning). */
 void Sound_SE(s16 Code) {
     SsRequest(Code);
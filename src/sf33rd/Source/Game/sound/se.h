@@ -18,6 +18,7 @@
 extern u8 gSeqStatus[1];
 
 void Stage_BGM(u16 Stage_Number, u16 Round_Number);
+void Stage_BGM_Prefetch(u16 Stage_Number);
 void Sound_SE(s16 Code);
 void BGM_Request(s16 Code);
 void BGM_Request_Code_Check(u16 Code);
@@ -30,6 +30,7 @@
 #include "sf33rd/Source/Game/sound/se.h"
 #include "sf33rd/Source/Game/sound/se_data.h"
 #include "sf33rd/Source/Game/sound/sound_ids.h"
+#include "sf33rd/Source/Game/stage/bg.h"
 #include "sf33rd/Source/Game/system/ramcnt.h"
 #include "sf33rd/Source/Game/system/sys_sub.h"
 #include "sf33rd/Source/Game/system/work_sys.h"
@@ -386,6 +387,11 @@ void BGM_Server() {
             bgm_exe.code = bgm_req.code;
         }
 
+        // The stage is decided before the VS screen, which then runs for seconds: decode a modded stage track meanwhile
+        if (bgm_req.code == BGM_CODE_VS) {
+            Stage_BGM_Prefetch(bg_w.stage);
+        }
+
         bgm_exe.rno = 0;
 
         if (bgm_exe.code < 0 || bgm_exe.code >= BGM_TABLE_SIZE) {
@@ -977,6 +983,33 @@ void SsBgmFadeIn(u16 ReqNumber, u16 FadeSpeed) {
     }
 }
 
+/**
+ * @brief Warm up whatever a later SsRequest(ReqNumber) would play.
+ *
+ * Only modded tracks need it: resolves the request to the AFS file the
+ * BGM server would start, for both the direct and the seamless path.
+ */
+void SsBgmPrefetch(u16 ReqNumber) {
+    const SoundLookupEntry* lookup = Get_Sound_Lookup((SoundRequest)ReqNumber);
+
+    if (!lookup || lookup->ptix != BGM_PTIX) {
+        return;
+    }
+
+    const u16 code = lookup->engine_code;
+
+    if (code == 0 || code >= BGM_TABLE_SIZE || sys_w.bgm_type >= BGM_TYPE_COUNT) {
+        return;
+    }
+
+    if (bgm_table[sys_w.bgm_type][code].data & 0x4000) {
+        const s16 ex_index = bgm_table[sys_w.bgm_type][code].data & 0xFF;
+        ModdedBGM_Prefetch(bgm_exdata[sys_w.bgm_type][ex_index].numStart);
+    }
+
+    ModdedBGM_Prefetch(bgm_table[sys_w.bgm_type][code].fnum);
+}
+
 /** @brief Fade out the current BGM over the given frame count (bank=5). */
 void SsBgmFadeOut(u16 time) {
     SoundRequestData rmcode;
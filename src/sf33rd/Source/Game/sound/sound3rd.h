@@ -51,6 +51,7 @@ void SsBgmControl(s8 /* unused */, s8 VOLUME);
 void SsRequestPan(u16 reqNum, s16 start, s16 /* unused */, s32 /* unused */, s32 /* unused */);
 void SsBgmOff();
 void SsBgmFadeIn(u16 ReqNumber, u16 FadeSpeed);
+void SsBgmPrefetch(u16 ReqNumber);
 void spu_all_off();
 
 #endif
@@ -6,6 +6,7 @@
 #include "sf33rd/Source/Game/stage/bg.h"
 #include "common.h"
 #include "port/config/paths.h"
+#include "port/tracy_zones.h"
 #include "port/mods/modded_stage.h"
 #include "port/rendering/legacy_matrix.h"
 #include "port/rendering/renderer.h"
@@ -60,6 +61,49 @@ RW_DATA rw_dat[20];
 /** @brief Non-zero when the Shin Gouki palette XOR has been applied to ColorRAM. */
 static u8 s_gouki_pal_xored;
 
+/** @brief Max 128px chips in one plane's cached layer (8x8 over the 0..0x3FF plane). */
+#define BG_LAYER_CHIP_MAX 64
+/** @brief Max merged trans sub-quads in one plane's cached layer. */
+#define BG_LAYER_QUAD_MAX 4096
+
+/** @brief One visible chip of a cached BG layer. */
+typedef struct {
+    s16 x;
+    s16 y;
+    u8 cellsW;
+    u8 cellsH;
+    u16 first;
+    u16 num;
+    const TextureHandle* handle; // Texture slot the chip was resolved from (staleness check)
+    u16 texhan;
+} BgLayerChip;
+
+/**
+ * @brief Per-plane cache of the resolved chip/sub-quad list drawn by bgDrawOneScreen().
+ *
+ * ⚡ Bolt: Resolving a chip walks the rewrite tables, swaps data lists and parses
+ * the PPG trans table on every frame even though the result only changes when
+ * the visible chip window moves by a whole chip or a rewrite fires. The cache
+ * keeps the merged quad list and only re-projects it by the current scroll.
+ */
+typedef struct {
+    u32 gen; // bg_layer_gen at build time; 0 = empty
+    s32 xx[2];
+    s32 yy[2];
+    s32 ofsPal;
+    s32 direct; // Did not fit; draw uncached until the next invalidation
+    s32 numChips;
+    BgLayerChip chip[BG_LAYER_CHIP_MAX];
+    PPGTransQuad quad[BG_LAYER_QUAD_MAX];
+} BgLayerCache;
+
+static BgLayerCache bg_layer[4];
+
+/** @brief Bumped whenever chip indices, rewrite state or BG textures change. */
+static u32 bg_layer_gen = 1;
+
+/** @brief Invalidate every cached BG layer. */
+static void bgLayerInvalidate();
 /** @brief Update read/write work buffers for animated background tiles. */
 static void bgRWWorkUpdate();
 /** @brief Draw all visible chips for a single background screen. */
@@ -95,6 +139,8 @@ void Bg_Kakikae_Set() {
     const bgrw_data_tbl_elem* rwtbl_ptr;
     s8 rw;
 
+    bgLayerInvalidate();
+
     switch (bg_w.stage) {
     case 3:
         tokusyu_stage = 1;
@@ -189,6 +235,8 @@ void Ed_Kakikae_Set(s16 type) {
     u8 i;
     s8 rw;
 
+    bgLayerInvalidate();
+
     rw_num = 0;
 
     for (i = 0; i < 4; i++) {
@@ -238,6 +286,8 @@ void Ed_Kakikae_Set(s16 type) {
 void Bg_Close() {
     u32 i;
 
+    bgLayerInvalidate();
+
     tokusyu_stage = 0;
     rw_num = 0;
 
@@ -313,6 +363,7 @@ void Bg_Texture_Load_EX() {
 
     mmDebWriteTag("\nSTAGE\n\n");
     Bg_TexInit();
+    bgLayerInvalidate();
 
     for (i = 0; i < 8; i++) {
         bgPalCodeOffset[i] = 0x12C;
@@ -419,6 +470,7 @@ void Bg_Texture_Load2(u8 type) {
 
     mmDebWriteTag("\nBG ETC.\n\n");
     Bg_TexInit();
+    bgLayerInvalidate();
     (void)assign;
     ending_flag = 0;
     tokusyu_stage = 0;
@@ -483,6 +535,7 @@ void Bg_Texture_Load_Ending(s16 type) {
     mmDebWriteTag("\nENDING\n\n");
     rw_num = 0;
     Bg_TexInit();
+    bgLayerInvalidate();
     ending_flag = 1;
 
     for (i = 0; i < end_use_real_scr[type]; i++) {
@@ -1071,14 +1124,24 @@ void scr_trans(u8 bgnm) {
     }
 }
 
+/** @brief Invalidate every cached BG layer. */
+void bgLayerInvalidate() {
+    if (++bg_layer_gen == 0) {
+        bg_layer_gen = 1;
+    }
+}
+
 /** @brief Update read/write work buffers for animated background tiles. */
 void bgRWWorkUpdate() {
     s32 i;
+    s32 prev;
 
     for (i = 0; i < rw_num; i++) {
         rw_dat[i].rw_cnt--;
 
         if (rw_dat[i].rw_cnt == 0) {
+            prev = rw_dat[i].gbix;
+
             if (*rw_dat[i].rwd_ptr == -1) {
                 rw_dat[i].rwd_ptr = rw_dat[i].brw_ptr;
                 rw_dat[i].rw_cnt = *rw_dat[i].rwd_ptr++;
@@ -1087,14 +1150,145 @@ void bgRWWorkUpdate() {
                 rw_dat[i].rw_cnt = *rw_dat[i].rwd_ptr++;
                 rw_dat[i].gbix = *rw_dat[i].rwd_ptr++;
             }
+
+            if (rw_dat[i].gbix != prev) {
+                bgLayerInvalidate();
+            }
+        }
+    }
+}
+
+/** @brief Resolve the rewritten chip index for @p gbix and the data list it lives in. */
+static s32 bgResolveChip(s32 bgnum, s32 gbix, PPGDataList** list) {
+    s32 i;
+
+    if (rw_bg_flag[bgnum] && rw_num) {
+        for (i = 0; i < rw_num; i++) {
+            if (bgnum == rw_dat[i].bg_num && gbix == rw_dat[i].rwgbix) {
+                gbix = rw_dat[i].gbix;
+                if (!(ppgCheckTextureNumber((*list)->tex, gbix))) {
+                    *list = &ppgRwBgList;
+                }
+                break;
+            }
+        }
+    }
+
+    return gbix;
+}
+
+/** @brief Check that a cached layer still describes the requested chip window. */
+static s32 bgLayerIsCurrent(const BgLayerCache* lc, const s32* xx, const s32* yy, s32 ofsPal) {
+    s32 i;
+
+    if ((lc->gen != bg_layer_gen) || (lc->xx[0] != xx[0]) || (lc->xx[1] != xx[1]) || (lc->yy[0] != yy[0]) ||
+        (lc->yy[1] != yy[1]) || (lc->ofsPal != ofsPal)) {
+        return 0;
+    }
+
+    // Loaders can (re)create texture slots after the build; rebuild if any changed.
+    for (i = 0; i < lc->numChips; i++) {
+        const BgLayerChip* chip = &lc->chip[i];
+
+        if ((chip->handle != NULL) && (chip->handle->b16[0] != chip->texhan)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/** @brief Rebuild the cached chip/sub-quad list of one BG plane. */
+static void bgLayerBuild(BgLayerCache* lc, s32 bgnum, s32 gixbase, const s32* xx, const s32* yy, s32 ofsPal,
+                         PPGDataList* curDataList) {
+    PPGDataList* list;
+    BgLayerChip* chip;
+    Texture* tex;
+    s32 x, y, gbix, num;
+    s32 used = 0;
+
+    lc->gen = bg_layer_gen;
+    lc->xx[0] = xx[0];
+    lc->xx[1] = xx[1];
+    lc->yy[0] = yy[0];
+    lc->yy[1] = yy[1];
+    lc->ofsPal = ofsPal;
+    lc->direct = 0;
+    lc->numChips = 0;
+
+    for (y = yy[0]; y < yy[1]; y += 128) {
+        for (x = xx[0]; x < xx[1]; x += 128) {
+            // Wider spans than the 8x8 plane (zoomed views) don't fit; draw them the old way
+            if (lc->numChips >= BG_LAYER_CHIP_MAX) {
+                lc->direct = 1;
+                return;
+            }
+
+            list = curDataList;
+            gbix = bgResolveChip(bgnum, ((y >> 7) << 3) + (x >> 7) + gixbase, &list);
+            tex = list->tex;
+            chip = &lc->chip[lc->numChips++];
+            chip->x = x;
+            chip->y = y;
+            chip->first = used;
+            chip->num = 0;
+            chip->handle = NULL;
+            chip->texhan = 0;
+
+            if ((tex != NULL) && tex->be && ((u32)(gbix - tex->ixNum1st) < tex->total)) {
+                chip->handle = &tex->handle[gbix - tex->ixNum1st];
+                chip->texhan = chip->handle->b16[0];
+            }
+
+            if ((tex != NULL) && ppgCheckTextureNumber(tex, gbix)) {
+                num = ppgBuildTransQuads(
+                    list, gbix, 0, ofsPal, &lc->quad[used], BG_LAYER_QUAD_MAX - used, &chip->cellsW, &chip->cellsH);
+
+                if (num < 0) {
+                    lc->direct = 1;
+                }
+
+                if (num > 0) {
+                    chip->num = num;
+                    used += num;
+                }
+            }
         }
     }
 }
 
 /** @brief Draw all visible chips for a single background screen. */
 void bgDrawOneScreen(s32 bgnum, s32 gixbase, s32* xx, s32* yy, s32 /* unused */, s32 ofsPal, PPGDataList* curDataList) {
+    BgLayerCache* lc = &bg_layer[bgnum];
     s32 i, x, y, gbix;
 
+    TRACE_ZONE_N("bgDrawOneScreen");
+
+    if (No_Trans != 0) {
+        TRACE_ZONE_END();
+        return;
+    }
+
+    if (!bgLayerIsCurrent(lc, xx, yy, ofsPal)) {
+        bgLayerBuild(lc, bgnum, gixbase, xx, yy, ofsPal, curDataList);
+    }
+
+    if (!lc->direct) {
+        for (i = 0; i < lc->numChips; i++) {
+            const BgLayerChip* chip = &lc->chip[i];
+
+            if (chip->num == 0) {
+                continue;
+            }
+
+            ppgCalScrPosition(chip->x, chip->y, 128, 128);
+            ppgWriteTransQuads(scrDrawPos, 0xFFFFFFFF, &lc->quad[chip->first], chip->num, chip->cellsW, chip->cellsH);
+        }
+
+        TRACE_ZONE_END();
+        return;
+    }
+
     for (y = yy[0]; y < yy[1]; y += 128) {
         for (x = xx[0]; x < xx[1]; x += 128) {
             gbix = ((y >> 7) << 3) + (x >> 7) + gixbase;
@@ -1115,6 +1309,8 @@ void bgDrawOneScreen(s32 bgnum, s32 gixbase, s32* xx, s32* yy, s32 /* unused */,
             ppgSetupCurrentDataList(curDataList);
         }
     }
+
+    TRACE_ZONE_END();
 }
 
 /** @brief Draw a single background tile chip at the given position. */
@@ -13,12 +13,17 @@
 
 #include "sf33rd/Source/Game/system/ramcnt.h"
 #include "common.h"
+#include "port/io/load_trace.h"
+#include "port/io/tile_cache.h"
 #include "sf33rd/AcrSDK/ps2/flps2debug.h"
 #include "sf33rd/AcrSDK/ps2/foundaps2.h"
 #include "sf33rd/Source/Common/MemMan.h"
+#include "sf33rd/Source/Common/PPGChunkDir.h"
 #include "sf33rd/Source/Game/debug/Debug.h"
 #include "sf33rd/Source/Game/rendering/texgroup.h"
 
+#include <string.h>
+
 #define ERR_STOP                                                                                                       \
     do {                                                                                                               \
         flLogOut("[ramcnt] ERR_STOP triggered at %s:%d", __FILE__, __LINE__);                                          \
@@ -36,6 +41,22 @@ s16 rckeyque[RCKEY_WORK_MAX];
 s16 rckeyctr;
 s16 rckeymin;
 
+// Pull history per kind; live counts are taken from rckey_work on demand,
+// since texgroup retypes keys after they are pulled
+static struct {
+    size_t peak_bytes;
+    s32 pulls;
+    s32 failures;
+} kind_history[256];
+
+/** @brief Largest single allocation the key heap could still serve (cell header included). */
+static ssize_t largest_free_area() {
+    MMHeapStats stats;
+
+    mmGetStats(&rckey_mmobj, &stats);
+    return stats.largest_free;
+}
+
 /** @brief Display debug overlay showing RAM key pool status (remaining memory, key count). */
 void disp_ramcnt_free_area() {
     if (Debug_w[DEBUG_RAMCNT_FREE_AREA]) {
@@ -44,6 +65,47 @@ void disp_ramcnt_free_area() {
         flPrintL(4, 9, "Now %07X", mmGetRemainder(&rckey_mmobj));
         flPrintL(4, 0xA, "Min %07X", mmGetRemainderMin(&rckey_mmobj));
         flPrintL(4, 0xB, "Key %2d / %2d", rckeymin, rckeyctr);
+        flPrintL(4, 0xC, "Big %07X", largest_free_area());
+    }
+}
+
+/** @brief Count a pull of @p kokey and refresh its byte peak. */
+static void note_pull(u8 kokey) {
+    RamcntKindStats stats;
+
+    kind_history[kokey].pulls += 1;
+    Get_ramcnt_kind_stats(kokey, &stats);
+
+    if (stats.bytes > kind_history[kokey].peak_bytes) {
+        kind_history[kokey].peak_bytes = stats.bytes;
+    }
+}
+
+/** @brief Live keys and bytes of kind @p kokey, with its pull history. */
+void Get_ramcnt_kind_stats(u8 kokey, RamcntKindStats* stats) {
+    s16 i;
+
+    stats->keys = 0;
+    stats->bytes = 0;
+    stats->borrowed_bytes = 0;
+    stats->peak_bytes = kind_history[kokey].peak_bytes;
+    stats->pulls = kind_history[kokey].pulls;
+    stats->failures = kind_history[kokey].failures;
+
+    for (i = 1; i < RCKEY_WORK_MAX; i++) {
+        const RCKeyWork* rwk = &rckey_work[i];
+
+        if (!rwk->use || (rwk->type != kokey)) {
+            continue;
+        }
+
+        stats->keys += 1;
+
+        if (rwk->borrowed) {
+            stats->borrowed_bytes += rwk->size;
+        } else {
+            stats->bytes += rwk->size;
+        }
     }
 }
 
@@ -68,6 +130,8 @@ void Init_ram_control_work(u8* adrs, s32 size) {
     for (i = 1; i < RCKEY_WORK_MAX; i++) {
         rckey_work[i] = rckey_work[0];
     }
+
+    memset(kind_history, 0, sizeof(kind_history));
 }
 
 /** @brief Release a RAM key (non-texcash type) — free its memory and return the key to the pool. */
@@ -107,9 +171,17 @@ void Push_ramcnt_key_original_2(s16 key) {
     RCKeyWork* rwk = &rckey_work[key];
 
     if (rwk->use != 0) {
-        mmFree(&rckey_mmobj, (u8*)rwk->adr);
+        TileCache_UnbindFile((void*)rwk->adr);
+
+        // Borrowed memory never changes, so its chunk directory stays valid for the next load
+        if (!rwk->borrowed) {
+            ppgChunkDirForget((const u8*)rwk->adr);
+            mmFree(&rckey_mmobj, (u8*)rwk->adr);
+        }
+
         rwk->type = 0;
         rwk->use = 0;
+        rwk->borrowed = 0;
 
         if (rwk->group_num) {
             purge_texture_group(rwk->group_num);
@@ -197,12 +269,26 @@ s32 Test_ramcnt_key(s16 key) {
     return 1;
 }
 
+/** @brief Say why a pull failed: how much was free and how much of it was contiguous. */
+static void log_alloc_failure(size_t memreq, u8 kokey) {
+    MMHeapStats stats;
+
+    mmGetStats(&rckey_mmobj, &stats);
+    flLogOut("[ramcnt] %zu bytes for kind %d: %zd free, largest gap %zd, %d blocks live",
+             memreq,
+             kokey,
+             stats.size - stats.live,
+             stats.largest_free,
+             stats.blocks);
+}
+
 /** @brief Allocate a new RAM key with the requested memory size, type, and texture group. */
 s16 Pull_ramcnt_key(size_t memreq, u8 kokey, u8 group, u8 frre) {
     RCKeyWork* rwk;
     s16 key;
 
     if (rckeyctr <= 0) {
+        kind_history[kokey].failures += 1;
         // There are not enough memory keys.\n
         flLogOut("メモリキーの個数が足りなくなりました。\n");
         ERR_STOP_VAL(-1);
@@ -222,7 +308,9 @@ s16 Pull_ramcnt_key(size_t memreq, u8 kokey, u8 group, u8 frre) {
             frre--;
         }
 
+        LOAD_TRACE_BEGIN(ALLOC);
         rwk->adr = (uintptr_t)mmAlloc(&rckey_mmobj, memreq, frre);
+        LOAD_TRACE_END(ALLOC);
     } else {
         goto err;
     }
@@ -230,13 +318,51 @@ s16 Pull_ramcnt_key(size_t memreq, u8 kokey, u8 group, u8 frre) {
     if (rwk->adr == 0) {
     err:
         rckeyque[rckeyctr++] = key;
+        kind_history[kokey].failures += 1;
+        log_alloc_failure(memreq, kokey);
         // Failed to allocate memory.\n
         flLogOut("メモリの確保に失敗しました。\n");
         ERR_STOP_VAL(-1);
     }
 
     rwk->use = 1;
+    rwk->borrowed = 0;
+    rwk->type = kokey;
+    rwk->group_num = group;
+    note_pull(kokey);
+    return key;
+}
+
+/**
+ * @brief Allocate a RAM key for memory that is already resident (no heap allocation).
+ *
+ * The key behaves like any other (type, texture group, release via
+ * Push_ramcnt_key), but releasing it leaves @p adr alone.
+ */
+s16 Pull_ramcnt_key_borrowed(const void* adr, size_t size, u8 kokey, u8 group) {
+    RCKeyWork* rwk;
+    s16 key;
+
+    if (rckeyctr <= 0) {
+        kind_history[kokey].failures += 1;
+        // There are not enough memory keys.\n
+        flLogOut("メモリキーの個数が足りなくなりました。\n");
+        ERR_STOP_VAL(-1);
+    }
+
+    key = rckeyque[(rckeyctr -= 1)];
+    rwk = &rckey_work[key];
+
+    if (rckeyctr < rckeymin) {
+        rckeymin = rckeyctr;
+    }
+
+    rwk->adr = (uintptr_t)adr;
+    rwk->size = size;
+    rwk->use = 1;
+    rwk->borrowed = 1;
     rwk->type = kokey;
     rwk->group_num = group;
+    note_pull(kokey);
     return key;
 }
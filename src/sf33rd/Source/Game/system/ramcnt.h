@@ -10,6 +10,16 @@
 
 #define RCKEY_WORK_MAX 64
 
+/** @brief Keys of one kind (type): live now, plus pull history since Init_ram_control_work(). */
+typedef struct {
+    s32 keys;              // Live keys
+    size_t bytes;          // Heap bytes held by live keys
+    size_t borrowed_bytes; // Bytes of live keys borrowed from elsewhere (AFS mapping)
+    size_t peak_bytes;     // Highest heap bytes seen at a pull
+    s32 pulls;
+    s32 failures; // Pulls that ran out of keys or heap
+} RamcntKindStats;
+
 extern s16 rckeyctr;
 extern s16 rckeymin;
 extern _MEMMAN_OBJ rckey_mmobj;
@@ -25,8 +35,10 @@ void Set_size_data_ramcnt_key(s16 key, u32 size);
 uintptr_t Get_ramcnt_address(s16 key);
 s16 Search_ramcnt_type(u8 kokey);
 s16 Pull_ramcnt_key(size_t memreq, u8 kokey, u8 group, u8 frre);
+s16 Pull_ramcnt_key_borrowed(const void* adr, size_t size, u8 kokey, u8 group);
 size_t Get_size_data_ramcnt_key(s16 key);
 s32 Test_ramcnt_key(s16 key);
 void Push_ramcnt_key_original(s16 key);
+void Get_ramcnt_kind_stats(u8 kokey, RamcntKindStats* stats);
 
 #endif
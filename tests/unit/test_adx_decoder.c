@@ -1,15 +1,107 @@
 /**
  * @file test_adx_decoder.c
  * @brief Unit tests for the ADX ADPCM decoder.
+ *
+ * The SIMD block path is checked against ADX_DecodeReference() on random
+ * streams (including full-range scales that clamp constantly), decoded in
+ * uneven chunks so predictor state must carry across calls.
  */
 #include <stdarg.h>
 #include <stddef.h>
 #include <setjmp.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include "cmocka.h"
 #include "port/sound/adx_decoder.h"
 
+#define STREAM_FRAMES 2048
+#define BENCH_PASSES 200
+
+static u8 s_stream[STREAM_FRAMES * 18 * 2];
+static s16 s_ref[STREAM_FRAMES * 32 * 2];
+static s16 s_out[STREAM_FRAMES * 32 * 2];
+static u32 s_rng;
+
+static u32 next_rand(void) {
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return s_rng >> 8;
+}
+
+/** Init @p ctx for an 18-byte-block stream with @p channels at @p rate. */
+static void init_ctx(ADXContext* ctx, int channels, u32 rate) {
+    u8 header[16] = {0};
+    header[0] = 0x80;
+    header[1] = 0x03;
+    header[3] = 0x0C;
+    header[5] = 18;
+    header[7] = (u8)channels;
+    header[8] = (u8)(rate >> 24);
+    header[9] = (u8)(rate >> 16);
+    header[10] = (u8)(rate >> 8);
+    header[11] = (u8)rate;
+    assert_int_equal(ADX_InitContext(ctx, header, 16), 0);
+}
+
+/** Fill s_stream with random blocks; scales mix quiet, typical and full-range values. */
+static void make_stream(u32 seed, int channels) {
+    s_rng = seed;
+
+    for (int b = 0; b < STREAM_FRAMES * channels; b++) {
+        u8* block = &s_stream[b * 18];
+        u32 scale;
+
+        switch (next_rand() % 4) {
+        case 0:
+            scale = next_rand() % 16;
+            break;
+        case 1:
+            scale = 0xFFFF - next_rand() % 16;
+            break;
+        default:
+            scale = next_rand() % 0x800;
+            break;
+        }
+
+        block[0] = (u8)(scale >> 8);
+        block[1] = (u8)scale;
+        for (int i = 2; i < 18; i++) {
+            block[i] = (u8)next_rand();
+        }
+    }
+}
+
+/** Decode the whole stream in chunks of @p chunk_frames with either decoder. */
+static void decode_stream(int channels, u32 rate, int chunk_frames, bool reference, s16* out) {
+    ADXContext ctx;
+    const int frame_size = 18 * channels;
+    const int frame_samples = 32 * channels;
+    int frame = 0;
+
+    init_ctx(&ctx, channels, rate);
+
+    while (frame < STREAM_FRAMES) {
+        const int n = chunk_frames < STREAM_FRAMES - frame ? chunk_frames : STREAM_FRAMES - frame;
+        s32 out_samples = n * frame_samples;
+        s32 consumed = 0;
+        int result;
+
+        if (reference) {
+            result = ADX_DecodeReference(&ctx, &s_stream[frame * frame_size], (size_t)n * frame_size,
+                                         &out[frame * frame_samples], &out_samples, &consumed);
+        } else {
+            result = ADX_Decode(&ctx, &s_stream[frame * frame_size], (size_t)n * frame_size,
+                                &out[frame * frame_samples], &out_samples, &consumed);
+        }
+
+        assert_int_equal(result, 0);
+        assert_int_equal(consumed, n * frame_size);
+        assert_int_equal(out_samples, n * frame_samples);
+        frame += n;
+    }
+}
+
 static void test_adx_init_valid_mono(void** state) {
     (void)state;
     ADXContext ctx;
@@ -174,6 +266,83 @@ static void test_adx_decode_synthetic_frame(void** state) {
     assert_int_equal(out[1], 2);
 }
 
+static void check_matches_reference(int channels, u32 rate) {
+    const size_t bytes = (size_t)STREAM_FRAMES * 32 * channels * sizeof(s16);
+
+    for (u32 seed = 1; seed <= 4; seed++) {
+        make_stream(seed * 0x9E3779B9u, channels);
+        decode_stream(channels, rate, STREAM_FRAMES, true, s_ref);
+        decode_stream(channels, rate, 1 + (int)seed * 13, false, s_out);
+        assert_memory_equal(s_out, s_ref, bytes);
+    }
+}
+
+static void test_adx_simd_matches_reference_mono(void** state) {
+    (void)state;
+    check_matches_reference(1, 44100);
+}
+
+static void test_adx_simd_matches_reference_stereo(void** state) {
+    (void)state;
+    check_matches_reference(2, 48000);
+    check_matches_reference(2, 22050);
+}
+
+static void test_adx_simd_extreme_nibbles(void** state) {
+    (void)state;
+    ADXContext ref_ctx;
+    ADXContext ctx;
+    u8 block[18 * 2];
+    s16 ref[64];
+    s16 out[64];
+    s32 ref_samples = 64;
+    s32 out_samples = 64;
+    s32 consumed = 0;
+
+    // 0x80 / 0x7F alternate the most negative and most positive nibbles at full scale
+    block[0] = block[18] = 0xFF;
+    block[1] = block[19] = 0xFF;
+    for (int i = 2; i < 18; i++) {
+        block[i] = (i & 1) ? 0x7F : 0x80;
+        block[i + 18] = 0x88;
+    }
+
+    init_ctx(&ref_ctx, 2, 48000);
+    init_ctx(&ctx, 2, 48000);
+    assert_int_equal(ADX_DecodeReference(&ref_ctx, block, sizeof(block), ref, &ref_samples, &consumed), 0);
+    assert_int_equal(ADX_Decode(&ctx, block, sizeof(block), out, &out_samples, &consumed), 0);
+    assert_int_equal(out_samples, ref_samples);
+    assert_memory_equal(out, ref, sizeof(ref));
+    assert_int_equal(out[1], -32768); // Right channel: first nibble -8 × 0xFFFF clamps
+    assert_memory_equal(&ctx.ch_state, &ref_ctx.ch_state, sizeof(ctx.ch_state));
+}
+
+/** Not a pass/fail gate: reports reference vs SIMD throughput on a stereo stream. */
+static void test_adx_decode_benchmark(void** state) {
+    (void)state;
+    clock_t start;
+    double ref_s;
+    double simd_s;
+
+    make_stream(0xBE4C4u, 2);
+
+    start = clock();
+    for (int i = 0; i < BENCH_PASSES; i++) {
+        decode_stream(2, 48000, 64, true, s_ref);
+    }
+    ref_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int i = 0; i < BENCH_PASSES; i++) {
+        decode_stream(2, 48000, 64, false, s_out);
+    }
+    simd_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    assert_memory_equal(s_out, s_ref, sizeof(s_ref));
+    printf("ADX decode, %d stereo frames x %d: reference %.1f ms, SIMD %.1f ms (%.2fx)\n", STREAM_FRAMES,
+           BENCH_PASSES, ref_s * 1000.0, simd_s * 1000.0, simd_s > 0.0 ? ref_s / simd_s : 0.0);
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_adx_init_valid_mono),
@@ -185,6 +354,10 @@ int main(void) {
         cmocka_unit_test(test_adx_decode_invalid_args),
         cmocka_unit_test(test_adx_decode_zero_frame_size),
         cmocka_unit_test(test_adx_decode_synthetic_frame),
+        cmocka_unit_test(test_adx_simd_matches_reference_mono),
+        cmocka_unit_test(test_adx_simd_matches_reference_stereo),
+        cmocka_unit_test(test_adx_simd_extreme_nibbles),
+        cmocka_unit_test(test_adx_decode_benchmark),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
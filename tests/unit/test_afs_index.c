@@ -0,0 +1,403 @@
+/**
+ * @file test_afs_index.c
+ * @brief Unit tests for the AFS sidecar index and background verification.
+ *
+ * Checks the XXH64 digests against reference values and across arbitrary
+ * streaming splits, that the index round-trips and is rejected when stale
+ * or damaged, and, on a synthetic archive, that the first launch writes
+ * the index, a verification pass records the digests, later launches load
+ * them, and damaged entries are reported with the lowest bad entry first.
+ * A damaged or replaced archive no longer matches its index; the digests
+ * must survive the rebuild instead of being re-recorded from the new bytes.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+#include <SDL3/SDL.h>
+
+#include "port/io/afs.h"
+#include "port/io/afs_index.h"
+
+#define ARCHIVE_PATH "test_afs_index.afs"
+#define INDEX_PATH ARCHIVE_PATH ".idx"
+#define SECTOR 2048
+#define ENTRY_COUNT 40
+
+static uint32_t s_offset[ENTRY_COUNT];
+static uint32_t s_size[ENTRY_COUNT];
+static uint32_t s_file_size;
+
+static uint32_t align_sector(uint32_t n) {
+    return (n + SECTOR - 1) & ~(uint32_t)(SECTOR - 1);
+}
+
+static void put_u32le(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void write_archive(uint32_t seed) {
+    uint32_t rng = seed;
+    uint32_t pos = align_sector(8 + ENTRY_COUNT * 8 + 8);
+    uint8_t* file;
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        rng = rng * 1664525u + 1013904223u;
+        s_size[i] = 1 + (rng >> 8) % (6 * SECTOR);
+        s_offset[i] = pos;
+        pos += align_sector(s_size[i]);
+    }
+
+    s_file_size = pos;
+    file = calloc(1, pos);
+    assert_non_null(file);
+    memcpy(file, "AFS", 4);
+    put_u32le(file + 4, ENTRY_COUNT);
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        put_u32le(file + 8 + i * 8, s_offset[i]);
+        put_u32le(file + 12 + i * 8, s_size[i]);
+
+        for (uint32_t j = 0; j < s_size[i]; j++) {
+            rng = rng * 1664525u + 1013904223u;
+            file[s_offset[i] + j] = (uint8_t)(rng >> 24);
+        }
+    }
+
+    FILE* f = fopen(ARCHIVE_PATH, "wb");
+    assert_non_null(f);
+    assert_int_equal(fwrite(file, 1, pos, f), pos);
+    fclose(f);
+    free(file);
+}
+
+static uint8_t* read_entry(int i) {
+    uint8_t* buf = malloc(s_size[i]);
+    FILE* f = fopen(ARCHIVE_PATH, "rb");
+
+    assert_non_null(buf);
+    assert_non_null(f);
+    assert_int_equal(fseek(f, (long)s_offset[i], SEEK_SET), 0);
+    assert_int_equal(fread(buf, 1, s_size[i], f), s_size[i]);
+    fclose(f);
+    return buf;
+}
+
+/** Overwrite one byte in the middle of entry @p i, keeping the archive's size. */
+static void damage_entry(int i) {
+    FILE* f = fopen(ARCHIVE_PATH, "r+b");
+    uint8_t b;
+
+    assert_non_null(f);
+    assert_int_equal(fseek(f, (long)(s_offset[i] + s_size[i] / 2), SEEK_SET), 0);
+    assert_int_equal(fread(&b, 1, 1, f), 1);
+    b ^= 0x5A;
+    assert_int_equal(fseek(f, (long)(s_offset[i] + s_size[i] / 2), SEEK_SET), 0);
+    assert_int_equal(fwrite(&b, 1, 1, f), 1);
+    fclose(f);
+}
+
+static AFSVerifyStats run_verify(void) {
+    AFSVerifyStats stats;
+
+    AFS_StartVerify();
+
+    for (int i = 0; i < 10000; i++) {
+        AFS_GetVerifyStats(&stats);
+
+        if (stats.done) {
+            return stats;
+        }
+
+        SDL_Delay(1);
+    }
+
+    fail();
+    return stats;
+}
+
+static int setup(void** state) {
+    (void)state;
+    remove(ARCHIVE_PATH);
+    remove(INDEX_PATH);
+    write_archive(99);
+    AFS_SetPreloadThreads(2);
+    return 0;
+}
+
+static int teardown(void** state) {
+    (void)state;
+    AFS_Finish();
+    AFS_SetMemoryMapped(true);
+    AFS_SetPreloadThreads(0);
+    remove(ARCHIVE_PATH);
+    remove(INDEX_PATH);
+    return 0;
+}
+
+static void test_digest_reference_values(void** state) {
+    (void)state;
+    uint8_t data[1000];
+
+    for (int i = 0; i < (int)sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    assert_true(AFSDigest("", 0, 0) == 0xEF46DB3751D8E999ull);
+    assert_true(AFSDigest("a", 1, 0) == 0xD24EC4F1A98C6E5Bull);
+    assert_true(AFSDigest("abc", 3, 0) == 0x44BC2CF5AD770999ull);
+    assert_true(AFSDigest(data, sizeof(data), 0) == 0x5F235FA033F1A3FBull);
+    assert_true(AFSDigest(data, 101, 0x9E3779B1) == 0x6C892CEEBBC660AAull);
+}
+
+static void test_digest_streaming_splits(void** state) {
+    (void)state;
+    static uint8_t data[5000];
+    uint32_t rng = 5;
+
+    for (int i = 0; i < (int)sizeof(data); i++) {
+        rng = rng * 1664525u + 1013904223u;
+        data[i] = (uint8_t)(rng >> 24);
+    }
+
+    for (int trial = 0; trial < 200; trial++) {
+        const size_t len = (trial * 37) % sizeof(data);
+        AFSDigestState digest;
+        size_t pos = 0;
+
+        AFSDigest_Reset(&digest, (uint64_t)trial);
+
+        while (pos < len) {
+            rng = rng * 1664525u + 1013904223u;
+            const size_t chunk = SDL_min((size_t)((rng >> 8) % 80), len - pos);
+
+            AFSDigest_Update(&digest, data + pos, chunk);
+            pos += chunk;
+        }
+
+        assert_true(AFSDigest_Final(&digest) == AFSDigest(data, len, (uint64_t)trial));
+    }
+}
+
+static void test_index_round_trip_and_rejects(void** state) {
+    (void)state;
+    AFSIndexEntry entries[3] = {
+        { 4096, 100, "one", 1, true }, { 8192, 5000, "two", 2, true }, { 0, 0, "", 3, false }
+    };
+    AFSIndex index = { 123456, 987654321, 3, true, entries };
+    AFSIndex loaded;
+    size_t size;
+    uint8_t* file;
+    FILE* f;
+
+    assert_true(AFSIndex_Save(INDEX_PATH, &index));
+    assert_true(AFSIndex_Load(INDEX_PATH, 123456, 987654321, &loaded));
+    assert_int_equal(loaded.entry_count, 3);
+    assert_true(loaded.has_digests);
+    assert_memory_equal(loaded.entries, entries, sizeof(entries));
+    AFSIndex_Free(&loaded);
+
+    // Written for another archive, but still readable for its digests
+    assert_false(AFSIndex_Load(INDEX_PATH, 123457, 987654321, &loaded));
+    assert_false(AFSIndex_Load(INDEX_PATH, 123456, 987654322, &loaded));
+    assert_null(loaded.entries);
+    assert_true(AFSIndex_LoadAny(INDEX_PATH, &loaded));
+    assert_true(loaded.archive_size == 123456);
+    assert_true(loaded.archive_mtime == 987654321);
+    assert_memory_equal(loaded.entries, entries, sizeof(entries));
+    AFSIndex_Free(&loaded);
+
+    // One damaged byte in the entry table
+    file = SDL_LoadFile(INDEX_PATH, &size);
+    assert_non_null(file);
+    file[size - 20] ^= 1;
+    f = fopen(INDEX_PATH, "wb");
+    assert_non_null(f);
+    assert_int_equal(fwrite(file, 1, size, f), size);
+    fclose(f);
+    assert_false(AFSIndex_Load(INDEX_PATH, 123456, 987654321, &loaded));
+    assert_false(AFSIndex_LoadAny(INDEX_PATH, &loaded));
+
+    // Truncated
+    f = fopen(INDEX_PATH, "wb");
+    assert_non_null(f);
+    assert_int_equal(fwrite(file, 1, size - 48, f), size - 48);
+    fclose(f);
+    assert_false(AFSIndex_Load(INDEX_PATH, 123456, 987654321, &loaded));
+    SDL_free(file);
+
+    assert_false(AFSIndex_Load("does_not_exist.idx", 0, 0, &loaded));
+}
+
+static void check_first_pass_records_digests(bool mapped) {
+    AFSVerifyStats stats;
+    AFSIndex index;
+    SDL_PathInfo info;
+    uint64_t content;
+
+    AFS_SetMemoryMapped(mapped);
+    assert_true(AFS_Init(ARCHIVE_PATH));
+    assert_true(SDL_GetPathInfo(ARCHIVE_PATH, &info));
+
+    // The first launch writes the table of contents, without digests
+    assert_true(AFSIndex_Load(INDEX_PATH, info.size, info.modify_time, &index));
+    assert_int_equal(index.entry_count, ENTRY_COUNT);
+    assert_false(index.has_digests);
+    AFSIndex_Free(&index);
+    assert_true(AFS_GetContentDigest() == 0);
+
+    stats = run_verify();
+    assert_int_equal(stats.total, ENTRY_COUNT);
+    assert_int_equal(stats.checked, ENTRY_COUNT);
+    assert_int_equal(stats.bad, 0);
+    assert_int_equal(stats.first_bad, -1);
+    content = AFS_GetContentDigest();
+    assert_true(content != 0);
+
+    // The index now has the digest of every entry's bytes
+    assert_true(AFSIndex_Load(INDEX_PATH, info.size, info.modify_time, &index));
+    assert_true(index.has_digests);
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        uint8_t* data = read_entry(i);
+
+        assert_int_equal(index.entries[i].offset, s_offset[i]);
+        assert_int_equal(index.entries[i].size, s_size[i]);
+        assert_true(index.entries[i].has_digest);
+        assert_true(index.entries[i].digest == AFSDigest(data, s_size[i], 0));
+        free(data);
+    }
+
+    AFSIndex_Free(&index);
+
+    // The next launch takes the table of contents and digests from the index
+    AFS_Finish();
+    assert_true(AFS_Init(ARCHIVE_PATH));
+    assert_true(AFS_GetContentDigest() == content);
+    assert_int_equal(AFS_GetFileCount(), ENTRY_COUNT);
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        assert_int_equal(AFS_GetSize(i), s_size[i]);
+    }
+
+    stats = run_verify();
+    assert_int_equal(stats.bad, 0);
+}
+
+static void test_first_pass_records_digests_mapped(void** state) {
+    (void)state;
+    check_first_pass_records_digests(true);
+}
+
+static void test_first_pass_records_digests_read(void** state) {
+    (void)state;
+    check_first_pass_records_digests(false);
+}
+
+static void test_verify_reports_first_bad_entry(void** state) {
+    (void)state;
+    AFSVerifyStats stats;
+    SDL_PathInfo after;
+    AFSIndex index;
+    uint64_t good[ENTRY_COUNT];
+
+    AFS_SetMemoryMapped(false);
+    assert_true(AFS_Init(ARCHIVE_PATH));
+    run_verify();
+    AFS_Finish();
+
+    // Damage two entries. Writing the archive changes its mtime, which makes the index stale;
+    // timestamps can be coarse, so age the index to be sure
+    damage_entry(23);
+    damage_entry(9);
+    assert_true(SDL_GetPathInfo(ARCHIVE_PATH, &after));
+    assert_true(AFSIndex_LoadAny(INDEX_PATH, &index));
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        good[i] = index.entries[i].digest;
+    }
+
+    index.archive_mtime = after.modify_time - 1;
+    assert_true(AFSIndex_Save(INDEX_PATH, &index));
+    AFSIndex_Free(&index);
+
+    for (int launch = 0; launch < 2; launch++) {
+        assert_true(AFS_Init(ARCHIVE_PATH));
+        stats = run_verify();
+        assert_int_equal(stats.bad, 2);
+        assert_int_equal(stats.first_bad, 9);
+
+        // The rebuilt index keeps the digests of the good archive, not the damaged one
+        assert_true(AFSIndex_Load(INDEX_PATH, after.size, after.modify_time, &index));
+        assert_true(index.has_digests);
+
+        for (int i = 0; i < ENTRY_COUNT; i++) {
+            assert_true(index.entries[i].has_digest);
+            assert_true(index.entries[i].digest == good[i]);
+        }
+
+        AFSIndex_Free(&index);
+        AFS_Finish();
+    }
+}
+
+static void test_stale_index_is_rebuilt(void** state) {
+    (void)state;
+    AFSVerifyStats stats;
+    uint32_t old_size[ENTRY_COUNT];
+
+    assert_true(AFS_Init(ARCHIVE_PATH));
+    run_verify();
+    AFS_Finish();
+    memcpy(old_size, s_size, sizeof(old_size));
+
+    // A different archive under the same name
+    write_archive(1234);
+    assert_memory_not_equal(old_size, s_size, sizeof(old_size));
+    assert_true(AFS_Init(ARCHIVE_PATH));
+    assert_true(AFS_GetContentDigest() == 0);
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        assert_int_equal(AFS_GetSize(i), s_size[i]);
+    }
+
+    // Every entry moved, so none has a digest to check against; the pass reports them instead of recording them
+    stats = run_verify();
+    assert_int_equal(stats.bad, ENTRY_COUNT);
+    assert_int_equal(stats.first_bad, 0);
+    assert_true(AFS_GetContentDigest() == 0);
+    AFS_Finish();
+
+    assert_true(AFS_Init(ARCHIVE_PATH));
+    stats = run_verify();
+    assert_int_equal(stats.bad, ENTRY_COUNT);
+    AFS_Finish();
+
+    // Deleting the index accepts the new archive
+    remove(INDEX_PATH);
+    assert_true(AFS_Init(ARCHIVE_PATH));
+    stats = run_verify();
+    assert_int_equal(stats.bad, 0);
+    assert_true(AFS_GetContentDigest() != 0);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_digest_reference_values),
+        cmocka_unit_test(test_digest_streaming_splits),
+        cmocka_unit_test_setup_teardown(test_index_round_trip_and_rejects, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_first_pass_records_digests_mapped, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_first_pass_records_digests_read, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_verify_reports_first_bad_entry, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_stale_index_is_rebuilt, setup, teardown),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
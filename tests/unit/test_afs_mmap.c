@@ -0,0 +1,236 @@
+/**
+ * @file test_afs_mmap.c
+ * @brief Unit tests for the mapped AFS reader against the preloading one.
+ *
+ * Builds a small synthetic archive with entries inside the streamed BGM
+ * range and one entry whose sector padding runs past the end of the file,
+ * then reads every entry with mapping off and on and checks both modes
+ * return the same bytes. Set SF3_AFS_PATH to also compare a real archive.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include "port/io/afs.h"
+
+#define ARCHIVE_PATH "test_afs_mmap.afs"
+#define SECTOR 2048
+#define ENTRY_COUNT 96    // 91..95 fall in the streamed BGM range
+#define TAIL_ENTRY 42     // Stored last, unpadded: can't be mapped
+#define BGM_START_INDEX 91
+
+static uint32_t s_offset[ENTRY_COUNT];
+static uint32_t s_size[ENTRY_COUNT];
+static uint8_t* s_data[ENTRY_COUNT];
+
+static uint32_t align_sector(uint32_t n) {
+    return (n + SECTOR - 1) & ~(uint32_t)(SECTOR - 1);
+}
+
+static void put_u32le(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void write_archive(void) {
+    const uint32_t header_size = align_sector(8 + ENTRY_COUNT * 8 + 8);
+    uint32_t rng = 12345;
+    uint32_t pos = header_size;
+    uint32_t file_size;
+    uint8_t* file;
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        rng = rng * 1664525u + 1013904223u;
+        s_size[i] = 1 + (rng >> 8) % (3 * SECTOR); // Mix of partial, exact and multi-sector entries
+    }
+    s_size[1] = SECTOR;
+    s_size[TAIL_ENTRY] = SECTOR + 100;
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        if (i != TAIL_ENTRY) {
+            s_offset[i] = pos;
+            pos += align_sector(s_size[i]);
+        }
+    }
+    s_offset[TAIL_ENTRY] = pos;
+    file_size = pos + s_size[TAIL_ENTRY];
+
+    file = calloc(1, file_size);
+    assert_non_null(file);
+    file[0] = 'A';
+    file[1] = 'F';
+    file[2] = 'S';
+    file[3] = 0;
+    put_u32le(file + 4, ENTRY_COUNT);
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        put_u32le(file + 8 + i * 8, s_offset[i]);
+        put_u32le(file + 12 + i * 8, s_size[i]);
+
+        s_data[i] = malloc(s_size[i]);
+        assert_non_null(s_data[i]);
+
+        for (uint32_t j = 0; j < s_size[i]; j++) {
+            rng = rng * 1664525u + 1013904223u;
+            s_data[i][j] = (uint8_t)(rng >> 24);
+        }
+
+        memcpy(file + s_offset[i], s_data[i], s_size[i]);
+    }
+
+    FILE* f = fopen(ARCHIVE_PATH, "wb");
+    assert_non_null(f);
+    assert_int_equal(fwrite(file, 1, file_size, f), file_size);
+    fclose(f);
+    free(file);
+}
+
+static int setup(void** state) {
+    (void)state;
+    remove(ARCHIVE_PATH);
+    remove(ARCHIVE_PATH ".idx");
+    write_archive();
+    return 0;
+}
+
+static int teardown(void** state) {
+    (void)state;
+    AFS_Finish();
+    AFS_SetMemoryMapped(true);
+    remove(ARCHIVE_PATH);
+    remove(ARCHIVE_PATH ".idx");
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        free(s_data[i]);
+        s_data[i] = NULL;
+    }
+
+    return 0;
+}
+
+/** Read entry @p file_num through the handle API; returns a malloc'd sector-padded buffer. */
+static uint8_t* read_entry(int file_num) {
+    const AFSHandle handle = AFS_Open(file_num);
+    uint8_t* buf;
+
+    assert_int_not_equal(handle, AFS_NONE);
+    const unsigned int sectors = AFS_GetSectorCount(handle);
+    buf = calloc(sectors ? sectors : 1, SECTOR);
+    assert_non_null(buf);
+
+    AFS_ReadSync(handle, (int)sectors, buf);
+    assert_int_equal(AFS_GetState(handle), AFS_READ_STATE_FINISHED);
+    AFS_Close(handle);
+    return buf;
+}
+
+static void check_synthetic_entries(void) {
+    assert_int_equal(AFS_GetFileCount(), ENTRY_COUNT);
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        uint8_t* buf = read_entry(i);
+
+        assert_int_equal(AFS_GetSize(i), s_size[i]);
+        assert_memory_equal(buf, s_data[i], s_size[i]);
+        free(buf);
+    }
+}
+
+static void test_preloaded_reads(void** state) {
+    (void)state;
+
+    AFS_SetMemoryMapped(false);
+    assert_true(AFS_Init(ARCHIVE_PATH));
+    assert_false(AFS_IsMemoryMapped());
+    check_synthetic_entries();
+}
+
+static void test_mapped_reads_match(void** state) {
+    (void)state;
+
+    AFS_SetMemoryMapped(true);
+    assert_true(AFS_Init(ARCHIVE_PATH));
+    assert_true(AFS_IsMemoryMapped());
+    check_synthetic_entries();
+}
+
+static void test_entry_pointers(void** state) {
+    (void)state;
+
+    AFS_SetMemoryMapped(true);
+    assert_true(AFS_Init(ARCHIVE_PATH));
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        const uint8_t* p = AFS_GetEntryPointer(i);
+
+        if (i >= BGM_START_INDEX) {
+            // Streamed, never resident
+            assert_null(p);
+        } else if (i == TAIL_ENTRY) {
+            // Left to the preload thread: either not there yet or a heap copy
+            if (p != NULL) {
+                assert_memory_equal(p, s_data[i], s_size[i]);
+            }
+        } else {
+            assert_non_null(p);
+            assert_memory_equal(p, s_data[i], s_size[i]);
+        }
+    }
+
+    assert_null(AFS_GetEntryPointer(-1));
+    assert_null(AFS_GetEntryPointer(ENTRY_COUNT));
+}
+
+static void test_real_archive_matches(void** state) {
+    (void)state;
+    const char* path = getenv("SF3_AFS_PATH");
+    uint8_t** preloaded;
+    unsigned int count;
+
+    if (path == NULL) {
+        print_message("SF3_AFS_PATH not set, skipping real archive comparison\n");
+        return;
+    }
+
+    AFS_SetMemoryMapped(false);
+    assert_true(AFS_Init(path));
+    count = AFS_GetFileCount();
+    preloaded = calloc(count, sizeof(*preloaded));
+    assert_non_null(preloaded);
+
+    for (unsigned int i = 0; i < count; i++) {
+        preloaded[i] = read_entry((int)i);
+    }
+
+    AFS_Finish();
+    AFS_SetMemoryMapped(true);
+    assert_true(AFS_Init(path));
+
+    for (unsigned int i = 0; i < count; i++) {
+        uint8_t* buf = read_entry((int)i);
+
+        assert_memory_equal(buf, preloaded[i], AFS_GetSize((int)i));
+        free(buf);
+        free(preloaded[i]);
+    }
+
+    free(preloaded);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_preloaded_reads, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_mapped_reads_match, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_entry_pointers, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_real_archive_matches, setup, teardown),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
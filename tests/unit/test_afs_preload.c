@@ -0,0 +1,223 @@
+/**
+ * @file test_afs_preload.c
+ * @brief Unit tests for the prioritized AFS preloader.
+ *
+ * Preloads a synthetic archive with mapping off, so every non-BGM entry
+ * goes through the reader pool, and checks that each one ends up identical
+ * to a plain sequential read of the file. Also checks the hit/miss
+ * counters and that hints are ignored for entries that can't be preloaded.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+#include <SDL3/SDL.h>
+
+#include "port/io/afs.h"
+
+#define ARCHIVE_PATH "test_afs_preload.afs"
+#define SECTOR 2048
+#define ENTRY_COUNT 120 // 91..119 fall in the streamed BGM range
+#define BGM_START_INDEX 91
+#define PRELOADABLE BGM_START_INDEX
+
+static uint32_t s_offset[ENTRY_COUNT];
+static uint32_t s_size[ENTRY_COUNT];
+
+static uint32_t align_sector(uint32_t n) {
+    return (n + SECTOR - 1) & ~(uint32_t)(SECTOR - 1);
+}
+
+static void put_u32le(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void write_archive(void) {
+    uint32_t rng = 777;
+    uint32_t pos = align_sector(8 + ENTRY_COUNT * 8 + 8);
+    uint8_t* file;
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        rng = rng * 1664525u + 1013904223u;
+        s_size[i] = 1 + (rng >> 8) % (24 * SECTOR);
+        s_offset[i] = pos;
+        pos += align_sector(s_size[i]);
+    }
+
+    file = calloc(1, pos);
+    assert_non_null(file);
+    memcpy(file, "AFS", 4);
+    put_u32le(file + 4, ENTRY_COUNT);
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        put_u32le(file + 8 + i * 8, s_offset[i]);
+        put_u32le(file + 12 + i * 8, s_size[i]);
+
+        for (uint32_t j = 0; j < s_size[i]; j++) {
+            rng = rng * 1664525u + 1013904223u;
+            file[s_offset[i] + j] = (uint8_t)(rng >> 24);
+        }
+    }
+
+    FILE* f = fopen(ARCHIVE_PATH, "wb");
+    assert_non_null(f);
+    assert_int_equal(fwrite(file, 1, pos, f), pos);
+    fclose(f);
+    free(file);
+}
+
+/** Entry @p file_num read straight from the archive file; caller frees. */
+static uint8_t* read_sequential(FILE* f, int file_num) {
+    uint8_t* buf = malloc(s_size[file_num]);
+
+    assert_non_null(buf);
+    assert_int_equal(fseek(f, (long)s_offset[file_num], SEEK_SET), 0);
+    assert_int_equal(fread(buf, 1, s_size[file_num], f), s_size[file_num]);
+    return buf;
+}
+
+static void wait_for_preload(void) {
+    AFSPreloadStats stats;
+
+    for (int i = 0; i < 10000; i++) {
+        AFS_GetPreloadStats(&stats);
+
+        if (stats.done) {
+            return;
+        }
+
+        SDL_Delay(1);
+    }
+
+    fail();
+}
+
+static int setup(void** state) {
+    (void)state;
+    remove(ARCHIVE_PATH);
+    remove(ARCHIVE_PATH ".idx");
+    write_archive();
+    AFS_SetMemoryMapped(false);
+    return 0;
+}
+
+static int teardown(void** state) {
+    (void)state;
+    AFS_Finish();
+    AFS_SetMemoryMapped(true);
+    AFS_SetPreloadThreads(0);
+    remove(ARCHIVE_PATH);
+    remove(ARCHIVE_PATH ".idx");
+    return 0;
+}
+
+static void check_preloaded_matches_sequential(int threads) {
+    AFSPreloadStats stats;
+    FILE* f;
+
+    AFS_SetPreloadThreads(threads);
+    assert_true(AFS_Init(ARCHIVE_PATH));
+
+    // Hint from the far end so the pool serves out of index order
+    for (int i = PRELOADABLE - 1; i >= PRELOADABLE - 8; i--) {
+        AFS_Hint(i);
+    }
+
+    wait_for_preload();
+    AFS_GetPreloadStats(&stats);
+    assert_int_equal(stats.total, PRELOADABLE);
+    assert_int_equal(stats.loaded, PRELOADABLE);
+
+    f = fopen(ARCHIVE_PATH, "rb");
+    assert_non_null(f);
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        const uint8_t* p = AFS_GetEntryPointer(i);
+
+        if (i >= BGM_START_INDEX) {
+            assert_null(p);
+            continue;
+        }
+
+        uint8_t* expected = read_sequential(f, i);
+
+        assert_non_null(p);
+        assert_memory_equal(p, expected, s_size[i]);
+        free(expected);
+    }
+
+    fclose(f);
+}
+
+static void test_single_reader_matches_sequential(void** state) {
+    (void)state;
+    check_preloaded_matches_sequential(1);
+}
+
+static void test_reader_pool_matches_sequential(void** state) {
+    (void)state;
+    check_preloaded_matches_sequential(4);
+}
+
+static void test_hits_after_preload(void** state) {
+    (void)state;
+    AFSPreloadStats before;
+    AFSPreloadStats after;
+    uint8_t* buf = malloc(24 * SECTOR);
+
+    assert_non_null(buf);
+    AFS_SetPreloadThreads(2);
+    assert_true(AFS_Init(ARCHIVE_PATH));
+    wait_for_preload();
+    AFS_GetPreloadStats(&before);
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        const AFSHandle handle = AFS_Open(i);
+
+        AFS_ReadSync(handle, (int)AFS_GetSectorCount(handle), buf);
+        AFS_Close(handle);
+    }
+
+    // BGM reads are streamed and never counted
+    AFS_GetPreloadStats(&after);
+    assert_int_equal(after.hits - before.hits, PRELOADABLE);
+    assert_int_equal(after.misses, before.misses);
+    free(buf);
+}
+
+static void test_hint_ignores_unpreloadable(void** state) {
+    (void)state;
+    AFSPreloadStats before;
+    AFSPreloadStats after;
+
+    AFS_SetPreloadThreads(1);
+    assert_true(AFS_Init(ARCHIVE_PATH));
+    wait_for_preload();
+    AFS_GetPreloadStats(&before);
+
+    AFS_Hint(-1);
+    AFS_Hint(ENTRY_COUNT);
+    AFS_Hint(BGM_START_INDEX);
+    AFS_Hint(0); // Already resident
+
+    AFS_GetPreloadStats(&after);
+    assert_int_equal(after.bumps, before.bumps);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_single_reader_matches_sequential, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_reader_pool_matches_sequential, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_hits_after_preload, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_hint_ignores_unpreloadable, setup, teardown),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,153 @@
+/**
+ * @file test_cmd_queue.c
+ * @brief Unit tests for the SPSC sound command queue.
+ *
+ * The stress tests run a producer thread against a consumer on the main
+ * thread with a deliberately small queue, so both sides constantly hit
+ * the full / empty edges, and check that every record arrives intact and
+ * in order.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+#include "cmocka.h"
+#include "port/sound/cmd_queue.h"
+
+#define STRESS_RECORDS 200000
+
+typedef struct {
+    u32 seq;
+    u32 check;
+    u8 pad[24]; // Make a torn record visible in more than one word
+} Record;
+
+typedef struct {
+    CmdQueue* q;
+    u32 count;
+} ProducerArgs;
+
+static u32 check_of(u32 seq) {
+    return seq * 2654435761u ^ 0xA5A5A5A5u;
+}
+
+static void fill_record(Record* r, u32 seq) {
+    r->seq = seq;
+    r->check = check_of(seq);
+    memset(r->pad, (int)(seq & 0xFF), sizeof(r->pad));
+}
+
+static void assert_record(const Record* r, u32 seq) {
+    assert_int_equal(r->seq, seq);
+    assert_int_equal(r->check, check_of(seq));
+    for (size_t i = 0; i < sizeof(r->pad); i++) {
+        assert_int_equal(r->pad[i], seq & 0xFF);
+    }
+}
+
+static int producer_main(void* data) {
+    ProducerArgs* args = data;
+
+    for (u32 seq = 0; seq < args->count; seq++) {
+        Record* slot;
+
+        // A full queue is reported immediately; the producer decides what to do
+        while ((slot = CmdQueue_Reserve(args->q)) == NULL) {
+            SDL_Delay(0);
+        }
+
+        fill_record(slot, seq);
+        CmdQueue_Push(args->q);
+    }
+
+    return 0;
+}
+
+static void test_fifo_and_wraparound(void** state) {
+    (void)state;
+    Record storage[8];
+    CmdQueue q;
+    u32 next_push = 0;
+    u32 next_pop = 0;
+
+    CmdQueue_Init(&q, storage, sizeof(Record), 8);
+    assert_null(CmdQueue_Peek(&q));
+
+    for (int round = 0; round < 100; round++) {
+        // Fill to capacity, then one more must be refused
+        while (CmdQueue_Count(&q) < 8) {
+            Record* slot = CmdQueue_Reserve(&q);
+            assert_non_null(slot);
+            fill_record(slot, next_push++);
+            CmdQueue_Push(&q);
+        }
+        assert_null(CmdQueue_Reserve(&q));
+
+        // Drain a varying amount so the indices wrap at different offsets
+        for (int n = 0; n < 1 + round % 8; n++) {
+            const Record* r = CmdQueue_Peek(&q);
+            assert_non_null(r);
+            assert_record(r, next_pop++);
+            CmdQueue_Pop(&q);
+        }
+    }
+
+    while (CmdQueue_Count(&q) > 0) {
+        assert_record(CmdQueue_Peek(&q), next_pop++);
+        CmdQueue_Pop(&q);
+    }
+
+    assert_null(CmdQueue_Peek(&q));
+    assert_int_equal(next_pop, next_push);
+}
+
+static void run_stress(u32 capacity) {
+    static Record storage[64];
+    CmdQueue q;
+    ProducerArgs args = { &q, STRESS_RECORDS };
+    SDL_Thread* producer;
+    u32 expect = 0;
+
+    assert_true(capacity <= 64);
+    CmdQueue_Init(&q, storage, sizeof(Record), capacity);
+
+    producer = SDL_CreateThread(producer_main, "cmdq_producer", &args);
+    assert_non_null(producer);
+
+    while (expect < STRESS_RECORDS) {
+        const Record* r = CmdQueue_Peek(&q);
+
+        if (!r) {
+            SDL_Delay(0); // Let the producer run on single-core machines
+            continue;
+        }
+
+        assert_record(r, expect++);
+        CmdQueue_Pop(&q);
+    }
+
+    SDL_WaitThread(producer, NULL);
+    assert_null(CmdQueue_Peek(&q));
+    assert_int_equal(CmdQueue_Count(&q), 0);
+}
+
+static void test_concurrent_stress_small_queue(void** state) {
+    (void)state;
+    run_stress(4);
+}
+
+static void test_concurrent_stress_large_queue(void** state) {
+    (void)state;
+    run_stress(64);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_fifo_and_wraparound),
+        cmocka_unit_test(test_concurrent_stress_small_queue),
+        cmocka_unit_test(test_concurrent_stress_large_queue),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
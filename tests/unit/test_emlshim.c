@@ -0,0 +1,254 @@
+/**
+ * @file test_emlshim.c
+ * @brief Unit tests for emlShim voice allocation, stealing and tick updates.
+ *
+ * The SPU runs offline, so every shim command applies immediately on the
+ * test thread. Voices are told apart by the volume each SE was started
+ * with, read back through SPU_VoiceGetConf(). The last test is a dense SE
+ * burst microbenchmark (reported, not gated).
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "cmocka.h"
+#include "port/sound/emlShim.h"
+#include "port/sound/spu.h"
+
+#define VOICES 48
+#define TICK_SAMPLES 192 // One 250 Hz workTick
+#define FRAME_SAMPLES 805
+#define BENCH_FRAMES 600
+#define BENCH_BURST 24
+
+static u16 s_sample[8 * 4];
+static s16 s_out[FRAME_SAMPLES * 2];
+
+static int setup(void** state) {
+    (void)state;
+
+    // Four ADPCM blocks looping forever: silence is fine, only the envelope matters
+    memset(s_sample, 0, sizeof(s_sample));
+    s_sample[0] = 0x400;     // loop start
+    s_sample[8 * 3] = 0x300; // end + repeat
+
+    SPU_SetOffline(true);
+    SPU_Reset();
+    emlShimInit();
+    SPU_Upload(0, s_sample, sizeof(s_sample));
+    return 0;
+}
+
+static void start_se(u8 prio, u8 vol, u8 bank) {
+    CSE_SYS_PARAM_SNDSTART param;
+
+    memset(&param, 0, sizeof(param));
+    param.reqp.prio = prio;
+    param.reqp.bank = bank;
+    param.reqp.vol = 0x7f;
+    param.reqp.pan = 64;
+    param.phdp.vol = vol;
+    param.phdp.pan = 64;
+    param.phdp.freq = 48000;
+    param.phdp.adsr1 = 0x000F; // Fastest attack, full sustain
+    param.phdp.adsr2 = 0x1FC0; // Sustain holds until key-off
+    emlShimStartSound(&param);
+}
+
+/** Voice currently configured with the left volume an SE of @p vol gets, or -1. */
+static int find_voice(u8 vol) {
+    const int volume = (0x3fff * ((vol * 0x3fff) / 0x7f)) / 0x3fff;
+    const u32 voll = (u32)((volume * 63) / 127) << 1;
+    int found = -1;
+
+    for (int v = 0; v < VOICES; v++) {
+        struct SPUVConf conf;
+
+        SPU_VoiceGetConf(v, &conf);
+        if (conf.voll == voll) {
+            assert_int_equal(found, -1);
+            found = v;
+        }
+    }
+
+    return found;
+}
+
+static void render_ticks(int ticks) {
+    for (int i = 0; i < ticks; i++) {
+        SPU_RenderOffline(s_out, TICK_SAMPLES);
+    }
+}
+
+static void test_full_pool_steals_lowest_prio(void** state) {
+    (void)state;
+
+    for (int i = 0; i < VOICES; i++) {
+        start_se((u8)(10 + (i * 7) % VOICES), (u8)(10 + i), 0);
+    }
+
+    const int victim = find_voice(10); // SE 0 has the lowest prio (10)
+    assert_true(victim >= 0);
+
+    start_se(100, 100, 0);
+    assert_int_equal(find_voice(100), victim);
+    assert_int_equal(find_voice(10), -1);
+
+    // Everyone else kept their voice
+    for (int i = 1; i < VOICES; i++) {
+        assert_true(find_voice((u8)(10 + i)) >= 0);
+    }
+}
+
+static void test_equal_prio_steals_oldest_then_newest(void** state) {
+    (void)state;
+
+    // First half is one tick older than the second half
+    for (int i = 0; i < VOICES / 2; i++) {
+        start_se(50, (u8)(10 + i), 0);
+    }
+    render_ticks(1);
+    for (int i = VOICES / 2; i < VOICES; i++) {
+        start_se(50, (u8)(10 + i), 0);
+    }
+
+    // Oldest tick wins; among equally old voices the latest allocation goes first
+    const int victim = find_voice(10 + VOICES / 2 - 1);
+    assert_true(victim >= 0);
+    start_se(50, 100, 0);
+    assert_int_equal(find_voice(100), victim);
+}
+
+static void test_stopped_voices_are_reused_before_stealing(void** state) {
+    (void)state;
+    CSE_REQP stop;
+
+    for (int i = 0; i < VOICES; i++) {
+        start_se(50, (u8)(10 + i), (u8)(i == 20));
+    }
+
+    // Stop bank 1 only (flags & 4 matches on bank)
+    memset(&stop, 0, sizeof(stop));
+    stop.flags = 4;
+    stop.bank = 1;
+    emlShimSeStop(&stop);
+
+    const int freed = find_voice(30);
+    start_se(1, 100, 0);
+    assert_int_equal(find_voice(100), freed);
+
+    // Nothing with a real SE was stolen
+    for (int i = 0; i < VOICES; i++) {
+        if (i != 20) {
+            assert_true(find_voice((u8)(10 + i)) >= 0);
+        }
+    }
+}
+
+static void test_volume_change_reaches_idle_voices(void** state) {
+    (void)state;
+    CSE_SYS_PARAM_BANKVOL vol = { 0 };
+    struct SPUVConf before;
+    struct SPUVConf after;
+
+    start_se(50, 0x7f, 0);
+    const int v = find_voice(0x7f);
+    assert_true(v >= 0);
+    render_ticks(2);
+    SPU_VoiceGetConf(v, &before);
+
+    // No LFO and no new SE: only the dirty flag can make the tick refresh this voice
+    vol.bank = 0xff;
+    vol.vol = 0x40;
+    emlShimSysSetVolume(&vol);
+    render_ticks(1);
+
+    SPU_VoiceGetConf(v, &after);
+    assert_true(after.voll < before.voll);
+    assert_true(after.voll > 0);
+}
+
+static void test_lfo_moves_pitch(void** state) {
+    (void)state;
+    CSE_SYS_PARAM_LFO lfo = { 0 };
+    struct SPUVConf conf;
+    u32 base_pitch;
+    bool moved = false;
+
+    start_se(50, 0x7f, 0);
+    const int v = find_voice(0x7f);
+    assert_true(v >= 0);
+    SPU_VoiceGetConf(v, &conf);
+    base_pitch = conf.pitch;
+
+    lfo.pmd_speed = 0x4000;
+    lfo.pmd_depth = 0x7fff;
+    emlShimSeSetLfo(&lfo);
+
+    for (int t = 0; t < 16 && !moved; t++) {
+        render_ticks(1);
+        SPU_VoiceGetConf(v, &conf);
+        moved = conf.pitch != base_pitch;
+    }
+    assert_true(moved);
+}
+
+/** Not a pass/fail gate: dense bursts of SEs with limits, as in hit sparks and super freezes. */
+static void test_se_burst_benchmark(void** state) {
+    (void)state;
+    clock_t start_total;
+    clock_t spent_starts = 0;
+    u32 rng = 1;
+
+    start_total = clock();
+    for (int f = 0; f < BENCH_FRAMES; f++) {
+        const clock_t t0 = clock();
+
+        for (int n = 0; n < BENCH_BURST; n++) {
+            CSE_SYS_PARAM_SNDSTART param;
+
+            rng = rng * 1664525u + 1013904223u;
+            memset(&param, 0, sizeof(param));
+            param.reqp.prio = (u8)(rng >> 24);
+            param.reqp.bank = (u8)((rng >> 8) & 3);
+            param.reqp.flags = (rng & 0x100) ? 4 : 0;
+            param.reqp.limit = (rng & 0x200) ? 4 : 0;
+            param.reqp.vol = 0x7f;
+            param.reqp.pan = 64;
+            param.phdp.vol = 0x60;
+            param.phdp.pan = (u8)(rng >> 16 & 0x7f);
+            param.phdp.freq = 48000;
+            param.phdp.adsr1 = 0x000F;
+            param.phdp.adsr2 = 0x1FC0;
+            emlShimStartSound(&param);
+        }
+
+        spent_starts += clock() - t0;
+        SPU_RenderOffline(s_out, FRAME_SAMPLES);
+    }
+
+    const double total_ms = (double)(clock() - start_total) * 1000.0 / CLOCKS_PER_SEC;
+    const double start_ms = (double)spent_starts * 1000.0 / CLOCKS_PER_SEC;
+    printf("emlShim burst: %d frames x %d SEs: starts %.1f ms (%.0f ns/SE), total with mixing %.1f ms\n",
+           BENCH_FRAMES,
+           BENCH_BURST,
+           start_ms,
+           start_ms * 1e6 / (BENCH_FRAMES * BENCH_BURST),
+           total_ms);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup(test_full_pool_steals_lowest_prio, setup),
+        cmocka_unit_test_setup(test_equal_prio_steals_oldest_then_newest, setup),
+        cmocka_unit_test_setup(test_stopped_voices_are_reused_before_stealing, setup),
+        cmocka_unit_test_setup(test_volume_change_reaches_idle_voices, setup),
+        cmocka_unit_test_setup(test_lfo_moves_pitch, setup),
+        cmocka_unit_test_setup(test_se_burst_benchmark, setup),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,192 @@
+/**
+ * @file test_heap_stats.c
+ * @brief Unit tests for the MemMan and memmgr heap statistics.
+ *
+ * Checks live/peak bytes, allocation counters and the largest free block
+ * (from the gap index and from a cell walk) for MemMan heaps, and the
+ * hole search and compaction accounting of the AcrSDK memory manager.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include "common.h"
+#include "sf33rd/AcrSDK/common/memmgr.h"
+#include "sf33rd/Source/Common/MemMan.h"
+
+#define HEAP_SIZE 0x10000
+#define UNIT ALIGN_UP(sizeof(_MEMMAN_CELL), 16)
+#define BLOCK_COUNT 16
+
+static u8 s_heap[HEAP_SIZE] __attribute__((aligned(64)));
+
+static void check_memman_stats(s32 indexed) {
+    _MEMMAN_OBJ mmobj;
+    MMHeapStats stats;
+    u8* a;
+    u8* b;
+    u8* c;
+
+    mmSetGapIndexEnabled(indexed);
+    mmHeapInitialize(&mmobj, s_heap, HEAP_SIZE, UNIT, (s8*)"- for Test -");
+    mmSetGapIndexEnabled(1);
+
+    mmGetStats(&mmobj, &stats);
+    assert_string_equal(stats.name, "- for Test -");
+    assert_int_equal(stats.size, HEAP_SIZE - UNIT * 2);
+    assert_int_equal(stats.live, 0);
+    assert_int_equal(stats.largest_free, stats.size);
+
+    a = mmAlloc(&mmobj, 0x1000, 0);
+    b = mmAlloc(&mmobj, 0x2000, 0);
+    c = mmAlloc(&mmobj, 0x1000, 0);
+    assert_non_null(a);
+    assert_non_null(b);
+    assert_non_null(c);
+    assert_null(mmAlloc(&mmobj, HEAP_SIZE, 0));
+
+    // Free the middle block: free space is now split in two
+    mmFree(&mmobj, b);
+    mmGetStats(&mmobj, &stats);
+    assert_int_equal(stats.live, (0x1000 + UNIT) * 2);
+    assert_int_equal(stats.peak, (0x1000 + UNIT) * 2 + 0x2000 + UNIT);
+    assert_int_equal(stats.blocks, 2);
+    assert_int_equal(stats.allocs, 3);
+    assert_int_equal(stats.frees, 1);
+    assert_int_equal(stats.failures, 1);
+    assert_int_equal(stats.largest_free, stats.size - (0x1000 + UNIT) * 2 - (0x2000 + UNIT));
+
+    mmFree(&mmobj, c);
+    mmGetStats(&mmobj, &stats);
+    assert_int_equal(stats.largest_free, stats.size - (0x1000 + UNIT));
+
+    mmFree(&mmobj, a);
+    mmGetStats(&mmobj, &stats);
+    assert_int_equal(stats.live, 0);
+    assert_int_equal(stats.blocks, 0);
+    assert_int_equal(stats.largest_free, stats.size);
+}
+
+static void test_memman_stats_indexed(void** state) {
+    (void)state;
+    check_memman_stats(1);
+}
+
+static void test_memman_stats_walked(void** state) {
+    (void)state;
+    check_memman_stats(0);
+}
+
+static void test_memman_heap_list(void** state) {
+    (void)state;
+    static _MEMMAN_OBJ heaps[10];
+    static u8 bufs[10][1024] __attribute__((aligned(64)));
+    const s32 before = mmGetHeapCount();
+
+    // Re-initialising a listed heap doesn't list it twice
+    mmHeapInitialize(&heaps[0], bufs[0], sizeof(bufs[0]), UNIT, (s8*)"a");
+    mmHeapInitialize(&heaps[0], bufs[0], sizeof(bufs[0]), UNIT, (s8*)"a");
+    assert_int_equal(mmGetHeapCount(), (before < 8) ? before + 1 : 8);
+
+    // Only the most recent heaps are kept
+    for (s32 i = 1; i < 10; i++) {
+        mmHeapInitialize(&heaps[i], bufs[i], sizeof(bufs[i]), UNIT, (s8*)"b");
+    }
+
+    assert_int_equal(mmGetHeapCount(), 8);
+    assert_ptr_equal(mmGetHeap(7), &heaps[9]);
+    assert_ptr_equal(mmGetHeap(0), &heaps[2]);
+    assert_null(mmGetHeap(8));
+    assert_null(mmGetHeap(-1));
+}
+
+static void test_memmgr_holes_and_compaction(void** state) {
+    (void)state;
+    static MEM_BLOCK blocks[BLOCK_COUNT];
+    MEM_MGR mgr;
+    MEM_MGR_STATS stats;
+    u32 han[4];
+
+    plmemInit(&mgr, blocks, BLOCK_COUNT, s_heap, HEAP_SIZE, 16, 1);
+
+    for (s32 i = 0; i < 4; i++) {
+        han[i] = plmemRegister(&mgr, 0x1000);
+        assert_int_not_equal(han[i], 0);
+        memset(plmemRetrieve(&mgr, han[i]), 0x10 + i, 0x1000);
+    }
+
+    assert_int_equal(plmemRegister(&mgr, HEAP_SIZE), 0);
+
+    // Two one-block holes, both smaller than the frontier
+    plmemRelease(&mgr, han[0]);
+    plmemRelease(&mgr, han[2]);
+    plmemGetStats(&mgr, &stats);
+    assert_int_equal(stats.used, 0x2000);
+    assert_int_equal(stats.peak_used, 0x4000);
+    assert_int_equal(stats.blocks, 2);
+    assert_int_equal(stats.registers, 4);
+    assert_int_equal(stats.releases, 2);
+    assert_int_equal(stats.failures, 1);
+    assert_int_equal(stats.largest_free, HEAP_SIZE - 0x4000);
+    assert_int_equal(stats.compactions, 0);
+
+    // With a small pool the hole wins over the frontier
+    plmemInit(&mgr, blocks, BLOCK_COUNT, s_heap, 0x5000, 16, 1);
+
+    for (s32 i = 0; i < 4; i++) {
+        han[i] = plmemRegister(&mgr, 0x1000);
+        memset(plmemRetrieve(&mgr, han[i]), 0x10 + i, 0x1000);
+    }
+
+    plmemRelease(&mgr, han[1]);
+    plmemRelease(&mgr, han[2]);
+    plmemGetStats(&mgr, &stats);
+    assert_int_equal(stats.largest_free, 0x2000);
+
+    plmemCompact(&mgr);
+    plmemGetStats(&mgr, &stats);
+    assert_int_equal(stats.compactions, 1);
+    assert_int_equal(stats.compact_moves, 1);
+    assert_int_equal(stats.compact_bytes, 0x1000);
+    assert_true(stats.compact_max_ns <= stats.compact_ns);
+    assert_int_equal(stats.largest_free, 0x3000);
+    assert_int_equal(((u8*)plmemRetrieve(&mgr, han[3]))[0], 0x13);
+}
+
+static void test_memmgr_reverse_holes(void** state) {
+    (void)state;
+    static MEM_BLOCK blocks[BLOCK_COUNT];
+    MEM_MGR mgr;
+    MEM_MGR_STATS stats;
+    u32 han[4];
+
+    plmemInit(&mgr, blocks, BLOCK_COUNT, s_heap, 0x5000, 16, 0);
+
+    for (s32 i = 0; i < 4; i++) {
+        han[i] = plmemRegister(&mgr, 0x1000);
+        assert_int_not_equal(han[i], 0);
+    }
+
+    plmemRelease(&mgr, han[0]);
+    plmemRelease(&mgr, han[1]);
+    plmemGetStats(&mgr, &stats);
+    assert_int_equal(stats.blocks, 2);
+    assert_int_equal(stats.largest_free, 0x2000);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_memman_stats_indexed),
+        cmocka_unit_test(test_memman_stats_walked),
+        cmocka_unit_test(test_memman_heap_list),
+        cmocka_unit_test(test_memmgr_holes_and_compaction),
+        cmocka_unit_test(test_memmgr_reverse_holes),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,298 @@
+/**
+ * @file test_hitbox.c
+ * @brief Unit tests for the attack_hit_check() broadphase and vectorised box test.
+ *
+ * Feeds random attacker and defender box sets through hit_check_subroutine()
+ * and through the world-space HitBoxGroup path, and checks that every depth
+ * matches, that pairs the broadphase culls have no overlapping boxes, and
+ * that the hit attack_hit_check() would pick from a pair is the same either
+ * way. Sets that could wrap hit_check_subroutine()'s 16-bit math must be
+ * flagged inexact so they keep using it.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include "sf33rd/Source/Game/engine/hitbox.h"
+#include "sf33rd/Source/Game/engine/hitcheck.h"
+
+#define TRIALS 200000
+
+typedef struct BoxSet {
+    WORK wk;
+    s16 boxes[11][4];
+    const s16* ptrs[11];
+} BoxSet;
+
+typedef struct Pick {
+    s16 att;
+    s16 dm;
+    s16 mw;
+} Pick;
+
+static uint32_t rng_state = 0x3533F00Du;
+
+static uint32_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static s16 random_range(s32 lo, s32 hi) {
+    return (s16)(lo + (s32)(next_random() % (uint32_t)(hi - lo + 1)));
+}
+
+/** @brief Mostly game-sized boxes near the players; now and then empty, inverted or far-off ones. */
+static void random_set(BoxSet* set, s16 count) {
+    const uint32_t mode = next_random() % 16;
+
+    memset(&set->wk, 0, sizeof(set->wk));
+    set->wk.rl_flag = next_random() & 1;
+    set->wk.xyz[0].disp.pos = random_range(100, 300);
+    set->wk.xyz[1].disp.pos = random_range(0, 120);
+
+    if (mode == 0) {
+        set->wk.xyz[0].disp.pos = random_range(-32768, 32767);
+        set->wk.xyz[1].disp.pos = random_range(-32768, 32767);
+    }
+
+    for (s16 i = 0; i < count; i++) {
+        s16* box = set->boxes[i];
+
+        box[0] = random_range(-80, 80);
+        box[1] = ((next_random() % 4) == 0) ? 0 : random_range(1, 60);
+        box[2] = random_range(-20, 120);
+        box[3] = random_range(0, 60);
+
+        if ((mode == 1) && ((next_random() % 4) == 0)) {
+            box[1] = random_range(-60, 60);
+            box[3] = random_range(-60, 60);
+        } else if ((mode == 2) && ((next_random() % 4) == 0)) {
+            box[0] = random_range(-32768, 32767);
+            box[1] = random_range(-32768, 32767);
+            box[2] = random_range(-32768, 32767);
+            box[3] = random_range(-32768, 32767);
+        }
+
+        set->ptrs[i] = box;
+    }
+}
+
+/** @brief attack_hit_check()'s choice for one pair: the first box pair with the deepest overlap. */
+static Pick pick_reference(BoxSet* att, BoxSet* dm) {
+    Pick pick = { -1, -1, 0 };
+
+    for (s16 lp = 0; lp < 4; lp++) {
+        if (att->boxes[lp][1] == 0) {
+            continue;
+        }
+
+        for (s16 lp2 = 0; lp2 < 11; lp2++) {
+            s16 mw;
+
+            if (dm->boxes[lp2][1] == 0) {
+                continue;
+            }
+
+            mw = hit_check_subroutine(&att->wk, &dm->wk, att->boxes[lp], dm->boxes[lp2]);
+
+            if (mw > pick.mw) {
+                pick.att = lp;
+                pick.dm = lp2;
+                pick.mw = mw;
+            }
+        }
+    }
+
+    return pick;
+}
+
+/** @brief The same choice through the broadphase and the vectorised depths. */
+static Pick pick_grouped(BoxSet* att, BoxSet* dm, const HitBoxGroup* ag, const HitBoxGroup* dg) {
+    Pick pick = { -1, -1, 0 };
+    const bool exact = ag->exact && dg->exact;
+    s16 depth[HITBOX_LANES];
+
+    if (!hitbox_may_touch(ag, dg)) {
+        return pick;
+    }
+
+    for (s16 lp = 0; lp < 4; lp++) {
+        if (att->boxes[lp][1] == 0) {
+            continue;
+        }
+
+        if (exact) {
+            hitbox_depths(ag, lp, dg, depth);
+        }
+
+        for (s16 lp2 = 0; lp2 < 11; lp2++) {
+            s16 mw;
+
+            if (dm->boxes[lp2][1] == 0) {
+                continue;
+            }
+
+            mw = exact ? depth[lp2] : hit_check_subroutine(&att->wk, &dm->wk, att->boxes[lp], dm->boxes[lp2]);
+
+            if (mw > pick.mw) {
+                pick.att = lp;
+                pick.dm = lp2;
+                pick.mw = mw;
+            }
+        }
+    }
+
+    return pick;
+}
+
+static void test_random_sets_match_reference(void** state) {
+    static BoxSet att;
+    static BoxSet dm;
+    int culled = 0;
+    int exact_pairs = 0;
+    int hits = 0;
+
+    for (int trial = 0; trial < TRIALS; trial++) {
+        HitBoxGroup ag;
+        HitBoxGroup dg;
+        bool any_overlap = false;
+        Pick want;
+        Pick got;
+
+        random_set(&att, 4);
+        random_set(&dm, 11);
+        hitbox_build(&ag, &att.wk, att.ptrs, 4);
+        hitbox_build(&dg, &dm.wk, dm.ptrs, 11);
+
+        for (s16 lp = 0; lp < 4; lp++) {
+            s16 depth[HITBOX_LANES];
+
+            if (att.boxes[lp][1] == 0) {
+                continue;
+            }
+
+            if (ag.exact && dg.exact) {
+                hitbox_depths(&ag, lp, &dg, depth);
+            }
+
+            for (s16 lp2 = 0; lp2 < 11; lp2++) {
+                s16 mw;
+
+                if (dm.boxes[lp2][1] == 0) {
+                    continue;
+                }
+
+                mw = hit_check_subroutine(&att.wk, &dm.wk, att.boxes[lp], dm.boxes[lp2]);
+                any_overlap |= (mw != 0);
+
+                if (ag.exact && dg.exact) {
+                    assert_int_equal(depth[lp2], mw);
+                }
+            }
+        }
+
+        // A culled pair must not have a single box pair the reference would report
+        if (!hitbox_may_touch(&ag, &dg)) {
+            assert_false(any_overlap);
+            culled++;
+        }
+
+        want = pick_reference(&att, &dm);
+        got = pick_grouped(&att, &dm, &ag, &dg);
+        assert_int_equal(got.att, want.att);
+        assert_int_equal(got.dm, want.dm);
+        assert_int_equal(got.mw, want.mw);
+
+        exact_pairs += (ag.exact && dg.exact);
+        hits += (want.mw > 0);
+    }
+
+    // Make sure every path was exercised
+    assert_true(culled > TRIALS / 20);
+    assert_true(hits > TRIALS / 20);
+    assert_true(exact_pairs > TRIALS / 2);
+    assert_true(exact_pairs < TRIALS);
+}
+
+static void test_edges(void** state) {
+    static BoxSet att;
+    static BoxSet dm;
+    HitBoxGroup ag;
+    HitBoxGroup dg;
+    s16 depth[HITBOX_LANES];
+    const s16 cases[][4] = {
+        { 0, 10, 0, 10 },    // x: dm right edge on the attack box's left edge
+        { 20, 10, 0, 10 },   // x: dm left edge on its right edge
+        { 10, 10, 10, 10 },  // y: dm bottom on its top
+        { 10, 10, -10, 10 }, // y: dm top on its bottom
+        { 15, 10, 5, 0 },    // zero-height dm box inside it
+        { 19, 1, 9, 1 },     // 1x1 in its corner
+    };
+
+    memset(&att, 0, sizeof(att));
+    memset(&dm, 0, sizeof(dm));
+    att.wk.xyz[0].disp.pos = 100;
+    dm.wk.xyz[0].disp.pos = 100;
+
+    // Attack box covers x 110..120, y 0..10 once mirrored
+    att.wk.rl_flag = 1;
+    att.boxes[0][0] = -20;
+    att.boxes[0][1] = 10;
+    att.boxes[0][2] = 0;
+    att.boxes[0][3] = 10;
+    att.ptrs[0] = att.boxes[0];
+
+    for (s16 i = 0; i < 11; i++) {
+        if (i < (s16)(sizeof(cases) / sizeof(cases[0]))) {
+            memcpy(dm.boxes[i], cases[i], sizeof(cases[i]));
+        }
+
+        dm.ptrs[i] = dm.boxes[i];
+    }
+
+    hitbox_build(&ag, &att.wk, att.ptrs, 1);
+    hitbox_build(&dg, &dm.wk, dm.ptrs, 11);
+    assert_true(ag.exact && dg.exact);
+    assert_int_equal(ag.l[0], 110);
+    assert_int_equal(ag.r[0], 120);
+    assert_true(hitbox_may_touch(&ag, &dg));
+
+    hitbox_depths(&ag, 0, &dg, depth);
+
+    for (s16 i = 0; i < 11; i++) {
+        const s16 want = (dm.boxes[i][1] != 0) ? hit_check_subroutine(&att.wk, &dm.wk, att.boxes[0], dm.boxes[i]) : 0;
+
+        assert_int_equal(depth[i], want);
+    }
+
+    // Touching in x counts, and so does touching the attack box's top; the 1x1 is 1 deep
+    assert_int_equal(depth[0], 0);
+    assert_int_equal(depth[5], 1);
+
+    // An attacker with no boxes never touches anything, wherever it is
+    att.boxes[0][1] = 0;
+    hitbox_build(&ag, &att.wk, att.ptrs, 1);
+    assert_false(ag.any);
+    assert_false(hitbox_may_touch(&ag, &dg));
+
+    // A far-off box makes the group inexact, so the pair is never culled
+    att.boxes[0][1] = 10;
+    att.boxes[0][0] = 30000;
+    hitbox_build(&ag, &att.wk, att.ptrs, 1);
+    assert_false(ag.exact);
+    assert_true(hitbox_may_touch(&ag, &dg));
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_random_sets_match_reference),
+        cmocka_unit_test(test_edges),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
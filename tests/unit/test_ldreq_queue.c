@@ -0,0 +1,540 @@
+/**
+ * @file test_ldreq_queue.c
+ * @brief Serial vs. overlapped runs of the load-request queue.
+ *
+ * Queues the same player and stage loads twice against a synthetic AFS
+ * archive: once with one slot (the original one-request-at-a-time queue)
+ * and once with reads overlapping. The requests run through the real
+ * texture group and color loaders (texgroup.c, color3rd.c) with the real
+ * obj_group_table, so texture groups that share a slot are ordered the way
+ * the game orders them; only the character fixups, sound hardware and
+ * palette upload are stubbed. The archive has an entry for every file
+ * texgrpdat and color_file name, sized to what each loader reads.
+ *
+ * Both runs must hand out the same ramcnt keys at the same addresses, leave
+ * the same bytes in every resident texture group, write the same palettes,
+ * send the same sound banks to the SPU in the same order and set the same
+ * result bits; the overlapped run must not take more frames.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+#include <SDL3/SDL.h>
+
+#include "common.h"
+#include "main.h"
+#include "port/io/afs.h"
+#include "sf33rd/AcrSDK/MiddleWare/PS2/CapSndEng/cse.h"
+#include "sf33rd/AcrSDK/common/plcommon.h"
+#include "sf33rd/Source/Game/debug/Debug.h"
+#include "sf33rd/Source/Game/engine/charid.h"
+#include "sf33rd/Source/Game/io/gd3rd.h"
+#include "sf33rd/Source/Game/rendering/chren3rd.h"
+#include "sf33rd/Source/Game/rendering/color3rd.h"
+#include "sf33rd/Source/Game/rendering/texgroup.h"
+#include "sf33rd/Source/Game/sound/sound3rd.h"
+#include "sf33rd/Source/Game/system/ramcnt.h"
+
+#define ARCHIVE_PATH "test_ldreq_queue.afs"
+#define SECTOR 2048
+#define ENTRY_MAX 2048
+#define RAMCNT_SIZE 0x1000000
+#define UPLOAD_MAX 16
+
+extern u8 ldreq_result[294];
+extern u16 ColorRAM[512][64];
+extern u16 hi_meta[2][2][64];
+
+// Same layout as color3rd.c's col_file_data
+typedef struct {
+    u16 data;
+    u16 type;
+    u16 apfn;
+    u16 free;
+} ColorFile;
+
+extern const ColorFile color_file[161];
+
+typedef struct {
+    ptrdiff_t offset; // From the start of the ramcnt heap, -1 if unused
+    size_t size;
+    u8 type;
+    u8 use;
+} Key;
+
+typedef struct {
+    u32 dst;
+    u32 size;
+    u32 sum;
+} Upload;
+
+typedef struct {
+    s32 frames;
+    u8 result[294];
+    s16 tex_key[100];
+    u8 tex_data[100][64]; // Head of each resident texture group
+    s32 tex_ix[100];      // texgrpdat entry each resident group was loaded from
+    Key keys[RCKEY_WORK_MAX];
+    u16 color_ram[512][64];
+    u16 meta[2][2][64];
+    Upload uploads[UPLOAD_MAX];
+    s32 num_uploads;
+} Run;
+
+static uint32_t s_entries;
+static uint32_t s_offset[ENTRY_MAX];
+static uint32_t s_size[ENTRY_MAX];
+static uint8_t* s_archive;
+static u8 s_ramcnt[RAMCNT_SIZE] __attribute__((aligned(64)));
+static u16 s_palette_row[64];
+static u16 s_palette_handles[512];
+static Run* s_run;
+
+// Game state the loaders link against
+s8 Debug_w[DEBUG_OPTION_COUNT];
+u32 system_timer;
+u8 My_char[2];
+s8 Player_Color[2];
+MPP mpp_w;
+CharInitData char_init_data[23];
+UNK_Data* parabora_own_table[20];
+const s8 plid_data[20] = { 6, 3, 5, 1, 2, 9, 7, 4, 10, 8, 12, 13, 14, 15, 16, 18, 19, 20, 21, 22 };
+u16 hi_meta[2][2][64];
+CSE_SYSWORK g_cseSysWork;
+s8* csePHDDataTable[256];
+SoundEvent* cseTSBDataTable[256];
+s8* sdbd[3];
+
+s32 flPrintColor(u32 col) {
+    (void)col;
+    return 1;
+}
+
+s32 flPrintL(s32 posi_x, s32 posi_y, const s8* format, ...) {
+    (void)posi_x;
+    (void)posi_y;
+    (void)format;
+    return 1;
+}
+
+s32 flLogOut(s8* format, ...) {
+    (void)format;
+    return 1;
+}
+
+s32 mlTsbExecServer() {
+    return 0;
+}
+
+void fatal_error(const s8* fmt, ...) {
+    (void)fmt;
+    abort();
+}
+
+void TileCache_BindFile(int file_num, const void* base, unsigned int size) {
+    (void)file_num;
+    (void)base;
+    (void)size;
+}
+
+void TileCache_UnbindFile(const void* base) {
+    (void)base;
+}
+
+void tileDecodeInvalidate(void) {}
+
+void ppgChunkDirForget(const u8* adrs) {
+    (void)adrs;
+}
+
+void CharData_ApplyFixups(CharInitData* data, int character_id) {
+    (void)data;
+    (void)character_id;
+}
+
+void Clear_texcash_work() {}
+
+s16 load_it_use_any_key(u16 fnum, u8 kokey, u8 group) {
+    (void)fnum;
+    (void)kokey;
+    (void)group;
+    fail();
+    return 0;
+}
+
+s32 load_it_use_this_key(u16 fnum, s16 key) {
+    (void)fnum;
+    (void)key;
+    fail();
+    return 0;
+}
+
+s32 ppgSetupPalChunkDir(Palette* pch, PPLFileHeader* ppl, u8* adrs, s32 ixNum1st, s32 unused) {
+    (void)pch;
+    (void)ppl;
+    (void)adrs;
+    (void)ixNum1st;
+    (void)unused;
+    return 0;
+}
+
+s32 flLockPalette(Rect* lprect, u32 th, plContext* lpcontext, u32 flag) {
+    (void)lprect;
+    (void)th;
+    (void)flag;
+    lpcontext->ptr = s_palette_row;
+    return 1;
+}
+
+s32 flUnlockPalette(u32 th) {
+    (void)th;
+    return 1;
+}
+
+void metamor_color_store(s16 wkid) {
+    (void)wkid;
+}
+
+s32 sndCheckVTransStatus(s32 type) {
+    (void)type;
+    return 1;
+}
+
+u32 mlMemMapGetBankAddr(u32 bank) {
+    return bank << 20;
+}
+
+s32 mlMemMapSetPhdAddr(u32 bank, void* addr) {
+    (void)bank;
+    (void)addr;
+    return 0;
+}
+
+s32 mlTsbSetBankAddr(u32 bank, SoundEvent* addr) {
+    (void)bank;
+    (void)addr;
+    return 0;
+}
+
+/** Sound banks must reach the SPU in the same order with the same bytes. */
+void SPU_Upload(u32 dst, void* src, u32 size) {
+    Upload* up;
+
+    assert_true(s_run->num_uploads < UPLOAD_MAX);
+    up = &s_run->uploads[s_run->num_uploads++];
+    up->dst = dst;
+    up->size = size;
+    up->sum = 0;
+
+    for (u32 i = 0; i < size; i++) {
+        up->sum = up->sum * 31 + ((const u8*)src)[i];
+    }
+}
+
+static uint32_t align_sector(uint32_t n) {
+    return (n + SECTOR - 1) & ~(uint32_t)(SECTOR - 1);
+}
+
+static void put_u32le(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/** Bytes init_trans_color_ram() reads from a color file of @p type (player color 0). */
+static uint32_t color_file_size(u16 type) {
+    switch (type) {
+    case 1:
+        return 2 * 28 * 64 * 2;
+
+    case 2:
+        return 64 * 2; // Copied whole into ColorRAM, so one row
+
+    case 3:
+        return 2 * 16 * 64 * 2;
+
+    case 5:
+        return 3 * 64 * 2;
+
+    case 6:
+        return 2 * 64 * 2;
+
+    case 7:
+        return 20 * 16 * 16 * 2;
+
+    default:
+        return 64 * 2;
+    }
+}
+
+static void write_archive(void) {
+    uint32_t rng = 4321;
+    uint32_t pos;
+
+    memset(s_size, 0, sizeof(s_size));
+    s_entries = 0;
+
+    // Character files hold their init data at to_chd; the rest only need to exist
+    for (int i = 0; i < 100; i++) {
+        const TexGroupData* bsd = &texgrpdat[i];
+
+        if (bsd->apfn < 0) {
+            continue;
+        }
+
+        assert_true(bsd->apfn < ENTRY_MAX);
+        rng = rng * 1664525u + 1013904223u;
+        s_size[bsd->apfn] = bsd->to_chd ? bsd->to_chd + 25 * 4 : 1 + (rng >> 8) % (12 * SECTOR);
+        s_entries = SDL_max(s_entries, (uint32_t)bsd->apfn + 1);
+    }
+
+    for (int i = 0; i < 161; i++) {
+        const ColorFile* cf = &color_file[i];
+
+        if (cf->apfn == 0xFFFF) {
+            continue;
+        }
+
+        assert_true(cf->apfn < ENTRY_MAX);
+        s_size[cf->apfn] = color_file_size(cf->type);
+        s_entries = SDL_max(s_entries, (uint32_t)cf->apfn + 1);
+    }
+
+    pos = align_sector(8 + s_entries * 8 + 8);
+
+    for (uint32_t i = 0; i < s_entries; i++) {
+        if (s_size[i] == 0) {
+            s_size[i] = 16;
+        }
+
+        s_offset[i] = pos;
+        pos += align_sector(s_size[i]);
+    }
+
+    s_archive = calloc(1, pos);
+    assert_non_null(s_archive);
+    memcpy(s_archive, "AFS", 4);
+    put_u32le(s_archive + 4, s_entries);
+
+    for (uint32_t i = 0; i < s_entries; i++) {
+        put_u32le(s_archive + 8 + i * 8, s_offset[i]);
+        put_u32le(s_archive + 12 + i * 8, s_size[i]);
+
+        for (uint32_t j = 0; j < s_size[i]; j++) {
+            rng = rng * 1664525u + 1013904223u;
+            s_archive[s_offset[i] + j] = (uint8_t)(rng >> 24);
+        }
+    }
+
+    // Zero init data offsets, so the pointers texgroup.c builds stay inside the file
+    for (int i = 0; i < 100; i++) {
+        if ((texgrpdat[i].apfn >= 0) && texgrpdat[i].to_chd) {
+            memset(s_archive + s_offset[texgrpdat[i].apfn] + texgrpdat[i].to_chd, 0, 25 * 4);
+        }
+    }
+
+    FILE* f = fopen(ARCHIVE_PATH, "wb");
+    assert_non_null(f);
+    assert_int_equal(fwrite(s_archive, 1, pos, f), pos);
+    fclose(f);
+}
+
+static int setup(void** state) {
+    (void)state;
+    remove(ARCHIVE_PATH);
+    remove(ARCHIVE_PATH ".idx");
+    write_archive();
+    AFS_SetMemoryMapped(false);
+    AFS_SetPreloadThreads(0);
+    assert_true(AFS_Init(ARCHIVE_PATH));
+    return 0;
+}
+
+static int teardown(void** state) {
+    (void)state;
+    AFS_Finish();
+    AFS_SetMemoryMapped(true);
+    remove(ARCHIVE_PATH);
+    remove(ARCHIVE_PATH ".idx");
+    free(s_archive);
+    return 0;
+}
+
+static u8 texture_group_of(s32 ix) {
+    const u16 first = texgrpdat[ix].num_of_1st;
+
+    return obj_group_table[(first == 0) ? 1 : first];
+}
+
+/**
+ * Gill and Ryu, then a stage. Gill's texture group 27 and Ryu's 89 are
+ * different files that obj_group_table puts in the same group; pushing their
+ * ldreq_tbl entries directly up front puts both reads in the same window.
+ */
+static void push_loads(void) {
+    Push_LDREQ_Queue_Direct(1, 0);
+    Push_LDREQ_Queue_Direct(11, 1);
+    Push_LDREQ_Queue_Player(0, 0);
+    Push_LDREQ_Queue_Player(1, 2);
+    Push_LDREQ_Queue_BG(0);
+}
+
+static void reset_game_state(Run* run, s32 slots) {
+    memset(run, 0, sizeof(*run));
+    memset(texgrplds, 0, sizeof(texgrplds));
+    memset(ldreq_result, 0, sizeof(ldreq_result));
+    memset(s_ramcnt, 0, sizeof(s_ramcnt));
+    memset(ColorRAM, 0, sizeof(ColorRAM));
+    memset(hi_meta, 0, sizeof(hi_meta));
+    memset(char_init_data, 0, sizeof(char_init_data));
+    memset(&g_cseSysWork, 0, sizeof(g_cseSysWork));
+    col3rd_w.palCP3.handle = s_palette_handles; // Normally set up by the ghost palette init
+    s_run = run;
+
+    Init_ram_control_work(s_ramcnt, RAMCNT_SIZE);
+    Init_Load_Request_Queue_1st();
+    Set_LDREQ_Slots(slots);
+    push_loads();
+}
+
+static void run_queue(Run* run, s32 slots) {
+    reset_game_state(run, slots);
+
+    while (!Check_LDREQ_Clear()) {
+        AFS_RunServer();
+        Check_LDREQ_Queue();
+        run->frames += 1;
+        assert_true(run->frames < 1000);
+    }
+
+    assert_false(fsCheckCommandExecuting());
+    memcpy(run->result, ldreq_result, sizeof(run->result));
+    memcpy(run->color_ram, ColorRAM, sizeof(run->color_ram));
+    memcpy(run->meta, hi_meta, sizeof(run->meta));
+
+    for (s32 i = 0; i < RCKEY_WORK_MAX; i++) {
+        const RCKeyWork* rk = &rckey_work[i];
+
+        run->keys[i].offset = rk->use ? (const u8*)rk->adr - s_ramcnt : -1;
+        run->keys[i].size = rk->use ? rk->size : 0;
+        run->keys[i].type = rk->type;
+        run->keys[i].use = rk->use;
+    }
+
+    for (s32 i = 0; i < 100; i++) {
+        const u8* adr;
+        s32 ix;
+
+        if (!texgrplds[i].ok) {
+            continue;
+        }
+
+        adr = (const u8*)Get_ramcnt_address(texgrplds[i].key);
+        run->tex_key[i] = texgrplds[i].key;
+        memcpy(run->tex_data[i], adr, 64);
+
+        // Whatever the queue did, a resident group holds one of its files
+        for (ix = 0; ix < 100; ix++) {
+            const s16 fnum = texgrpdat[ix].apfn;
+
+            if ((fnum >= 0) && (texture_group_of(ix) == i) &&
+                (memcmp(adr, s_archive + s_offset[fnum], s_size[fnum]) == 0)) {
+                break;
+            }
+        }
+
+        assert_true(ix < 100);
+        run->tex_ix[i] = ix;
+    }
+}
+
+static void check_same_as_serial(s32 slots) {
+    static Run serial;
+    static Run overlapped;
+    s32 groups = 0;
+
+    run_queue(&serial, 1);
+    run_queue(&overlapped, slots);
+
+    for (s32 i = 0; i < 100; i++) {
+        groups += (serial.tex_key[i] != 0);
+    }
+
+    assert_true(groups > 3);
+    assert_true(serial.num_uploads > 0);
+    assert_int_equal(overlapped.num_uploads, serial.num_uploads);
+    assert_memory_equal(overlapped.uploads, serial.uploads, sizeof(serial.uploads));
+    assert_memory_equal(overlapped.keys, serial.keys, sizeof(serial.keys));
+    assert_memory_equal(overlapped.result, serial.result, sizeof(serial.result));
+    assert_memory_equal(overlapped.tex_key, serial.tex_key, sizeof(serial.tex_key));
+    assert_memory_equal(overlapped.tex_data, serial.tex_data, sizeof(serial.tex_data));
+    assert_memory_equal(overlapped.tex_ix, serial.tex_ix, sizeof(serial.tex_ix));
+
+    // Gill's load owns the shared group; Ryu's finds it resident and marks it as used by both
+    assert_int_equal(serial.tex_ix[texture_group_of(89)], 27);
+    assert_int_equal(serial.keys[serial.tex_key[texture_group_of(89)]].type, 5);
+    assert_memory_equal(overlapped.color_ram, serial.color_ram, sizeof(serial.color_ram));
+    assert_memory_equal(overlapped.meta, serial.meta, sizeof(serial.meta));
+    assert_true(Check_LDREQ_Queue_Player(0));
+    assert_true(Check_LDREQ_Queue_Player(1));
+    assert_true(Check_LDREQ_Queue_BG(0));
+    assert_true(overlapped.frames <= serial.frames);
+
+    if (slots > 1) {
+        assert_true(overlapped.frames < serial.frames);
+    }
+
+    printf("%d texture groups: serial %d frames, %d slots %d frames\n", groups, serial.frames, slots,
+           overlapped.frames);
+}
+
+static void test_two_slots_match_serial(void** state) {
+    (void)state;
+    check_same_as_serial(2);
+}
+
+static void test_four_slots_match_serial(void** state) {
+    (void)state;
+    check_same_as_serial(4);
+}
+
+static void test_eight_slots_match_serial(void** state) {
+    (void)state;
+    check_same_as_serial(8);
+}
+
+static void test_break_closes_every_read(void** state) {
+    (void)state;
+    static Run run;
+
+    reset_game_state(&run, 4);
+
+    // Issue the first batch of reads, then break before any completes
+    Check_LDREQ_Queue();
+    assert_false(Check_LDREQ_Clear());
+    Request_LDREQ_Break();
+    assert_true(Check_LDREQ_Break());
+    Check_LDREQ_Queue();
+
+    assert_true(Check_LDREQ_Clear());
+    assert_false(Check_LDREQ_Break());
+    AFS_RunServer();
+    assert_false(fsCheckCommandExecuting());
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_two_slots_match_serial),
+        cmocka_unit_test(test_four_slots_match_serial),
+        cmocka_unit_test(test_eight_slots_match_serial),
+        cmocka_unit_test(test_break_closes_every_read),
+    };
+
+    return cmocka_run_group_tests(tests, setup, teardown);
+}
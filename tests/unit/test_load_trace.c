@@ -0,0 +1,255 @@
+/**
+ * @file test_load_trace.c
+ * @brief Unit tests for the asset load trace.
+ *
+ * Checks that nothing is recorded while the trace is off, that nested
+ * scopes carry their asset tag and report self time without their
+ * children, that spans and the ring buffer keep order when it overflows,
+ * that per-asset totals add up, and that the Chrome trace JSON export has
+ * complete events for scopes, paired async events for spans and escaped
+ * names.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+#include <SDL3/SDL.h>
+
+#include "port/io/load_trace.h"
+
+#define TRACE_PATH "test_load_trace.json"
+
+/** @brief Busy-wait so scopes have a measurable, non-zero duration. */
+static void spin_ns(uint64_t ns) {
+    const uint64_t until = SDL_GetTicksNS() + ns;
+
+    while (SDL_GetTicksNS() < until) {}
+}
+
+static uint64_t duration(const LoadTraceEvent* event) {
+    return event->end_ns - event->begin_ns;
+}
+
+static int teardown(void** state) {
+    LoadTrace_Stop();
+    remove(TRACE_PATH);
+    return 0;
+}
+
+static void test_nothing_recorded_while_off(void** state) {
+    assert_false(LoadTrace_IsActive());
+    assert_true(LoadTrace_Now() == 0);
+    assert_true(LoadTrace_Begin() == 0);
+
+    LoadTrace_End(LOAD_TRACE_DECOMPRESS, 0);
+    LoadTrace_Span(LOAD_TRACE_IO_WAIT, "x.bin", 0, 10);
+    assert_int_equal(LoadTrace_GetEventCount(), 0);
+
+    // A scope opened before the trace started is dropped, not closed against a newer one
+    const uint64_t stale = LoadTrace_Begin();
+    assert_true(LoadTrace_Start(16));
+    LOAD_TRACE_BEGIN(ALLOC);
+    LoadTrace_End(LOAD_TRACE_CONVERT, stale);
+    LOAD_TRACE_END(ALLOC);
+
+    assert_int_equal(LoadTrace_GetEventCount(), 1);
+    assert_int_equal(LoadTrace_GetEvent(0)->category, LOAD_TRACE_ALLOC);
+}
+
+static void test_nested_scopes_report_self_time(void** state) {
+    const LoadTraceEvent* inner;
+    const LoadTraceEvent* outer;
+
+    assert_true(LoadTrace_Start(0));
+    LoadTrace_SetAsset("PL01.BIN");
+
+    LOAD_TRACE_BEGIN(DECOMPRESS);
+    spin_ns(200000);
+    LOAD_TRACE_BEGIN(CONVERT);
+    spin_ns(300000);
+    LOAD_TRACE_END(CONVERT);
+    spin_ns(100000);
+    LOAD_TRACE_END(DECOMPRESS);
+
+    // Children finish first
+    assert_int_equal(LoadTrace_GetEventCount(), 2);
+    inner = LoadTrace_GetEvent(0);
+    outer = LoadTrace_GetEvent(1);
+
+    assert_int_equal(inner->category, LOAD_TRACE_CONVERT);
+    assert_int_equal(outer->category, LOAD_TRACE_DECOMPRESS);
+    assert_string_equal(inner->asset, "PL01.BIN");
+    assert_string_equal(outer->asset, "PL01.BIN");
+    assert_false(inner->span);
+
+    assert_true(inner->begin_ns >= outer->begin_ns);
+    assert_true(inner->end_ns <= outer->end_ns);
+    assert_true(duration(inner) >= 300000);
+    assert_true(inner->self_ns == duration(inner));
+    assert_true(outer->self_ns == duration(outer) - duration(inner));
+    assert_true(outer->self_ns >= 300000);
+
+    // Clearing the tag leaves later events untagged
+    LoadTrace_SetAsset(NULL);
+    LOAD_TRACE_BEGIN(ALLOC);
+    LOAD_TRACE_END(ALLOC);
+    assert_string_equal(LoadTrace_GetEvent(2)->asset, "");
+}
+
+static void test_spans_and_ring_overflow(void** state) {
+    const uint64_t t0 = 1000;
+
+    assert_true(LoadTrace_Start(4));
+    LoadTrace_SetAsset("current.bin");
+
+    for (int i = 0; i < 6; i++) {
+        char name[LOAD_TRACE_NAME_LENGTH];
+
+        SDL_snprintf(name, sizeof(name), "e%d.bin", i);
+        LoadTrace_Span(LOAD_TRACE_IO_WAIT, name, t0 + i * 100, t0 + i * 100 + 50 + i);
+    }
+
+    assert_int_equal(LoadTrace_GetEventCount(), 4);
+    assert_int_equal(LoadTrace_GetDropped(), 2);
+
+    for (int i = 0; i < 4; i++) {
+        const LoadTraceEvent* event = LoadTrace_GetEvent(i);
+        char name[LOAD_TRACE_NAME_LENGTH];
+
+        SDL_snprintf(name, sizeof(name), "e%d.bin", i + 2);
+        assert_string_equal(event->asset, name);
+        assert_true(event->span);
+        assert_true(event->self_ns == (uint64_t)(50 + i + 2));
+    }
+
+    assert_null(LoadTrace_GetEvent(4));
+
+    // No name falls back to the current tag; an end before the start is clamped
+    LoadTrace_Span(LOAD_TRACE_REQUEST, NULL, t0 + 900, t0 + 800);
+    assert_string_equal(LoadTrace_GetEvent(3)->asset, "current.bin");
+    assert_true(duration(LoadTrace_GetEvent(3)) == 0);
+
+    LoadTrace_Clear();
+    assert_int_equal(LoadTrace_GetEventCount(), 0);
+    assert_int_equal(LoadTrace_GetDropped(), 0);
+    assert_true(LoadTrace_IsActive());
+}
+
+static void test_summarize_per_asset(void** state) {
+    LoadTraceAsset assets[2];
+    const uint64_t t0 = 5000;
+
+    assert_true(LoadTrace_Start(0));
+    LoadTrace_Span(LOAD_TRACE_IO_WAIT, "a.bin", t0, t0 + 10);
+    LoadTrace_Span(LOAD_TRACE_IO_WAIT, "b.bin", t0, t0 + 20);
+    LoadTrace_Span(LOAD_TRACE_IO_WAIT, "a.bin", t0, t0 + 30);
+    LoadTrace_Span(LOAD_TRACE_REQUEST, "a.bin", t0, t0 + 100);
+    LoadTrace_Span(LOAD_TRACE_DECOMPRESS, "c.bin", t0, t0 + 7);
+
+    // c.bin doesn't fit; the others are totalled in order of first appearance
+    assert_int_equal(LoadTrace_Summarize(assets, 2), 2);
+    assert_string_equal(assets[0].name, "a.bin");
+    assert_true(assets[0].ns[LOAD_TRACE_IO_WAIT] == 40);
+    assert_int_equal(assets[0].count[LOAD_TRACE_IO_WAIT], 2);
+    assert_true(assets[0].ns[LOAD_TRACE_REQUEST] == 100);
+    assert_int_equal(assets[0].count[LOAD_TRACE_REQUEST], 1);
+    assert_true(assets[0].ns[LOAD_TRACE_DECOMPRESS] == 0);
+    assert_string_equal(assets[1].name, "b.bin");
+    assert_true(assets[1].ns[LOAD_TRACE_IO_WAIT] == 20);
+}
+
+static char* read_text(const char* path) {
+    FILE* f = fopen(path, "rb");
+    char* text;
+    long size;
+
+    assert_non_null(f);
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    text = calloc(size + 1, 1);
+    assert_int_equal(fread(text, 1, size, f), size);
+    fclose(f);
+    return text;
+}
+
+static int count_of(const char* text, const char* needle) {
+    int n = 0;
+
+    for (const char* p = strstr(text, needle); p != NULL; p = strstr(p + 1, needle)) {
+        n++;
+    }
+
+    return n;
+}
+
+static void test_chrome_export(void** state) {
+    char* json;
+    int depth = 0;
+    bool in_string = false;
+
+    assert_true(LoadTrace_Start(0));
+    LoadTrace_SetAsset("odd \"name\"\\1");
+    LOAD_TRACE_BEGIN(DECOMPRESS);
+    LOAD_TRACE_BEGIN(CONVERT);
+    LOAD_TRACE_END(CONVERT);
+    LOAD_TRACE_END(DECOMPRESS);
+    LoadTrace_Span(LOAD_TRACE_IO_WAIT, "SEL.BIN", LoadTrace_Now(), LoadTrace_Now() + 1000);
+    LoadTrace_SetAsset(NULL);
+    LOAD_TRACE_BEGIN(ALLOC);
+    LOAD_TRACE_END(ALLOC);
+
+    assert_true(LoadTrace_WriteChrome(TRACE_PATH));
+    json = read_text(TRACE_PATH);
+
+    assert_non_null(strstr(json, "\"traceEvents\":["));
+    assert_int_equal(count_of(json, "\"ph\":\"X\""), 3);
+    assert_int_equal(count_of(json, "\"ph\":\"b\""), 1);
+    assert_int_equal(count_of(json, "\"ph\":\"e\""), 1);
+    assert_int_equal(count_of(json, "\"cat\":\"decompress\""), 1);
+    assert_int_equal(count_of(json, "\"cat\":\"convert\""), 1);
+    assert_int_equal(count_of(json, "\"cat\":\"io-wait\""), 2);
+    assert_int_equal(count_of(json, "\"name\":\"odd \\\"name\\\"\\\\1\""), 2);
+    assert_int_equal(count_of(json, "\"name\":\"SEL.BIN\""), 2);
+
+    // Untagged events are named after their category
+    assert_non_null(strstr(json, "\"name\":\"alloc\",\"cat\":\"alloc\""));
+
+    // Braces and brackets balance outside strings
+    for (const char* p = json; *p != '\0'; p++) {
+        if (in_string) {
+            if (*p == '\\') {
+                p++;
+            } else if (*p == '"') {
+                in_string = false;
+            }
+        } else if (*p == '"') {
+            in_string = true;
+        } else if ((*p == '{') || (*p == '[')) {
+            depth++;
+        } else if ((*p == '}') || (*p == ']')) {
+            depth--;
+            assert_true(depth >= 0);
+        }
+    }
+
+    assert_false(in_string);
+    assert_int_equal(depth, 0);
+    free(json);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_teardown(test_nothing_recorded_while_off, teardown),
+        cmocka_unit_test_teardown(test_nested_scopes_report_self_time, teardown),
+        cmocka_unit_test_teardown(test_spans_and_ring_overflow, teardown),
+        cmocka_unit_test_teardown(test_summarize_per_asset, teardown),
+        cmocka_unit_test_teardown(test_chrome_export, teardown),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
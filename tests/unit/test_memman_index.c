@@ -0,0 +1,223 @@
+/**
+ * @file test_memman_index.c
+ * @brief Layout-identity tests for the MemMan gap index.
+ *
+ * Replays the same pseudo-random alloc/free trace (mixed forward and
+ * reverse allocations) on two heaps, one searched through the gap index
+ * and one by walking the cells, and checks that every allocation lands at
+ * the same offset with the same remainder. The last test times a long,
+ * heavily fragmented trace both ways (reported, not gated).
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include "common.h"
+#include "sf33rd/Source/Common/MemMan.h"
+
+#define HEAP_SIZE 0x100000
+#define LIVE_MAX 512
+#define UNIT_PPG ALIGN_UP(sizeof(_MEMMAN_CELL), 16)    // PPG and zlib heaps
+#define UNIT_RAMCNT ALIGN_UP(sizeof(_MEMMAN_CELL), 64) // ramcnt heap
+
+typedef struct {
+    u8* ptr[LIVE_MAX];
+    s32 live;
+} Trace;
+
+static u8 s_heap_walk[HEAP_SIZE] __attribute__((aligned(64)));
+static u8 s_heap_index[HEAP_SIZE] __attribute__((aligned(64)));
+
+static u32 next_rand(u32* rng) {
+    *rng = *rng * 1664525u + 1013904223u;
+    return *rng >> 8;
+}
+
+static void init_heap(_MEMMAN_OBJ* mmobj, u8* buf, s32 unit, s32 indexed) {
+    mmSetGapIndexEnabled(indexed);
+    mmHeapInitialize(mmobj, buf, HEAP_SIZE, unit, (s8*)"test");
+    mmSetGapIndexEnabled(1);
+}
+
+/** One trace step: allocate (forward or reverse) or free a random live block. Returns the new block or NULL. */
+static u8* step(_MEMMAN_OBJ* mmobj, Trace* t, u32 r, u32 r2) {
+    if ((t->live > 0) && ((t->live == LIVE_MAX) || (r % 100 < 45))) {
+        const s32 i = (s32)(r2 % (u32)t->live);
+
+        mmFree(mmobj, t->ptr[i]);
+        t->ptr[i] = t->ptr[--t->live];
+        return NULL;
+    }
+
+    // Mostly small blocks with the odd texture-sized one, like the PPG and ramcnt heaps see
+    const ssize_t size = (r2 % 8 == 0) ? (ssize_t)(r2 % 0x8000) : (ssize_t)(r2 % 600);
+    u8* p = mmAlloc(mmobj, size, (r >> 7) & 1);
+
+    if (p != NULL) {
+        t->ptr[t->live++] = p;
+    }
+
+    return p;
+}
+
+static void check_same_layout(s32 unit, u32 seed, s32 steps) {
+    _MEMMAN_OBJ walk;
+    _MEMMAN_OBJ index;
+    Trace tw = { 0 };
+    Trace ti = { 0 };
+    u32 rng = seed;
+
+    init_heap(&walk, s_heap_walk, unit, 0);
+    init_heap(&index, s_heap_index, unit, 1);
+
+    for (s32 i = 0; i < steps; i++) {
+        const u32 r = next_rand(&rng);
+        const u32 r2 = next_rand(&rng);
+        u8* pw = step(&walk, &tw, r, r2);
+        u8* pi = step(&index, &ti, r, r2);
+
+        assert_int_equal(tw.live, ti.live);
+        assert_true((pw == NULL) == (pi == NULL));
+
+        if (pw != NULL) {
+            assert_int_equal(pw - s_heap_walk, pi - s_heap_index);
+        }
+
+        assert_int_equal(mmGetRemainder(&walk), mmGetRemainder(&index));
+    }
+
+    assert_int_equal(mmGetRemainderMin(&walk), mmGetRemainderMin(&index));
+
+    // Free everything: both heaps are whole again
+    while (tw.live > 0) {
+        mmFree(&walk, tw.ptr[--tw.live]);
+        mmFree(&index, ti.ptr[--ti.live]);
+    }
+
+    assert_int_equal(mmGetRemainder(&walk), mmGetRemainder(&index));
+    assert_int_equal(mmAlloc(&index, HEAP_SIZE / 2, 1) - s_heap_index, mmAlloc(&walk, HEAP_SIZE / 2, 1) - s_heap_walk);
+}
+
+static void test_same_layout_ppg_unit(void** state) {
+    (void)state;
+
+    for (u32 seed = 1; seed <= 8; seed++) {
+        check_same_layout(UNIT_PPG, seed, 20000);
+    }
+}
+
+static void test_same_layout_ramcnt_unit(void** state) {
+    (void)state;
+
+    for (u32 seed = 100; seed <= 108; seed++) {
+        check_same_layout(UNIT_RAMCNT, seed, 20000);
+    }
+}
+
+static void test_exact_fits_and_ties(void** state) {
+    (void)state;
+    _MEMMAN_OBJ walk;
+    _MEMMAN_OBJ index;
+    u8* bw[16];
+    u8* bi[16];
+
+    init_heap(&walk, s_heap_walk, UNIT_PPG, 0);
+    init_heap(&index, s_heap_index, UNIT_PPG, 1);
+
+    // Equal-sized holes everywhere, so every pick is a tie
+    for (s32 i = 0; i < 16; i++) {
+        bw[i] = mmAlloc(&walk, 64, i & 1);
+        bi[i] = mmAlloc(&index, 64, i & 1);
+        assert_int_equal(bw[i] - s_heap_walk, bi[i] - s_heap_index);
+    }
+
+    for (s32 i = 0; i < 16; i += 3) {
+        mmFree(&walk, bw[i]);
+        mmFree(&index, bi[i]);
+    }
+
+    for (s32 i = 0; i < 8; i++) {
+        const ssize_t size = (i < 4) ? 64 : 8;
+
+        assert_int_equal(mmAlloc(&walk, size, i & 1) - s_heap_walk, mmAlloc(&index, size, i & 1) - s_heap_index);
+    }
+
+    // Nothing fits
+    assert_null(mmAlloc(&walk, HEAP_SIZE, 0));
+    assert_null(mmAlloc(&index, HEAP_SIZE, 0));
+    assert_null(mmAlloc(&index, HEAP_SIZE, 1));
+}
+
+static void test_more_heaps_than_slots(void** state) {
+    (void)state;
+    static u8 small[12][4096] __attribute__((aligned(64)));
+    _MEMMAN_OBJ heaps[12];
+    const s32 unit = UNIT_PPG;
+
+    // Older heaps lose their index to newer ones and keep working by walking
+    for (s32 i = 0; i < 12; i++) {
+        mmHeapInitialize(&heaps[i], small[i], sizeof(small[i]), unit, (s8*)"test");
+    }
+
+    for (s32 i = 0; i < 12; i++) {
+        u8* a = mmAlloc(&heaps[i], 100, 0);
+        u8* b = mmAlloc(&heaps[i], 100, 1);
+
+        assert_ptr_equal(a, small[i] + unit * 2);
+        assert_ptr_equal(b, small[i] + sizeof(small[i]) - unit - mmRoundUp(unit, 100));
+        mmFree(&heaps[i], a);
+        mmFree(&heaps[i], b);
+        assert_int_equal(mmGetRemainder(&heaps[i]), sizeof(small[i]) - unit * 2);
+    }
+}
+
+static double replay_ms(s32 indexed, u32 seed, s32 steps) {
+    _MEMMAN_OBJ mmobj;
+    Trace t = { 0 };
+    u32 rng = seed;
+    clock_t t0;
+
+    init_heap(&mmobj, indexed ? s_heap_index : s_heap_walk, UNIT_PPG, indexed);
+    t0 = clock();
+
+    for (s32 i = 0; i < steps; i++) {
+        const u32 r = next_rand(&rng);
+        const u32 r2 = next_rand(&rng);
+
+        step(&mmobj, &t, r, r2);
+    }
+
+    return (double)(clock() - t0) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/** Not a pass/fail gate: the same trace with and without the index. */
+static void test_replay_benchmark(void** state) {
+    (void)state;
+    const s32 steps = 200000;
+    const double walk_ms = replay_ms(0, 4242, steps);
+    const double index_ms = replay_ms(1, 4242, steps);
+
+    printf("MemMan trace replay: %d steps, up to %d live blocks: walk %.1f ms, gap index %.1f ms\n",
+           steps,
+           LIVE_MAX,
+           walk_ms,
+           index_ms);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_same_layout_ppg_unit),
+        cmocka_unit_test(test_same_layout_ramcnt_unit),
+        cmocka_unit_test(test_exact_fits_and_ties),
+        cmocka_unit_test(test_more_heaps_than_slots),
+        cmocka_unit_test(test_replay_benchmark),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
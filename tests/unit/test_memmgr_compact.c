@@ -0,0 +1,340 @@
+/**
+ * @file test_memmgr_compact.c
+ * @brief Stress tests for full and incremental memmgr compaction.
+ *
+ * Drives the AcrSDK memory manager through pseudo-random register, release,
+ * compact and budgeted compact-step sequences in both directions, and after
+ * every operation checks each live block's contents through plmemRetrieve
+ * and that no two blocks overlap. Also checks that stepping ends in exactly
+ * the layout a full compaction produces, that budgets bound each step, and
+ * that the move hook reports every block that moved.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include "sf33rd/AcrSDK/common/memmgr.h"
+
+#define POOL_SIZE 0x40000
+#define BLOCK_COUNT 256
+#define ALIGNMENT 16
+
+typedef struct {
+    MEM_MGR mgr;
+    MEM_BLOCK blocks[BLOCK_COUNT];
+    u32 len[BLOCK_COUNT + 1]; // By handle; 0 when not live
+    u8 seed[BLOCK_COUNT + 1];
+} Pool;
+
+static u8 s_mem_a[POOL_SIZE + ALIGNMENT] __attribute__((aligned(64)));
+static u8 s_mem_b[POOL_SIZE + ALIGNMENT] __attribute__((aligned(64)));
+static u8 s_expect[0x4000];
+
+static u32 next_rand(u32* rng) {
+    *rng = *rng * 1664525u + 1013904223u;
+    return *rng >> 8;
+}
+
+static void pool_init(Pool* pool, u8* mem, s32 direction) {
+    memset(pool, 0, sizeof(*pool));
+    plmemInit(&pool->mgr, pool->blocks, BLOCK_COUNT, mem, POOL_SIZE, ALIGNMENT, direction);
+}
+
+static void fill(u8* p, u32 len, u8 seed) {
+    for (u32 i = 0; i < len; i++) {
+        p[i] = (u8)(seed + i * 7);
+    }
+}
+
+static void check_pool(Pool* pool, const u8* mem) {
+    const u8* lo = mem;
+    const u8* hi = lo + POOL_SIZE;
+    const u8* prev_ptr = NULL;
+    u32 prev_len = 0;
+    s32 live = 0;
+
+    for (u32 han = 1; han <= BLOCK_COUNT; han++) {
+        const u8* p = plmemRetrieve(&pool->mgr, han);
+
+        if (pool->len[han] == 0) {
+            continue;
+        }
+
+        live += 1;
+        assert_non_null(p);
+        assert_true((p >= lo) && (p + pool->len[han] <= hi));
+
+        fill(s_expect, pool->len[han], pool->seed[han]);
+        assert_memory_equal(p, s_expect, pool->len[han]);
+    }
+
+    // The block list stays sorted away from memptr, without overlaps
+    for (u32 han = pool->mgr.blocklist; han != MEM_NULL_HANDLE; han = pool->blocks[han].next) {
+        const MEM_BLOCK* block = &pool->blocks[han];
+
+        if (prev_ptr != NULL) {
+            if (pool->mgr.direction != 0) {
+                assert_true(prev_ptr + prev_len <= block->ptr);
+            } else {
+                assert_true(block->ptr + block->len <= prev_ptr);
+            }
+        }
+
+        prev_ptr = block->ptr;
+        prev_len = block->len;
+        live -= 1;
+    }
+
+    assert_int_equal(live, 0);
+}
+
+/** One random operation; returns the handle registered (0 for none). */
+static u32 random_op(Pool* pool, u32* rng) {
+    const u32 r = next_rand(rng);
+    const u32 r2 = next_rand(rng);
+    u32 han;
+
+    if (r % 100 < 40) {
+        const u32 len = 1 + ((r2 % 8 == 0) ? r2 % 0x4000 : r2 % 0x600);
+
+        han = ((r >> 10) & 1) ? plmemRegisterS(&pool->mgr, len) : plmemRegister(&pool->mgr, len);
+
+        if (han != 0) {
+            pool->len[han] = len;
+            pool->seed[han] = (u8)r2;
+            fill(plmemRetrieve(&pool->mgr, han), len, (u8)r2);
+        }
+
+        return han;
+    }
+
+    if (r % 100 < 80) {
+        han = 1 + r2 % BLOCK_COUNT;
+
+        if (pool->len[han] != 0) {
+            assert_int_equal(plmemRelease(&pool->mgr, han), 1);
+            pool->len[han] = 0;
+        }
+
+        return 0;
+    }
+
+    if (r % 100 < 83) {
+        plmemCompact(&pool->mgr);
+    } else {
+        plmemCompactStep(&pool->mgr, r2 % 0x2000, ((r >> 12) & 1) ? 0 : ~(u64)0);
+    }
+
+    return 0;
+}
+
+static void stress(s32 direction, u32 seed) {
+    static Pool pool;
+    MEM_MGR_STATS stats;
+    u8* mem = s_mem_a;
+    u32 rng = seed;
+
+    pool_init(&pool, mem, direction);
+
+    for (s32 i = 0; i < 1500; i++) {
+        random_op(&pool, &rng);
+        check_pool(&pool, mem);
+    }
+
+    // Stepping to the end leaves one free run at the frontier
+    while (!plmemCompactStep(&pool.mgr, 0x800, ~(u64)0)) {
+        check_pool(&pool, mem);
+    }
+
+    check_pool(&pool, mem);
+    plmemGetStats(&pool.mgr, &stats);
+    assert_true(stats.compact_moves > 0);
+    assert_true(plmemGetFreeSpace(&pool.mgr) + pool.mgr.used_size + ALIGNMENT * BLOCK_COUNT >= POOL_SIZE);
+}
+
+static void test_stress_forward(void** state) {
+    (void)state;
+
+    for (u32 seed = 1; seed <= 3; seed++) {
+        stress(1, seed);
+    }
+}
+
+static void test_stress_reverse(void** state) {
+    (void)state;
+
+    for (u32 seed = 50; seed <= 52; seed++) {
+        stress(0, seed);
+    }
+}
+
+/** Same ops on two pools; one compacts at once, the other in small steps. */
+static void check_step_matches_full(s32 direction, u32 seed) {
+    static Pool full;
+    static Pool step;
+    u32 rng = seed;
+    s32 steps = 0;
+
+    pool_init(&full, s_mem_a, direction);
+    pool_init(&step, s_mem_b, direction);
+
+    for (s32 i = 0; i < 1500; i++) {
+        const u32 r = next_rand(&rng);
+
+        // Register and release only, so both pools fragment identically
+        if (r % 3 != 0) {
+            const u32 len = 1 + r % 0x900;
+            const u32 ha = plmemRegisterS(&full.mgr, len);
+            const u32 hb = plmemRegisterS(&step.mgr, len);
+
+            assert_int_equal(ha, hb);
+
+            if (ha != 0) {
+                full.len[ha] = step.len[hb] = len;
+                full.seed[ha] = step.seed[hb] = (u8)r;
+                fill(plmemRetrieve(&full.mgr, ha), len, (u8)r);
+                fill(plmemRetrieve(&step.mgr, hb), len, (u8)r);
+            }
+        } else {
+            const u32 han = 1 + (r >> 4) % BLOCK_COUNT;
+
+            if (full.len[han] != 0) {
+                plmemRelease(&full.mgr, han);
+                plmemRelease(&step.mgr, han);
+                full.len[han] = step.len[han] = 0;
+            }
+        }
+    }
+
+    plmemCompact(&full.mgr);
+
+    while (!plmemCompactStep(&step.mgr, 0x400, ~(u64)0)) {
+        steps += 1;
+    }
+
+    assert_true(steps > 0);
+    check_pool(&full, s_mem_a);
+    check_pool(&step, s_mem_b);
+    assert_int_equal(step.mgr.memnow - s_mem_b, full.mgr.memnow - s_mem_a);
+
+    for (u32 han = 1; han <= BLOCK_COUNT; han++) {
+        if (full.len[han] != 0) {
+            assert_int_equal((u8*)plmemRetrieve(&step.mgr, han) - s_mem_b,
+                             (u8*)plmemRetrieve(&full.mgr, han) - s_mem_a);
+        }
+    }
+
+    // A compacted pool has nothing left to move
+    assert_int_equal(plmemCompactStep(&step.mgr, 0, 0), 1);
+}
+
+static void test_step_matches_full(void** state) {
+    (void)state;
+
+    for (u32 seed = 10; seed <= 14; seed++) {
+        check_step_matches_full(1, seed);
+        check_step_matches_full(0, seed);
+    }
+}
+
+static void test_budgets(void** state) {
+    (void)state;
+    static Pool pool;
+    MEM_MGR_STATS stats;
+    u32 han[8];
+    u32 moves;
+
+    pool_init(&pool, s_mem_a, 1);
+
+    for (s32 i = 0; i < 8; i++) {
+        han[i] = plmemRegister(&pool.mgr, 0x1000);
+        pool.len[han[i]] = 0x1000;
+        pool.seed[han[i]] = (u8)i;
+        fill(plmemRetrieve(&pool.mgr, han[i]), 0x1000, (u8)i);
+    }
+
+    // Free the first block: the seven after it all have to move
+    plmemRelease(&pool.mgr, han[0]);
+    pool.len[han[0]] = 0;
+
+    // A budget smaller than one block still moves one block per call
+    for (s32 i = 0; i < 6; i++) {
+        assert_int_equal(plmemCompactStep(&pool.mgr, 1, ~(u64)0), 0);
+        plmemGetStats(&pool.mgr, &stats);
+        assert_int_equal(stats.compact_moves, i + 1);
+        assert_int_equal(stats.compact_steps, i + 1);
+        check_pool(&pool, s_mem_a);
+    }
+
+    assert_int_equal(plmemCompactStep(&pool.mgr, 1, ~(u64)0), 1);
+    plmemGetStats(&pool.mgr, &stats);
+    moves = stats.compact_moves;
+    assert_int_equal(moves, 7);
+    assert_int_equal(stats.compactions, 0);
+    assert_int_equal(stats.largest_free, POOL_SIZE - 0x7000);
+
+    // A zero time budget also moves one block per call
+    plmemRelease(&pool.mgr, han[1]);
+    pool.len[han[1]] = 0;
+    assert_int_equal(plmemCompactStep(&pool.mgr, POOL_SIZE, 0), 0);
+    plmemGetStats(&pool.mgr, &stats);
+    assert_int_equal(stats.compact_moves, moves + 1);
+
+    // A budget that covers the rest finishes in one call
+    assert_int_equal(plmemCompactStep(&pool.mgr, POOL_SIZE, ~(u64)0), 1);
+    check_pool(&pool, s_mem_a);
+    assert_int_equal(plmemGetFreeSpace(&pool.mgr), POOL_SIZE - 0x6000);
+}
+
+static struct {
+    s32 calls;
+    Pool* pool;
+} s_hook;
+
+static void move_hook(u32 handle, u8* old_ptr, u8* new_ptr) {
+    s_hook.calls += 1;
+    assert_ptr_not_equal(old_ptr, new_ptr);
+    assert_ptr_equal(plmemRetrieve(&s_hook.pool->mgr, handle), new_ptr);
+    assert_int_equal(new_ptr[0], s_hook.pool->seed[handle]);
+}
+
+static void test_move_hook(void** state) {
+    (void)state;
+    static Pool pool;
+    MEM_MGR_STATS stats;
+    u32 rng = 77;
+
+    pool_init(&pool, s_mem_a, 1);
+    plmemSetMoveHook(&pool.mgr, move_hook);
+    s_hook.calls = 0;
+    s_hook.pool = &pool;
+
+    for (s32 i = 0; i < 3000; i++) {
+        random_op(&pool, &rng);
+    }
+
+    plmemGetStats(&pool.mgr, &stats);
+    assert_true(stats.compact_moves > 0);
+    assert_int_equal(s_hook.calls, stats.compact_moves);
+
+    // Init clears the hook
+    plmemInit(&pool.mgr, pool.blocks, BLOCK_COUNT, s_mem_a, POOL_SIZE, ALIGNMENT, 1);
+    assert_null(pool.mgr.move_hook);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_stress_forward),
+        cmocka_unit_test(test_stress_reverse),
+        cmocka_unit_test(test_step_matches_full),
+        cmocka_unit_test(test_budgets),
+        cmocka_unit_test(test_move_hook),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
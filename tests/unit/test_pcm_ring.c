@@ -0,0 +1,199 @@
+/**
+ * @file test_pcm_ring.c
+ * @brief Unit tests for the SPSC PCM ring between the ADX decode worker and the audio callback.
+ *
+ * The stress test runs a producer thread writing odd-sized batches against
+ * a consumer reading odd-sized batches through a small ring, and checks that
+ * the sample stream arrives gap-free and in order. The discard tests check
+ * that a producer-side flush drops exactly the frames written before it.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+#include "cmocka.h"
+#include "port/sound/pcm_ring.h"
+
+#define STRESS_FRAMES 400000
+
+typedef struct {
+    PcmRing* r;
+    u32 count;
+} ProducerArgs;
+
+/** Left/right sample of frame @p n: distinct per frame and per channel. */
+static s16 sample_of(u32 n, int ch) {
+    return (s16)((n * 7 + (u32)ch * 3) & 0x7FFF);
+}
+
+static void fill_frames(s16* dst, u32 first, u32 count) {
+    for (u32 i = 0; i < count; i++) {
+        dst[i * 2] = sample_of(first + i, 0);
+        dst[i * 2 + 1] = sample_of(first + i, 1);
+    }
+}
+
+static void assert_frames(const s16* src, u32 first, u32 count) {
+    for (u32 i = 0; i < count; i++) {
+        assert_int_equal(src[i * 2], sample_of(first + i, 0));
+        assert_int_equal(src[i * 2 + 1], sample_of(first + i, 1));
+    }
+}
+
+static int producer_main(void* data) {
+    ProducerArgs* args = data;
+    s16 batch[97 * 2];
+    u32 next = 0;
+    u32 size = 1;
+
+    while (next < args->count) {
+        const u32 want = SDL_min(size, args->count - next);
+        fill_frames(batch, next, want);
+
+        u32 done = 0;
+        while (done < want) {
+            const u32 n = PcmRing_Write(args->r, batch + done * 2, want - done);
+
+            if (n == 0) {
+                SDL_Delay(0);
+            }
+            done += n;
+        }
+
+        next += want;
+        size = size % 85 + 13; // 13..97
+    }
+
+    return 0;
+}
+
+static void test_wraparound_order(void** state) {
+    (void)state;
+    s16 storage[16 * 2];
+    s16 buf[16 * 2];
+    PcmRing r;
+    u32 written = 0;
+    u32 read = 0;
+
+    PcmRing_Init(&r, storage, 16);
+    assert_int_equal(PcmRing_Space(&r), 16);
+
+    for (int round = 0; round < 200; round++) {
+        const u32 w = 1 + round % 11;
+        const u32 space = PcmRing_Space(&r);
+        const u32 expect = SDL_min(w, space);
+
+        fill_frames(buf, written, w);
+        assert_int_equal(PcmRing_Write(&r, buf, w), expect);
+        written += expect;
+        assert_int_equal(PcmRing_Count(&r), written - read);
+
+        const u32 n = PcmRing_Read(&r, buf, 1 + round % 7);
+        assert_frames(buf, read, n);
+        read += n;
+    }
+
+    // Full ring refuses writes, and drains completely
+    while (PcmRing_Space(&r) > 0) {
+        fill_frames(buf, written, 1);
+        written += PcmRing_Write(&r, buf, 1);
+    }
+    fill_frames(buf, written, 1);
+    assert_int_equal(PcmRing_Write(&r, buf, 1), 0);
+
+    while (read < written) {
+        const u32 n = PcmRing_Read(&r, buf, 5);
+        assert_true(n > 0);
+        assert_frames(buf, read, n);
+        read += n;
+    }
+    assert_int_equal(PcmRing_Read(&r, buf, 5), 0);
+}
+
+static void test_discard_drops_only_earlier_frames(void** state) {
+    (void)state;
+    s16 storage[32 * 2];
+    s16 buf[32 * 2];
+    PcmRing r;
+
+    PcmRing_Init(&r, storage, 32);
+
+    fill_frames(buf, 0, 20);
+    assert_int_equal(PcmRing_Write(&r, buf, 20), 20);
+    assert_int_equal(PcmRing_Read(&r, buf, 5), 5);
+
+    PcmRing_Discard(&r);
+    assert_int_equal(PcmRing_Pending(&r), 0);
+
+    // Frames written after the mark survive it
+    fill_frames(buf, 1000, 8);
+    assert_int_equal(PcmRing_Write(&r, buf, 8), 8);
+    assert_int_equal(PcmRing_Pending(&r), 8);
+
+    assert_int_equal(PcmRing_Read(&r, buf, 32), 8);
+    assert_frames(buf, 1000, 8);
+    assert_int_equal(PcmRing_Count(&r), 0);
+    assert_int_equal(PcmRing_Space(&r), 32);
+}
+
+static void test_discard_of_empty_ring_is_noop(void** state) {
+    (void)state;
+    s16 storage[8 * 2];
+    s16 buf[8 * 2];
+    PcmRing r;
+
+    PcmRing_Init(&r, storage, 8);
+    fill_frames(buf, 0, 6);
+    PcmRing_Write(&r, buf, 6);
+    assert_int_equal(PcmRing_Read(&r, buf, 6), 6);
+
+    PcmRing_Discard(&r);
+    fill_frames(buf, 6, 4);
+    PcmRing_Write(&r, buf, 4);
+    assert_int_equal(PcmRing_Read(&r, buf, 8), 4);
+    assert_frames(buf, 6, 4);
+}
+
+static void test_concurrent_stress(void** state) {
+    (void)state;
+    static s16 storage[256 * 2];
+    s16 buf[61 * 2];
+    PcmRing r;
+    ProducerArgs args = { &r, STRESS_FRAMES };
+    SDL_Thread* producer;
+    u32 expect = 0;
+    u32 size = 1;
+
+    PcmRing_Init(&r, storage, 256);
+
+    producer = SDL_CreateThread(producer_main, "pcm_producer", &args);
+    assert_non_null(producer);
+
+    while (expect < STRESS_FRAMES) {
+        const u32 n = PcmRing_Read(&r, buf, size);
+
+        if (n == 0) {
+            SDL_Delay(0); // Let the producer run on single-core machines
+            continue;
+        }
+
+        assert_frames(buf, expect, n);
+        expect += n;
+        size = size % 55 + 7; // 7..61
+    }
+
+    SDL_WaitThread(producer, NULL);
+    assert_int_equal(PcmRing_Count(&r), 0);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_wraparound_order),
+        cmocka_unit_test(test_discard_drops_only_earlier_frames),
+        cmocka_unit_test(test_discard_of_empty_ring_is_noop),
+        cmocka_unit_test(test_concurrent_stress),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,255 @@
+/**
+ * @file test_ppg_chunk_dir.c
+ * @brief Unit tests for the cached PPG chunk directory.
+ *
+ * Builds synthetic PPG buffers with interleaved pTEX, pPAL, pCMP and
+ * unknown chunks, and checks every directory lookup against a plain walk
+ * of the chunk chain. The last test compares per-chunk lookup cost for a
+ * large file against the walk (reported, not gated).
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include "sf33rd/Source/Common/PPGChunkDir.h"
+
+#define BUF_SIZE 0x40000
+#define BENCH_CHUNKS 512
+
+static const char* const s_magic[] = { "pCMP", "pPAL", "pTEX", "pXYZ" };
+
+static u8 s_buf[BUF_SIZE];
+static u8 s_buf2[BUF_SIZE];
+
+static void put_be32(u8* p, u32 v) {
+    p[0] = (u8)(v >> 24);
+    p[1] = (u8)(v >> 16);
+    p[2] = (u8)(v >> 8);
+    p[3] = (u8)v;
+}
+
+/** Fill @p buf with @p chunks chunks of pseudo-random kind and size; returns the size used. */
+static u32 make_ppg(u8* buf, s32 chunks, u32 seed) {
+    u32 ofs = 0;
+
+    memset(buf, 0, BUF_SIZE);
+
+    for (s32 i = 0; i < chunks; i++) {
+        seed = seed * 1664525u + 1013904223u;
+
+        const s32 kind = (seed >> 8) % 4;
+        const u32 size = 16 + (seed >> 12) % 200; // Not always a multiple of 4
+
+        memcpy(buf + ofs, s_magic[kind], 4);
+        put_be32(buf + ofs + 4, size);
+        buf[ofs + 10] = (u8)((seed >> 20) % 3);
+        ofs += (size + 3) & ~3u;
+    }
+
+    memcpy(buf + ofs, "pEND", 4);
+    return ofs + 16;
+}
+
+/** Reference: the walk the PPG loaders used to do. Returns the chunk offset or -1. */
+static s32 linear_find(const u8* buf, const char* magic, s32 num) {
+    u32 ofs = 0;
+
+    while (memcmp(buf + ofs, "pEND", 4) != 0) {
+        const u32 size = ((u32)buf[ofs + 4] << 24) | ((u32)buf[ofs + 5] << 16) | ((u32)buf[ofs + 6] << 8) |
+                         buf[ofs + 7];
+
+        if (memcmp(buf + ofs, magic, 4) == 0) {
+            if (num == 0) {
+                return (s32)ofs;
+            }
+
+            num -= 1;
+        }
+
+        ofs += (size + 3) & ~3u;
+    }
+
+    return -1;
+}
+
+static int setup(void** state) {
+    (void)state;
+    ppgChunkDirForget(NULL);
+    return 0;
+}
+
+static void check_against_walk(const u8* buf) {
+    for (s32 kind = 0; kind < PPG_CHUNK_KINDS; kind++) {
+        const s32 count = ppgChunkDirCount(buf, kind);
+        s32 expected_count = 0;
+
+        while (linear_find(buf, s_magic[kind], expected_count) >= 0) {
+            expected_count += 1;
+        }
+
+        assert_int_equal(count, expected_count);
+
+        for (s32 n = 0; n < count; n++) {
+            const PPGChunkInfo* info = ppgChunkDirFind(buf, kind, n);
+            const s32 ofs = linear_find(buf, s_magic[kind], n);
+
+            assert_non_null(info);
+            assert_int_equal(info->ofs, ofs);
+            assert_int_equal(info->size, ((u32)buf[ofs + 6] << 8) | buf[ofs + 7]);
+            assert_int_equal(info->compress, buf[ofs + 10] & 3);
+        }
+
+        assert_null(ppgChunkDirFind(buf, kind, count));
+        assert_null(ppgChunkDirFind(buf, kind, -1));
+    }
+}
+
+static void test_lookups_match_walk(void** state) {
+    (void)state;
+
+    for (u32 seed = 1; seed <= 20; seed++) {
+        make_ppg(s_buf, 1 + (s32)(seed * 7) % 64, seed);
+        ppgChunkDirForget(s_buf);
+        check_against_walk(s_buf);
+    }
+}
+
+static void test_directory_built_once_per_buffer(void** state) {
+    (void)state;
+    PPGChunkDirStats before;
+    PPGChunkDirStats after;
+
+    make_ppg(s_buf, 40, 99);
+    make_ppg(s_buf2, 30, 77);
+    ppgChunkDirGetStats(&before);
+
+    for (s32 pass = 0; pass < 3; pass++) {
+        check_against_walk(s_buf);
+        check_against_walk(s_buf2);
+    }
+
+    ppgChunkDirGetStats(&after);
+    assert_int_equal(after.builds - before.builds, 2);
+    assert_true(after.lookups - before.lookups > 2);
+}
+
+static void test_forget_and_reuse(void** state) {
+    (void)state;
+    PPGChunkDirStats before;
+    PPGChunkDirStats after;
+
+    make_ppg(s_buf, 40, 5);
+    check_against_walk(s_buf);
+
+    // Same address, new file: the owner forgets the old directory first
+    make_ppg(s_buf, 12, 6);
+    ppgChunkDirForget(s_buf);
+    ppgChunkDirGetStats(&before);
+    check_against_walk(s_buf);
+    ppgChunkDirGetStats(&after);
+    assert_int_equal(after.builds - before.builds, 1);
+
+    // A reuse without a forget is still caught when the first chunk header differs
+    make_ppg(s_buf, 20, 8);
+    check_against_walk(s_buf);
+}
+
+static void test_empty_and_degenerate(void** state) {
+    (void)state;
+
+    memset(s_buf, 0, 32);
+    memcpy(s_buf, "pEND", 4);
+    ppgChunkDirForget(s_buf);
+
+    for (s32 kind = 0; kind < PPG_CHUNK_KINDS; kind++) {
+        assert_int_equal(ppgChunkDirCount(s_buf, kind), 0);
+        assert_null(ppgChunkDirFind(s_buf, kind, 0));
+    }
+
+    // A zero-sized chunk ends the chain instead of looping
+    memcpy(s_buf, "pTEX", 4);
+    put_be32(s_buf + 4, 32);
+    memcpy(s_buf + 32, "pPAL", 4);
+    put_be32(s_buf + 36, 0);
+    ppgChunkDirForget(s_buf);
+    assert_int_equal(ppgChunkDirCount(s_buf, PPG_CHUNK_TEX), 1);
+    assert_int_equal(ppgChunkDirCount(s_buf, PPG_CHUNK_PAL), 0);
+
+    assert_null(ppgChunkDirFind(NULL, PPG_CHUNK_TEX, 0));
+}
+
+static void test_many_buffers_evict_lru(void** state) {
+    (void)state;
+    static u8 bufs[12][1024];
+
+    // More buffers than directory slots: results stay right while slots are recycled
+    for (s32 round = 0; round < 3; round++) {
+        for (s32 i = 0; i < 12; i++) {
+            u32 ofs = 0;
+
+            memset(bufs[i], 0, sizeof(bufs[i]));
+
+            for (s32 c = 0; c <= i; c++) {
+                memcpy(bufs[i] + ofs, "pTEX", 4);
+                put_be32(bufs[i] + ofs + 4, 16);
+                ofs += 16;
+            }
+
+            memcpy(bufs[i] + ofs, "pEND", 4);
+            assert_int_equal(ppgChunkDirCount(bufs[i], PPG_CHUNK_TEX), i + 1);
+            assert_int_equal(ppgChunkDirFind(bufs[i], PPG_CHUNK_TEX, i)->ofs, i * 16);
+        }
+    }
+}
+
+/** Not a pass/fail gate: loading every texture of a big stage file one chunk at a time. */
+static void test_lookup_benchmark(void** state) {
+    (void)state;
+    volatile s32 sink = 0;
+    clock_t t0;
+    double walk_ms;
+    double dir_ms;
+    s32 count;
+
+    make_ppg(s_buf, BENCH_CHUNKS, 1234);
+    ppgChunkDirForget(s_buf);
+    count = ppgChunkDirCount(s_buf, PPG_CHUNK_TEX);
+
+    t0 = clock();
+    for (s32 n = 0; n < count; n++) {
+        sink += linear_find(s_buf, "pTEX", n);
+    }
+    walk_ms = (double)(clock() - t0) * 1000.0 / CLOCKS_PER_SEC;
+
+    t0 = clock();
+    for (s32 n = 0; n < count; n++) {
+        sink += (s32)ppgChunkDirFind(s_buf, PPG_CHUNK_TEX, n)->ofs;
+    }
+    dir_ms = (double)(clock() - t0) * 1000.0 / CLOCKS_PER_SEC;
+
+    printf("PPG chunk lookup: %d textures in %d chunks: walk %.3f ms, directory %.3f ms\n",
+           count,
+           BENCH_CHUNKS,
+           walk_ms,
+           dir_ms);
+    (void)sink;
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup(test_lookups_match_walk, setup),
+        cmocka_unit_test_setup(test_directory_built_once_per_buffer, setup),
+        cmocka_unit_test_setup(test_forget_and_reuse, setup),
+        cmocka_unit_test_setup(test_empty_and_degenerate, setup),
+        cmocka_unit_test_setup(test_many_buffers_evict_lru, setup),
+        cmocka_unit_test_setup(test_lookup_benchmark, setup),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,502 @@
+/**
+ * @file test_ppg_stream.c
+ * @brief Tests for windowed PPG decompression into the final buffer.
+ *
+ * Builds random LZ77 code streams covering every code kind and reach,
+ * zlib streams and raw data, and checks that ppgStreamDecompress() returns
+ * what ppgDecompress() would, that its windows are in order, whole units
+ * and already final when handed over, and that rewriting each window in
+ * place never disturbs the bytes still to come. Also checks that a texture
+ * expanded and converted in place is byte-identical to one created from a
+ * separate swapped buffer, for every pixel depth.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+#include <zlib.h>
+
+#include "sf33rd/AcrSDK/ps2/flps2vram.h"
+#include "sf33rd/AcrSDK/ps2/foundaps2.h"
+#include "sf33rd/Source/Common/PPGStream.h"
+#include "sf33rd/Source/Compress/Lz77/Lz77Dec.h"
+#include "sf33rd/Source/Compress/zlibApp.h"
+
+#define MAX_SIZE (256 * 256 * 4)
+#define ZLIB_HEAP_SIZE 0x10000 // As in main.c
+
+/* --- Stubs for flps2vram.c --- */
+
+FLTexture flTexture[FL_TEXTURE_MAX];
+FLTexture flPalette[FL_PALETTE_MAX];
+
+static u8* s_sysmem[64];
+static s32 s_sysmem_count;
+
+u32 flPS2GetSystemMemoryHandle(s32 len, s32 type) {
+    (void)type;
+    s_sysmem[s_sysmem_count] = malloc(len);
+    memset(s_sysmem[s_sysmem_count], 0xCD, len);
+    return ++s_sysmem_count;
+}
+
+void* flPS2GetSystemBuffAdrs(u32 handle) {
+    return s_sysmem[handle - 1];
+}
+
+void flPS2ReleaseSystemMemory(u32 handle) {
+    free(s_sysmem[handle - 1]);
+    s_sysmem[handle - 1] = NULL;
+}
+
+void flMemcpy(void* dst, void* src, s32 size) {
+    memcpy(dst, src, size);
+}
+
+void flMemset(void* dst, u32 pat, s32 size) {
+    memset(dst, pat, size);
+}
+
+s32 flLogOut(s8* format, ...) {
+    (void)format;
+    return 0;
+}
+
+void flPS2SystemError(s32 error_level, s8* format, ...) {
+    (void)error_level;
+    (void)format;
+    fail();
+}
+
+void* mflTemporaryUse(s32 len) {
+    (void)len;
+    return NULL;
+}
+
+void SDLGameRenderer_CreateTexture(unsigned int th) {
+    (void)th;
+}
+
+void SDLGameRenderer_DestroyTexture(unsigned int th) {
+    (void)th;
+}
+
+void SDLGameRenderer_UnlockTexture(unsigned int th) {
+    (void)th;
+}
+
+void SDLGameRenderer_CreatePalette(unsigned int ph) {
+    (void)ph;
+}
+
+void SDLGameRenderer_DestroyPalette(unsigned int ph) {
+    (void)ph;
+}
+
+void SDLGameRenderer_UnlockPalette(unsigned int ph) {
+    (void)ph;
+}
+
+/* --- Random LZ77 code streams --- */
+
+static u8 s_src[MAX_SIZE * 2];
+static u8 s_ref[MAX_SIZE + 0x10000];
+static u8 s_dst[MAX_SIZE + 0x10000];
+static u8 s_zlib_heap[ZLIB_HEAP_SIZE] __attribute__((aligned(16)));
+static u32 s_rng;
+
+static u32 next_rand(void) {
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return s_rng >> 8;
+}
+
+static s32 pick_len(s32 max, s32 remaining) {
+    const s32 len = 1 + (s32)(next_rand() % (u32)max);
+
+    return (len < remaining) ? len : remaining;
+}
+
+/** Emit random codes of every kind until exactly @p size bytes would be produced; returns the stream length. */
+static s32 make_lz77(u8* out, s32 size) {
+    u8* const start = out;
+    s32 produced = 0;
+
+    while (produced < size) {
+        const s32 remaining = size - produced;
+        const u32 kind = next_rand() % 10;
+        s32 len;
+
+        if ((kind < 3) && (produced >= 1)) {
+            // Short copy: up to 16 bytes from up to 0x800 back
+            const s32 dist = 1 + (s32)(next_rand() % (u32)((produced < 0x800) ? produced : 0x800));
+            u32 code;
+
+            len = pick_len(16, remaining);
+            code = ((u32)(dist & 0x7FF) << 4) | (u32)(len & 0xF);
+            *out++ = (u8)(code >> 8);
+            *out++ = (u8)code;
+        } else if ((kind < 6) && (produced >= 1)) {
+            // Long copy: up to 0x80 bytes from up to LZ77_MAX_DISTANCE back, sometimes with a step
+            const s32 far = (next_rand() % 4 == 0) ? LZ77_MAX_DISTANCE : 0x200;
+            const s32 dist = 1 + (s32)(next_rand() % (u32)((produced < far) ? produced : far));
+            const u8 step = (next_rand() % 3 == 0) ? (u8)next_rand() : 0;
+
+            len = pick_len(0x80, remaining);
+            *out++ = (u8)(0xC0 | ((dist >> 8) & 0x3F));
+            *out++ = (u8)dist;
+            *out++ = (u8)((step ? 0x80 : 0) | (len & 0x7F));
+
+            if (step) {
+                *out++ = step;
+            }
+        } else if (kind < 8) {
+            // Literals, 8- or 16-bit count
+            const s32 wide = next_rand() % 8 == 0;
+
+            len = pick_len(wide ? 0x3000 : 0x100, remaining);
+
+            if (wide) {
+                *out++ = 0x82;
+                *out++ = (u8)(len >> 8);
+                *out++ = (u8)len;
+            } else {
+                *out++ = 0x81;
+                *out++ = (u8)len;
+            }
+
+            for (s32 i = 0; i < len; i++) {
+                *out++ = (u8)next_rand();
+            }
+        } else {
+            // Fills and incrementing fills, 8- or 16-bit count
+            const s32 wide = next_rand() % 4 == 0;
+            const s32 inc = next_rand() % 2;
+
+            len = pick_len(wide ? 0x6000 : 0x100, remaining);
+            *out++ = (u8)(0x83 + (wide ? 1 : 0) + (inc ? 2 : 0));
+            *out++ = (u8)next_rand();
+
+            if (inc) {
+                *out++ = (u8)next_rand();
+            }
+
+            if (wide) {
+                *out++ = (u8)(len >> 8);
+            }
+
+            *out++ = (u8)len;
+        }
+
+        produced += len;
+    }
+
+    return (s32)(out - start);
+}
+
+/* --- Sink that checks each window, then rewrites it in place --- */
+
+typedef struct {
+    u8* base;
+    s32 next;
+    s32 unit;
+    s32 windows;
+    bool last;
+} Check;
+
+static void check_sink(u8* adrs, s32 size, void* user) {
+    Check* check = user;
+    const s32 ofs = (s32)(adrs - check->base);
+
+    assert_false(check->last);
+    assert_int_equal(ofs, check->next);
+    assert_true(size > 0);
+    assert_true(size <= PPG_STREAM_WINDOW || size == check->unit);
+
+    if (size % check->unit != 0) {
+        check->last = true;
+    }
+
+    assert_memory_equal(adrs, s_ref + ofs, size);
+
+    for (s32 i = 0; i < size; i++) {
+        adrs[i] ^= 0xA5;
+    }
+
+    check->next += size;
+    check->windows += 1;
+}
+
+static void null_sink(u8* adrs, s32 size, void* user) {
+    (void)adrs;
+    (void)size;
+    (void)user;
+}
+
+static void check_transformed(s32 size) {
+    for (s32 i = 0; i < size; i++) {
+        if ((u8)(s_dst[i] ^ 0xA5) != s_ref[i]) {
+            assert_int_equal(i, -1);
+        }
+    }
+}
+
+static Check stream(s32 koCmpr, s32 srcSize, s32 size, s32 unit, ssize_t expect) {
+    Check check = { s_dst, 0, unit, 0, false };
+
+    memset(s_dst, 0xEE, sizeof(s_dst));
+    assert_int_equal(ppgStreamDecompress(koCmpr, s_src, srcSize, s_dst, size, unit, check_sink, &check), expect);
+    return check;
+}
+
+static const s32 s_sizes[] = { 1, 100, 0x3FFF, 0x4000, 0x4001, 0x9000, 0x12345, 128 * 128 * 2, MAX_SIZE };
+static const s32 s_units[] = { 1, 16, 64, 512, 1024, 3000 };
+
+static void test_lz77_windows_match_whole(void** state) {
+    (void)state;
+
+    for (s32 i = 0; i < (s32)(sizeof(s_sizes) / sizeof(s_sizes[0])); i++) {
+        for (s32 u = 0; u < (s32)(sizeof(s_units) / sizeof(s_units[0])); u++) {
+            const s32 size = s_sizes[i];
+            s32 srcSize;
+            Check check;
+
+            s_rng = (u32)(i * 31 + u);
+            srcSize = make_lz77(s_src, size);
+            assert_int_equal(decLZ77withSizeCheck(s_src, s_ref, size), 1);
+
+            check = stream(1, srcSize, size, s_units[u], size);
+            assert_int_equal(check.next, size);
+            check_transformed(size);
+        }
+    }
+}
+
+static void test_zlib_windows_match_whole(void** state) {
+    (void)state;
+    zlib_Initialize(s_zlib_heap, ZLIB_HEAP_SIZE);
+
+    for (s32 i = 0; i < (s32)(sizeof(s_sizes) / sizeof(s_sizes[0])); i++) {
+        for (s32 u = 0; u < (s32)(sizeof(s_units) / sizeof(s_units[0])); u++) {
+            const s32 size = s_sizes[i];
+            uLongf srcSize = sizeof(s_src);
+            Check check;
+
+            // Compressible content: the LZ77 stream's output
+            s_rng = (u32)(i * 17 + u);
+            make_lz77(s_src, size);
+            assert_int_equal(decLZ77withSizeCheck(s_src, s_ref, size), 1);
+            assert_int_equal(compress2(s_src, &srcSize, s_ref, size, u % 10), Z_OK);
+
+            check = stream(2, (s32)srcSize, size, s_units[u], size);
+            assert_int_equal(check.next, size);
+            check_transformed(size);
+
+            // Same bytes as the one-shot inflate
+            assert_int_equal(zlib_Decompress(s_src, (s32)srcSize, s_dst, size), size);
+            assert_memory_equal(s_dst, s_ref, size);
+        }
+    }
+}
+
+static void test_raw_copy(void** state) {
+    (void)state;
+
+    for (s32 i = 0; i < (s32)(sizeof(s_sizes) / sizeof(s_sizes[0])); i++) {
+        const s32 size = s_sizes[i];
+        Check check;
+
+        s_rng = (u32)i;
+
+        for (s32 j = 0; j < size; j++) {
+            s_src[j] = s_ref[j] = (u8)next_rand();
+        }
+
+        // Like ppgDecompress, a raw chunk reports its source size
+        check = stream(0, size + 16, size, 64, size + 16);
+        assert_int_equal(check.next, size);
+        check_transformed(size);
+    }
+}
+
+static void test_bad_streams_fail(void** state) {
+    (void)state;
+    uLongf srcSize = sizeof(s_src);
+    s32 lzSize;
+
+    zlib_Initialize(s_zlib_heap, ZLIB_HEAP_SIZE);
+
+    // LZ77 whose last code (a 0x100-byte fill) runs past the expected size
+    s_rng = 5;
+    lzSize = make_lz77(s_src, 0x8F00);
+    s_src[lzSize++] = 0x83;
+    s_src[lzSize++] = 0x11;
+    s_src[lzSize++] = 0x00;
+    assert_int_equal(decLZ77withSizeCheck(s_src, s_ref, 0x9000), 1);
+    stream(1, lzSize, 0x9000 - 0x80, 16, 0);
+
+    // zlib: longer than expected, shorter than expected, damaged; none may leak the zlib heap
+    assert_int_equal(compress2(s_src, &srcSize, s_ref, 0x9000, 6), Z_OK);
+
+    for (s32 i = 0; i < 50; i++) {
+        stream(2, (s32)srcSize, 0x8000, 16, 0);
+        assert_true(stream(2, (s32)srcSize, 0x9000, 16, 0x9000).next == 0x9000);
+        assert_true(ppgStreamDecompress(2, s_src, (s32)srcSize - 20, s_dst, 0x9000, 16, null_sink, NULL) != 0x9000);
+    }
+
+    s_src[srcSize / 2] ^= 0xFF;
+    assert_true(ppgStreamDecompress(2, s_src, (s32)srcSize, s_dst, 0x9000, 16, null_sink, NULL) != 0x9000);
+    s_src[srcSize / 2] ^= 0xFF;
+
+    // The heap is still whole enough for a full-size stream
+    assert_true(stream(2, (s32)srcSize, 0x9000, 16, 0x9000).next == 0x9000);
+}
+
+/* --- In-place textures vs a separate buffer --- */
+
+typedef struct {
+    const char* name;
+    s32 bitdepth; // As set up by ppgSetupContextFromPPG
+    s32 swap;     // 0 = none, 2 = 16-bit, 4 = 32-bit (ppgChangeDataEndian)
+    s32 width;
+    s32 height;
+} TexCase;
+
+static void setup_bits(plContext* bits, const TexCase* tc) {
+    memset(bits, 0, sizeof(*bits));
+    bits->width = tc->width;
+    bits->height = tc->height;
+    bits->bitdepth = tc->bitdepth;
+
+    switch (tc->bitdepth) {
+    case 0:
+        bits->desc = 0x14;
+        bits->pitch = tc->width / 2;
+        break;
+
+    case 1:
+        bits->desc = 4;
+        bits->pitch = tc->width;
+        break;
+
+    case 2:
+        // ARGB1555
+        bits->desc = 2;
+        bits->pitch = tc->width * 2;
+        bits->pixelformat = (PixelFormat) { 5, 0xA, 0x1F, 5, 5, 0x1F, 5, 0, 0x1F, 1, 0xF, 1 };
+        break;
+
+    case 4:
+        bits->desc = 2;
+        bits->pitch = tc->width * 4;
+        bits->pixelformat = (PixelFormat) { 8, 0x10, 0xFF, 8, 8, 0xFF, 8, 0, 0xFF, 8, 0x18, 0xFF };
+        break;
+    }
+}
+
+static void swap_endian(u8* p, s32 size, s32 swap) {
+    if (swap == 0) {
+        return;
+    }
+
+    for (s32 i = 0; i + swap <= size; i += swap) {
+        for (s32 j = 0; j < swap / 2; j++) {
+            const u8 t = p[i + j];
+
+            p[i + j] = p[i + swap - 1 - j];
+            p[i + swap - 1 - j] = t;
+        }
+    }
+}
+
+typedef struct {
+    u32 th;
+    plContext* bits;
+    u8* base;
+    s32 swap;
+} TexSink;
+
+static void tex_sink(u8* adrs, s32 size, void* user) {
+    TexSink* ts = user;
+
+    swap_endian(adrs, size, ts->swap);
+    flPS2ConvertTextureRows(ts->th, ts->bits, (s32)(adrs - ts->base) / ts->bits->pitch, size / ts->bits->pitch);
+}
+
+static void test_texture_in_place_matches(void** state) {
+    (void)state;
+    static const TexCase cases[] = {
+        { "4-bit", 0, 0, 256, 128 }, { "8-bit", 1, 0, 128, 256 }, { "16-bit", 2, 2, 256, 256 },
+        { "16-bit LE", 2, 0, 64, 32 }, { "32-bit", 4, 4, 256, 256 }, { "32-bit LE", 4, 0, 32, 64 },
+    };
+
+    zlib_Initialize(s_zlib_heap, ZLIB_HEAP_SIZE);
+
+    for (s32 c = 0; c < (s32)(sizeof(cases) / sizeof(cases[0])); c++) {
+        for (s32 koCmpr = 0; koCmpr <= 2; koCmpr++) {
+            const TexCase* tc = &cases[c];
+            plContext bits;
+            TexSink ts;
+            u32 th_old;
+            u32 th_new;
+            u8* pixels;
+            s32 size;
+            s32 srcSize;
+
+            setup_bits(&bits, tc);
+            size = bits.pitch * bits.height;
+            s_rng = (u32)(c * 3 + koCmpr);
+            srcSize = make_lz77(s_src, size);
+            assert_int_equal(decLZ77withSizeCheck(s_src, s_ref, size), 1);
+
+            if (koCmpr == 0) {
+                memcpy(s_src, s_ref, size);
+                srcSize = size;
+            } else if (koCmpr == 2) {
+                uLongf zSize = sizeof(s_src);
+
+                assert_int_equal(compress2(s_src, &zSize, s_ref, size, 6), Z_OK);
+                srcSize = (s32)zSize;
+            }
+
+            // Old path: expand into a scratch buffer, swap it, create the texture from it
+            memcpy(s_dst, s_ref, size);
+            swap_endian(s_dst, size, tc->swap);
+            bits.ptr = s_dst;
+            th_old = flCreateTextureHandle(0, &bits, 0);
+            assert_true(th_old != 0);
+
+            // New path: expand into the texture's memory, converting window by window
+            bits.ptr = NULL;
+            th_new = flCreateTextureHandleInPlace(&bits, 0, &pixels);
+            assert_true(th_new != 0);
+            assert_true(th_new != th_old);
+            ts = (TexSink) { th_new, &bits, pixels, tc->swap };
+            assert_int_equal(ppgStreamDecompress(koCmpr, s_src, srcSize, pixels, size, bits.pitch, tex_sink, &ts),
+                             (koCmpr == 0) ? srcSize : size);
+            flPS2CreateTextureHandle(th_new, 0);
+
+            assert_int_equal(flTexture[th_new - 1].size, flTexture[th_old - 1].size);
+            assert_int_equal(flTexture[th_new - 1].format, flTexture[th_old - 1].format);
+            assert_memory_equal(flPS2GetSystemBuffAdrs(flTexture[th_new - 1].mem_handle),
+                                flPS2GetSystemBuffAdrs(flTexture[th_old - 1].mem_handle),
+                                flTexture[th_old - 1].size);
+
+            flReleaseTextureHandle(th_new);
+            flReleaseTextureHandle(th_old);
+        }
+    }
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_lz77_windows_match_whole), cmocka_unit_test(test_zlib_windows_match_whole),
+        cmocka_unit_test(test_raw_copy),                 cmocka_unit_test(test_bad_streams_fail),
+        cmocka_unit_test(test_texture_in_place_matches),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
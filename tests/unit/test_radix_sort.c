@@ -1,6 +1,7 @@
 /**
  * @file test_radix_sort.c
- * @brief Unit tests for the radix sort used in SDL2D z-depth ordering.
+ * @brief Unit tests for the radix sort used in SDL2D z-depth ordering
+ *        and the 64-bit state sort key used by the GL/GPU backends.
  */
 #include <stdarg.h>
 #include <stddef.h>
@@ -18,6 +19,8 @@
 static uint32_t test_keys[TEST_MAX];
 static int      test_scratch[TEST_MAX];
 static int      test_order[TEST_MAX];
+static uint64_t test_keys64[TEST_MAX];
+static float    test_bounds[TEST_MAX * 4];
 
 /* --- Helpers --- */
 
@@ -159,6 +162,113 @@ static void test_float_to_sortable_monotonic(void** state) {
     }
 }
 
+/* --- 64-bit state key --- */
+
+static void set_bounds(int i, float x0, float y0, float x1, float y1) {
+    test_bounds[i * 4 + 0] = x0;
+    test_bounds[i * 4 + 1] = y0;
+    test_bounds[i * 4 + 2] = x1;
+    test_bounds[i * 4 + 3] = y1;
+}
+
+static void test_key64_z_dominates_state(void** state) {
+    (void)state;
+    /* Lower z must win even against a lower texture/palette */
+    uint64_t a = render_sort_key(1.0f, RENDER_SORT_BLEND_ALPHA, 0xFFFF, 0x3FFF);
+    uint64_t b = render_sort_key(2.0f, RENDER_SORT_BLEND_ALPHA, 0, 0);
+    assert_true(a < b);
+    /* Same z: texture, then palette */
+    uint64_t c = render_sort_key(2.0f, RENDER_SORT_BLEND_ALPHA, 3, 9);
+    uint64_t d = render_sort_key(2.0f, RENDER_SORT_BLEND_ALPHA, 4, 0);
+    assert_true(c < d);
+    assert_true(b < c);
+}
+
+static void test_key64_groups_equal_z_by_state(void** state) {
+    (void)state;
+    /* z=5 group with interleaved textures A,B,A,B — expect A,A,B,B */
+    test_keys64[0] = render_sort_key(5.0f, 0, 2, 0);
+    test_keys64[1] = render_sort_key(5.0f, 0, 1, 0);
+    test_keys64[2] = render_sort_key(5.0f, 0, 2, 0);
+    test_keys64[3] = render_sort_key(5.0f, 0, 1, 0);
+    test_keys64[4] = render_sort_key(1.0f, 0, 7, 0);
+
+    radix_sort_indices_by_key64(test_order, test_keys64, 5, test_scratch);
+
+    assert_int_equal(test_order[0], 4);
+    assert_int_equal(test_order[1], 1); /* ties keep ascending submission order */
+    assert_int_equal(test_order[2], 3);
+    assert_int_equal(test_order[3], 0);
+    assert_int_equal(test_order[4], 2);
+}
+
+static void test_key64_uniform_keys_keep_submission_order(void** state) {
+    (void)state;
+    /* Every pass is skipped — order must stay identity */
+    for (int i = 0; i < 64; i++) {
+        test_keys64[i] = render_sort_key(3.0f, 0, 5, 5);
+    }
+    radix_sort_indices_by_key64(test_order, test_keys64, 64, test_scratch);
+    for (int i = 0; i < 64; i++) {
+        assert_int_equal(test_order[i], i);
+    }
+}
+
+static void test_key64_matches_reference_order(void** state) {
+    (void)state;
+    /* Pseudo-random keys varying in an odd number of bytes; compare to insertion sort */
+    const int count = 512;
+    uint32_t seed = 12345;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1103515245u + 12345u;
+        const float z = (float)((seed >> 16) % 16);
+        test_keys64[i] = render_sort_key(z, 0, (seed >> 8) & 0x3, 0);
+    }
+    radix_sort_indices_by_key64(test_order, test_keys64, count, test_scratch);
+
+    for (int i = 1; i < count; i++) {
+        const uint64_t prev = test_keys64[test_order[i - 1]];
+        const uint64_t curr = test_keys64[test_order[i]];
+        assert_true(prev <= curr);
+        if (prev == curr) {
+            assert_true(test_order[i - 1] < test_order[i]);
+        }
+    }
+}
+
+static void test_restore_overlaps_keeps_disjoint_grouping(void** state) {
+    (void)state;
+    /* Two side-by-side tiles at the same z — regrouping is safe */
+    test_keys64[0] = render_sort_key(1.0f, 0, 9, 0);
+    test_keys64[1] = render_sort_key(1.0f, 0, 2, 0);
+    set_bounds(0, 0, 0, 16, 16);
+    set_bounds(1, 16, 0, 32, 16);
+
+    radix_sort_indices_by_key64(test_order, test_keys64, 2, test_scratch);
+    render_sort_restore_overlaps(test_order, test_keys64, test_bounds, 2);
+
+    assert_int_equal(test_order[0], 1);
+    assert_int_equal(test_order[1], 0);
+}
+
+static void test_restore_overlaps_reverts_overlapping_group(void** state) {
+    (void)state;
+    /* Overlapping quads at the same z must stay in submission order */
+    test_keys64[0] = render_sort_key(1.0f, 0, 9, 0);
+    test_keys64[1] = render_sort_key(1.0f, 0, 2, 0);
+    test_keys64[2] = render_sort_key(0.5f, 0, 9, 0);
+    set_bounds(0, 0, 0, 16, 16);
+    set_bounds(1, 8, 8, 24, 24);
+    set_bounds(2, 0, 0, 16, 16);
+
+    radix_sort_indices_by_key64(test_order, test_keys64, 3, test_scratch);
+    render_sort_restore_overlaps(test_order, test_keys64, test_bounds, 3);
+
+    assert_int_equal(test_order[0], 2);
+    assert_int_equal(test_order[1], 0);
+    assert_int_equal(test_order[2], 1);
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_single_element),
@@ -170,6 +280,12 @@ int main(void) {
         cmocka_unit_test(test_partial_ties),
         cmocka_unit_test(test_larger_count),
         cmocka_unit_test(test_float_to_sortable_monotonic),
+        cmocka_unit_test(test_key64_z_dominates_state),
+        cmocka_unit_test(test_key64_groups_equal_z_by_state),
+        cmocka_unit_test(test_key64_uniform_keys_keep_submission_order),
+        cmocka_unit_test(test_key64_matches_reference_order),
+        cmocka_unit_test(test_restore_overlaps_keeps_disjoint_grouping),
+        cmocka_unit_test(test_restore_overlaps_reverts_overlapping_group),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
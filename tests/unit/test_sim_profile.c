@@ -0,0 +1,259 @@
+/**
+ * @file test_sim_profile.c
+ * @brief Unit tests for the simulation CPU profiler.
+ *
+ * Checks that nothing is counted while the profiler is off or for calls
+ * that straddle it being turned off, that time and calls land on the right
+ * task, effect and command, that rows sort by time, calls and average, that
+ * effect and task names match the source, and that the CSV export and the
+ * HUD table cover what was recorded.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+#include <SDL3/SDL.h>
+
+#include "port/sim_profile.h"
+
+#define CSV_PATH "test_sim_profile.csv"
+#define HUD_LINES 8
+
+/** @brief Busy-wait so calls have a measurable, non-zero duration. */
+static void spin_ns(uint64_t ns) {
+    const uint64_t until = SDL_GetTicksNS() + ns;
+
+    while (SDL_GetTicksNS() < until) {}
+}
+
+/** @brief One profiled call that takes about @p ns. */
+static void call(SimProfileKind kind, int id, uint64_t ns) {
+    const uint64_t prof = SimProfile_Begin();
+
+    spin_ns(ns);
+    SimProfile_End(kind, id, prof);
+}
+
+static int teardown(void** state) {
+    // Cycle the HUD back to its "off" view, then make sure the profiler is off too
+    for (int i = 0; i < 4; i++) {
+        char lines[1][SIM_PROFILE_LINE_LENGTH];
+
+        if (SimProfile_FormatOverlay(lines, 1) == 0) {
+            break;
+        }
+
+        SimProfile_CycleView();
+    }
+
+    SimProfile_SetEnabled(false);
+    remove(CSV_PATH);
+    return 0;
+}
+
+static void test_nothing_counted_while_off(void** state) {
+    SimProfileRow rows[4];
+    uint64_t stale;
+
+    assert_false(SimProfile_IsEnabled());
+    assert_true(SimProfile_Begin() == 0);
+    call(SIM_PROFILE_EFFECT, 3, 0);
+    SimProfile_NoteFrame();
+
+    // A call that is still running when the profiler is turned off is dropped
+    SimProfile_SetEnabled(true);
+    stale = SimProfile_Begin();
+    assert_true(stale != 0);
+    SimProfile_SetEnabled(false);
+    SimProfile_End(SIM_PROFILE_EFFECT, 3, stale);
+
+    SimProfile_SetEnabled(true);
+    assert_true(SimProfile_GetFrames() == 0);
+    assert_int_equal(SimProfile_GetRows(SIM_PROFILE_EFFECT, SIM_PROFILE_BY_TIME, rows, 4), 0);
+
+    // Out of range IDs are ignored rather than written past the tables
+    call(SIM_PROFILE_EFFECT, SIM_PROFILE_EFFECTS, 0);
+    call(SIM_PROFILE_COMMAND, -1, 0);
+    assert_int_equal(SimProfile_GetRows(SIM_PROFILE_EFFECT, SIM_PROFILE_BY_TIME, rows, 4), 0);
+    assert_int_equal(SimProfile_GetRows(SIM_PROFILE_COMMAND, SIM_PROFILE_BY_TIME, rows, 4), 0);
+}
+
+static void test_counts_and_sort_orders(void** state) {
+    SimProfileRow rows[4];
+
+    SimProfile_SetEnabled(true);
+
+    // 10: one slow call; 20: many fast calls; 30: two medium calls
+    call(SIM_PROFILE_EFFECT, 10, 2000000);
+
+    for (int i = 0; i < 5; i++) {
+        call(SIM_PROFILE_EFFECT, 20, 10000);
+    }
+
+    call(SIM_PROFILE_EFFECT, 30, 400000);
+    call(SIM_PROFILE_EFFECT, 30, 400000);
+    call(SIM_PROFILE_COMMAND, 7, 0);
+
+    assert_int_equal(SimProfile_GetRows(SIM_PROFILE_EFFECT, SIM_PROFILE_BY_TIME, rows, 4), 3);
+    assert_int_equal(rows[0].id, 10);
+    assert_int_equal(rows[1].id, 30);
+    assert_int_equal(rows[2].id, 20);
+    assert_int_equal(rows[0].kind, SIM_PROFILE_EFFECT);
+    assert_true(rows[0].calls == 1);
+    assert_true(rows[1].calls == 2);
+    assert_true(rows[2].calls == 5);
+    assert_true(rows[0].ns >= 2000000);
+    assert_true(rows[1].ns >= 800000);
+    assert_true(rows[2].ns >= 50000);
+
+    assert_int_equal(SimProfile_GetRows(SIM_PROFILE_EFFECT, SIM_PROFILE_BY_CALLS, rows, 4), 3);
+    assert_int_equal(rows[0].id, 20);
+    assert_int_equal(rows[1].id, 30);
+    assert_int_equal(rows[2].id, 10);
+
+    // Truncated to the most expensive per call
+    assert_int_equal(SimProfile_GetRows(SIM_PROFILE_EFFECT, SIM_PROFILE_BY_AVERAGE, rows, 2), 2);
+    assert_int_equal(rows[0].id, 10);
+    assert_int_equal(rows[1].id, 30);
+
+    // Kinds are counted apart
+    assert_int_equal(SimProfile_GetRows(SIM_PROFILE_COMMAND, SIM_PROFILE_BY_TIME, rows, 4), 1);
+    assert_int_equal(rows[0].id, 7);
+    assert_int_equal(rows[0].kind, SIM_PROFILE_COMMAND);
+    assert_int_equal(SimProfile_GetRows(SIM_PROFILE_TASK, SIM_PROFILE_BY_TIME, rows, 4), 0);
+
+    // Turning it back on starts over
+    SimProfile_SetEnabled(false);
+    SimProfile_SetEnabled(true);
+    assert_int_equal(SimProfile_GetRows(SIM_PROFILE_EFFECT, SIM_PROFILE_BY_TIME, rows, 4), 0);
+}
+
+static void test_names(void** state) {
+    char name[32];
+
+    SimProfile_FormatName(SIM_PROFILE_TASK, 5, name, sizeof(name));
+    assert_string_equal(name, "Task:Game");
+    SimProfile_FormatName(SIM_PROFILE_TASK, 8, name, sizeof(name));
+    assert_string_equal(name, "Task:Slot8");
+
+    // Same numbering as the effect_XX_move handlers in effmovejptbl
+    SimProfile_FormatName(SIM_PROFILE_EFFECT, 7, name, sizeof(name));
+    assert_string_equal(name, "effect_07");
+    SimProfile_FormatName(SIM_PROFILE_EFFECT, 99, name, sizeof(name));
+    assert_string_equal(name, "effect_99");
+    SimProfile_FormatName(SIM_PROFILE_EFFECT, 106, name, sizeof(name));
+    assert_string_equal(name, "effect_A6");
+    SimProfile_FormatName(SIM_PROFILE_EFFECT, 228, name, sizeof(name));
+    assert_string_equal(name, "effect_M8");
+
+    SimProfile_FormatName(SIM_PROFILE_COMMAND, 42, name, sizeof(name));
+    assert_string_equal(name, "cmd_42");
+}
+
+static char* read_text(const char* path) {
+    FILE* f = fopen(path, "rb");
+    char* text;
+    long size;
+
+    assert_non_null(f);
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    text = calloc(size + 1, 1);
+    assert_int_equal(fread(text, 1, size, f), size);
+    fclose(f);
+    return text;
+}
+
+static void test_csv_export(void** state) {
+    char* csv;
+    int lines = 0;
+
+    SimProfile_SetEnabled(true);
+
+    for (int frame = 0; frame < 4; frame++) {
+        const uint64_t prof = SimProfile_Begin();
+
+        SimProfile_NoteFrame();
+        call(SIM_PROFILE_EFFECT, 106, 1000);
+        call(SIM_PROFILE_COMMAND, 3, 0);
+        SimProfile_End(SIM_PROFILE_TASK, 5, prof);
+    }
+
+    assert_true(SimProfile_GetFrames() == 4);
+    assert_true(SimProfile_WriteCSV(CSV_PATH));
+    csv = read_text(CSV_PATH);
+
+    for (const char* p = csv; *p != '\0'; p++) {
+        lines += (*p == '\n');
+    }
+
+    // Header plus one row per ID that was called
+    assert_int_equal(lines, 4);
+    assert_true(strncmp(csv, "kind,id,name,calls,total_us,avg_us,us_per_frame\n", 48) == 0);
+    assert_non_null(strstr(csv, "\ntask,5,Task:Game,4,"));
+    assert_non_null(strstr(csv, "\neffect,106,effect_A6,4,"));
+    assert_non_null(strstr(csv, "\ncommand,3,cmd_3,4,"));
+    free(csv);
+}
+
+static void test_hud_table(void** state) {
+    char lines[HUD_LINES][SIM_PROFILE_LINE_LENGTH];
+
+    assert_int_equal(SimProfile_FormatOverlay(lines, HUD_LINES), 0);
+
+    // Selecting a table turns the profiler on
+    SimProfile_CycleView();
+    assert_true(SimProfile_IsEnabled());
+    call(SIM_PROFILE_TASK, 5, 1000);
+    call(SIM_PROFILE_TASK, 0, 0);
+
+    assert_int_equal(SimProfile_FormatOverlay(lines, HUD_LINES), 3);
+    assert_non_null(strstr(lines[0], "task by time"));
+    assert_true(strncmp(lines[1], "Task:Game ", 10) == 0);
+    assert_true(strncmp(lines[2], "Task:Init ", 10) == 0);
+
+    // Only as many rows as there is room for
+    assert_int_equal(SimProfile_FormatOverlay(lines, 2), 2);
+
+    SimProfile_CycleSort();
+    SimProfile_FormatOverlay(lines, HUD_LINES);
+    assert_non_null(strstr(lines[0], "task by calls"));
+
+    SimProfile_CycleView();
+    assert_int_equal(SimProfile_FormatOverlay(lines, HUD_LINES), 1);
+    assert_non_null(strstr(lines[0], "effect by calls"));
+    SimProfile_CycleView();
+    SimProfile_FormatOverlay(lines, HUD_LINES);
+    assert_non_null(strstr(lines[0], "command by calls"));
+
+    // Back to off: the HUD turned it on, so it turns it off
+    SimProfile_CycleView();
+    assert_int_equal(SimProfile_FormatOverlay(lines, HUD_LINES), 0);
+    assert_false(SimProfile_IsEnabled());
+
+    // But it leaves a profile that was already running (--sim-profile) alone
+    SimProfile_SetEnabled(true);
+
+    for (int i = 0; i < 4; i++) {
+        SimProfile_CycleView();
+    }
+
+    assert_true(SimProfile_IsEnabled());
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_teardown(test_nothing_counted_while_off, teardown),
+        cmocka_unit_test_teardown(test_counts_and_sort_orders, teardown),
+        cmocka_unit_test_teardown(test_names, teardown),
+        cmocka_unit_test_teardown(test_csv_export, teardown),
+        cmocka_unit_test_teardown(test_hud_table, teardown),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
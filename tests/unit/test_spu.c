@@ -0,0 +1,231 @@
+/**
+ * @file test_spu.c
+ * @brief Unit tests for the SPU emulator's voice-major block renderer.
+ *
+ * Each test builds the same voice scenario twice: once rendered with the
+ * per-sample SPU_Tick() reference path and once with SPU_Render() in
+ * blocks of varying size. The two outputs must be bit-identical.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+#include "cmocka.h"
+#include "port/sound/spu.h"
+
+#define SAMPLE_RATE 48000
+#define TEST_SAMPLES (SAMPLE_RATE / 2)
+#define BLOCK_WORDS 8 // 16-byte ADPCM block: header + 28 nibbles
+
+enum {
+    EV_START,
+    EV_KEY_OFF,
+    EV_STOP,
+};
+
+typedef struct {
+    int at;
+    int type;
+    int voice;
+    u32 addr;
+} Event;
+
+static s16 s_ref[TEST_SAMPLES * 2];
+static s16 s_out[TEST_SAMPLES * 2];
+static u16 s_adpcm[0x4000];
+static u32 s_rng;
+
+static u32 next_rand(void) {
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return s_rng >> 8;
+}
+
+/** Write @p blocks random ADPCM blocks at word @p addr; @p end_flags go on the last header. */
+static void make_sample(u32 addr, int blocks, u16 end_flags) {
+    for (int b = 0; b < blocks; b++) {
+        u16* blk = &s_adpcm[addr + b * BLOCK_WORDS];
+        u16 header = (u16)((next_rand() % 13) | ((next_rand() % 5) << 4));
+
+        if (b == 0) {
+            header |= 0x400; // loop start
+        }
+        if (b == blocks - 1) {
+            header |= end_flags;
+        }
+
+        blk[0] = header;
+        for (int w = 1; w < BLOCK_WORDS; w++) {
+            blk[w] = (u16)next_rand();
+        }
+    }
+}
+
+static void configure_voice(int vnum, u32 pitch, bool pmon) {
+    struct SPUVConf conf;
+
+    conf.pitch = pitch;
+    conf.voll = 0x1000 + next_rand() % 0x2FFF;
+    conf.volr = 0x1000 + next_rand() % 0x2FFF;
+    conf.adsr1 = (u16)next_rand();
+    conf.adsr2 = (u16)(next_rand() & ~0x4000u); // mix of rising and infinite sustain
+    conf.pmon = pmon;
+    SPU_VoiceSetConf(vnum, &conf);
+}
+
+static void apply_event(const Event* ev) {
+    switch (ev->type) {
+    case EV_START:
+        SPU_VoiceStart(ev->voice, ev->addr);
+        break;
+    case EV_KEY_OFF:
+        SPU_VoiceKeyOff(ev->voice);
+        break;
+    case EV_STOP:
+        SPU_VoiceStop(ev->voice);
+        break;
+    }
+}
+
+/** Reset the SPU and program the shared scenario; returns the event count. */
+static int setup_scenario(u32 seed, Event* events) {
+    static const u32 looped = 0x0000;
+    static const u32 one_shot = 0x1000;
+    static const u32 short_shot = 0x2000;
+    int n = 0;
+
+    s_rng = seed;
+    memset(s_adpcm, 0, sizeof(s_adpcm));
+    make_sample(looped, 64, 0x300);   // end + repeat: jumps back to the loop start
+    make_sample(one_shot, 48, 0x100); // end without repeat: voice stops
+    make_sample(short_shot, 3, 0x100);
+
+    SPU_Reset();
+    SPU_Upload(0, s_adpcm, sizeof(s_adpcm));
+
+    // Plain voices at assorted pitches
+    for (int v = 0; v < 4; v++) {
+        configure_voice(v, 0x400 + next_rand() % 0x3C00, false);
+        events[n++] = (Event) { 0, EV_START, v, (v & 1) ? one_shot : looped };
+    }
+
+    // pmon chain 8 -> 9 -> 10
+    configure_voice(8, 0x1000, false);
+    configure_voice(9, 0x0800, true);
+    configure_voice(10, 0x2000, true);
+    events[n++] = (Event) { 0, EV_START, 8, looped };
+    events[n++] = (Event) { 0, EV_START, 9, looped };
+    events[n++] = (Event) { 0, EV_START, 10, one_shot };
+
+    // pmon voice whose predecessor ends almost immediately (frozen last_sample)
+    configure_voice(20, 0x3FFF, false);
+    configure_voice(21, 0x1000, true);
+    events[n++] = (Event) { 0, EV_START, 20, short_shot };
+    events[n++] = (Event) { 0, EV_START, 21, looped };
+
+    // pmon voice whose predecessor never runs
+    configure_voice(31, 0x1800, true);
+    events[n++] = (Event) { 0, EV_START, 31, looped };
+
+    // Mid-stream changes, on and off 192-sample timer boundaries
+    events[n++] = (Event) { 1000, EV_START, 40, looped };
+    events[n++] = (Event) { 192 * 7, EV_KEY_OFF, 0, 0 };
+    events[n++] = (Event) { 3333, EV_KEY_OFF, 8, 0 };
+    events[n++] = (Event) { 5000, EV_STOP, 2, 0 };
+    events[n++] = (Event) { 6001, EV_START, 2, one_shot };
+    events[n++] = (Event) { 9000, EV_KEY_OFF, 40, 0 };
+    events[n++] = (Event) { 12000, EV_START, 47, short_shot };
+    configure_voice(40, 0x2A00, false);
+    configure_voice(47, 0x0C00, true);
+
+    return n;
+}
+
+static void render_reference(u32 seed) {
+    Event events[32];
+    const int count = setup_scenario(seed, events);
+    int e = 0;
+
+    for (int i = 0; i < TEST_SAMPLES; i++) {
+        while (e < count && events[e].at == i) {
+            apply_event(&events[e++]);
+        }
+        SPU_Tick(&s_ref[i * 2]);
+    }
+}
+
+static void render_blocks(u32 seed, const int* sizes, int size_count) {
+    Event events[32];
+    const int count = setup_scenario(seed, events);
+    int e = 0;
+    int pos = 0;
+    int s = 0;
+
+    while (pos < TEST_SAMPLES) {
+        while (e < count && events[e].at == pos) {
+            apply_event(&events[e++]);
+        }
+
+        int run = sizes[s++ % size_count];
+        if (run > TEST_SAMPLES - pos) {
+            run = TEST_SAMPLES - pos;
+        }
+        if (e < count && events[e].at - pos < run) {
+            run = events[e].at - pos;
+        }
+
+        SPU_Render(&s_out[pos * 2], run);
+        pos += run;
+    }
+}
+
+static bool has_signal(const s16* buf) {
+    for (int i = 0; i < TEST_SAMPLES * 2; i++) {
+        if (buf[i] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void test_block_matches_per_sample(void** state) {
+    (void)state;
+    static const int sizes[] = { 256 };
+
+    render_reference(0x5EED0001);
+    render_blocks(0x5EED0001, sizes, 1);
+
+    assert_true(has_signal(s_ref));
+    assert_memory_equal(s_out, s_ref, sizeof(s_ref));
+}
+
+static void test_odd_and_oversized_blocks_match(void** state) {
+    (void)state;
+    static const int sizes[] = { 1, 7, 192, 255, 256, 257, 1000, 3 };
+
+    render_reference(0x5EED0002);
+    render_blocks(0x5EED0002, sizes, 8);
+
+    assert_memory_equal(s_out, s_ref, sizeof(s_ref));
+}
+
+static void test_many_seeds_match(void** state) {
+    (void)state;
+    static const int sizes[] = { 192, 64, 256 };
+
+    for (u32 seed = 100; seed < 108; seed++) {
+        render_reference(seed);
+        render_blocks(seed, sizes, 3);
+        assert_memory_equal(s_out, s_ref, sizeof(s_ref));
+    }
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_block_matches_per_sample),
+        cmocka_unit_test(test_odd_and_oversized_blocks_match),
+        cmocka_unit_test(test_many_seeds_match),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,190 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include "port/io/tile_cache.h"
+
+#define CACHE_PATH "test_tile_cache.bin"
+#define AFS_HASH 0x0123456789ABCDEFull
+#define FILE_NUM 1468
+#define FILE_SIZE 0x4000
+#define TILE_SIZE 0x100
+
+static uint8_t s_file[FILE_SIZE];
+static uint8_t s_tile[TILE_SIZE];
+
+static int setup(void** state) {
+    (void)state;
+
+    for (int i = 0; i < FILE_SIZE; i++) {
+        s_file[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    for (int i = 0; i < TILE_SIZE; i++) {
+        s_tile[i] = (uint8_t)(i ^ 0x5A);
+    }
+
+    remove(CACHE_PATH);
+    return 0;
+}
+
+static int teardown(void** state) {
+    (void)state;
+    TileCache_Finish();
+    remove(CACHE_PATH);
+    return 0;
+}
+
+/** Open the cache, bind the fake AFS file, and store one tile at @p offset. */
+static void populate(unsigned int offset) {
+    assert_true(TileCache_Init(CACHE_PATH, AFS_HASH));
+    TileCache_BindFile(FILE_NUM, s_file, FILE_SIZE);
+    assert_null(TileCache_Lookup(s_file + offset, TILE_SIZE));
+    TileCache_Store(s_file + offset, TILE_SIZE, s_tile);
+    TileCache_Finish();
+}
+
+static void test_store_then_map_on_next_session(void** state) {
+    (void)state;
+    const void* hit;
+
+    populate(0x200);
+
+    assert_true(TileCache_Init(CACHE_PATH, AFS_HASH));
+    TileCache_BindFile(FILE_NUM, s_file, FILE_SIZE);
+    hit = TileCache_Lookup(s_file + 0x200, TILE_SIZE);
+    assert_non_null(hit);
+    assert_memory_equal(hit, s_tile, TILE_SIZE);
+
+    // Different chunk offset or decoded size is a different tile
+    assert_null(TileCache_Lookup(s_file + 0x300, TILE_SIZE));
+    assert_null(TileCache_Lookup(s_file + 0x200, TILE_SIZE / 2));
+}
+
+static void test_changed_file_contents_miss(void** state) {
+    (void)state;
+
+    populate(0x200);
+    s_file[FILE_SIZE - 1] ^= 0xFF;
+
+    assert_true(TileCache_Init(CACHE_PATH, AFS_HASH));
+    TileCache_BindFile(FILE_NUM, s_file, FILE_SIZE);
+    assert_null(TileCache_Lookup(s_file + 0x200, TILE_SIZE));
+}
+
+static void test_changed_archive_discards_cache(void** state) {
+    (void)state;
+
+    populate(0x200);
+
+    assert_true(TileCache_Init(CACHE_PATH, AFS_HASH + 1));
+    TileCache_BindFile(FILE_NUM, s_file, FILE_SIZE);
+    assert_null(TileCache_Lookup(s_file + 0x200, TILE_SIZE));
+}
+
+static void test_unbound_source_is_ignored(void** state) {
+    (void)state;
+    uint8_t other[TILE_SIZE];
+
+    assert_true(TileCache_Init(CACHE_PATH, AFS_HASH));
+    TileCache_BindFile(FILE_NUM, s_file, FILE_SIZE);
+    TileCache_Store(other, TILE_SIZE, s_tile);
+    TileCache_UnbindFile(s_file);
+    TileCache_Store(s_file, TILE_SIZE, s_tile);
+    TileCache_Finish();
+
+    assert_true(TileCache_Init(CACHE_PATH, AFS_HASH));
+    TileCache_BindFile(FILE_NUM, s_file, FILE_SIZE);
+    assert_null(TileCache_Lookup(s_file, TILE_SIZE));
+}
+
+static void test_uncommitted_tail_is_ignored(void** state) {
+    (void)state;
+    static const uint8_t junk[64] = { 0x54, 0x49, 0x4C, 0x45, 0xFF };
+    FILE* f;
+
+    populate(0x200);
+
+    // Bytes past data_end (an interrupted append) must not be parsed
+    f = fopen(CACHE_PATH, "ab");
+    assert_non_null(f);
+    fwrite(junk, 1, sizeof(junk), f);
+    fclose(f);
+
+    assert_true(TileCache_Init(CACHE_PATH, AFS_HASH));
+    TileCache_BindFile(FILE_NUM, s_file, FILE_SIZE);
+    assert_non_null(TileCache_Lookup(s_file + 0x200, TILE_SIZE));
+    TileCache_Store(s_file + 0x400, TILE_SIZE, s_tile);
+    TileCache_Finish();
+
+    assert_true(TileCache_Init(CACHE_PATH, AFS_HASH));
+    TileCache_BindFile(FILE_NUM, s_file, FILE_SIZE);
+    assert_non_null(TileCache_Lookup(s_file + 0x200, TILE_SIZE));
+    assert_non_null(TileCache_Lookup(s_file + 0x400, TILE_SIZE));
+}
+
+static void test_corrupt_record_misses(void** state) {
+    (void)state;
+    FILE* f;
+    long size;
+    uint8_t b;
+
+    populate(0x200);
+
+    // Flip a byte inside the only record's tile data (the file ends with it)
+    f = fopen(CACHE_PATH, "r+b");
+    assert_non_null(f);
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, size - 8, SEEK_SET);
+    assert_int_equal(fread(&b, 1, 1, f), 1);
+    b ^= 0x80;
+    fseek(f, size - 8, SEEK_SET);
+    fwrite(&b, 1, 1, f);
+    fclose(f);
+
+    assert_true(TileCache_Init(CACHE_PATH, AFS_HASH));
+    TileCache_BindFile(FILE_NUM, s_file, FILE_SIZE);
+    assert_null(TileCache_Lookup(s_file + 0x200, TILE_SIZE));
+}
+
+static void test_full_bind_table_evicts_oldest(void** state) {
+    (void)state;
+    static uint8_t others[32][16];
+
+    populate(0x200);
+
+    // The newest binding always gets a range, pushing out the oldest one
+    assert_true(TileCache_Init(CACHE_PATH, AFS_HASH));
+
+    for (int i = 0; i < 32; i++) {
+        TileCache_BindFile(i, others[i], sizeof(others[i]));
+    }
+
+    TileCache_BindFile(FILE_NUM, s_file, FILE_SIZE);
+    assert_non_null(TileCache_Lookup(s_file + 0x200, TILE_SIZE));
+
+    for (int i = 0; i < 32; i++) {
+        TileCache_BindFile(i, others[i], sizeof(others[i]));
+    }
+
+    assert_null(TileCache_Lookup(s_file + 0x200, TILE_SIZE));
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_store_then_map_on_next_session, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_changed_file_contents_miss, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_changed_archive_discards_cache, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_unbound_source_is_ignored, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_uncommitted_tail_is_ignored, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_corrupt_record_misses, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_full_bind_table_evicts_oldest, setup, teardown),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
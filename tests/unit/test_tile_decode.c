@@ -0,0 +1,218 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include "sf33rd/Source/Game/rendering/tile_decode.h"
+
+#define TILE_COUNT 64
+#define DST_SLACK 0x80
+
+/* --- ppgRenewDotDataSeqs stub: records what the pool writes, per (gix, code) --- */
+
+static u8 s_written[4][256][TILE_DECODE_MAX_BYTES];
+static s32 s_write_order[TILE_COUNT * 4];
+static s32 s_write_count;
+
+void ppgRenewDotDataSeqs(Texture* tch, u32 gix, u32* srcRam, u32 code, u32 size) {
+    (void)tch;
+    memcpy(s_written[gix & 3][code & 0xFF], srcRam, size);
+    s_write_order[s_write_count++] = (s32)((gix << 8) | code);
+}
+
+/* --- Deterministic compressed tile generator --- */
+
+static u8 s_streams[TILE_COUNT][TILE_DECODE_MAX_BYTES * 2];
+static u32 s_sizes[TILE_COUNT];
+static u32 s_rng = 0x12345678;
+
+static u32 next_rand(void) {
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return s_rng >> 8;
+}
+
+/** Emit random literal / back-reference / nibble-run tokens until @p size bytes are produced. */
+static void make_stream(u8* out, u32 size) {
+    u32 produced = 0;
+
+    while (produced < size) {
+        u32 kind = next_rand() % 4;
+
+        if (kind == 0 || produced == 0) {
+            *out++ = next_rand() & 0x3F;
+            produced += 1;
+        } else if (kind == 1 && produced >= 16) {
+            u32 dist = next_rand() % 16; // (tmp >> 2) with 4-bit distance
+            *out++ = 0x40 | (dist << 2) | (next_rand() & 3);
+            produced += (u32)((out[-1] & 3) + 2);
+        } else if (kind == 2 && produced >= 2) {
+            u32 dist = next_rand() % (produced < 256 ? produced : 256);
+            u32 len = next_rand() & 0x3F;
+            u32 tok = (dist << 6) | len;
+            *out++ = 0x80 | ((tok >> 8) & 0x3F);
+            *out++ = tok & 0xFF;
+            produced += len + 2;
+        } else {
+            u32 n = next_rand() & 0xF;
+            *out++ = 0xC0 | (next_rand() & 0x30) | n;
+            for (u32 i = 0; i < n + 2; i++) {
+                *out++ = next_rand() & 0xFF;
+            }
+            produced += (n + 2) * 2;
+        }
+    }
+}
+
+static int setup(void** state) {
+    (void)state;
+    static const u32 sizes[3] = { 0x40, 0x100, 0x400 };
+
+    for (s32 i = 0; i < TILE_COUNT; i++) {
+        s_sizes[i] = sizes[i % 3];
+        make_stream(s_streams[i], s_sizes[i]);
+    }
+
+    memset(s_written, 0, sizeof(s_written));
+    s_write_count = 0;
+    tileDecodeInit();
+    return 0;
+}
+
+static int teardown(void** state) {
+    (void)state;
+    tileDecodeShutdown();
+    return 0;
+}
+
+static void decode_inline(s32 i, u8* dst) {
+    lz_ext_p6_fx(s_streams[i], dst, s_sizes[i]);
+}
+
+static void test_lz_ext_p6_fx_tokens(void** state) {
+    (void)state;
+    // literal 0x05, literal 0x06, back-ref dist 1 len 2, nibble run 0x10|{0xA,0xB} x2
+    static const u8 src[] = { 0x05, 0x06, 0x44, 0xD0, 0xAB, 0x12 };
+    static const u8 expect[] = { 0x05, 0x06, 0x05, 0x06, 0x1A, 0x1B, 0x11, 0x12 };
+    u8 dst[8 + DST_SLACK];
+
+    lz_ext_p6_fx(src, dst, sizeof(expect));
+    assert_memory_equal(dst, expect, sizeof(expect));
+}
+
+static void test_submit_drain_matches_inline(void** state) {
+    (void)state;
+    u8 ref[TILE_DECODE_MAX_BYTES + DST_SLACK];
+    s32 queued = 0;
+
+    for (s32 i = 0; i < TILE_COUNT; i++) {
+        if (tileDecodeSubmit(NULL, i & 3, (u32)i, s_streams[i], s_sizes[i])) {
+            queued++;
+        } else {
+            decode_inline(i, ref);
+            ppgRenewDotDataSeqs(NULL, i & 3, (u32*)ref, (u32)i, s_sizes[i]);
+        }
+    }
+
+    tileDecodeDrain();
+
+    for (s32 i = 0; i < TILE_COUNT; i++) {
+        decode_inline(i, ref);
+        assert_memory_equal(s_written[i & 3][i], ref, s_sizes[i]);
+    }
+
+    assert_int_equal(s_write_count, TILE_COUNT);
+    (void)queued;
+}
+
+static void test_drain_applies_in_submission_order(void** state) {
+    (void)state;
+    s32 order[TILE_COUNT];
+    s32 n = 0;
+
+    s_write_count = 0;
+
+    for (s32 i = TILE_COUNT - 1; i >= 0; i--) {
+        if (tileDecodeSubmit(NULL, i & 3, (u32)i, s_streams[i], s_sizes[i])) {
+            order[n++] = ((i & 3) << 8) | i;
+        }
+    }
+
+    tileDecodeDrain();
+    assert_int_equal(s_write_count, n);
+
+    for (s32 i = 0; i < n; i++) {
+        assert_int_equal(s_write_order[i], order[i]);
+    }
+}
+
+static void test_prefetch_serves_demand(void** state) {
+    (void)state;
+    const u8* srcs[TILE_COUNT];
+    u8 ref[TILE_DECODE_MAX_BYTES + DST_SLACK];
+    TileDecodeStats stats;
+
+    tileDecodeInvalidate();
+    tileDecodeGetStats(&stats);
+
+    for (s32 i = 0; i < TILE_COUNT; i++) {
+        srcs[i] = s_streams[i];
+    }
+
+    tileDecodePrefetch(srcs, s_sizes, TILE_COUNT);
+    memset(s_written, 0, sizeof(s_written));
+
+    for (s32 i = 0; i < TILE_COUNT; i++) {
+        if (!tileDecodeSubmit(NULL, 1, (u32)i, s_streams[i], s_sizes[i])) {
+            decode_inline(i, ref);
+            ppgRenewDotDataSeqs(NULL, 1, (u32*)ref, (u32)i, s_sizes[i]);
+        }
+    }
+
+    tileDecodeDrain();
+    tileDecodeGetStats(&stats);
+
+    for (s32 i = 0; i < TILE_COUNT; i++) {
+        decode_inline(i, ref);
+        assert_memory_equal(s_written[1][i], ref, s_sizes[i]);
+    }
+
+    // Every submit is accounted for exactly once
+    assert_int_equal(stats.prefetch_hits + stats.async + stats.sync, TILE_COUNT);
+
+    if (stats.sync != TILE_COUNT) {
+        // Pool is running: every tile was prefetched, so none needed a fresh demand slot
+        assert_int_equal(stats.prefetched, TILE_COUNT);
+        assert_int_equal(stats.sync, 0);
+    }
+}
+
+static void test_invalidate_forgets_tiles(void** state) {
+    (void)state;
+    const u8* src = s_streams[0];
+    TileDecodeStats stats;
+
+    tileDecodePrefetch(&src, &s_sizes[0], 1);
+    tileDecodeInvalidate();
+    tileDecodeGetStats(&stats);
+
+    if (tileDecodeSubmit(NULL, 0, 0, s_streams[0], s_sizes[0])) {
+        tileDecodeDrain();
+        tileDecodeGetStats(&stats);
+        assert_int_equal(stats.prefetch_hits, 0);
+        assert_int_equal(stats.async, 1);
+    }
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_lz_ext_p6_fx_tokens),
+        cmocka_unit_test_setup_teardown(test_submit_drain_matches_inline, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_drain_applies_in_submission_order, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_prefetch_serves_demand, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_invalidate_forgets_tiles, setup, teardown),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,121 @@
+/**
+ * @file test_wav_writer.c
+ * @brief Unit tests for the streaming WAV writer used by offline audio rendering.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include "port/sound/wav_writer.h"
+
+#define WAV_PATH "test_wav_writer.wav"
+#define HEADER_SIZE 44
+
+static uint8_t s_file[HEADER_SIZE + 4096];
+
+static uint32_t rd32(const uint8_t* p) {
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint16_t rd16(const uint8_t* p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+/** Read the whole test file into s_file; returns its size. */
+static long read_back(void) {
+    FILE* f = fopen(WAV_PATH, "rb");
+    long size;
+
+    assert_non_null(f);
+    size = (long)fread(s_file, 1, sizeof(s_file), f);
+    fclose(f);
+    return size;
+}
+
+static int setup(void** state) {
+    (void)state;
+    remove(WAV_PATH);
+    return 0;
+}
+
+static int teardown(void** state) {
+    (void)state;
+    remove(WAV_PATH);
+    return 0;
+}
+
+static void test_header_and_data(void** state) {
+    (void)state;
+    WavWriter w;
+    s16 frames[300 * 2];
+    long size;
+
+    for (int i = 0; i < 300 * 2; i++) {
+        frames[i] = (s16)(i * 37 - 9000);
+    }
+
+    assert_true(WavWriter_Open(&w, WAV_PATH, 48000, 2));
+
+    // Uneven appends, as produced by 805/806-sample game frames
+    assert_true(WavWriter_Write(&w, frames, 7));
+    assert_true(WavWriter_Write(&w, frames + 7 * 2, 193));
+    assert_true(WavWriter_Write(&w, frames + 200 * 2, 100));
+    assert_true(WavWriter_Close(&w));
+
+    size = read_back();
+    assert_int_equal(size, HEADER_SIZE + sizeof(frames));
+
+    assert_memory_equal(s_file, "RIFF", 4);
+    assert_int_equal(rd32(s_file + 4), size - 8);
+    assert_memory_equal(s_file + 8, "WAVEfmt ", 8);
+    assert_int_equal(rd32(s_file + 16), 16);
+    assert_int_equal(rd16(s_file + 20), 1);
+    assert_int_equal(rd16(s_file + 22), 2);
+    assert_int_equal(rd32(s_file + 24), 48000);
+    assert_int_equal(rd32(s_file + 28), 48000 * 4);
+    assert_int_equal(rd16(s_file + 32), 4);
+    assert_int_equal(rd16(s_file + 34), 16);
+    assert_memory_equal(s_file + 36, "data", 4);
+    assert_int_equal(rd32(s_file + 40), sizeof(frames));
+
+    for (int i = 0; i < 300 * 2; i++) {
+        assert_int_equal((s16)rd16(s_file + HEADER_SIZE + i * 2), frames[i]);
+    }
+}
+
+static void test_empty_file_is_valid(void** state) {
+    (void)state;
+    WavWriter w;
+
+    assert_true(WavWriter_Open(&w, WAV_PATH, 48000, 2));
+    assert_true(WavWriter_Close(&w));
+
+    assert_int_equal(read_back(), HEADER_SIZE);
+    assert_int_equal(rd32(s_file + 4), HEADER_SIZE - 8);
+    assert_int_equal(rd32(s_file + 40), 0);
+}
+
+static void test_closed_writer_rejects_io(void** state) {
+    (void)state;
+    WavWriter w;
+    s16 frame[2] = { 1, 2 };
+
+    assert_true(WavWriter_Open(&w, WAV_PATH, 48000, 2));
+    assert_true(WavWriter_Close(&w));
+    assert_false(WavWriter_Write(&w, frame, 1));
+    assert_false(WavWriter_Close(&w));
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_header_and_data, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_empty_file_is_valid, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_closed_writer_rejects_io, setup, teardown),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}